@@ -0,0 +1,76 @@
+#!/usr/bin/env python
+
+"""Times the pygame.draw primitives on surfaces of each bit depth.
+
+No display is needed, the drawing is done on plain Surfaces.
+"""
+
+import sys, time
+import pygame
+
+
+SIZE = (640, 480)
+
+
+def _shapes():
+    """(name, draw function) pairs for every primitive that is timed"""
+    draw = pygame.draw
+    color = (200, 120, 40)
+    texture = pygame.Surface((64, 64), pygame.SRCALPHA, 32)
+    texture.fill((40, 160, 220, 200))
+    quad = [(20, 20), (620, 40), (600, 460), (40, 440)]
+    uvs = [(0, 0), (4, 0), (4, 4), (0, 4)]
+    return [
+        ('circle filled', lambda s: draw.circle(s, color, (320, 240), 200)),
+        ('circle w=5', lambda s: draw.circle(s, color, (320, 240), 200, 5)),
+        ('ellipse filled',
+         lambda s: draw.ellipse(s, color, (20, 40, 600, 400))),
+        ('ellipse w=5',
+         lambda s: draw.ellipse(s, color, (20, 40, 600, 400), 5)),
+        ('arc w=3',
+         lambda s: draw.arc(s, color, (20, 40, 600, 400), 0.3, 5.5, 3)),
+        ('line w=1', lambda s: draw.line(s, color, (10, 20), (630, 400))),
+        ('line w=9', lambda s: draw.line(s, color, (10, 20), (630, 400), 9)),
+        ('lines w=4',
+         lambda s: draw.lines(s, color, True,
+                              [(10, 10), (630, 30), (600, 470), (30, 400)],
+                              4)),
+        ('rect filled', lambda s: draw.rect(s, color, (10, 10, 620, 460))),
+        ('rect w=4', lambda s: draw.rect(s, color, (10, 10, 620, 460), 4)),
+        ('polygon filled',
+         lambda s: draw.polygon(s, color,
+                                [(320, 10), (630, 240), (320, 470), (10, 240)])),
+        ('textured quad',
+         lambda s: draw.textured_triangles(s, texture, quad, uvs,
+                                           [0, 1, 2, 0, 2, 3])),
+    ]
+
+
+def main(loops=50, depths=(8, 16, 24, 32)):
+    """time each draw primitive for each surface bit depth
+
+    arguments:
+    loops - number of times each shape is drawn (default 50)
+    depths - surface bit depths to time (default 8, 16, 24 and 32)
+
+    """
+    shapes = _shapes()
+    print ("%-16s" % "" + "".join(["%10s" % ("%d bit" % d) for d in depths]))
+    for name, func in shapes:
+        row = "%-16s" % name
+        for depth in depths:
+            surf = pygame.Surface(SIZE, 0, depth)
+            func(surf)
+            start = time.time()
+            for i in range(loops):
+                func(surf)
+            duration = (time.time() - start) / loops
+            row += "%10s" % ("%.3f ms" % (duration * 1000.0))
+        print (row)
+
+
+if __name__ == '__main__':
+    if len(sys.argv) > 1:
+        main(int(sys.argv[1]))
+    else:
+        main()
@@ -0,0 +1,68 @@
+#!/usr/bin/env python
+
+"""Times posting and taking back events that carry Python objects.
+
+Every posted event keeps its attributes in a table slot until it is taken
+off the queue again, so the cost per event should stay the same however
+many events are waiting. Each row posts a batch of events and then reads
+them all back, with pygame.event.poll() and with pygame.event.get().
+
+The SDL 1 event queue only holds 128 events, larger batches are skipped.
+"""
+
+import sys, time
+import pygame
+
+
+def _time(batch, total, read):
+    """microseconds per event to post and read total events in batches"""
+    payload = {'peer': 'client-7', 'data': list(range(8))}
+    events = [pygame.event.Event(pygame.USEREVENT, msg=payload, seq=i)
+              for i in range(batch)]
+    start = time.time()
+    for i in range(total // batch):
+        for e in events:
+            pygame.event.post(e)
+        read(batch)
+    return (time.time() - start) * 1000000.0 / (total // batch * batch)
+
+
+def _poll(batch):
+    poll = pygame.event.poll
+    for i in range(batch):
+        poll()
+
+
+def _get(batch):
+    pygame.event.get()
+
+
+def main(total=100000, batches=(16, 128, 1024, 8192, 32768)):
+    """time posting and reading back user events
+
+    arguments:
+    total - number of events posted for each batch size (default 100000)
+    batches - numbers of events on the queue at once (default 16 to 32768)
+
+    """
+    pygame.display.init()
+    try:
+        print ("%8s%14s%14s" % ("batch", "poll", "get"))
+        for batch in batches:
+            row = "%8d" % batch
+            try:
+                for read in (_poll, _get):
+                    pygame.event.clear()
+                    row += "%14s" % ("%.2f us" % _time(batch, total, read))
+            except pygame.error:
+                row += "%14s" % "queue full"
+            print (row)
+    finally:
+        pygame.display.quit()
+
+
+if __name__ == '__main__':
+    if len(sys.argv) > 1:
+        main(int(sys.argv[1]))
+    else:
+        main()
@@ -0,0 +1,95 @@
+#!/usr/bin/env python
+
+"""Times the filled pygame.gfxdraw primitives with and without blending.
+
+The opaque column writes every span directly. The blended columns use
+an alpha of 128, which on 32 bit surfaces goes through the span blender
+and on other depths through the per pixel blending loop. The scalar
+column draws the same blended shapes with the span blender switched to
+its one pixel at a time reference loop, and the speedup column compares
+the two, so one build times both. The threaded column draws on one
+surface per thread at once, which only scales because the primitives
+release the GIL while they draw.
+
+No display is needed, the drawing is done on plain Surfaces.
+"""
+
+import sys, time, threading
+import pygame
+import pygame.gfxdraw
+
+
+SIZE = (640, 480)
+
+
+def _shapes():
+    """(name, draw function) pairs for every primitive that is timed"""
+    gfx = pygame.gfxdraw
+    star = [(320, 10), (390, 170), (630, 180), (430, 290), (510, 470),
+            (320, 360), (130, 470), (210, 290), (10, 180), (250, 170)]
+    return [
+        ('box', lambda s, c: gfx.box(s, (10, 10, 620, 460), c)),
+        ('filled_circle', lambda s, c: gfx.filled_circle(s, 320, 240, 220, c)),
+        ('filled_ellipse',
+         lambda s, c: gfx.filled_ellipse(s, 320, 240, 300, 200, c)),
+        ('filled_trigon',
+         lambda s, c: gfx.filled_trigon(s, 10, 470, 320, 10, 630, 400, c)),
+        ('filled_polygon', lambda s, c: gfx.filled_polygon(s, star, c)),
+    ]
+
+
+def _time(func, surfs, color, loops):
+    """seconds per call of func on each of surfs, one thread per surface"""
+    def run(surf):
+        for i in range(loops):
+            func(surf, color)
+
+    threads = [threading.Thread(target=run, args=(s,)) for s in surfs]
+    start = time.time()
+    for t in threads:
+        t.start()
+    for t in threads:
+        t.join()
+    return (time.time() - start) / (loops * len(surfs))
+
+
+def main(loops=50, depths=(16, 24, 32), threads=4):
+    """time the filled gfxdraw primitives for each surface bit depth
+
+    arguments:
+    loops - number of times each shape is drawn (default 50)
+    depths - surface bit depths to time (default 16, 24 and 32)
+    threads - number of threads for the threaded column (default 4)
+
+    """
+    gfx = pygame.gfxdraw
+    opaque, blended = (200, 120, 40), (200, 120, 40, 128)
+    header = "%-16s%6s" % ("", "")
+    for name in ['opaque', 'blended', 'scalar', 'speedup',
+                 'blended x%d' % threads]:
+        header += "%14s" % name
+    print (header)
+    for name, func in _shapes():
+        for depth in depths:
+            surfs = [pygame.Surface(SIZE, 0, depth) for i in range(threads)]
+            row = "%-16s%6s" % (name, "%d bit" % depth)
+            fast = _time(func, surfs[:1], blended, loops)
+            previous = gfx._set_scalar_blend(True)
+            try:
+                scalar = _time(func, surfs[:1], blended, loops)
+            finally:
+                gfx._set_scalar_blend(previous)
+            for duration in [_time(func, surfs[:1], opaque, loops),
+                             fast, scalar]:
+                row += "%14s" % ("%.3f ms" % (duration * 1000.0))
+            row += "%14s" % ("%.2fx" % (scalar / fast))
+            duration = _time(func, surfs, blended, loops)
+            row += "%14s" % ("%.3f ms" % (duration * 1000.0))
+            print (row)
+
+
+if __name__ == '__main__':
+    if len(sys.argv) > 1:
+        main(int(sys.argv[1]))
+    else:
+        main()
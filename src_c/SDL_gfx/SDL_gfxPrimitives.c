@@ -20,6 +20,12 @@ LGPL (c) A. Schiffler
 #define DEFAULT_ALPHA_PIXEL_ROUTINE
 #undef EXPERIMENTAL_ALPHA_PIXEL_ROUTINE
 
+#if defined(__SSE2__) || defined(_M_X64) || \
+	(defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SDL_GFX_SSE2
+#endif
+
 /* ---- Structures */
 
 /*!
@@ -542,6 +548,114 @@ int pixelColorNolock(SDL_Surface * dst, Sint16 x, Sint16 y, Uint32 color)
 }
 
 
+/*!
+\brief Global flag to blend 32-bpp runs one pixel at a time.
+
+Note: Lets benchmarks time the vector blend against the scalar one.
+*/
+static int gfxPrimitivesScalarBlend = 0;
+
+/*!
+\brief Selects the scalar or the vector blend of 32-bpp runs.
+
+\param scalar Nonzero to blend one pixel at a time, 0 for the vector blend when available.
+
+\returns Returns the previous setting.
+*/
+int gfxPrimitivesSetScalarBlend(int scalar)
+{
+	int previous = gfxPrimitivesScalarBlend;
+
+	gfxPrimitivesScalarBlend = (scalar != 0);
+	return (previous);
+}
+
+/*!
+\brief Internal function to blend a run of 32-bpp pixels with a color.
+
+Gives the same result as the per-pixel blending loop of the default alpha
+routine. With SSE2 and byte aligned channels four pixels are blended at once,
+unless gfxPrimitivesSetScalarBlend() selected the scalar blend.
+
+\param format The pixel format of the pixels.
+\param pixel The first pixel of the run.
+\param n The number of pixels in the run.
+\param color The mapped color value to blend with.
+\param alpha The alpha value of the blend.
+*/
+static void _blendSpan32(SDL_PixelFormat *format, Uint32 *pixel, int n, Uint32 color, Uint8 alpha)
+{
+	Uint32 Rmask, Gmask, Bmask, Amask;
+	Uint32 Rshift, Gshift, Bshift, Ashift;
+	Uint32 dR, dG, dB, A;
+	Uint32 R, G, B;
+	Uint32 *last = pixel + n;
+#ifdef SDL_GFX_SSE2
+	__m128i zero, src, wrap, mul, low, keep, bits, lo, hi;
+#endif
+
+	Rmask = format->Rmask;
+	Gmask = format->Gmask;
+	Bmask = format->Bmask;
+	Amask = format->Amask;
+
+	Rshift = format->Rshift;
+	Gshift = format->Gshift;
+	Bshift = format->Bshift;
+	Ashift = format->Ashift;
+
+	dR = (color & Rmask);
+	dG = (color & Gmask);
+	dB = (color & Bmask);
+
+	/*
+	* The alpha channel is blended against the already cleared
+	* destination, so it is the same for every pixel of the run
+	*/
+	A = 0;
+	if (Amask != 0) {
+		A = (((((color & Amask) >> Ashift) * alpha >> 8) << Ashift)) & Amask;
+	}
+
+#ifdef SDL_GFX_SSE2
+	if ((n >= 4) && !gfxPrimitivesScalarBlend &&
+		(Rmask == (Uint32) 0xff << Rshift) && !(Rshift & 7) &&
+		(Gmask == (Uint32) 0xff << Gshift) && !(Gshift & 7) &&
+		(Bmask == (Uint32) 0xff << Bshift) && !(Bshift & 7)) {
+		/*
+		* One 16 bit lane per channel. The difference is taken modulo
+		* 256 for the top byte, as the shifted 32 bit arithmetic does.
+		*/
+		zero = _mm_setzero_si128();
+		src = _mm_unpacklo_epi8(_mm_set1_epi32((int) color), zero);
+		wrap = _mm_set_epi16(0x00ff, -1, -1, -1, 0x00ff, -1, -1, -1);
+		mul = _mm_set1_epi16((short) alpha);
+		low = _mm_set1_epi16(0x00ff);
+		keep = _mm_set1_epi32((int) (Rmask | Gmask | Bmask));
+		bits = _mm_set1_epi32((int) A);
+		for (; last - pixel >= 4; pixel += 4) {
+			__m128i dst = _mm_loadu_si128((__m128i *) pixel);
+
+			lo = _mm_unpacklo_epi8(dst, zero);
+			hi = _mm_unpackhi_epi8(dst, zero);
+			lo = _mm_add_epi16(lo, _mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(_mm_sub_epi16(src, lo), wrap), mul), 8));
+			hi = _mm_add_epi16(hi, _mm_srli_epi16(_mm_mullo_epi16(_mm_and_si128(_mm_sub_epi16(src, hi), wrap), mul), 8));
+			lo = _mm_and_si128(lo, low);
+			hi = _mm_and_si128(hi, low);
+			dst = _mm_or_si128(_mm_and_si128(_mm_packus_epi16(lo, hi), keep), bits);
+			_mm_storeu_si128((__m128i *) pixel, dst);
+		}
+	}
+#endif
+
+	for (; pixel < last; pixel++) {
+		R = ((*pixel & Rmask) + ((((dR - (*pixel & Rmask)) >> Rshift) * alpha >> 8) << Rshift)) & Rmask;
+		G = ((*pixel & Gmask) + ((((dG - (*pixel & Gmask)) >> Gshift) * alpha >> 8) << Gshift)) & Gmask;
+		B = ((*pixel & Bmask) + ((((dB - (*pixel & Bmask)) >> Bshift) * alpha >> 8) << Bshift)) & Bmask;
+		*pixel = R | G | B | A;
+	}
+}
+
 /*!
 \brief Internal function to draw filled rectangle with alpha blending.
 
@@ -678,39 +792,11 @@ int _filledRectAlpha(SDL_Surface * dst, Sint16 x1, Sint16 y1, Sint16 x2, Sint16
 #ifdef DEFAULT_ALPHA_PIXEL_ROUTINE
 	case 4:
 		{			/* Probably :-) 32-bpp */
-			Uint32 *row, *pixel;
-			Uint32 dR, dG, dB, dA;
-
-			Rmask = format->Rmask;
-			Gmask = format->Gmask;
-			Bmask = format->Bmask;
-			Amask = format->Amask;
-
-			Rshift = format->Rshift;
-			Gshift = format->Gshift;
-			Bshift = format->Bshift;
-			Ashift = format->Ashift;
-
-			dR = (color & Rmask);
-			dG = (color & Gmask);
-			dB = (color & Bmask);
-			dA = (color & Amask);
+			Uint32 *row;
 
 			for (y = y1; y <= y2; y++) {
 				row = (Uint32 *) dst->pixels + y * dst->pitch / 4;
-				for (x = x1; x <= x2; x++) {
-					pixel = row + x;
-
-					R = ((*pixel & Rmask) + ((((dR - (*pixel & Rmask)) >> Rshift) * alpha >> 8) << Rshift)) & Rmask;
-					G = ((*pixel & Gmask) + ((((dG - (*pixel & Gmask)) >> Gshift) * alpha >> 8) << Gshift)) & Gmask;
-					B = ((*pixel & Bmask) + ((((dB - (*pixel & Bmask)) >> Bshift) * alpha >> 8) << Bshift)) & Bmask;
-					*pixel = R | G | B;
-					if (Amask!=0)
-					{
-						A = ((*pixel & Amask) + ((((dA - (*pixel & Amask)) >> Ashift) * alpha >> 8) << Ashift)) & Amask;
-						*pixel |= A;
-					}					
-				}
+				_blendSpan32(format, row + x1, x2 - x1 + 1, color, alpha);
 			}
 		}
 		break;
@@ -1307,6 +1393,106 @@ int hlineRGBA(SDL_Surface * dst, Sint16 x1, Sint16 x2, Sint16 y, Uint8 r, Uint8
 	return (hlineColor(dst, x1, x2, y, ((Uint32) r << 24) | ((Uint32) g << 16) | ((Uint32) b << 8) | (Uint32) a));
 }
 
+/*!
+\brief Internal function to map a color for the span routines.
+
+\param dst The surface the color is drawn on.
+\param color The color value to map (0xRRGGBBAA).
+
+\returns Returns the color mapped to the pixel format of the surface.
+*/
+static Uint32 _mapSpanColor(SDL_Surface * dst, Uint32 color)
+{
+	return (SDL_MapRGBA(dst->format, (color >> 24) & 0xff, (color >> 16) & 0xff, (color >> 8) & 0xff, color & 0xff));
+}
+
+/*!
+\brief Internal horizontal span drawing - no locking, clipping, mapped color.
+
+Used by the filled primitives, which lock the surface and map the color once
+and then draw all of their spans with it. Draws the same pixels as hlineColor.
+
+\param dst The surface to draw on.
+\param x1 X coordinate of the first point (i.e. left) of the span.
+\param x2 X coordinate of the second point (i.e. right) of the span.
+\param y Y coordinate of the points of the span.
+\param color The mapped color value of the span.
+\param alpha The alpha value of the span, 255 draws without blending.
+
+\returns Returns 0 on success, -1 on failure.
+*/
+static int _hlineColorNolock(SDL_Surface * dst, Sint16 x1, Sint16 x2, Sint16 y, Uint32 color, Uint8 alpha)
+{
+	Sint16 xtmp;
+	Uint8 *pixel, *pixellast;
+	Uint8 color3[3];
+
+	/*
+	* Swap x1, x2 if required to ensure x1<=x2
+	*/
+	if (x1 > x2) {
+		xtmp = x1;
+		x1 = x2;
+		x2 = xtmp;
+	}
+
+	/*
+	* Clip against the clipping rectangle
+	*/
+	if ((y < clip_ymin(dst)) || (y > clip_ymax(dst))) {
+		return (0);
+	}
+	if ((x2 < clip_xmin(dst)) || (x1 > clip_xmax(dst))) {
+		return (0);
+	}
+	if (x1 < clip_xmin(dst)) {
+		x1 = clip_xmin(dst);
+	}
+	if (x2 > clip_xmax(dst)) {
+		x2 = clip_xmax(dst);
+	}
+
+	if (alpha != 255) {
+		return (_filledRectAlpha(dst, x1, y, x2, y, color, alpha));
+	}
+
+	pixel = ((Uint8 *) dst->pixels) + dst->format->BytesPerPixel * (int) x1 + dst->pitch * (int) y;
+	switch (dst->format->BytesPerPixel) {
+	case 1:
+		memset(pixel, color, x2 - x1 + 1);
+		break;
+	case 2:
+		pixellast = pixel + 2 * (x2 - x1);
+		for (; pixel <= pixellast; pixel += 2) {
+			*(Uint16 *) pixel = color;
+		}
+		break;
+	case 3:
+		pixellast = pixel + 3 * (x2 - x1);
+		if (SDL_BYTEORDER == SDL_BIG_ENDIAN) {
+			color3[0] = (color >> 16) & 0xff;
+			color3[1] = (color >> 8) & 0xff;
+			color3[2] = color & 0xff;
+		} else {
+			color3[0] = color & 0xff;
+			color3[1] = (color >> 8) & 0xff;
+			color3[2] = (color >> 16) & 0xff;
+		}
+		for (; pixel <= pixellast; pixel += 3) {
+			memcpy(pixel, color3, 3);
+		}
+		break;
+	default:		/* case 4 */
+		pixellast = pixel + 4 * (x2 - x1);
+		for (; pixel <= pixellast; pixel += 4) {
+			*(Uint32 *) pixel = color;
+		}
+		break;
+	}
+
+	return (0);
+}
+
 /*!
 \brief Draw vertical line with blending.
 
@@ -3486,6 +3672,8 @@ int filledCircleColor(SDL_Surface * dst, Sint16 x, Sint16 y, Sint16 rad, Uint32
 {
 	Sint16 left, right, top, bottom;
 	int result;
+	Uint32 mcolor;
+	Uint8 alpha;
 	Sint16 x1, y1, x2, y2;
 	Sint16 cx = 0;
 	Sint16 cy = rad;
@@ -3543,6 +3731,17 @@ int filledCircleColor(SDL_Surface * dst, Sint16 x, Sint16 y, Sint16 rad, Uint32
 		return(0);
 	} 
 
+	/*
+	* Setup color and lock the surface once for all spans
+	*/
+	alpha = color & 0x000000ff;
+	mcolor = _mapSpanColor(dst, color);
+	if (SDL_MUSTLOCK(dst)) {
+		if (SDL_LockSurface(dst) < 0) {
+			return (-1);
+		}
+	}
+
 	/*
 	* Draw 
 	*/
@@ -3556,10 +3755,10 @@ int filledCircleColor(SDL_Surface * dst, Sint16 x, Sint16 y, Sint16 rad, Uint32
 			if (cy > 0) {
 				ypcy = y + cy;
 				ymcy = y - cy;
-				result |= hlineColor(dst, xmcx, xpcx, ypcy, color);
-				result |= hlineColor(dst, xmcx, xpcx, ymcy, color);
+				result |= _hlineColorNolock(dst, xmcx, xpcx, ypcy, mcolor, alpha);
+				result |= _hlineColorNolock(dst, xmcx, xpcx, ymcy, mcolor, alpha);
 			} else {
-				result |= hlineColor(dst, xmcx, xpcx, y, color);
+				result |= _hlineColorNolock(dst, xmcx, xpcx, y, mcolor, alpha);
 			}
 			ocy = cy;
 		}
@@ -3568,10 +3767,10 @@ int filledCircleColor(SDL_Surface * dst, Sint16 x, Sint16 y, Sint16 rad, Uint32
 				if (cx > 0) {
 					ypcx = y + cx;
 					ymcx = y - cx;
-					result |= hlineColor(dst, xmcy, xpcy, ymcx, color);
-					result |= hlineColor(dst, xmcy, xpcy, ypcx, color);
+					result |= _hlineColorNolock(dst, xmcy, xpcy, ymcx, mcolor, alpha);
+					result |= _hlineColorNolock(dst, xmcy, xpcy, ypcx, mcolor, alpha);
 				} else {
-					result |= hlineColor(dst, xmcy, xpcy, y, color);
+					result |= _hlineColorNolock(dst, xmcy, xpcy, y, mcolor, alpha);
 				}
 			}
 			ocx = cx;
@@ -3592,6 +3791,13 @@ int filledCircleColor(SDL_Surface * dst, Sint16 x, Sint16 y, Sint16 rad, Uint32
 		cx++;
 	} while (cx <= cy);
 
+	/*
+	* Unlock the surface 
+	*/
+	if (SDL_MUSTLOCK(dst)) {
+		SDL_UnlockSurface(dst);
+	}
+
 	return (result);
 }
 
@@ -4287,6 +4493,8 @@ int filledEllipseColor(SDL_Surface * dst, Sint16 x, Sint16 y, Sint16 rx, Sint16
 {
 	Sint16 left, right, top, bottom;
 	int result;
+	Uint32 mcolor;
+	Uint8 alpha;
 	Sint16 x1, y1, x2, y2;
 	int ix, iy;
 	int h, i, j, k;
@@ -4348,6 +4556,17 @@ int filledEllipseColor(SDL_Surface * dst, Sint16 x, Sint16 y, Sint16 rx, Sint16
 		return(0);
 	} 
 
+	/*
+	* Setup color and lock the surface once for all spans
+	*/
+	alpha = color & 0x000000ff;
+	mcolor = _mapSpanColor(dst, color);
+	if (SDL_MUSTLOCK(dst)) {
+		if (SDL_LockSurface(dst) < 0) {
+			return (-1);
+		}
+	}
+
 	/*
 	* Init vars 
 	*/
@@ -4371,10 +4590,10 @@ int filledEllipseColor(SDL_Surface * dst, Sint16 x, Sint16 y, Sint16 rx, Sint16
 				xph = x + h;
 				xmh = x - h;
 				if (k > 0) {
-					result |= hlineColor(dst, xmh, xph, y + k, color);
-					result |= hlineColor(dst, xmh, xph, y - k, color);
+					result |= _hlineColorNolock(dst, xmh, xph, y + k, mcolor, alpha);
+					result |= _hlineColorNolock(dst, xmh, xph, y - k, mcolor, alpha);
 				} else {
-					result |= hlineColor(dst, xmh, xph, y, color);
+					result |= _hlineColorNolock(dst, xmh, xph, y, mcolor, alpha);
 				}
 				ok = k;
 			}
@@ -4382,10 +4601,10 @@ int filledEllipseColor(SDL_Surface * dst, Sint16 x, Sint16 y, Sint16 rx, Sint16
 				xmi = x - i;
 				xpi = x + i;
 				if (j > 0) {
-					result |= hlineColor(dst, xmi, xpi, y + j, color);
-					result |= hlineColor(dst, xmi, xpi, y - j, color);
+					result |= _hlineColorNolock(dst, xmi, xpi, y + j, mcolor, alpha);
+					result |= _hlineColorNolock(dst, xmi, xpi, y - j, mcolor, alpha);
 				} else {
-					result |= hlineColor(dst, xmi, xpi, y, color);
+					result |= _hlineColorNolock(dst, xmi, xpi, y, mcolor, alpha);
 				}
 				oj = j;
 			}
@@ -4408,10 +4627,10 @@ int filledEllipseColor(SDL_Surface * dst, Sint16 x, Sint16 y, Sint16 rx, Sint16
 				xmj = x - j;
 				xpj = x + j;
 				if (i > 0) {
-					result |= hlineColor(dst, xmj, xpj, y + i, color);
-					result |= hlineColor(dst, xmj, xpj, y - i, color);
+					result |= _hlineColorNolock(dst, xmj, xpj, y + i, mcolor, alpha);
+					result |= _hlineColorNolock(dst, xmj, xpj, y - i, mcolor, alpha);
 				} else {
-					result |= hlineColor(dst, xmj, xpj, y, color);
+					result |= _hlineColorNolock(dst, xmj, xpj, y, mcolor, alpha);
 				}
 				oi = i;
 			}
@@ -4419,10 +4638,10 @@ int filledEllipseColor(SDL_Surface * dst, Sint16 x, Sint16 y, Sint16 rx, Sint16
 				xmk = x - k;
 				xpk = x + k;
 				if (h > 0) {
-					result |= hlineColor(dst, xmk, xpk, y + h, color);
-					result |= hlineColor(dst, xmk, xpk, y - h, color);
+					result |= _hlineColorNolock(dst, xmk, xpk, y + h, mcolor, alpha);
+					result |= _hlineColorNolock(dst, xmk, xpk, y - h, mcolor, alpha);
 				} else {
-					result |= hlineColor(dst, xmk, xpk, y, color);
+					result |= _hlineColorNolock(dst, xmk, xpk, y, mcolor, alpha);
 				}
 				oh = h;
 			}
@@ -4433,6 +4652,13 @@ int filledEllipseColor(SDL_Surface * dst, Sint16 x, Sint16 y, Sint16 rx, Sint16
 		} while (i > h);
 	}
 
+	/*
+	* Unlock the surface 
+	*/
+	if (SDL_MUSTLOCK(dst)) {
+		SDL_UnlockSurface(dst);
+	}
+
 	return (result);
 }
 
@@ -4488,6 +4714,8 @@ int _pieColor(SDL_Surface * dst, Sint16 x, Sint16 y, Sint16 rad, Sint16 start, S
 	double dr;
 	int numpoints, i;
 	Sint16 *vx, *vy;
+	int *polyInts = NULL;
+	int polyAllocated = 0;
 
 	/*
 	* Check visibility of clipping rectangle
@@ -4603,7 +4831,8 @@ int _pieColor(SDL_Surface * dst, Sint16 x, Sint16 y, Sint16 rad, Sint16 start, S
 
 		/* Draw */
 		if (filled) {
-			result = filledPolygonColor(dst, vx, vy, numpoints, color);
+			result = filledPolygonColorMT(dst, vx, vy, numpoints, color, &polyInts, &polyAllocated);
+			free(polyInts);
 		} else {
 			result = polygonColor(dst, vx, vy, numpoints, color);
 		}
@@ -4854,6 +5083,9 @@ int filledTrigonColor(SDL_Surface * dst, Sint16 x1, Sint16 y1, Sint16 x2, Sint16
 {
 	Sint16 vx[3]; 
 	Sint16 vy[3];
+	int *polyInts = NULL;
+	int polyAllocated = 0;
+	int result;
 
 	vx[0]=x1;
 	vx[1]=x2;
@@ -4862,7 +5094,10 @@ int filledTrigonColor(SDL_Surface * dst, Sint16 x1, Sint16 y1, Sint16 x2, Sint16
 	vy[1]=y2;
 	vy[2]=y3;
 
-	return(filledPolygonColor(dst,vx,vy,3,color));
+	result = filledPolygonColorMT(dst,vx,vy,3,color,&polyInts,&polyAllocated);
+	free(polyInts);
+
+	return(result);
 }
 
 /*!
@@ -4887,17 +5122,8 @@ Note: Creates vertex array and uses aapolygon routine to render.
 int filledTrigonRGBA(SDL_Surface * dst, Sint16 x1, Sint16 y1, Sint16 x2, Sint16 y2, Sint16 x3, Sint16 y3,
 					 Uint8 r, Uint8 g, Uint8 b, Uint8 a)
 {
-	Sint16 vx[3]; 
-	Sint16 vy[3];
-
-	vx[0]=x1;
-	vx[1]=x2;
-	vx[2]=x3;
-	vy[0]=y1;
-	vy[1]=y2;
-	vy[2]=y3;
-
-	return(filledPolygonRGBA(dst,vx,vy,3,r,g,b,a));
+	return (filledTrigonColor(dst, x1, y1, x2, y2, x3, y3, 
+		((Uint32) r << 24) | ((Uint32) g << 16) | ((Uint32) b << 8) | (Uint32) a));
 }
 
 /* ---- Polygon */
@@ -5125,6 +5351,8 @@ Note: The last two parameters are optional; but are required for multithreaded o
 int filledPolygonColorMT(SDL_Surface * dst, const Sint16 * vx, const Sint16 * vy, int n, Uint32 color, int **polyInts, int *polyAllocated)
 {
 	int result;
+	Uint32 mcolor;
+	Uint8 alpha;
 	int i;
 	int y, xa, xb;
 	int miny, maxy;
@@ -5233,6 +5461,17 @@ int filledPolygonColorMT(SDL_Surface * dst, const Sint16 * vx, const Sint16 * vy
 		}
 	}
 
+	/*
+	* Setup color and lock the surface once for all spans
+	*/
+	alpha = color & 0x000000ff;
+	mcolor = _mapSpanColor(dst, color);
+	if (SDL_MUSTLOCK(dst)) {
+		if (SDL_LockSurface(dst) < 0) {
+			return (-1);
+		}
+	}
+
 	/*
 	* Draw, scanning y 
 	*/
@@ -5272,10 +5511,17 @@ int filledPolygonColorMT(SDL_Surface * dst, const Sint16 * vx, const Sint16 * vy
 			xa = (xa >> 16) + ((xa & 32768) >> 15);
 			xb = gfxPrimitivesPolyInts[i+1] - 1;
 			xb = (xb >> 16) + ((xb & 32768) >> 15);
-			result |= hlineColor(dst, xa, xb, y, color);
+			result |= _hlineColorNolock(dst, xa, xb, y, mcolor, alpha);
 		}
 	}
 
+	/*
+	* Unlock the surface 
+	*/
+	if (SDL_MUSTLOCK(dst)) {
+		SDL_UnlockSurface(dst);
+	}
+
 	return (result);
 }
 
@@ -208,6 +208,10 @@ extern "C" {
 	SDL_GFXPRIMITIVES_SCOPE int bezierRGBA(SDL_Surface * dst, const Sint16 * vx, const Sint16 * vy,
 		int n, int s, Uint8 r, Uint8 g, Uint8 b, Uint8 a);
 
+	/* Blending */
+
+	SDL_GFXPRIMITIVES_SCOPE int gfxPrimitivesSetScalarBlend(int scalar);
+
 	/* Characters/Strings */
 
 	SDL_GFXPRIMITIVES_SCOPE void gfxPrimitivesSetFont(const void *fontdata, Uint32 cw, Uint32 ch);
@@ -552,6 +552,7 @@ typedef struct {
     PyObject *weakreflist;
     PyObject *locklist;
     PyObject *dependency;
+    int subsurfaces;                       /*subsurfaces of this one alive*/
 } pgSurfaceObject;
 #define pgSurface_AsSurface(x) (((pgSurfaceObject*)x)->surf)
 #ifndef PYGAMEAPI_SURFACE_INTERNAL
@@ -640,15 +641,23 @@ typedef struct
 #define PYGAMEAPI_EVENT_FIRSTSLOT                                       \
     (PYGAMEAPI_SURFLOCK_FIRSTSLOT + PYGAMEAPI_SURFLOCK_NUMSLOTS)
 #if IS_SDLv1
-#define PYGAMEAPI_EVENT_NUMSLOTS 4
+#define PYGAMEAPI_EVENT_NUMSLOTS 7
 #else /* IS_SDLv2 */
-#define PYGAMEAPI_EVENT_NUMSLOTS 6
+#define PYGAMEAPI_EVENT_NUMSLOTS 9
 #endif /* IS_SDLv2 */
 
+/* A timer pump returns this when it has no timers waiting. */
+#define PG_TIMER_IDLE ((Uint32)-1)
+
+/* Events from the queue keep the SDL event and build their dict the
+ * first time the attributes are used, so dict may be NULL. The event
+ * module functions fill it in as needed.
+ */
 typedef struct {
     PyObject_HEAD
     int type;
     PyObject* dict;
+    SDL_Event event;
 } pgEventObject;
 
 #ifndef PYGAMEAPI_EVENT_INTERNAL
@@ -669,6 +678,25 @@ typedef struct {
 #define pg_GetKeyRepeat                                 \
     (*(void (*)(int*, int*))PyGAME_C_API[PYGAMEAPI_EVENT_FIRSTSLOT + 5])
 #endif /* IS_SDLv2 */
+/* Posts a copy of an SDL event from any thread, without the GIL. Returns
+ * 0 when the event was dropped because too many are waiting.
+ */
+#define pg_PostEventThreaded                                            \
+    (*(int (*)(SDL_Event*))                                             \
+     PyGAME_C_API[PYGAMEAPI_EVENT_FIRSTSLOT + PYGAMEAPI_EVENT_NUMSLOTS - 1])
+/* Sets the function that runs the timers of the time module each time
+ * events are pumped. It returns the milliseconds until it should run
+ * again, so event.wait() wakes up for the timers.
+ */
+#define pg_SetTimerPump                                                 \
+    (*(void (*)(Uint32 (*)(void)))                                      \
+     PyGAME_C_API[PYGAMEAPI_EVENT_FIRSTSLOT + PYGAMEAPI_EVENT_NUMSLOTS - 2])
+/* Pumps events like event.pump(): timers, events posted from threads and
+ * a replayed log go on the queue, then SDL's own. Needs the GIL.
+ */
+#define pg_PumpEvents                                                   \
+    (*(void (*)(void))                                                  \
+     PyGAME_C_API[PYGAMEAPI_EVENT_FIRSTSLOT + PYGAMEAPI_EVENT_NUMSLOTS - 3])
 #define import_pygame_event() IMPORT_PYGAME_MODULE(event, EVENT)
 #endif
 
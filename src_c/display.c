@@ -149,11 +149,456 @@ display_resource_end:
 }
 #endif
 
+#if IS_SDLv2
+/*the present thread. While it runs, the display Surface is a back buffer
+ *with the format of the window surface. flip() and update() wait until
+ *the frame before is presented, copy the back buffer into the window
+ *surface and leave the slow SDL_UpdateWindowSurface() to the thread, so
+ *the game draws the next frame meanwhile.
+ */
+static struct {
+    SDL_Thread* thread;
+    SDL_mutex* lock;
+    SDL_cond* cond;
+    SDL_Window* win;
+    SDL_Surface* back;
+    SDL_Rect* rects;            /* NULL for the whole window */
+    int nrects, rects_size;
+    int pending;                /* a frame waits for the thread */
+    int quit;
+    int failed;                 /* the last present failed with error */
+    char error[256];
+} present;
+
+static int
+present_thread (void* data)
+{
+    int status;
+
+    SDL_LockMutex (present.lock);
+    for (;;)
+    {
+        while (!present.pending && !present.quit)
+            SDL_CondWait (present.cond, present.lock);
+        if (!present.pending)
+            break;
+
+        /*the rects do not change while the frame is pending*/
+        SDL_UnlockMutex (present.lock);
+        if (present.rects)
+            status = SDL_UpdateWindowSurfaceRects (present.win,
+                                                   present.rects,
+                                                   present.nrects);
+        else
+            status = SDL_UpdateWindowSurface (present.win);
+        SDL_LockMutex (present.lock);
+
+        if (status < 0)
+        {
+            /*the SDL error is only set for this thread*/
+            present.failed = 1;
+            strncpy (present.error, SDL_GetError (),
+                     sizeof (present.error) - 1);
+        }
+        present.pending = 0;
+        SDL_CondBroadcast (present.cond);
+    }
+    SDL_UnlockMutex (present.lock);
+    return 0;
+}
+
+/*hands a frame to the present thread, rects NULL for all of it*/
+static PyObject*
+present_frame (SDL_Rect* rects, int count)
+{
+    SDL_Surface* window_surf;
+    SDL_Rect src, dst;
+    const char* error = NULL;
+    int i;
+
+    Py_BEGIN_ALLOW_THREADS;
+    SDL_LockMutex (present.lock);
+    /*the fence, the window surface is not touched while it is shown*/
+    while (present.pending)
+        SDL_CondWait (present.cond, present.lock);
+
+    window_surf = SDL_GetWindowSurface (present.win);
+    if (present.failed)
+    {
+        present.failed = 0;
+        error = present.error;
+    }
+    else if (!window_surf)
+        error = SDL_GetError ();
+    else if (count > present.rects_size)
+    {
+        SDL_Rect* more = realloc (present.rects, count * sizeof (SDL_Rect));
+        if (!more)
+            error = "out of memory";
+        else
+        {
+            present.rects = more;
+            present.rects_size = count;
+        }
+    }
+
+    if (!error)
+    {
+        if (rects)
+        {
+            for (i = 0; i < count; ++i)
+            {
+                src = dst = rects[i];
+                SDL_BlitSurface (present.back, &src, window_surf, &dst);
+                present.rects[i] = rects[i];
+            }
+            present.nrects = count;
+        }
+        else
+        {
+            SDL_BlitSurface (present.back, NULL, window_surf, NULL);
+            present.nrects = 0;
+        }
+        present.pending = 1;
+        SDL_CondBroadcast (present.cond);
+    }
+    SDL_UnlockMutex (present.lock);
+    Py_END_ALLOW_THREADS;
+
+    if (error)
+        return RAISE (pgExc_SDLError, error);
+    Py_RETURN_NONE;
+}
+
+/*the pixels of the display Surface are used by subsurfaces, locks or
+ *exported views, which would go on using them after a swap
+ */
+static int
+present_surface_busy (PyObject* surface)
+{
+    pgSurfaceObject* obj = (pgSurfaceObject*) surface;
+
+    return obj->subsurfaces > 0 ||
+        (obj->locklist && PyList_Size (obj->locklist) > 0) ||
+        (obj->surf && obj->surf->locked);
+}
+
+/*stops the present thread, the display Surface is the window surface
+ *again with what was drawn since the last flip. When set_mode() or quit()
+ *stop it while subsurfaces or views still use the back buffer, the display
+ *Surface keeps the back buffer alive instead of freeing it.
+ */
+static void
+present_stop (void)
+{
+    PyObject* surface = pg_GetDefaultWindowSurface ();
+    PyObject* backobj;
+    SDL_Surface* window_surf;
+
+    if (!present.thread)
+        return;
+
+    SDL_LockMutex (present.lock);
+    present.quit = 1;
+    SDL_CondBroadcast (present.cond);
+    SDL_UnlockMutex (present.lock);
+    Py_BEGIN_ALLOW_THREADS;
+    SDL_WaitThread (present.thread, NULL);
+    Py_END_ALLOW_THREADS;
+    present.thread = NULL;
+
+    window_surf = SDL_GetWindowSurface (present.win);
+    if (window_surf)
+        SDL_BlitSurface (present.back, NULL, window_surf, NULL);
+    if (surface && pgSurface_AsSurface (surface) == present.back)
+    {
+        pgSurface_AsSurface (surface) = window_surf;
+        if (present_surface_busy (surface))
+        {
+            backobj = pgSurface_New (present.back);
+            if (backobj)
+            {
+                ((pgSurfaceObject*) backobj)->dependency =
+                    ((pgSurfaceObject*) surface)->dependency;
+                ((pgSurfaceObject*) surface)->dependency = backobj;
+            }
+            else
+                PyErr_Clear ();
+            present.back = NULL;
+        }
+    }
+    if (present.back)
+        SDL_FreeSurface (present.back);
+    present.back = NULL;
+    free (present.rects);
+    present.rects = NULL;
+    present.rects_size = 0;
+    present.win = NULL;
+}
+
+static PyObject*
+pg_set_present_thread (PyObject* self, PyObject* arg)
+{
+    SDL_Window* win = pg_GetDefaultWindow ();
+    PyObject* surface = pg_GetDefaultWindowSurface ();
+    SDL_Surface* window_surf;
+    const char* driver;
+    int enable;
+
+    if (!PyArg_ParseTuple (arg, "i", &enable))
+        return NULL;
+
+    VIDEO_INIT_CHECK ();
+
+    if (!enable)
+    {
+        if (present.thread && surface && present_surface_busy (surface))
+            return RAISE (pgExc_SDLError,
+                          "Cannot stop the present thread while the display "
+                          "Surface is locked or has subsurfaces");
+        present_stop ();
+        Py_RETURN_FALSE;
+    }
+    if (present.thread)
+        Py_RETURN_TRUE;
+
+    /*cocoa windows are only updated from the main thread*/
+    driver = SDL_GetCurrentVideoDriver ();
+    if (driver && !strcmp (driver, "cocoa"))
+        Py_RETURN_FALSE;
+
+    if (!win || !surface)
+        return RAISE (pgExc_SDLError, "Display mode not set");
+    if (SDL_GetWindowFlags (win) & SDL_WINDOW_OPENGL)
+        return RAISE (pgExc_SDLError,
+                      "Cannot use a present thread with an OPENGL display");
+    if (present_surface_busy (surface))
+        return RAISE (pgExc_SDLError,
+                      "Cannot start the present thread while the display "
+                      "Surface is locked or has subsurfaces");
+    window_surf = SDL_GetWindowSurface (win);
+    if (!window_surf)
+        return RAISE (pgExc_SDLError, SDL_GetError ());
+
+    if (!present.lock)
+    {
+        present.lock = SDL_CreateMutex ();
+        present.cond = SDL_CreateCond ();
+        if (!present.lock || !present.cond)
+            return RAISE (pgExc_SDLError, SDL_GetError ());
+    }
+
+    /*a copy of the screen the game goes on drawing into*/
+    present.back = SDL_ConvertSurface (window_surf, window_surf->format, 0);
+    if (!present.back)
+        return RAISE (pgExc_SDLError, SDL_GetError ());
+    SDL_SetSurfaceBlendMode (present.back, SDL_BLENDMODE_NONE);
+
+    present.win = win;
+    present.pending = 0;
+    present.quit = 0;
+    present.failed = 0;
+    present.thread = SDL_CreateThread (present_thread, "pygame present",
+                                       NULL);
+    if (!present.thread)
+    {
+        SDL_FreeSurface (present.back);
+        present.back = NULL;
+        return RAISE (pgExc_SDLError, SDL_GetError ());
+    }
+    pgSurface_AsSurface (surface) = present.back;
+    Py_RETURN_TRUE;
+}
+#else /* IS_SDLv1 */
+static PyObject*
+pg_set_present_thread (PyObject* self, PyObject* arg)
+{
+    int enable;
+
+    if (!PyArg_ParseTuple (arg, "i", &enable))
+        return NULL;
+
+    /*SDL 1.2 can only update the screen from the main thread*/
+    Py_RETURN_FALSE;
+}
+#endif /* IS_SDLv1 */
+
+/*the capture ring. Every every_n-th flip() or update() copies the display
+ *Surface into the next of a list of preallocated Surfaces, so frames can
+ *be recorded without a display. get_captured() hands out views of the
+ *ring Surfaces, not copies.
+ */
+static struct {
+    PyObject* frames;           /* list of Surfaces, NULL when stopped */
+    int every_n;
+    int skip;                   /* flips left until the next capture */
+    int next;                   /* ring slot written next */
+    int count;                  /* frames in the ring */
+} capture;
+
+static SDL_Surface*
+capture_source (void)
+{
+#if IS_SDLv2
+    PyObject* surface = pg_GetDefaultWindowSurface ();
+#else /* IS_SDLv1 */
+    PyObject* surface = pgDisplaySurfaceObject;
+#endif /* IS_SDLv1 */
+
+    return surface ? pgSurface_AsSurface (surface) : NULL;
+}
+
+static void
+capture_stop (void)
+{
+    Py_XDECREF (capture.frames);
+    capture.frames = NULL;
+    capture.next = 0;
+    capture.count = 0;
+}
+
+/*copies the display Surface into the ring, -1 with an exception set
+ *when that fails
+ */
+static int
+capture_frame (void)
+{
+    SDL_Surface* src = capture_source ();
+    SDL_Surface* dst;
+    int y, w, h, size;
+
+    if (!capture.frames || !src)
+        return 0;
+    if (--capture.skip > 0)
+        return 0;
+    capture.skip = capture.every_n;
+
+    dst = pgSurface_AsSurface (PyList_GET_ITEM (capture.frames,
+                                                capture.next));
+    /*a resized window only keeps what fits the ring*/
+    w = MIN (src->w, dst->w);
+    h = MIN (src->h, dst->h);
+    size = w * dst->format->BytesPerPixel;
+    if (SDL_LockSurface (src) < 0)
+    {
+        PyErr_SetString (pgExc_SDLError, SDL_GetError ());
+        return -1;
+    }
+    for (y = 0; y < h; ++y)
+        memcpy ((Uint8*)dst->pixels + y * dst->pitch,
+                (Uint8*)src->pixels + y * src->pitch, size);
+    SDL_UnlockSurface (src);
+
+    capture.next = (capture.next + 1) % PyList_GET_SIZE (capture.frames);
+    if (capture.count < PyList_GET_SIZE (capture.frames))
+        ++capture.count;
+    return 0;
+}
+
+static PyObject*
+pg_start_capture (PyObject* self, PyObject* arg, PyObject* kwds)
+{
+    static char* kwids[] = {"ring_frames", "every_n", NULL};
+    SDL_Surface* src;
+    SDL_Surface* surf;
+    PyObject* frames;
+    PyObject* obj;
+    int ring_frames, every_n = 1;
+    int i;
+
+    if (!PyArg_ParseTupleAndKeywords (arg, kwds, "i|i", kwids,
+                                      &ring_frames, &every_n))
+        return NULL;
+    if (ring_frames < 0)
+        return RAISE (PyExc_ValueError, "ring_frames cannot be negative");
+    if (every_n < 1)
+        return RAISE (PyExc_ValueError, "every_n must be at least 1");
+
+    VIDEO_INIT_CHECK ();
+
+    capture_stop ();
+    if (!ring_frames)
+        Py_RETURN_NONE;
+
+    src = capture_source ();
+    if (!src)
+        return RAISE (pgExc_SDLError, "Display mode not set");
+#if IS_SDLv2
+    if (SDL_GetWindowFlags (pg_GetDefaultWindow ()) & SDL_WINDOW_OPENGL)
+#else /* IS_SDLv1 */
+    if (src->flags & SDL_OPENGL)
+#endif /* IS_SDLv1 */
+        return RAISE (pgExc_SDLError, "Cannot capture an OPENGL display");
+
+    frames = PyList_New (ring_frames);
+    if (!frames)
+        return NULL;
+    for (i = 0; i < ring_frames; ++i)
+    {
+        surf = SDL_CreateRGBSurface (0, src->w, src->h,
+                                     src->format->BitsPerPixel,
+                                     src->format->Rmask, src->format->Gmask,
+                                     src->format->Bmask, src->format->Amask);
+        if (!surf)
+        {
+            Py_DECREF (frames);
+            return RAISE (pgExc_SDLError, SDL_GetError ());
+        }
+        obj = pgSurface_New (surf);
+        if (!obj)
+        {
+            SDL_FreeSurface (surf);
+            Py_DECREF (frames);
+            return NULL;
+        }
+        PyList_SET_ITEM (frames, i, obj);
+    }
+
+    capture.frames = frames;
+    capture.every_n = every_n;
+    capture.skip = 1;
+    Py_RETURN_NONE;
+}
+
+static PyObject*
+pg_get_captured (PyObject* self)
+{
+    PyObject* list;
+    PyObject* view;
+    Py_ssize_t size;
+    int i;
+
+    if (!capture.frames)
+        return PyList_New (0);
+
+    list = PyList_New (capture.count);
+    if (!list)
+        return NULL;
+    /*oldest first, the frame written next is the oldest once full*/
+    size = PyList_GET_SIZE (capture.frames);
+    for (i = 0; i < capture.count; ++i)
+    {
+        view = PyObject_CallMethod (
+            PyList_GET_ITEM (capture.frames,
+                             (capture.next - capture.count + i + size) % size),
+            "get_view", "s", "2");
+        if (!view)
+        {
+            Py_DECREF (list);
+            return NULL;
+        }
+        PyList_SET_ITEM (list, i, view);
+    }
+    return list;
+}
+
 /* init routines */
 #if IS_SDLv2
 static void
 pg_display_autoquit (void)
 {
+    present_stop ();
+    capture_stop ();
     if (pg_GetDefaultWindowSurface ()) {
         _DisplayState* state = DISPLAY_STATE;
 
@@ -178,6 +623,7 @@ pg_display_autoquit (void)
 static void
 pg_display_autoquit (void)
 {
+    capture_stop ();
     if (pgDisplaySurfaceObject) {
         pgSurface_AsSurface(pgDisplaySurfaceObject) = NULL;
         Py_DECREF(pgDisplaySurfaceObject);
@@ -556,6 +1002,10 @@ pg_set_mode (PyObject* self, PyObject* arg)
     if (w < 0 || h < 0)
         return RAISE (pgExc_SDLError, "Cannot set negative sized display mode");
 
+    /*the new window surface is only taken after the thread stopped*/
+    present_stop ();
+    capture_stop ();
+
     if (w == 0 || h == 0)
     {
         SDL_version versioninfo;
@@ -714,6 +1164,10 @@ pg_flip (PyObject* self)
 
     if (!win)
         return RAISE (pgExc_SDLError, "Display mode not set");
+    if (capture_frame ())
+        return NULL;
+    if (present.thread)
+        return present_frame (NULL, 0);
 
     Py_BEGIN_ALLOW_THREADS;
     if (SDL_GetWindowFlags(win) & SDL_WINDOW_OPENGL)
@@ -745,6 +1199,8 @@ pg_set_mode (PyObject* self, PyObject* arg)
     if (w < 0 || h < 0)
         return RAISE (pgExc_SDLError, "Cannot set negative sized display mode");
 
+    capture_stop ();
+
     if (w == 0 || h == 0)
     {
         SDL_version versioninfo;
@@ -891,6 +1347,8 @@ pg_flip (PyObject* self)
     screen = SDL_GetVideoSurface();
     if (!screen)
         return RAISE (pgExc_SDLError, "Display mode not set");
+    if (capture_frame ())
+        return NULL;
 
     Py_BEGIN_ALLOW_THREADS;
     if (screen->flags & SDL_OPENGL)
@@ -952,10 +1410,14 @@ pg_update (PyObject* self, PyObject* arg)
     if (screen->flags & SDL_OPENGL)
         return RAISE(pgExc_SDLError, "Cannot update an OPENGL display");
 #endif /* IS_SDLv1 */
+    if (capture_frame ())
+        return NULL;
 
     /*determine type of argument we got*/
     if (PyTuple_Size (arg) == 0) {
 #if IS_SDLv2
+        if (present.thread)
+            return present_frame (NULL, 0);
         SDL_UpdateWindowSurface(win);
 
         Py_RETURN_NONE;
@@ -983,8 +1445,11 @@ pg_update (PyObject* self, PyObject* arg)
 #if IS_SDLv2
         SDL_Rect sdlr;
 
-        if (pg_screencroprect(gr, wide, high, &sdlr))
-            SDL_UpdateWindowSurfaceRects(win, &sdlr, 1);
+        if (!pg_screencroprect(gr, wide, high, &sdlr))
+            Py_RETURN_NONE;
+        if (present.thread)
+            return present_frame (&sdlr, 1);
+        SDL_UpdateWindowSurfaceRects(win, &sdlr, 1);
 #else /* IS_SDLv1 */
         SDL_Rect sdlr;
 
@@ -1044,6 +1509,12 @@ pg_update (PyObject* self, PyObject* arg)
             SDL_UpdateRects(screen, count, rects);
             Py_END_ALLOW_THREADS;
 #else /* IS_SDLv2 */
+            if (present.thread)
+            {
+                obj = present_frame (rects, count);
+                PyMem_Free ((char*)rects);
+                return obj;
+            }
             Py_BEGIN_ALLOW_THREADS;
             SDL_UpdateWindowSurfaceRects(win, rects, count);
             Py_END_ALLOW_THREADS;
@@ -1560,6 +2031,12 @@ static PyMethodDef _pg_display_methods[] =
 
     { "flip", (PyCFunction) pg_flip, METH_NOARGS, DOC_PYGAMEDISPLAYFLIP },
     { "update", pg_update, METH_VARARGS, DOC_PYGAMEDISPLAYUPDATE },
+    { "set_present_thread", pg_set_present_thread, METH_VARARGS,
+      DOC_PYGAMEDISPLAYSETPRESENTTHREAD },
+    { "start_capture", (PyCFunction) pg_start_capture,
+      METH_VARARGS | METH_KEYWORDS, DOC_PYGAMEDISPLAYSTARTCAPTURE },
+    { "get_captured", (PyCFunction) pg_get_captured, METH_NOARGS,
+      DOC_PYGAMEDISPLAYGETCAPTURED },
 
     { "set_palette", pg_set_palette, METH_VARARGS, DOC_PYGAMEDISPLAYSETPALETTE },
     { "set_gamma", pg_set_gamma, METH_VARARGS, DOC_PYGAMEDISPLAYSETGAMMA },
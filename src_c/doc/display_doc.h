@@ -15,6 +15,12 @@
 
 #define DOC_PYGAMEDISPLAYUPDATE "update(rectangle=None) -> None\nupdate(rectangle_list) -> None\nUpdate portions of the screen for software displays"
 
+#define DOC_PYGAMEDISPLAYSETPRESENTTHREAD "set_present_thread(enable) -> bool\nshow the frames from a background thread"
+
+#define DOC_PYGAMEDISPLAYSTARTCAPTURE "start_capture(ring_frames, every_n=1) -> None\nrecord the frames shown in a ring of Surfaces"
+
+#define DOC_PYGAMEDISPLAYGETCAPTURED "get_captured() -> list\nget the frames recorded since start_capture()"
+
 #define DOC_PYGAMEDISPLAYGETDRIVER "get_driver() -> name\nGet the name of the pygame display backend"
 
 #define DOC_PYGAMEDISPLAYINFO "Info() -> VideoInfo\nCreate a video display information object"
@@ -85,6 +91,18 @@ pygame.display.update
  update(rectangle_list) -> None
 Update portions of the screen for software displays
 
+pygame.display.set_present_thread
+ set_present_thread(enable) -> bool
+show the frames from a background thread
+
+pygame.display.start_capture
+ start_capture(ring_frames, every_n=1) -> None
+record the frames shown in a ring of Surfaces
+
+pygame.display.get_captured
+ get_captured() -> list
+get the frames recorded since start_capture()
+
 pygame.display.get_driver
  get_driver() -> name
 Get the name of the pygame display backend
@@ -3,11 +3,11 @@
 
 #define DOC_PYGAMEDRAWRECT "rect(Surface, color, Rect, width=0) -> Rect\ndraw a rectangle shape"
 
-#define DOC_PYGAMEDRAWPOLYGON "polygon(Surface, color, pointlist, width=0) -> Rect\ndraw a shape with any number of sides"
+#define DOC_PYGAMEDRAWPOLYGON "polygon(Surface, color, pointlist, width=0, nonzero=False, antialias=False) -> Rect\ndraw a shape with any number of sides"
 
-#define DOC_PYGAMEDRAWCIRCLE "circle(Surface, color, pos, radius, width=0) -> Rect\ndraw a circle around a point"
+#define DOC_PYGAMEDRAWCIRCLE "circle(Surface, color, pos, radius, width=0, antialias=False) -> Rect\ndraw a circle around a point"
 
-#define DOC_PYGAMEDRAWELLIPSE "ellipse(Surface, color, Rect, width=0) -> Rect\ndraw a round shape inside a rectangle"
+#define DOC_PYGAMEDRAWELLIPSE "ellipse(Surface, color, Rect, width=0, antialias=False) -> Rect\ndraw a round shape inside a rectangle"
 
 #define DOC_PYGAMEDRAWARC "arc(Surface, color, Rect, start_angle, stop_angle, width=1) -> Rect\ndraw a partial section of an ellipse"
 
@@ -15,9 +15,17 @@
 
 #define DOC_PYGAMEDRAWLINES "lines(Surface, color, closed, pointlist, width=1) -> Rect\ndraw multiple contiguous line segments"
 
-#define DOC_PYGAMEDRAWAALINE "aaline(Surface, color, startpos, endpos, blend=1) -> Rect\ndraw fine antialiased lines"
+#define DOC_PYGAMEDRAWAALINE "aaline(Surface, color, startpos, endpos, blend=1, width=1) -> Rect\ndraw fine antialiased lines"
 
-#define DOC_PYGAMEDRAWAALINES "aalines(Surface, color, closed, pointlist, blend=1) -> Rect\ndraw a connected sequence of antialiased lines"
+#define DOC_PYGAMEDRAWAALINES "aalines(Surface, color, closed, pointlist, blend=1, width=1, joint='miter') -> Rect\ndraw a connected sequence of antialiased lines"
+
+#define DOC_PYGAMEDRAWLINESBATCH "lines_batch(Surface, color, segments, width=1) -> Rect\ndraw many separate straight line segments"
+
+#define DOC_PYGAMEDRAWCIRCLES "circles(Surface, color, centers, radius, width=0) -> Rect\ndraw many circles"
+
+#define DOC_PYGAMEDRAWRECTS "rects(Surface, color, rects, width=0) -> Rect\ndraw many rectangles"
+
+#define DOC_PYGAMEDRAWTEXTUREDTRIANGLES "textured_triangles(Surface, texture, vertices, uvs, indices=None, perspective=False, smooth=True) -> Rect\ndraw triangles filled with a texture"
 
 
 
@@ -33,15 +41,15 @@ pygame.draw.rect
 draw a rectangle shape
 
 pygame.draw.polygon
- polygon(Surface, color, pointlist, width=0) -> Rect
+ polygon(Surface, color, pointlist, width=0, nonzero=False, antialias=False) -> Rect
 draw a shape with any number of sides
 
 pygame.draw.circle
- circle(Surface, color, pos, radius, width=0) -> Rect
+ circle(Surface, color, pos, radius, width=0, antialias=False) -> Rect
 draw a circle around a point
 
 pygame.draw.ellipse
- ellipse(Surface, color, Rect, width=0) -> Rect
+ ellipse(Surface, color, Rect, width=0, antialias=False) -> Rect
 draw a round shape inside a rectangle
 
 pygame.draw.arc
@@ -57,11 +65,27 @@ pygame.draw.lines
 draw multiple contiguous line segments
 
 pygame.draw.aaline
- aaline(Surface, color, startpos, endpos, blend=1) -> Rect
+ aaline(Surface, color, startpos, endpos, blend=1, width=1) -> Rect
 draw fine antialiased lines
 
 pygame.draw.aalines
- aalines(Surface, color, closed, pointlist, blend=1) -> Rect
+ aalines(Surface, color, closed, pointlist, blend=1, width=1, joint='miter') -> Rect
 draw a connected sequence of antialiased lines
 
+pygame.draw.lines_batch
+ lines_batch(Surface, color, segments, width=1) -> Rect
+draw many separate straight line segments
+
+pygame.draw.circles
+ circles(Surface, color, centers, radius, width=0) -> Rect
+draw many circles
+
+pygame.draw.rects
+ rects(Surface, color, rects, width=0) -> Rect
+draw many rectangles
+
+pygame.draw.textured_triangles
+ textured_triangles(Surface, texture, vertices, uvs, indices=None, perspective=False, smooth=True) -> Rect
+draw triangles filled with a texture
+
 */
\ No newline at end of file
@@ -3,7 +3,9 @@
 
 #define DOC_PYGAMEEVENTPUMP "pump() -> None\ninternally process pygame event handlers"
 
-#define DOC_PYGAMEEVENTGET "get() -> Eventlist\nget(type) -> Eventlist\nget(typelist) -> Eventlist\nget events from the queue"
+#define DOC_PYGAMEEVENTGET "get() -> Eventlist\nget(type) -> Eventlist\nget(typelist) -> Eventlist\nget(type=None, filter=None) -> Eventlist\nget events from the queue"
+
+#define DOC_PYGAMEEVENTGETINTO "get_into(buffer) -> int\nget_into(buffer, type) -> int\nget_into(buffer, typelist) -> int\nget events from the queue into a buffer"
 
 #define DOC_PYGAMEEVENTPOLL "poll() -> EventType instance\nget a single event from the queue"
 
@@ -21,12 +23,28 @@
 
 #define DOC_PYGAMEEVENTGETBLOCKED "get_blocked(type) -> bool\ntest if a type of event is blocked from the queue"
 
+#define DOC_PYGAMEEVENTSETCOALESCE "set_coalesce(type, policy) -> None\nset_coalesce(typelist, policy) -> None\nmerge events of a type as they are taken off the queue"
+
 #define DOC_PYGAMEEVENTSETGRAB "set_grab(bool) -> None\ncontrol the sharing of input devices with other applications"
 
 #define DOC_PYGAMEEVENTGETGRAB "get_grab() -> bool\ntest if the program is sharing input devices"
 
 #define DOC_PYGAMEEVENTPOST "post(Event) -> None\nplace a new event on the queue"
 
+#define DOC_PYGAMEEVENTPOSTTHREADED "post_threaded(Event) -> bool\nplace a new event on the queue from any thread"
+
+#define DOC_PYGAMEEVENTGETTHREADEDSTATS "get_threaded_stats() -> (posted, dropped, high_water)\ncounters of the events posted from threads"
+
+#define DOC_PYGAMEEVENTSTARTRECORDING "start_recording(path) -> None\nrecord the events taken off the queue to a file"
+
+#define DOC_PYGAMEEVENTSTOPRECORDING "stop_recording() -> None\nstop recording events"
+
+#define DOC_PYGAMEEVENTREPLAY "replay(path, speed=1.0) -> int\nreplay a recorded event log"
+
+#define DOC_PYGAMEEVENTSTOPREPLAY "stop_replay() -> int\nstop replaying an event log"
+
+#define DOC_PYGAMEEVENTGETREPLAYPENDING "get_replay_pending() -> int\nnumber of events left to replay"
+
 #define DOC_PYGAMEEVENTEVENT "Event(type, dict) -> EventType instance\nEvent(type, **attributes) -> EventType instance\ncreate a new event object"
 
 #define DOC_PYGAMEEVENTEVENTTYPE "pygame object for representing SDL events"
@@ -52,8 +70,15 @@ pygame.event.get
  get() -> Eventlist
  get(type) -> Eventlist
  get(typelist) -> Eventlist
+ get(type=None, filter=None) -> Eventlist
 get events from the queue
 
+pygame.event.get_into
+ get_into(buffer) -> int
+ get_into(buffer, type) -> int
+ get_into(buffer, typelist) -> int
+get events from the queue into a buffer
+
 pygame.event.poll
  poll() -> EventType instance
 get a single event from the queue
@@ -93,6 +118,11 @@ pygame.event.get_blocked
  get_blocked(type) -> bool
 test if a type of event is blocked from the queue
 
+pygame.event.set_coalesce
+ set_coalesce(type, policy) -> None
+ set_coalesce(typelist, policy) -> None
+merge events of a type as they are taken off the queue
+
 pygame.event.set_grab
  set_grab(bool) -> None
 control the sharing of input devices with other applications
@@ -105,6 +135,34 @@ pygame.event.post
  post(Event) -> None
 place a new event on the queue
 
+pygame.event.post_threaded
+ post_threaded(Event) -> bool
+place a new event on the queue from any thread
+
+pygame.event.get_threaded_stats
+ get_threaded_stats() -> (posted, dropped, high_water)
+counters of the events posted from threads
+
+pygame.event.start_recording
+ start_recording(path) -> None
+record the events taken off the queue to a file
+
+pygame.event.stop_recording
+ stop_recording() -> None
+stop recording events
+
+pygame.event.replay
+ replay(path, speed=1.0) -> int
+replay a recorded event log
+
+pygame.event.stop_replay
+ stop_replay() -> int
+stop replaying an event log
+
+pygame.event.get_replay_pending
+ get_replay_pending() -> int
+number of events left to replay
+
 pygame.event.Event
  Event(type, dict) -> EventType instance
  Event(type, **attributes) -> EventType instance
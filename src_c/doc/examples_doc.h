@@ -51,6 +51,12 @@
 
 #define DOC_PYGAMEEXAMPLESSCALETESTMAIN "scaletest.main(imagefile, convert_alpha=False, run_speed_test=True) -> None\ninteractively scale an image using smoothscale"
 
+#define DOC_PYGAMEEXAMPLESDRAWBENCHMAIN "drawbench.main(loops=50, depths=(8, 16, 24, 32)) -> None\ntime the pygame.draw functions"
+
+#define DOC_PYGAMEEXAMPLESEVENTBENCHMAIN "eventbench.main(total=100000, batches=(16, 128, 1024, 8192, 32768)) -> None\ntime posting and reading events with Python attributes"
+
+#define DOC_PYGAMEEXAMPLESGFXDRAWBENCHMAIN "gfxdrawbench.main(loops=50, depths=(16, 24, 32), threads=4) -> None\ntime the filled pygame.gfxdraw functions"
+
 #define DOC_PYGAMEEXAMPLESMIDIMAIN "midi.main(mode='output', device_id=None) -> None\nrun a midi example"
 
 #define DOC_PYGAMEEXAMPLESSCROLLMAIN "scroll.main(image_file=None) -> None\nrun a Surface.scroll example that shows a magnified image"
@@ -168,6 +174,18 @@ pygame.examples.scaletest.main
  scaletest.main(imagefile, convert_alpha=False, run_speed_test=True) -> None
 interactively scale an image using smoothscale
 
+pygame.examples.drawbench.main
+ drawbench.main(loops=50, depths=(8, 16, 24, 32)) -> None
+time the pygame.draw functions
+
+pygame.examples.eventbench.main
+ eventbench.main(total=100000, batches=(16, 128, 1024, 8192, 32768)) -> None
+time posting and reading events with Python attributes
+
+pygame.examples.gfxdrawbench.main
+ gfxdrawbench.main(loops=50, depths=(16, 24, 32), threads=4) -> None
+time the filled pygame.gfxdraw functions
+
 pygame.examples.midi.main
  midi.main(mode='output', device_id=None) -> None
 run a midi example
@@ -1,9 +1,25 @@
 /* Auto generated file: with makeref.py .  Docs go in src/ *.doc . */
 #define DOC_PYGAMEIMAGE "pygame module for image transfer"
 
-#define DOC_PYGAMEIMAGELOAD "load(filename) -> Surface\nload(fileobj, namehint="") -> Surface\nload new image from a file"
+#define DOC_PYGAMEIMAGELOAD "load(filename) -> Surface\nload(fileobj, namehint="") -> Surface\nload(file, namehint="", format_like=None) -> Surface\nload new image from a file"
 
-#define DOC_PYGAMEIMAGESAVE "save(Surface, filename) -> None\nsave an image to disk"
+#define DOC_PYGAMEIMAGELOADMANY "load_many(paths_or_files, convert_to=None, threads=0) -> list\nload many images at once, on several threads"
+
+#define DOC_PYGAMEIMAGELOADASYNC "load_async(path, callback=None, event_type=None) -> AsyncLoad\nload an image on a background thread"
+
+#define DOC_PYGAMEIMAGEASYNCLOAD "load_async(path, callback=None, event_type=None) -> AsyncLoad\nan image being loaded on a background thread"
+
+#define DOC_ASYNCLOADDONE "done() -> bool\ntell if the load is over"
+
+#define DOC_ASYNCLOADCANCELLED "cancelled() -> bool\ntell if the load was cancelled"
+
+#define DOC_ASYNCLOADCANCEL "cancel() -> bool\nstop loading the image"
+
+#define DOC_ASYNCLOADRESULT "result(timeout=-1) -> Surface\nget the loaded Surface"
+
+#define DOC_ASYNCLOADPATH "path -> object\nthe filename or file object being loaded"
+
+#define DOC_PYGAMEIMAGESAVE "save(Surface, filename) -> None\nsave(Surface, filename, compression=-1, filter=None, threads=1) -> None\nsave(Surface, filename, quality=85, subsampling=None, progressive=False, optimize=False) -> None\nsave an image to disk"
 
 #define DOC_PYGAMEIMAGEGETEXTENDED "get_extended() -> bool\ntest if extended image formats can be loaded"
 
@@ -25,10 +41,45 @@ pygame module for image transfer
 pygame.image.load
  load(filename) -> Surface
  load(fileobj, namehint="") -> Surface
+ load(file, namehint="", format_like=None) -> Surface
 load new image from a file
 
+pygame.image.load_many
+ load_many(paths_or_files, convert_to=None, threads=0) -> list
+load many images at once, on several threads
+
+pygame.image.load_async
+ load_async(path, callback=None, event_type=None) -> AsyncLoad
+load an image on a background thread
+
+pygame.image.AsyncLoad
+ load_async(path, callback=None, event_type=None) -> AsyncLoad
+an image being loaded on a background thread
+
+pygame.image.AsyncLoad.done
+ done() -> bool
+tell if the load is over
+
+pygame.image.AsyncLoad.cancelled
+ cancelled() -> bool
+tell if the load was cancelled
+
+pygame.image.AsyncLoad.cancel
+ cancel() -> bool
+stop loading the image
+
+pygame.image.AsyncLoad.result
+ result(timeout=-1) -> Surface
+get the loaded Surface
+
+pygame.image.AsyncLoad.path
+ path -> object
+the filename or file object being loaded
+
 pygame.image.save
  save(Surface, filename) -> None
+ save(Surface, filename, compression=-1, filter=None, threads=1) -> None
+ save(Surface, filename, quality=85, subsampling=None, progressive=False, optimize=False) -> None
 save an image to disk
 
 pygame.image.get_extended
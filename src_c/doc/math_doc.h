@@ -105,6 +105,70 @@
 
 #define DOC_VECTOR3FROMSPHERICAL "from_spherical((r, theta, phi)) -> None\nSets x, y and z from a spherical coordinates 3-tuple."
 
+#define DOC_PYGAMEMATHAFFINE2 "Affine2() -> Affine2\nAffine2(Affine2) -> Affine2\nAffine2(a, b, c, d, e, f) -> Affine2\nAffine2((a, b, c, d, e, f)) -> Affine2\na 2-Dimensional affine transform"
+
+#define DOC_AFFINE2IDENTITY "identity() -> Affine2\nreturns the identity transform."
+
+#define DOC_AFFINE2TRANSLATION "translation(Vector2) -> Affine2\nreturns a transform that moves points by an offset."
+
+#define DOC_AFFINE2ROTATION "rotation(float) -> Affine2\nreturns a transform that rotates by an angle in degrees."
+
+#define DOC_AFFINE2SCALING "scaling(float) -> Affine2\nscaling(Vector2) -> Affine2\nreturns a transform that scales along the axes."
+
+#define DOC_AFFINE2DETERMINANT "determinant() -> float\nreturns the determinant of the linear part."
+
+#define DOC_AFFINE2INVERSE "inverse() -> Affine2\nreturns the inverse transform."
+
+#define DOC_AFFINE2DECOMPOSE "decompose() -> ((x, y), angle, (sx, sy), shear)\nsplits the transform into translation, rotation, scale and shear."
+
+#define DOC_AFFINE2TRANSFORMPOINT "transform_point(Vector2) -> Vector2\napplies the transform to a point."
+
+#define DOC_AFFINE2TRANSFORMVECTOR "transform_vector(Vector2) -> Vector2\napplies the transform to a direction, ignoring translation."
+
+#define DOC_AFFINE2TRANSFORMPOINTS "transform_points(buffer, out=None) -> buffer\ntransform_points(sequence) -> list\napplies the transform to many points at once."
+
+#define DOC_AFFINE2TRANSFORMVECTORS "transform_vectors(buffer, out=None) -> buffer\ntransform_vectors(sequence) -> list\napplies the transform to many directions at once."
+
+#define DOC_PYGAMEMATHMATRIX44 "Matrix44() -> Matrix44\nMatrix44(Matrix44) -> Matrix44\nMatrix44(m00, m01, ..., m33) -> Matrix44\nMatrix44(sequence) -> Matrix44\na 4x4 transformation matrix"
+
+#define DOC_MATRIX44IDENTITY "identity() -> Matrix44\nreturns the identity matrix."
+
+#define DOC_MATRIX44TRANSLATION "translation(Vector3) -> Matrix44\nreturns a matrix that moves points by an offset."
+
+#define DOC_MATRIX44ROTATION "rotation(angle, Vector3) -> Matrix44\nreturns a matrix that rotates around an axis."
+
+#define DOC_MATRIX44SCALING "scaling(float) -> Matrix44\nscaling(Vector3) -> Matrix44\nreturns a matrix that scales along the axes."
+
+#define DOC_MATRIX44PERSPECTIVE "perspective(fovy, aspect, near, far) -> Matrix44\nreturns a perspective projection matrix."
+
+#define DOC_MATRIX44ORTHOGRAPHIC "orthographic(left, right, bottom, top, near, far) -> Matrix44\nreturns an orthographic projection matrix."
+
+#define DOC_MATRIX44DETERMINANT "determinant() -> float\nreturns the determinant of the matrix."
+
+#define DOC_MATRIX44INVERSE "inverse() -> Matrix44\nreturns the inverse matrix."
+
+#define DOC_MATRIX44TRANSPOSE "transpose() -> Matrix44\nreturns the transposed matrix."
+
+#define DOC_MATRIX44DECOMPOSE "decompose() -> ((x, y, z), Matrix44, (sx, sy, sz))\nsplits the matrix into translation, rotation and scale."
+
+#define DOC_MATRIX44TRANSFORMPOINT "transform_point(Vector3) -> Vector3\napplies the matrix to a point."
+
+#define DOC_MATRIX44TRANSFORMVECTOR "transform_vector(Vector3) -> Vector3\napplies the matrix to a direction, ignoring translation."
+
+#define DOC_MATRIX44TRANSFORMPOINTS "transform_points(buffer, out=None) -> buffer\ntransform_points(sequence) -> list\napplies the matrix to many points at once."
+
+#define DOC_MATRIX44TRANSFORMVECTORS "transform_vectors(buffer, out=None) -> buffer\ntransform_vectors(sequence) -> list\napplies the matrix to many directions at once."
+
+#define DOC_PYGAMEMATHPOINTINDEX "PointIndex(buffer) -> PointIndex\nPointIndex(sequence) -> PointIndex\na spatial index for nearest neighbour and radius queries"
+
+#define DOC_POINTINDEXUPDATE "update(buffer) -> None\nupdate(sequence) -> None\nreplaces all points of the index."
+
+#define DOC_POINTINDEXNEAREST "nearest(point, k=1) -> list\nreturns the indices of the points closest to a position."
+
+#define DOC_POINTINDEXWITHIN "within(point, radius) -> list\nreturns the indices of the points inside a circle."
+
+#define DOC_POINTINDEXPAIRSWITHIN "pairs_within(radius) -> list\nreturns all pairs of points closer than a distance."
+
 #define DOC_PYGAMEMATHENABLESWIZZLING "enable_swizzling() -> None\nglobally enables swizzling for vectors."
 
 #define DOC_PYGAMEMATHDISABLESWIZZLING "disable_swizzling() -> None\nglobally disables swizzling for vectors."
@@ -336,6 +400,148 @@ pygame.math.Vector3.from_spherical
  from_spherical((r, theta, phi)) -> None
 Sets x, y and z from a spherical coordinates 3-tuple.
 
+pygame.math.Affine2
+ Affine2() -> Affine2
+ Affine2(Affine2) -> Affine2
+ Affine2(a, b, c, d, e, f) -> Affine2
+ Affine2((a, b, c, d, e, f)) -> Affine2
+a 2-Dimensional affine transform
+
+pygame.math.Affine2.identity
+ identity() -> Affine2
+returns the identity transform.
+
+pygame.math.Affine2.translation
+ translation(Vector2) -> Affine2
+returns a transform that moves points by an offset.
+
+pygame.math.Affine2.rotation
+ rotation(float) -> Affine2
+returns a transform that rotates by an angle in degrees.
+
+pygame.math.Affine2.scaling
+ scaling(float) -> Affine2
+ scaling(Vector2) -> Affine2
+returns a transform that scales along the axes.
+
+pygame.math.Affine2.determinant
+ determinant() -> float
+returns the determinant of the linear part.
+
+pygame.math.Affine2.inverse
+ inverse() -> Affine2
+returns the inverse transform.
+
+pygame.math.Affine2.decompose
+ decompose() -> ((x, y), angle, (sx, sy), shear)
+splits the transform into translation, rotation, scale and shear.
+
+pygame.math.Affine2.transform_point
+ transform_point(Vector2) -> Vector2
+applies the transform to a point.
+
+pygame.math.Affine2.transform_vector
+ transform_vector(Vector2) -> Vector2
+applies the transform to a direction, ignoring translation.
+
+pygame.math.Affine2.transform_points
+ transform_points(buffer, out=None) -> buffer
+ transform_points(sequence) -> list
+applies the transform to many points at once.
+
+pygame.math.Affine2.transform_vectors
+ transform_vectors(buffer, out=None) -> buffer
+ transform_vectors(sequence) -> list
+applies the transform to many directions at once.
+
+pygame.math.Matrix44
+ Matrix44() -> Matrix44
+ Matrix44(Matrix44) -> Matrix44
+ Matrix44(m00, m01, ..., m33) -> Matrix44
+ Matrix44(sequence) -> Matrix44
+a 4x4 transformation matrix
+
+pygame.math.Matrix44.identity
+ identity() -> Matrix44
+returns the identity matrix.
+
+pygame.math.Matrix44.translation
+ translation(Vector3) -> Matrix44
+returns a matrix that moves points by an offset.
+
+pygame.math.Matrix44.rotation
+ rotation(angle, Vector3) -> Matrix44
+returns a matrix that rotates around an axis.
+
+pygame.math.Matrix44.scaling
+ scaling(float) -> Matrix44
+ scaling(Vector3) -> Matrix44
+returns a matrix that scales along the axes.
+
+pygame.math.Matrix44.perspective
+ perspective(fovy, aspect, near, far) -> Matrix44
+returns a perspective projection matrix.
+
+pygame.math.Matrix44.orthographic
+ orthographic(left, right, bottom, top, near, far) -> Matrix44
+returns an orthographic projection matrix.
+
+pygame.math.Matrix44.determinant
+ determinant() -> float
+returns the determinant of the matrix.
+
+pygame.math.Matrix44.inverse
+ inverse() -> Matrix44
+returns the inverse matrix.
+
+pygame.math.Matrix44.transpose
+ transpose() -> Matrix44
+returns the transposed matrix.
+
+pygame.math.Matrix44.decompose
+ decompose() -> ((x, y, z), Matrix44, (sx, sy, sz))
+splits the matrix into translation, rotation and scale.
+
+pygame.math.Matrix44.transform_point
+ transform_point(Vector3) -> Vector3
+applies the matrix to a point.
+
+pygame.math.Matrix44.transform_vector
+ transform_vector(Vector3) -> Vector3
+applies the matrix to a direction, ignoring translation.
+
+pygame.math.Matrix44.transform_points
+ transform_points(buffer, out=None) -> buffer
+ transform_points(sequence) -> list
+applies the matrix to many points at once.
+
+pygame.math.Matrix44.transform_vectors
+ transform_vectors(buffer, out=None) -> buffer
+ transform_vectors(sequence) -> list
+applies the matrix to many directions at once.
+
+pygame.math.PointIndex
+ PointIndex(buffer) -> PointIndex
+ PointIndex(sequence) -> PointIndex
+a spatial index for nearest neighbour and radius queries
+
+pygame.math.PointIndex.update
+ update(buffer) -> None
+ update(sequence) -> None
+replaces all points of the index.
+
+pygame.math.PointIndex.nearest
+ nearest(point, k=1) -> list
+returns the indices of the points closest to a position.
+
+pygame.math.PointIndex.within
+ within(point, radius) -> list
+returns the indices of the points inside a circle.
+
+pygame.math.PointIndex.pairs_within
+ pairs_within(radius) -> list
+returns all pairs of points closer than a distance.
+
 pygame.math.enable_swizzling
  enable_swizzling() -> None
 globally enables swizzling for vectors.
@@ -3,13 +3,29 @@
 
 #define DOC_PYGAMETIMEGETTICKS "get_ticks() -> milliseconds\nget the time in milliseconds"
 
+#define DOC_PYGAMETIMEGETTICKSNS "get_ticks_ns() -> nanoseconds\nget the time in nanoseconds"
+
 #define DOC_PYGAMETIMEWAIT "wait(milliseconds) -> time\npause the program for an amount of time"
 
 #define DOC_PYGAMETIMEDELAY "delay(milliseconds) -> time\npause the program for an amount of time"
 
 #define DOC_PYGAMETIMESETTIMER "set_timer(eventid, milliseconds) -> None\nrepeatedly create an event on the event queue"
 
-#define DOC_PYGAMETIMECLOCK "Clock() -> Clock\ncreate an object to help track time"
+#define DOC_PYGAMETIMEADDTIMER "add_timer(event, millis, loops=0) -> Timer\ncreate events on the event queue after some time"
+
+#define DOC_PYGAMETIMETIMER "Timer\na timer from add_timer"
+
+#define DOC_TIMERCANCEL "cancel() -> bool\nstop the timer"
+
+#define DOC_PYGAMETIMEFIXEDSTEPLOOP "FixedStepLoop(update, render, hz, max_catchup=5, framerate=0) -> FixedStepLoop\nrun a game loop with a fixed update rate"
+
+#define DOC_FIXEDSTEPLOOPRUN "run(frames=0) -> None\nrun the loop"
+
+#define DOC_FIXEDSTEPLOOPSTOP "stop() -> None\nstop the loop after this frame"
+
+#define DOC_FIXEDSTEPLOOPGETSTATS "get_stats() -> dict\npacing statistics of the loop"
+
+#define DOC_PYGAMETIMECLOCK "Clock(precise=False) -> Clock\ncreate an object to help track time"
 
 #define DOC_CLOCKTICK "tick(framerate=0) -> milliseconds\nupdate the clock"
 
@@ -19,8 +35,16 @@
 
 #define DOC_CLOCKGETRAWTIME "get_rawtime() -> milliseconds\nactual time used in the previous tick"
 
+#define DOC_CLOCKGETTIMENS "get_time_ns() -> nanoseconds\ntime used in the previous tick in nanoseconds"
+
+#define DOC_CLOCKGETRAWTIMENS "get_rawtime_ns() -> nanoseconds\nactual time used in the previous tick in nanoseconds"
+
 #define DOC_CLOCKGETFPS "get_fps() -> float\ncompute the clock framerate"
 
+#define DOC_CLOCKGETSTATS "get_stats() -> dict\nframe time statistics of the last ticks"
+
+#define DOC_CLOCKSECTION "section(name) -> ClockSection\ntime a named part of each frame"
+
 
 
 /* Docs in a comment... slightly easier to read. */
@@ -34,6 +58,10 @@ pygame.time.get_ticks
  get_ticks() -> milliseconds
 get the time in milliseconds
 
+pygame.time.get_ticks_ns
+ get_ticks_ns() -> nanoseconds
+get the time in nanoseconds
+
 pygame.time.wait
  wait(milliseconds) -> time
 pause the program for an amount of time
@@ -46,8 +74,36 @@ pygame.time.set_timer
  set_timer(eventid, milliseconds) -> None
 repeatedly create an event on the event queue
 
+pygame.time.add_timer
+ add_timer(event, millis, loops=0) -> Timer
+create events on the event queue after some time
+
+pygame.time.Timer
+ Timer
+a timer from add_timer
+
+pygame.time.Timer.cancel
+ cancel() -> bool
+stop the timer
+
+pygame.time.FixedStepLoop
+ FixedStepLoop(update, render, hz, max_catchup=5, framerate=0) -> FixedStepLoop
+run a game loop with a fixed update rate
+
+pygame.time.FixedStepLoop.run
+ run(frames=0) -> None
+run the loop
+
+pygame.time.FixedStepLoop.stop
+ stop() -> None
+stop the loop after this frame
+
+pygame.time.FixedStepLoop.get_stats
+ get_stats() -> dict
+pacing statistics of the loop
+
 pygame.time.Clock
- Clock() -> Clock
+ Clock(precise=False) -> Clock
 create an object to help track time
 
 pygame.time.Clock.tick
@@ -66,8 +122,24 @@ pygame.time.Clock.get_rawtime
  get_rawtime() -> milliseconds
 actual time used in the previous tick
 
+pygame.time.Clock.get_time_ns
+ get_time_ns() -> nanoseconds
+time used in the previous tick in nanoseconds
+
+pygame.time.Clock.get_rawtime_ns
+ get_rawtime_ns() -> nanoseconds
+actual time used in the previous tick in nanoseconds
+
 pygame.time.Clock.get_fps
  get_fps() -> float
 compute the clock framerate
 
+pygame.time.Clock.get_stats
+ get_stats() -> dict
+frame time statistics of the last ticks
+
+pygame.time.Clock.section
+ section(name) -> ClockSection
+time a named part of each frame
+
 */
\ No newline at end of file
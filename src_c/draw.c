@@ -27,6 +27,7 @@
 #include "pgcompat.h"
 #include "doc/draw_doc.h"
 #include <math.h>
+#include <float.h>
 
 /* Many C libraries seem to lack the trunc call (added in C99) */
 #define trunc(d)   (((d) >= 0.0) ? (floor(d)) : (ceil(d)))
@@ -37,37 +38,140 @@
 #define M_PI 3.14159265358979323846
 #endif
 
-static int clip_and_draw_line(SDL_Surface* surf, SDL_Rect* rect, Uint32 color, int* pts);
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define PG_DRAW_SSE2
+#endif
+
+/* Destination of a draw call. The span and pixel writers are picked once
+ * for the pixel size of the surface by draw_target_init.
+ */
+typedef struct draw_target draw_target;
+struct draw_target {
+    Uint8 *pixels;
+    int pitch;
+    int bpp;
+    Uint32 color;
+    Uint8 color3[3];                /* color bytes for 24 bit surfaces */
+    int left, top, right, bottom;   /* clip rect, inclusive */
+    void (*pixel)(draw_target *t, int x, int y);
+    void (*hspan)(draw_target *t, int x1, int x2, int y);  /* x1 <= x2 */
+    void (*vspan)(draw_target *t, int x, int y1, int y2);  /* y1 <= y2 */
+};
+
+/* Outline of an antialiased shape, built from one or more closed
+ * contours and filled in one pass with the nonzero rule.
+ */
+typedef struct aa_path aa_path;
+struct aa_path {
+    float *x, *y;           /* vertices of all the contours */
+    int *ends;              /* one past the last vertex of each contour */
+    int count, contours;
+    int size, ends_size;    /* allocated lengths of the arrays */
+    int failed;             /* an allocation failed, the path is incomplete */
+};
+
+/* Triangle of draw.textured_triangles. Each edge i is the line
+ * ex*x + ey*y + ec = 0, positive inside. The s, t and q planes give the
+ * texture coordinates as a*x + b*y + c at pixel centers; without
+ * perspective q is 1.
+ */
+typedef struct {
+    double ex[3], ey[3], ec[3];
+    double s[3], t[3], q[3];
+    int left, top, right, bottom;   /* clipped bounds, inclusive */
+} tex_triangle;
+
+/* Work of one draw.textured_triangles call. The triangles are binned
+ * into TEX_TILE sized tiles over the drawn area, bins holding the
+ * triangle numbers of tile k from bin_start[k] to bin_start[k + 1].
+ */
+typedef struct {
+    SDL_Surface *surf;
+    Uint8 *texels;          /* premultiplied r, g, b, a bytes */
+    int tw, th;
+    int smooth, perspective;
+    tex_triangle *tris;
+    int *bin_start, *bins;
+    int left, top, right, bottom;
+    int tiles_x, tiles;
+    int threads;
+} tex_job;
+
+typedef struct {
+    tex_job *job;
+    int first;              /* first tile drawn by the thread */
+} tex_worker;
+
+#define TEX_TILE 64
+#define TEX_MAX_THREADS 16
+#define TEX_THREAD_AREA 32768   /* pixels, below this one thread draws */
+
+static int clip_and_draw_line(draw_target *t, int* pts);
 static int clip_and_draw_aaline(SDL_Surface* surf, SDL_Rect* rect, Uint32 color, float* pts, int blend);
-static int clip_and_draw_line_width(SDL_Surface* surf, SDL_Rect* rect, Uint32 color, int width, int* pts);
+static int clip_and_draw_line_width(draw_target *t, int width, int* pts);
 static int clipline(int* pts, int left, int top, int right, int bottom);
 static int clipaaline(float* pts, int left, int top, int right, int bottom);
-static void drawline(SDL_Surface* surf, Uint32 color, int startx, int starty, int endx, int endy);
+static void drawline(draw_target *t, int startx, int starty, int endx, int endy);
+static void drawline_width(draw_target *t, int width, int *pts);
 static void drawaaline(SDL_Surface* surf, Uint32 color, float startx, float starty, float endx, float endy,
                        int blend);
-static void drawhorzline(SDL_Surface* surf, Uint32 color, int startx, int starty, int endx);
-static void drawvertline(SDL_Surface* surf, Uint32 color, int x1, int y1, int y2);
-static void draw_arc(SDL_Surface *dst, int x, int y, int radius1, int radius2, double angle_start, double angle_stop, Uint32 color);
-static void draw_ellipse(SDL_Surface *dst, int x, int y, int rx, int ry, Uint32 color);
-static void draw_fillellipse(SDL_Surface *dst, int x, int y, int rx, int ry, Uint32 color);
-static void draw_fillpoly(SDL_Surface *dst, int *vx, int *vy, int n, Uint32 color);
-
-
-
-static PyObject* aaline(PyObject* self, PyObject* arg)
+static void draw_target_init(draw_target *t, SDL_Surface *surf, Uint32 color);
+static void draw_target_set_color(draw_target *t, Uint32 color);
+static void draw_pixel_clip(draw_target *t, int x, int y);
+static void draw_hspan_clip(draw_target *t, int x1, int x2, int y);
+static void draw_vspan_clip(draw_target *t, int x, int y1, int y2);
+static void draw_arc(draw_target *t, int x, int y, int radius1, int radius2, double angle_start, double angle_stop);
+static void draw_ellipse(draw_target *t, int x, int y, int rx, int ry);
+static void draw_fillellipse(draw_target *t, int x, int y, int rx, int ry);
+static void draw_fillpoly(draw_target *t, int *vx, int *vy, int n, int nonzero);
+static void draw_aafillpath(SDL_Surface *dst, float *vx, float *vy, int *ends,
+                            int contours, Uint32 color, int nonzero);
+static void aa_path_init(aa_path *p);
+static void aa_path_free(aa_path *p);
+static void aa_path_add_ellipse(aa_path *p, double cx, double cy, double rx,
+                                double ry, int sign);
+static void aa_path_add_polyline(aa_path *p, float *px, float *py, int n,
+                                 int closed, double width, int round);
+static PyObject* draw_aapath(PyObject *surfobj, aa_path *p, Uint32 color,
+                             int x, int y);
+static PyObject* draw_aathicklines(PyObject *surfobj, Uint32 color, PyObject *points,
+                                   int closed, float width, int round);
+static int draw_read_ints(PyObject *obj, int width, int **out,
+                          Py_ssize_t *count, const char *name);
+static int draw_read_colors(SDL_Surface *surf, PyObject *obj, Py_ssize_t count,
+                            Uint32 **colors, Uint32 *color);
+static int draw_read_floats(PyObject *obj, int width, float **out,
+                            Py_ssize_t *count, const char *name);
+static int tex_setup_triangle(tex_triangle *tri, float **pos, float **uv,
+                              int perspective, SDL_Rect *clip);
+static void tex_read_texture(SDL_Surface *tex, Uint8 *texels);
+static Uint32 tex_load_pixel(Uint8 *pixel, int bpp);
+static int tex_thread_count(int tiles, double area);
+static void tex_draw(tex_job *job);
+static void tex_job_free(tex_job *job);
+
+
+
+static PyObject* aaline(PyObject* self, PyObject* arg, PyObject* kwds)
 {
-    PyObject *surfobj, *colorobj, *start, *end;
+    PyObject *surfobj, *colorobj, *start, *end, *points, *ret;
     SDL_Surface* surf;
     float startx, starty, endx, endy;
     int top, left, bottom, right;
     int blend=1;
+    float width=1;
     float pts[4];
     Uint8 rgba[4];
     Uint32 color;
     int anydraw;
+    static char *kwlist[] = {"Surface", "color", "startpos", "endpos", "blend",
+                             "width", NULL};
 
     /*get all the arguments*/
-    if(!PyArg_ParseTuple(arg, "O!OOO|i", &pgSurface_Type, &surfobj, &colorobj, &start, &end, &blend))
+    if(!PyArg_ParseTupleAndKeywords(arg, kwds, "O!OOO|if", kwlist, &pgSurface_Type,
+                                    &surfobj, &colorobj, &start, &end, &blend, &width))
         return NULL;
     surf = pgSurface_AsSurface(surfobj);
 
@@ -84,6 +188,15 @@ static PyObject* aaline(PyObject* self, PyObject* arg)
     if(!pg_TwoFloatsFromObj(end, &endx, &endy))
         return RAISE(PyExc_TypeError, "Invalid end position argument");
 
+    if(width != 1)
+    {
+        points = Py_BuildValue("(OO)", start, end);
+        if(!points) return NULL;
+        ret = draw_aathicklines(surfobj, color, points, 0, width, 0);
+        Py_DECREF(points);
+        return ret;
+    }
+
     if(!pgSurface_Lock(surfobj)) return NULL;
 
     pts[0] = startx; pts[1] = starty;
@@ -131,6 +244,7 @@ static PyObject* line(PyObject* self, PyObject* arg)
     Uint8 rgba[4];
     Uint32 color;
     int anydraw;
+    draw_target target;
 
     /*get all the arguments*/
     if(!PyArg_ParseTuple(arg, "O!OOO|i", &pgSurface_Type, &surfobj, &colorobj, &start, &end, &width))
@@ -158,9 +272,10 @@ static PyObject* line(PyObject* self, PyObject* arg)
 
     if(!pgSurface_Lock(surfobj)) return NULL;
 
+    draw_target_init(&target, surf, color);
     pts[0] = startx; pts[1] = starty;
     pts[2] = endx; pts[3] = endy;
-    anydraw = clip_and_draw_line_width(surf, &surf->clip_rect, color, width, pts);
+    anydraw = clip_and_draw_line_width(&target, width, pts);
 
     if(!pgSurface_Unlock(surfobj)) return NULL;
 
@@ -186,7 +301,7 @@ static PyObject* line(PyObject* self, PyObject* arg)
 }
 
 
-static PyObject* aalines(PyObject* self, PyObject* arg)
+static PyObject* aalines(PyObject* self, PyObject* arg, PyObject* kwds)
 {
     PyObject *surfobj, *colorobj, *closedobj, *points, *item;
     SDL_Surface* surf;
@@ -195,14 +310,26 @@ static PyObject* aalines(PyObject* self, PyObject* arg)
     float pts[4];
     Uint8 rgba[4];
     Uint32 color;
-    int closed, blend;
+    int closed, blend=1, round=0;
+    float width=1;
+    char *joint = NULL;
     int result, loop, length, drawn;
     float startx, starty;
+    static char *kwlist[] = {"Surface", "color", "closed", "pointlist", "blend",
+                             "width", "joint", NULL};
 
     /*get all the arguments*/
-    if(!PyArg_ParseTuple(arg, "O!OOO|i", &pgSurface_Type, &surfobj, &colorobj, &closedobj,
-                         &points, &blend))
+    if(!PyArg_ParseTupleAndKeywords(arg, kwds, "O!OOO|ifs", kwlist, &pgSurface_Type,
+                                    &surfobj, &colorobj, &closedobj, &points,
+                                    &blend, &width, &joint))
         return NULL;
+    if(joint != NULL)
+    {
+        if(!strcmp(joint, "round"))
+            round = 1;
+        else if(strcmp(joint, "miter"))
+            return RAISE(PyExc_ValueError, "joint must be 'miter' or 'round'");
+    }
     surf = pgSurface_AsSurface(surfobj);
 
     if(surf->format->BytesPerPixel !=3 && surf->format->BytesPerPixel != 4)
@@ -226,6 +353,9 @@ static PyObject* aalines(PyObject* self, PyObject* arg)
     Py_DECREF(item);
     if(!result) return RAISE(PyExc_TypeError, "points must be number pairs");
 
+    if(width != 1)
+        return draw_aathicklines(surfobj, color, points, closed, width, round);
+
     startx = pts[0] = x;
     starty = pts[1] = y;
     left = right = (int)x;
@@ -287,6 +417,7 @@ static PyObject* lines(PyObject* self, PyObject* arg)
     int closed;
     int result, loop, length, drawn;
     int startx, starty;
+    draw_target target;
 
     /*get all the arguments*/
     if(!PyArg_ParseTuple(arg, "O!OOO|i", &pgSurface_Type, &surfobj, &colorobj, &closedobj, &points, &width))
@@ -323,6 +454,7 @@ static PyObject* lines(PyObject* self, PyObject* arg)
         return pgRect_New4(left, top, 0, 0);
 
     if(!pgSurface_Lock(surfobj)) return NULL;
+    draw_target_init(&target, surf, color);
 
     drawn = 1;
     for(loop = 1; loop < length; ++loop)
@@ -336,7 +468,7 @@ static PyObject* lines(PyObject* self, PyObject* arg)
         pts[1] = starty;
         startx = pts[2] = x;
         starty = pts[3] = y;
-        if(clip_and_draw_line_width(surf, &surf->clip_rect, color, width, pts))
+        if(clip_and_draw_line_width(&target, width, pts))
         {
             left = MIN(MIN(pts[0], pts[2]), left);
             top = MIN(MIN(pts[1], pts[3]), top);
@@ -355,7 +487,7 @@ static PyObject* lines(PyObject* self, PyObject* arg)
             pts[1] = starty;
             pts[2] = x;
             pts[3] = y;
-            clip_and_draw_line_width(surf, &surf->clip_rect, color, width, pts);
+            clip_and_draw_line_width(&target, width, pts);
         }
     }
 
@@ -376,6 +508,7 @@ static PyObject* arc(PyObject* self, PyObject* arg)
     Uint32 color;
     int width=1, loop, t, l, b, r;
     double angle_start, angle_stop;
+    draw_target target;
 
     /*get all the arguments*/
     if(!PyArg_ParseTuple(arg, "O!OOdd|i", &pgSurface_Type, &surfobj, &colorobj, &rectobj,
@@ -405,13 +538,14 @@ static PyObject* arc(PyObject* self, PyObject* arg)
         angle_stop += 2*M_PI;
 
     if(!pgSurface_Lock(surfobj)) return NULL;
+    draw_target_init(&target, surf, color);
 
     width = MIN(width, MIN(rect->w, rect->h) / 2);
     for(loop=0; loop<width; ++loop)
     {
-        draw_arc(surf, rect->x+rect->w/2, rect->y+rect->h/2,
+        draw_arc(&target, rect->x+rect->w/2, rect->y+rect->h/2,
                  rect->w/2-loop, rect->h/2-loop,
-                 angle_start, angle_stop, color);
+                 angle_start, angle_stop);
     }
 
     if(!pgSurface_Unlock(surfobj)) return NULL;
@@ -424,17 +558,23 @@ static PyObject* arc(PyObject* self, PyObject* arg)
 }
 
 
-static PyObject* ellipse(PyObject* self, PyObject* arg)
+static PyObject* ellipse(PyObject* self, PyObject* arg, PyObject* kwds)
 {
-    PyObject *surfobj, *colorobj, *rectobj;
+    PyObject *surfobj, *colorobj, *rectobj, *ret;
     GAME_Rect *rect, temp;
     SDL_Surface* surf;
     Uint8 rgba[4];
     Uint32 color;
-    int width=0, loop, t, l, b, r;
+    int width=0, loop, t, l, b, r, antialias=0;
+    double cx, cy, rx, ry;
+    draw_target target;
+    aa_path path;
+    static char *kwlist[] = {"Surface", "color", "Rect", "width", "antialias",
+                             NULL};
 
     /*get all the arguments*/
-    if(!PyArg_ParseTuple(arg, "O!OO|i", &pgSurface_Type, &surfobj, &colorobj, &rectobj, &width))
+    if(!PyArg_ParseTupleAndKeywords(arg, kwds, "O!OO|ii", kwlist, &pgSurface_Type,
+                                    &surfobj, &colorobj, &rectobj, &width, &antialias))
         return NULL;
     rect = pgRect_FromObject(rectobj, &temp);
     if(!rect)
@@ -456,18 +596,35 @@ static PyObject* ellipse(PyObject* self, PyObject* arg)
     if ( width > rect->w / 2 || width > rect->h / 2 )
         return RAISE(PyExc_ValueError, "width greater than ellipse radius");
 
+    if(antialias)
+    {
+        /*the ellipse fills the rect, pixel centers are at whole numbers*/
+        rx = rect->w / 2.0;
+        ry = rect->h / 2.0;
+        cx = rect->x + rx - 0.5;
+        cy = rect->y + ry - 0.5;
+        aa_path_init(&path);
+        aa_path_add_ellipse(&path, cx, cy, rx, ry, 1);
+        if(width)
+            aa_path_add_ellipse(&path, cx, cy, rx - width, ry - width, -1);
+        ret = draw_aapath(surfobj, &path, color, rect->x, rect->y);
+        aa_path_free(&path);
+        return ret;
+    }
+
     if(!pgSurface_Lock(surfobj)) return NULL;
+    draw_target_init(&target, surf, color);
 
     if(!width)
-        draw_fillellipse(surf, (Sint16)(rect->x+rect->w/2), (Sint16)(rect->y+rect->h/2),
-                         (Sint16)(rect->w/2), (Sint16)(rect->h/2), color);
+        draw_fillellipse(&target, (Sint16)(rect->x+rect->w/2), (Sint16)(rect->y+rect->h/2),
+                         (Sint16)(rect->w/2), (Sint16)(rect->h/2));
     else
     {
         width = MIN(width, MIN(rect->w, rect->h) / 2);
         for(loop=0; loop<width; ++loop)
         {
-            draw_ellipse(surf, rect->x+rect->w/2, rect->y+rect->h/2,
-                         rect->w/2-loop, rect->h/2-loop, color);
+            draw_ellipse(&target, rect->x+rect->w/2, rect->y+rect->h/2,
+                         rect->w/2-loop, rect->h/2-loop);
         }
     }
 
@@ -481,18 +638,37 @@ static PyObject* ellipse(PyObject* self, PyObject* arg)
 }
 
 
-static PyObject* circle(PyObject* self, PyObject* arg)
+static PyObject* circle(PyObject* self, PyObject* arg, PyObject* kwds)
 {
-    PyObject *surfobj, *colorobj;
+    PyObject *surfobj, *colorobj, *posobj, *ret;
     SDL_Surface* surf;
     Uint8 rgba[4];
     Uint32 color;
     int posx, posy, radius, t, l, b, r;
-    int width=0, loop;
+    int width=0, loop, antialias=0;
+    float fx, fy, fradius;
+    draw_target target;
+    aa_path path;
+    static char *kwlist[] = {"Surface", "color", "pos", "radius", "width",
+                             "antialias", NULL};
 
     /*get all the arguments*/
-    if(!PyArg_ParseTuple(arg, "O!O(ii)i|i", &pgSurface_Type, &surfobj, &colorobj, &posx, &posy, &radius, &width))
+    if(!PyArg_ParseTupleAndKeywords(arg, kwds, "O!OOf|ii", kwlist, &pgSurface_Type,
+                                    &surfobj, &colorobj, &posobj, &fradius, &width,
+                                    &antialias))
         return NULL;
+    if(!pg_TwoFloatsFromObj(posobj, &fx, &fy))
+        return RAISE(PyExc_TypeError, "pos must be a pair of numbers");
+    /*checked before the casts, nan fails them too. The bounds keep the
+      returned rect math in int range*/
+    if(!(fabs(fx) < INT_MAX / 2 && fabs(fy) < INT_MAX / 2))
+        return RAISE(PyExc_ValueError, "pos out of range");
+    if ( fradius < 0 )
+        return RAISE(PyExc_ValueError, "negative radius");
+    if(!(fradius < INT_MAX / 2))
+        return RAISE(PyExc_ValueError, "radius out of range");
+    posx = (int)fx; posy = (int)fy;
+    radius = (int)fradius;
 
     surf = pgSurface_AsSurface(surfobj);
     if(surf->format->BytesPerPixel <= 0 || surf->format->BytesPerPixel > 4)
@@ -505,27 +681,36 @@ static PyObject* circle(PyObject* self, PyObject* arg)
     else
         return RAISE(PyExc_TypeError, "invalid color argument");
 
-    if ( radius < 0 )
-        return RAISE(PyExc_ValueError, "negative radius");
     if ( width < 0 )
         return RAISE(PyExc_ValueError, "negative width");
-    if ( width > radius )
+    if ( width > fradius )
         return RAISE(PyExc_ValueError, "width greater than radius");
 
+    if(antialias)
+    {
+        aa_path_init(&path);
+        aa_path_add_ellipse(&path, fx, fy, fradius, fradius, 1);
+        if(width)
+            aa_path_add_ellipse(&path, fx, fy, fradius - width, fradius - width, -1);
+        ret = draw_aapath(surfobj, &path, color, posx, posy);
+        aa_path_free(&path);
+        return ret;
+    }
 
     if(!pgSurface_Lock(surfobj)) return NULL;
+    draw_target_init(&target, surf, color);
 
     if(!width) {
-        draw_fillellipse(surf, (Sint16)posx, (Sint16)posy, (Sint16)radius, (Sint16)radius, color);
+        draw_fillellipse(&target, (Sint16)posx, (Sint16)posy, (Sint16)radius, (Sint16)radius);
     } else {
         for(loop=0; loop<width; ++loop) {
-            draw_ellipse(surf, posx, posy, radius-loop, radius-loop, color);
+            draw_ellipse(&target, posx, posy, radius-loop, radius-loop);
             /* To avoid moiré pattern. Don't do an extra one on the outer ellipse.
                We draw another ellipse offset by a pixel, over drawing the missed
                spots in the filled circle caused by which pixels are filled.
             */
             if (width > 1 && loop > 0)
-                draw_ellipse(surf, posx+1, posy, radius-loop, radius-loop, color);
+                draw_ellipse(&target, posx+1, posy, radius-loop, radius-loop);
         }
     }
 
@@ -539,21 +724,39 @@ static PyObject* circle(PyObject* self, PyObject* arg)
 }
 
 
-static PyObject* polygon(PyObject* self, PyObject* arg)
+static PyObject* polygon(PyObject* self, PyObject* arg, PyObject* kwds)
 {
     PyObject *surfobj, *colorobj, *points, *item;
     SDL_Surface* surf;
     Uint8 rgba[4];
     Uint32 color;
-    int width=0, length, loop, numpoints;
+    int width=0, nonzero=0, antialias=0, length, loop, numpoints;
     int *xlist, *ylist;
+    float *fxlist, *fylist, fx, fy;
     int x, y, top, left, bottom, right, result;
+    draw_target target;
+    static char *kwlist[] = {"Surface", "color", "pointlist", "width",
+                             "nonzero", "antialias", NULL};
 
     /*get all the arguments*/
-    if(!PyArg_ParseTuple(arg, "O!OO|i", &pgSurface_Type, &surfobj, &colorobj, &points, &width))
+    if(!PyArg_ParseTupleAndKeywords(arg, kwds, "O!OO|iii", kwlist, &pgSurface_Type,
+                                    &surfobj, &colorobj, &points, &width,
+                                    &nonzero, &antialias))
         return NULL;
 
 
+    if(width && antialias)
+    {
+        surf = pgSurface_AsSurface(surfobj);
+        if(pg_RGBAFromColorObj(colorobj, rgba))
+            color = SDL_MapRGBA(surf->format, rgba[0], rgba[1], rgba[2], rgba[3]);
+        else
+            return RAISE(PyExc_TypeError, "invalid color argument");
+        if(!PySequence_Check(points))
+            return RAISE(PyExc_TypeError, "points argument must be a sequence of number pairs");
+        return draw_aathicklines(surfobj, color, points, 1, (float)width, 0);
+    }
+
     if(width)
     {
         PyObject *args, *ret;
@@ -583,44 +786,98 @@ static PyObject* polygon(PyObject* self, PyObject* arg)
     if(length < 3)
         return RAISE(PyExc_ValueError, "points argument must contain more than 2 points");
 
+    if(antialias)
+    {
+        item = PySequence_GetItem(points, 0);
+        result = pg_TwoFloatsFromObj(item, &fx, &fy);
+        Py_DECREF(item);
+        if(!result) return RAISE(PyExc_TypeError, "points must be number pairs");
+        left = right = (int)floor(fx);
+        top = bottom = (int)floor(fy);
 
-    item = PySequence_GetItem(points, 0);
-    result = pg_TwoIntsFromObj(item, &x, &y);
-    Py_DECREF(item);
-    if(!result) return RAISE(PyExc_TypeError, "points must be number pairs");
-    left = right = x;
-    top = bottom = y;
+        fxlist = PyMem_New(float, length);
+        fylist = PyMem_New(float, length);
+        if(fxlist == NULL || fylist == NULL)
+        {
+            PyMem_Del(fxlist); PyMem_Del(fylist);
+            return PyErr_NoMemory();
+        }
+
+        numpoints = 0;
+        for(loop = 0; loop < length; ++loop)
+        {
+            item = PySequence_GetItem(points, loop);
+            result = pg_TwoFloatsFromObj(item, &fx, &fy);
+            Py_DECREF(item);
+            if(!result) continue; /*note, we silently skip over bad points :[ */
+            fxlist[numpoints] = fx;
+            fylist[numpoints] = fy;
+            ++numpoints;
+            left = MIN((int)floor(fx), left);
+            top = MIN((int)floor(fy), top);
+            right = MAX((int)ceil(fx), right);
+            bottom = MAX((int)ceil(fy), bottom);
+        }
 
-    xlist = PyMem_New(int, length);
-    ylist = PyMem_New(int, length);
+        if(!pgSurface_Lock(surfobj))
+        {
+            PyMem_Del(fxlist); PyMem_Del(fylist);
+            return NULL;
+        }
 
-    numpoints = 0;
-    for(loop = 0; loop < length; ++loop)
+        draw_aafillpath(surf, fxlist, fylist, &numpoints, 1, color, nonzero);
+
+        PyMem_Del(fxlist); PyMem_Del(fylist);
+    }
+    else
     {
-        item = PySequence_GetItem(points, loop);
+        item = PySequence_GetItem(points, 0);
         result = pg_TwoIntsFromObj(item, &x, &y);
         Py_DECREF(item);
-        if(!result) continue; /*note, we silently skip over bad points :[ */
-        xlist[numpoints] = x;
-        ylist[numpoints] = y;
-        ++numpoints;
-        left = MIN(x, left);
-        top = MIN(y, top);
-        right = MAX(x, right);
-        bottom = MAX(y, bottom);
-    }
+        if(!result) return RAISE(PyExc_TypeError, "points must be number pairs");
+        left = right = x;
+        top = bottom = y;
+
+        xlist = PyMem_New(int, length);
+        ylist = PyMem_New(int, length);
+        if(xlist == NULL || ylist == NULL)
+        {
+            PyMem_Del(xlist); PyMem_Del(ylist);
+            return PyErr_NoMemory();
+        }
+
+        numpoints = 0;
+        for(loop = 0; loop < length; ++loop)
+        {
+            item = PySequence_GetItem(points, loop);
+            result = pg_TwoIntsFromObj(item, &x, &y);
+            Py_DECREF(item);
+            if(!result) continue; /*note, we silently skip over bad points :[ */
+            xlist[numpoints] = x;
+            ylist[numpoints] = y;
+            ++numpoints;
+            left = MIN(x, left);
+            top = MIN(y, top);
+            right = MAX(x, right);
+            bottom = MAX(y, bottom);
+        }
+
+        if(!pgSurface_Lock(surfobj))
+        {
+            PyMem_Del(xlist); PyMem_Del(ylist);
+            return NULL;
+        }
+
+        draw_target_init(&target, surf, color);
+        draw_fillpoly(&target, xlist, ylist, numpoints, nonzero);
 
-    if(!pgSurface_Lock(surfobj))
-    {
         PyMem_Del(xlist); PyMem_Del(ylist);
-        return NULL;
     }
 
-    draw_fillpoly(surf, xlist, ylist, numpoints, color);
-
-    PyMem_Del(xlist); PyMem_Del(ylist);
     if(!pgSurface_Unlock(surfobj))
         return NULL;
+    if(PyErr_Occurred())
+        return NULL;
 
     left = MAX(left, surf->clip_rect.x);
     top = MAX(top, surf->clip_rect.y);
@@ -634,7 +891,11 @@ static PyObject* rect(PyObject* self, PyObject* arg)
 {
     PyObject *surfobj, *colorobj, *rectobj, *points, *args, *ret=NULL;
     GAME_Rect* rect, temp;
-    int t, l, b, r, width=0;
+    SDL_Surface* surf;
+    Uint8 rgba[4];
+    Uint32 color;
+    int t, l, b, r, width=0, y;
+    draw_target target;
 
     /*get all the arguments*/
     if(!PyArg_ParseTuple(arg, "O!OO|i", &pgSurface_Type, &surfobj, &colorobj, &rectobj, &width))
@@ -646,958 +907,2922 @@ static PyObject* rect(PyObject* self, PyObject* arg)
     l = rect->x; r = rect->x + rect->w - 1;
     t = rect->y; b = rect->y + rect->h - 1;
 
+    if(!width && rect->w > 0 && rect->h > 0)
+    {
+        /*filled rects go straight to the span writer, row by row*/
+        surf = pgSurface_AsSurface(surfobj);
+
+        if(surf->format->BytesPerPixel <= 0 || surf->format->BytesPerPixel > 4)
+            return RAISE(PyExc_ValueError, "unsupport bit depth for line draw");
+
+        if(PyInt_Check(colorobj))
+            color = (Uint32)PyInt_AsLong(colorobj);
+        else if(pg_RGBAFromColorObj(colorobj, rgba))
+            color = SDL_MapRGBA(surf->format, rgba[0], rgba[1], rgba[2], rgba[3]);
+        else
+            return RAISE(PyExc_TypeError, "invalid color argument");
+
+        if(!pgSurface_Lock(surfobj)) return NULL;
+        draw_target_init(&target, surf, color);
+
+        for(y = MAX(t, target.top); y <= MIN(b, target.bottom); ++y)
+            draw_hspan_clip(&target, l, r, y);
+
+        if(!pgSurface_Unlock(surfobj)) return NULL;
+
+        /*the filled part, the clip corners are inclusive*/
+        l = MAX(l, target.left);
+        t = MAX(t, target.top);
+        r = MIN(r, target.right);
+        b = MIN(b, target.bottom);
+        if(l > r || t > b)
+            return pgRect_New4(rect->x, rect->y, 0, 0);
+        return pgRect_New4(l, t, r-l+1, b-t+1);
+    }
+
     /*build the pointlist*/
     points = Py_BuildValue("((ii)(ii)(ii)(ii))", l, t, r, t, r, b, l, b);
 
     args = Py_BuildValue("(OONi)", surfobj, colorobj, points, width);
-    if(args) ret = polygon(NULL, args);
+    if(args) ret = polygon(NULL, args, NULL);
 
     Py_XDECREF(args);
     return ret;
 }
 
+/* Gets <obj> as a C contiguous buffer of numbers holding a multiple of
+ * <width> items, in <view> with its format letter in <fmt>. Integer
+ * items are read by their itemsize, as the size of a letter depends on
+ * the '@' or '=' prefix, floating point items must have the size of a C
+ * float or double. Returns 0 with an exception set on failure.
+ */
+static int draw_get_number_buffer(PyObject *obj, int width, Py_buffer *view,
+                                  char *fmt, const char *name)
+{
+    const char *format;
+    Py_ssize_t size;
 
+    if(PyObject_GetBuffer(obj, view, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) != 0)
+        return 0;
+    format = view->format != NULL ? view->format : "B";
+#if (SDL_BYTEORDER == SDL_LIL_ENDIAN)
+    if(*format == '@' || *format == '=' || *format == '<')
+#else
+    if(*format == '@' || *format == '=' || *format == '>' || *format == '!')
+#endif
+        ++format;
+    *fmt = format[0];
+    size = view->itemsize;
+    if(*fmt == '\0' || format[1] != '\0' ||
+       strchr("bBhHiIlLqQfd", *fmt) == NULL ||
+       (*fmt == 'f' && size != sizeof(float)) ||
+       (*fmt == 'd' && size != sizeof(double)) ||
+       (*fmt != 'f' && *fmt != 'd' &&
+        size != 1 && size != 2 && size != 4 && size != 8))
+    {
+        PyBuffer_Release(view);
+        PyErr_Format(PyExc_TypeError,
+                     "%s buffer must hold native numbers", name);
+        return 0;
+    }
+    if((view->len / size) % width != 0)
+    {
+        PyBuffer_Release(view);
+        PyErr_Format(PyExc_ValueError,
+                     "%s buffer length must be a multiple of %d",
+                     name, width);
+        return 0;
+    }
+    return 1;
+}
 
+/* Item <i> of a buffer from draw_get_number_buffer. */
+static double draw_buffer_item(Py_buffer *view, char fmt, Py_ssize_t i)
+{
+    const char *item = (const char*)view->buf + i * view->itemsize;
 
-/*internal drawing tools*/
+    if(fmt == 'f')
+        return *(const float*)item;
+    if(fmt == 'd')
+        return *(const double*)item;
+    if(fmt >= 'a')
+    {
+        switch(view->itemsize)
+        {
+        case 1: return *(const signed char*)item;
+        case 2: return *(const Sint16*)item;
+        case 4: return *(const Sint32*)item;
+        default: return (double)*(const PY_LONG_LONG*)item;
+        }
+    }
+    switch(view->itemsize)
+    {
+    case 1: return *(const Uint8*)item;
+    case 2: return *(const Uint16*)item;
+    case 4: return *(const Uint32*)item;
+    default: return (double)*(const unsigned PY_LONG_LONG*)item;
+    }
+}
 
-static int clip_and_draw_aaline(SDL_Surface* surf, SDL_Rect* rect, Uint32 color, float* pts, int blend)
+/* Reads <obj> as an array of ints, <width> per item, into a new PyMem
+ * array returned in <out> with the number of items in <count>. Buffers
+ * of any C integer or floating point format are read directly, values
+ * out of the int range are clamped, anything else must be a sequence.
+ * For a sequence each item is read as a number (width 1), a number pair
+ * (width 2) or a rect style value (width 4).
+ * Returns 0 with an exception set on failure.
+ */
+static int draw_read_ints(PyObject *obj, int width, int **out,
+                          Py_ssize_t *count, const char *name)
 {
-    if(!clipaaline(pts, rect->x+1, rect->y+1, rect->x+rect->w-2, rect->y+rect->h-2))
+    int *values, *v;
+    Py_ssize_t i, n, len;
+    PyObject *item;
+    GAME_Rect *r, temp;
+    double d;
+    int ok;
+
+    if(PyObject_CheckBuffer(obj))
+    {
+        Py_buffer view;
+        char fmt;
+
+        if(!draw_get_number_buffer(obj, width, &view, &fmt, name))
+            return 0;
+        len = view.len / view.itemsize;
+        values = PyMem_New(int, len ? len : 1);
+        if(values == NULL)
+        {
+            PyBuffer_Release(&view);
+            PyErr_NoMemory();
+            return 0;
+        }
+        for(i = 0; i < len; ++i)
+        {
+            /*nan ends up as INT_MAX, casting it would be undefined*/
+            d = draw_buffer_item(&view, fmt, i);
+            values[i] = d < INT_MAX ? (d > INT_MIN ? (int)d : INT_MIN) :
+                                      INT_MAX;
+        }
+        PyBuffer_Release(&view);
+        *out = values;
+        *count = len / width;
+        return 1;
+    }
+
+    if(!PySequence_Check(obj))
+    {
+        PyErr_Format(PyExc_TypeError,
+                     "%s must be a buffer or a sequence", name);
         return 0;
-    drawaaline(surf, color, pts[0], pts[1], pts[2], pts[3], blend);
+    }
+    n = PySequence_Length(obj);
+    if(n < 0)
+        return 0;
+    values = PyMem_New(int, n ? n * width : 1);
+    if(values == NULL)
+    {
+        PyErr_NoMemory();
+        return 0;
+    }
+    for(i = 0, v = values; i < n; ++i, v += width)
+    {
+        item = PySequence_GetItem(obj, i);
+        if(item == NULL)
+        {
+            PyMem_Del(values);
+            return 0;
+        }
+        if(width == 1)
+            ok = pg_IntFromObj(item, v);
+        else if(width == 2)
+            ok = pg_TwoIntsFromObj(item, v, v + 1);
+        else if((ok = (r = pgRect_FromObject(item, &temp)) != NULL))
+        {
+            v[0] = r->x; v[1] = r->y;
+            v[2] = r->w; v[3] = r->h;
+        }
+        Py_DECREF(item);
+        if(!ok)
+        {
+            PyMem_Del(values);
+            PyErr_Format(PyExc_TypeError, "%s item %d is invalid",
+                         name, (int)i);
+            return 0;
+        }
+    }
+    *out = values;
+    *count = n;
     return 1;
 }
 
-static int clip_and_draw_line(SDL_Surface* surf, SDL_Rect* rect, Uint32 color, int* pts)
+/* Reads <obj> as an array of floats, <width> per item, like
+ * draw_read_ints. Buffer values beyond the float range are clamped.
+ * For a sequence each item is read as a number (width 1) or a sequence
+ * of <width> numbers.
+ */
+static int draw_read_floats(PyObject *obj, int width, float **out,
+                            Py_ssize_t *count, const char *name)
 {
-    if(!clipline(pts, rect->x, rect->y, rect->x+rect->w-1, rect->y+rect->h-1))
+    float *values, *v;
+    Py_ssize_t i, n, len;
+    PyObject *item;
+    double d;
+    int j, ok;
+
+    if(PyObject_CheckBuffer(obj))
+    {
+        Py_buffer view;
+        char fmt;
+
+        if(!draw_get_number_buffer(obj, width, &view, &fmt, name))
+            return 0;
+        len = view.len / view.itemsize;
+        values = PyMem_New(float, len ? len : 1);
+        if(values == NULL)
+        {
+            PyBuffer_Release(&view);
+            PyErr_NoMemory();
+            return 0;
+        }
+        for(i = 0; i < len; ++i)
+        {
+            d = draw_buffer_item(&view, fmt, i);
+            values[i] = (float)(d > FLT_MAX ? FLT_MAX :
+                                (d < -FLT_MAX ? -FLT_MAX : d));
+        }
+        PyBuffer_Release(&view);
+        *out = values;
+        *count = len / width;
+        return 1;
+    }
+
+    if(!PySequence_Check(obj))
+    {
+        PyErr_Format(PyExc_TypeError,
+                     "%s must be a buffer or a sequence", name);
         return 0;
-    if(pts[1] == pts[3])
-        drawhorzline(surf, color, pts[0], pts[1], pts[2]);
-    else if(pts[0] == pts[2])
-        drawvertline(surf, color, pts[0], pts[1], pts[3]);
-    else
-        drawline(surf, color, pts[0], pts[1], pts[2], pts[3]);
+    }
+    n = PySequence_Length(obj);
+    if(n < 0)
+        return 0;
+    values = PyMem_New(float, n ? n * width : 1);
+    if(values == NULL)
+    {
+        PyErr_NoMemory();
+        return 0;
+    }
+    for(i = 0, v = values; i < n; ++i, v += width)
+    {
+        item = PySequence_GetItem(obj, i);
+        if(item == NULL)
+        {
+            PyMem_Del(values);
+            return 0;
+        }
+        if(width == 1)
+            ok = pg_FloatFromObj(item, v);
+        else
+        {
+            ok = PySequence_Check(item) && PySequence_Length(item) == width;
+            for(j = 0; ok && j < width; ++j)
+                ok = pg_FloatFromObjIndex(item, j, v + j);
+        }
+        Py_DECREF(item);
+        if(!ok)
+        {
+            PyMem_Del(values);
+            PyErr_Format(PyExc_TypeError, "%s item %d is invalid",
+                         name, (int)i);
+            return 0;
+        }
+    }
+    *out = values;
+    *count = n;
     return 1;
 }
 
-static int clip_and_draw_line_width(SDL_Surface* surf, SDL_Rect* rect, Uint32 color, int width, int* pts)
+/* Reads mapped colors from a buffer of numbers into a new PyMem array.
+ * Signed buffers hold the upper colors as negative numbers.
+ */
+static int draw_read_mapped_colors(PyObject *obj, Py_ssize_t count,
+                                   Uint32 **colors)
 {
-    int loop;
-    int xinc=0, yinc=0;
-    int newpts[4];
-    int range[4];
-    int anydrawn = 0;
-
-    if(abs(pts[0]-pts[2]) > abs(pts[1]-pts[3]))
-        yinc = 1;
-    else
-        xinc = 1;
+    Py_buffer view;
+    Uint32 *values;
+    Py_ssize_t i;
+    double d;
+    char fmt;
 
-    memcpy(newpts, pts, sizeof(int)*4);
-    if(clip_and_draw_line(surf, rect, color, newpts))
+    if(!draw_get_number_buffer(obj, 1, &view, &fmt, "colors"))
+        return 0;
+    if(view.len / view.itemsize != count)
     {
-        anydrawn = 1;
-        memcpy(range, newpts, sizeof(int)*4);
+        PyBuffer_Release(&view);
+        PyErr_SetString(PyExc_ValueError, "need one color for each shape");
+        return 0;
     }
-    else
+    values = PyMem_New(Uint32, count ? count : 1);
+    if(values == NULL)
     {
-        range[0] = range[1] = 10000;
-        range[2] = range[3] = -10000;
+        PyBuffer_Release(&view);
+        PyErr_NoMemory();
+        return 0;
+    }
+    for(i = 0; i < count; ++i)
+    {
+        d = draw_buffer_item(&view, fmt, i);
+        if(!(d > -2147483649.0 && d < 4294967296.0))
+        {
+            PyBuffer_Release(&view);
+            PyMem_Del(values);
+            PyErr_SetString(PyExc_ValueError,
+                            "mapped colors must fit in 32 bits");
+            return 0;
+        }
+        values[i] = d < 0 ? (Uint32)(Sint32)d : (Uint32)d;
     }
+    PyBuffer_Release(&view);
+    *colors = values;
+    return 1;
+}
 
-    for(loop = 1; loop < width; loop += 2)
+/* Reads the color argument of the batch functions. A single color leaves
+ * <colors> NULL and stores the mapped color in <color>. Otherwise
+ * <colors> is a new PyMem array of <count> mapped colors, read from a
+ * buffer of mapped integers or a sequence of colors.
+ * A Color or a tuple is a single color when it reads as one, a buffer
+ * always holds a color for each shape and any other sequence does when
+ * its length is <count>, so three mapped colors for three shapes are not
+ * taken for an RGB color.
+ */
+static int draw_read_colors(SDL_Surface *surf, PyObject *obj, Py_ssize_t count,
+                            Uint32 **colors, Uint32 *color)
+{
+    Uint8 rgba[4];
+    Uint32 *values;
+    Py_ssize_t i;
+    PyObject *item;
+    int ok;
+
+    *colors = NULL;
+    if(PyInt_Check(obj))
     {
-        newpts[0] = pts[0] + xinc*(loop/2+1);
-        newpts[1] = pts[1] + yinc*(loop/2+1);
-        newpts[2] = pts[2] + xinc*(loop/2+1);
-        newpts[3] = pts[3] + yinc*(loop/2+1);
-        if(clip_and_draw_line(surf, rect, color, newpts))
+        *color = (Uint32)PyInt_AsLong(obj);
+        return 1;
+    }
+    if((pgColor_Check(obj) || PyTuple_Check(obj)) &&
+       pg_RGBAFromColorObj(obj, rgba))
+    {
+        *color = SDL_MapRGBA(surf->format, rgba[0], rgba[1], rgba[2], rgba[3]);
+        return 1;
+    }
+    if(PyObject_CheckBuffer(obj))
+        return draw_read_mapped_colors(obj, count, colors);
+    if(!PySequence_Check(obj) || PySequence_Length(obj) != count)
+    {
+        PyErr_Clear();
+        if(pg_RGBAFromColorObj(obj, rgba))
         {
-            anydrawn = 1;
-            range[0] = MIN(newpts[0], range[0]);
-            range[1] = MIN(newpts[1], range[1]);
-            range[2] = MAX(newpts[2], range[2]);
-            range[3] = MAX(newpts[3], range[3]);
+            *color = SDL_MapRGBA(surf->format,
+                                 rgba[0], rgba[1], rgba[2], rgba[3]);
+            return 1;
         }
-        if(loop+1<width)
+        PyErr_SetString(PyExc_TypeError, "invalid color argument, expected "
+                        "a color or one color for each shape");
+        return 0;
+    }
+    values = PyMem_New(Uint32, count ? count : 1);
+    if(values == NULL)
+    {
+        PyErr_NoMemory();
+        return 0;
+    }
+    for(i = 0; i < count; ++i)
+    {
+        item = PySequence_GetItem(obj, i);
+        if(item == NULL)
         {
-            newpts[0] = pts[0] - xinc*(loop/2+1);
-            newpts[1] = pts[1] - yinc*(loop/2+1);
-            newpts[2] = pts[2] - xinc*(loop/2+1);
-            newpts[3] = pts[3] - yinc*(loop/2+1);
-            if(clip_and_draw_line(surf, rect, color, newpts))
-            {
-                anydrawn = 1;
-                range[0] = MIN(newpts[0], range[0]);
-                range[1] = MIN(newpts[1], range[1]);
-                range[2] = MAX(newpts[2], range[2]);
-                range[3] = MAX(newpts[3], range[3]);
-            }
+            PyMem_Del(values);
+            return 0;
+        }
+        ok = 1;
+        if(PyInt_Check(item))
+            values[i] = (Uint32)PyInt_AsLong(item);
+        else if(pg_RGBAFromColorObj(item, rgba))
+            values[i] = SDL_MapRGBA(surf->format, rgba[0], rgba[1], rgba[2], rgba[3]);
+        else
+            ok = 0;
+        Py_DECREF(item);
+        if(!ok)
+        {
+            PyMem_Del(values);
+            PyErr_SetString(PyExc_TypeError, "invalid color argument");
+            return 0;
         }
     }
-    if(anydrawn)
-        memcpy(pts, range, sizeof(int)*4);
-    return anydrawn;
+    *colors = values;
+    return 1;
 }
 
-
-/*this line clipping based heavily off of code from
-http://www.ncsa.uiuc.edu/Vis/Graphics/src/clipCohSuth.c */
-#define LEFT_EDGE   0x1
-#define RIGHT_EDGE  0x2
-#define BOTTOM_EDGE 0x4
-#define TOP_EDGE    0x8
-#define INSIDE(a)   (!a)
-#define REJECT(a,b) (a&b)
-#define ACCEPT(a,b) (!(a|b))
-
-static int encode(int x, int y, int left, int top, int right, int bottom)
+/* Grows the inclusive bounding box <box> to hold the given corners. */
+static void draw_union_bounds(int *box, int *any, int l, int t, int r, int b)
 {
-    int code = 0;
-    if(x < left)  code |= LEFT_EDGE;
-    if(x > right) code |= RIGHT_EDGE;
-    if(y < top)   code |= TOP_EDGE;
-    if(y > bottom)code |= BOTTOM_EDGE;
-    return code;
+    if(!*any)
+    {
+        box[0] = l; box[1] = t;
+        box[2] = r; box[3] = b;
+        *any = 1;
+        return;
+    }
+    box[0] = MIN(box[0], l);
+    box[1] = MIN(box[1], t);
+    box[2] = MAX(box[2], r);
+    box[3] = MAX(box[3], b);
 }
 
-static int encodeFloat(float x, float y, int left, int top, int right, int bottom)
+static PyObject* draw_batch_result(SDL_Surface *surf, int *box, int any)
 {
-    int code = 0;
-    if(x < left)  code |= LEFT_EDGE;
-    if(x > right) code |= RIGHT_EDGE;
-    if(y < top)   code |= TOP_EDGE;
-    if(y > bottom)code |= BOTTOM_EDGE;
-    return code;
+    if(!any)
+        return pgRect_New4(surf->clip_rect.x, surf->clip_rect.y, 0, 0);
+    return pgRect_New4(box[0], box[1], box[2] - box[0] + 1, box[3] - box[1] + 1);
 }
 
-static int clipaaline(float* pts, int left, int top, int right, int bottom)
+static PyObject* lines_batch(PyObject* self, PyObject* arg)
 {
-    float x1 = pts[0];
-    float y1 = pts[1];
-    float x2 = pts[2];
-    float y2 = pts[3];
-    int code1, code2;
-    int draw = 0;
-    float swaptmp;
-    int intswaptmp;
-    float m; /*slope*/
+    PyObject *surfobj, *colorobj, *segobj;
+    SDL_Surface* surf;
+    Uint32 color, *colors = NULL;
+    int *segs = NULL;
+    int width = 1, pts[4], box[4], any = 0;
+    Py_ssize_t count, i;
+    draw_target target;
 
-    while(1) {
-        code1 = encodeFloat(x1, y1, left, top, right, bottom);
-        code2 = encodeFloat(x2, y2, left, top, right, bottom);
-        if(ACCEPT(code1, code2)) {
-            draw = 1;
-            break;
+    /*get all the arguments*/
+    if(!PyArg_ParseTuple(arg, "O!OO|i", &pgSurface_Type, &surfobj, &colorobj, &segobj, &width))
+        return NULL;
+    surf = pgSurface_AsSurface(surfobj);
+
+    if(surf->format->BytesPerPixel <= 0 || surf->format->BytesPerPixel > 4)
+        return RAISE(PyExc_ValueError, "unsupport bit depth for line draw");
+
+    if(!draw_read_ints(segobj, 4, &segs, &count, "segments"))
+        return NULL;
+    if(!draw_read_colors(surf, colorobj, count, &colors, &color))
+    {
+        PyMem_Del(segs);
+        return NULL;
+    }
+
+    if(width >= 1 && count > 0)
+    {
+        if(!pgSurface_Lock(surfobj))
+        {
+            PyMem_Del(segs); PyMem_Del(colors);
+            return NULL;
         }
-        else if(REJECT(code1, code2)) {
-            break;
+        draw_target_init(&target, surf, color);
+        for(i = 0; i < count; ++i)
+        {
+            if(colors != NULL)
+                draw_target_set_color(&target, colors[i]);
+            memcpy(pts, segs + i * 4, sizeof(int) * 4);
+            if(clip_and_draw_line_width(&target, width, pts))
+                draw_union_bounds(box, &any, MIN(pts[0], pts[2]), MIN(pts[1], pts[3]),
+                                  MAX(pts[0], pts[2]), MAX(pts[1], pts[3]));
         }
-        else {
-            if(INSIDE(code1)) {
-                swaptmp = x2; x2 = x1; x1 = swaptmp;
-                swaptmp = y2; y2 = y1; y1 = swaptmp;
-                intswaptmp = code2; code2 = code1; code1 = intswaptmp;
-            }
-            if(x2 != x1)
-                m = (y2 - y1) / (x2 - x1);
-            else
-                m = 1.0f;
-            if(code1 & LEFT_EDGE) {
-                y1 += ((float)left - x1) * m;
-                x1 = (float)left;
-            }
-            else if(code1 & RIGHT_EDGE) {
-                y1 += ((float)right - x1) * m;
-                x1 = (float)right;
-            }
-            else if(code1 & BOTTOM_EDGE) {
-                if(x2 != x1)
-                    x1 += ((float)bottom - y1) / m;
-                y1 = (float)bottom;
-            }
-            else if(code1 & TOP_EDGE) {
-                if(x2 != x1)
-                    x1 += ((float)top - y1) / m;
-                y1 = (float)top;
-            }
+        if(!pgSurface_Unlock(surfobj))
+        {
+            PyMem_Del(segs); PyMem_Del(colors);
+            return NULL;
         }
     }
-    if(draw) {
-        pts[0] = x1; pts[1] = y1;
-        pts[2] = x2; pts[3] = y2;
-    }
-    return draw;
+
+    PyMem_Del(segs); PyMem_Del(colors);
+    return draw_batch_result(surf, box, any);
 }
 
-static int clipline(int* pts, int left, int top, int right, int bottom)
+static PyObject* circles(PyObject* self, PyObject* arg)
 {
-    int x1 = pts[0];
-    int y1 = pts[1];
-    int x2 = pts[2];
-    int y2 = pts[3];
-    int code1, code2;
-    int draw = 0;
-    int swaptmp;
-    float m; /*slope*/
+    PyObject *surfobj, *colorobj, *centerobj, *radiusobj;
+    SDL_Surface* surf;
+    Uint32 color, *colors = NULL;
+    int *centers = NULL, *radii = NULL, radius;
+    int width = 0, loop, box[4], any = 0;
+    int x, y, r;
+    Py_ssize_t count, nradii, i;
+    draw_target target;
 
-    while(1)
+    /*get all the arguments*/
+    if(!PyArg_ParseTuple(arg, "O!OOO|i", &pgSurface_Type, &surfobj, &colorobj,
+                         &centerobj, &radiusobj, &width))
+        return NULL;
+    surf = pgSurface_AsSurface(surfobj);
+
+    if(surf->format->BytesPerPixel <= 0 || surf->format->BytesPerPixel > 4)
+        return RAISE(PyExc_ValueError, "unsupport bit depth for drawing");
+    if(width < 0)
+        return RAISE(PyExc_ValueError, "negative width");
+
+    if(!draw_read_ints(centerobj, 2, &centers, &count, "centers"))
+        return NULL;
+    if(pg_IntFromObj(radiusobj, &radius))
+        nradii = 0;
+    else if(!draw_read_ints(radiusobj, 1, &radii, &nradii, "radii"))
+        goto error;
+    else if(nradii != count)
     {
-        code1 = encode(x1, y1, left, top, right, bottom);
-        code2 = encode(x2, y2, left, top, right, bottom);
-        if(ACCEPT(code1, code2)) {
-            draw = 1;
-            break;
+        PyErr_SetString(PyExc_ValueError, "need one radius for each center");
+        goto error;
+    }
+    for(i = 0; i < count; ++i)
+    {
+        r = radii ? radii[i] : radius;
+        if(r < 0)
+        {
+            PyErr_SetString(PyExc_ValueError, "negative radius");
+            goto error;
         }
-        else if(REJECT(code1, code2))
-            break;
-        else {
-            if(INSIDE(code1)) {
-                swaptmp = x2; x2 = x1; x1 = swaptmp;
-                swaptmp = y2; y2 = y1; y1 = swaptmp;
-                swaptmp = code2; code2 = code1; code1 = swaptmp;
-            }
-            if(x2 != x1)
-                m = (y2 - y1) / (float)(x2 - x1);
-            else
-                m = 1.0f;
-            if(code1 & LEFT_EDGE) {
-                y1 += (int)((left - x1) * m);
-                x1 = left;
-            }
-            else if(code1 & RIGHT_EDGE) {
-                y1 += (int)((right - x1) * m);
-                x1 = right;
-            }
-            else if(code1 & BOTTOM_EDGE) {
-                if(x2 != x1)
-                    x1 += (int)((bottom - y1) / m);
-                y1 = bottom;
-            }
-            else if(code1 & TOP_EDGE) {
-                if(x2 != x1)
-                    x1 += (int)((top - y1) / m);
-                y1 = top;
-            }
+        if(r < width)
+        {
+            PyErr_SetString(PyExc_ValueError, "width greater than radius");
+            goto error;
         }
     }
-    if(draw) {
-        pts[0] = x1; pts[1] = y1;
-        pts[2] = x2; pts[3] = y2;
+    if(!draw_read_colors(surf, colorobj, count, &colors, &color))
+        goto error;
+
+    if(!pgSurface_Lock(surfobj))
+        goto error;
+    draw_target_init(&target, surf, color);
+    for(i = 0; i < count; ++i)
+    {
+        x = centers[i * 2];
+        y = centers[i * 2 + 1];
+        r = radii ? radii[i] : radius;
+        if(x + r + 1 < target.left || x - r > target.right ||
+           y + r < target.top || y - r > target.bottom)
+            continue;
+        if(colors != NULL)
+            draw_target_set_color(&target, colors[i]);
+        if(!width)
+            draw_fillellipse(&target, (Sint16)x, (Sint16)y, (Sint16)r, (Sint16)r);
+        else
+        {
+            for(loop = 0; loop < width; ++loop)
+            {
+                draw_ellipse(&target, x, y, r - loop, r - loop);
+                /*same moire fix as circle()*/
+                if(width > 1 && loop > 0)
+                    draw_ellipse(&target, x + 1, y, r - loop, r - loop);
+            }
+        }
+        draw_union_bounds(box, &any, MAX(x - r, target.left), MAX(y - r, target.top),
+                          MIN(x + r, target.right), MIN(y + r, target.bottom));
     }
-    return draw;
-}
+    if(!pgSurface_Unlock(surfobj))
+        goto error;
 
+    PyMem_Del(centers); PyMem_Del(radii); PyMem_Del(colors);
+    return draw_batch_result(surf, box, any);
 
+error:
+    PyMem_Del(centers); PyMem_Del(radii); PyMem_Del(colors);
+    return NULL;
+}
 
-static int set_at(SDL_Surface* surf, int x, int y, Uint32 color)
+static PyObject* rects(PyObject* self, PyObject* arg)
 {
-    SDL_PixelFormat* format = surf->format;
-    Uint8* pixels = (Uint8*)surf->pixels;
-    Uint8* byte_buf, rgb[4];
+    PyObject *surfobj, *colorobj, *rectobj;
+    SDL_Surface* surf;
+    Uint32 color, *colors = NULL;
+    int *rectlist = NULL, *v;
+    int width = 0, box[4], any = 0;
+    int l, t, r, b, y, side, pts[4];
+    Py_ssize_t count, i;
+    draw_target target;
 
-    if(x < surf->clip_rect.x || x >= surf->clip_rect.x + surf->clip_rect.w ||
-       y < surf->clip_rect.y || y >= surf->clip_rect.y + surf->clip_rect.h)
-        return 0;
+    /*get all the arguments*/
+    if(!PyArg_ParseTuple(arg, "O!OO|i", &pgSurface_Type, &surfobj, &colorobj, &rectobj, &width))
+        return NULL;
+    surf = pgSurface_AsSurface(surfobj);
 
-    switch(format->BytesPerPixel)
+    if(surf->format->BytesPerPixel <= 0 || surf->format->BytesPerPixel > 4)
+        return RAISE(PyExc_ValueError, "unsupport bit depth for drawing");
+
+    if(!draw_read_ints(rectobj, 4, &rectlist, &count, "rects"))
+        return NULL;
+    if(!draw_read_colors(surf, colorobj, count, &colors, &color))
     {
-    case 1:
-        *((Uint8*)pixels + y * surf->pitch + x) = (Uint8)color;
-        break;
-    case 2:
-        *((Uint16*)(pixels + y * surf->pitch) + x) = (Uint16)color;
-        break;
-    case 4:
-        *((Uint32*)(pixels + y * surf->pitch) + x) = color;
-/*              *((Uint32*)(pixels + y * surf->pitch) + x) =
-                ~(*((Uint32*)(pixels + y * surf->pitch) + x)) * 31;
-*/              break;
-    default:/*case 3:*/
-        SDL_GetRGB(color, format, rgb, rgb+1, rgb+2);
-        byte_buf = (Uint8*)(pixels + y * surf->pitch) + x * 3;
-#if (SDL_BYTEORDER == SDL_LIL_ENDIAN)
-        *(byte_buf + (format->Rshift >> 3)) = rgb[0];
-        *(byte_buf + (format->Gshift >> 3)) = rgb[1];
-        *(byte_buf + (format->Bshift >> 3)) = rgb[2];
-#else
-        *(byte_buf + 2 - (format->Rshift >> 3)) = rgb[0];
-        *(byte_buf + 2 - (format->Gshift >> 3)) = rgb[1];
-        *(byte_buf + 2 - (format->Bshift >> 3)) = rgb[2];
-#endif
-        break;
+        PyMem_Del(rectlist);
+        return NULL;
     }
-    return 1;
-}
 
-#define DRAWPIX32(pixel,colorptr,br,blend) \
-    if (blend) { \
-        SDL_GetRGBA(*pixel, surf->format, &pixel_r, &pixel_g, &pixel_b, &pixel_a); \
-        tmp_r = color_r * br + pixel_r * nbr; \
-        tmp_g = color_g * br + pixel_g * nbr; \
-        tmp_b = color_b * br + pixel_b * nbr; \
-        tmp_a = color_a * br + pixel_a * nbr; \
-        *((Uint32*)pixel) = SDL_MapRGBA(surf->format, \
-            (Uint8)((tmp_r>254) ? 255: tmp_r), \
-            (Uint8)((tmp_g>254) ? 255: tmp_g), \
-            (Uint8)((tmp_b>254) ? 255: tmp_b), \
-            (Uint8)((tmp_a>254) ? 255: tmp_a)); \
-    } else { \
-        pixel[0]=(Uint8)(colorptr[0]*br); \
-        pixel[1]=(Uint8)(colorptr[1]*br); \
-        pixel[2]=(Uint8)(colorptr[2]*br); \
-        if(hasalpha) pixel[3] = br*255; \
+    if(!pgSurface_Lock(surfobj))
+    {
+        PyMem_Del(rectlist); PyMem_Del(colors);
+        return NULL;
+    }
+    draw_target_init(&target, surf, color);
+    for(i = 0, v = rectlist; i < count; ++i, v += 4)
+    {
+        if(v[2] <= 0 || v[3] <= 0)
+            continue;
+        l = v[0]; r = v[0] + v[2] - 1;
+        t = v[1]; b = v[1] + v[3] - 1;
+        if(colors != NULL)
+            draw_target_set_color(&target, colors[i]);
+        if(!width)
+        {
+            l = MAX(l, target.left); r = MIN(r, target.right);
+            t = MAX(t, target.top); b = MIN(b, target.bottom);
+            if(l > r || t > b)
+                continue;
+            for(y = t; y <= b; ++y)
+                target.hspan(&target, l, r, y);
+            draw_union_bounds(box, &any, l, t, r, b);
+        }
+        else
+        {
+            /*the four sides, in the order rect() draws them*/
+            for(side = 0; side < 4; ++side)
+            {
+                pts[0] = side == 0 || side == 3 ? l : r;
+                pts[1] = side < 2 ? t : b;
+                pts[2] = side < 2 ? r : l;
+                pts[3] = side == 0 || side == 3 ? t : b;
+                if(clip_and_draw_line_width(&target, width, pts))
+                    draw_union_bounds(box, &any, MIN(pts[0], pts[2]), MIN(pts[1], pts[3]),
+                                      MAX(pts[0], pts[2]), MAX(pts[1], pts[3]));
+            }
+        }
+    }
+    if(!pgSurface_Unlock(surfobj))
+    {
+        PyMem_Del(rectlist); PyMem_Del(colors);
+        return NULL;
     }
 
-/* Adapted from http://freespace.virgin.net/hugo.elias/graphics/x_wuline.htm */
-static void drawaaline(SDL_Surface* surf, Uint32 color, float x1, float y1, float x2, float y2, int blend) {
-    float grad, xd, yd;
-    float xgap, ygap, xend, yend, xf, yf;
-    float brightness1, brightness2;
-    float swaptmp;
-    int x, y, ix1, ix2, iy1, iy2;
-    int pixx, pixy;
-
-    /* for D-RAWPIX32 */
-    int tmp_r, tmp_g, tmp_b, tmp_a;
-    float nbr = 0.0f;
-    Uint8 pixel_r, pixel_g, pixel_b, pixel_a;
-    Uint8 color_r, color_g, color_b, color_a;
+    PyMem_Del(rectlist); PyMem_Del(colors);
+    return draw_batch_result(surf, box, any);
+}
 
-    Uint8* pixel;
-    Uint8* pm = (Uint8*)surf->pixels;
-    Uint8* colorptr = (Uint8*)&color;
-    const int hasalpha = surf->format->Amask;
+static PyObject* textured_triangles(PyObject* self, PyObject* arg, PyObject* kwds)
+{
+    PyObject *surfobj, *texobj, *vertobj, *uvobj, *indexobj = Py_None;
+    SDL_Surface *surf, *tex;
+    float *verts = NULL, *uvs = NULL, *pos[3], *uv[3];
+    int *indices = NULL, *bin_fill = NULL;
+    int perspective = 0, smooth = 1, width, box[4], any = 0;
+    int i, k, pass, tx, ty, tx1, ty1, tx2, ty2, ntris, count, size;
+    Py_ssize_t nverts, nuvs, nindices;
+    double area = 0;
+    tex_job job;
+    static char *kwlist[] = {"Surface", "texture", "vertices", "uvs", "indices",
+                             "perspective", "smooth", NULL};
 
-    if (hasalpha) {
-        SDL_GetRGBA(color, surf->format, &color_r, &color_g, &color_b, &color_a);
-    } else {
-        SDL_GetRGB(color, surf->format, &color_r, &color_g, &color_b);
-    }
-    pixx = surf->format->BytesPerPixel;
-    pixy = surf->pitch;
+    /*get all the arguments*/
+    if(!PyArg_ParseTupleAndKeywords(arg, kwds, "O!O!OO|Oii", kwlist,
+                                    &pgSurface_Type, &surfobj, &pgSurface_Type,
+                                    &texobj, &vertobj, &uvobj, &indexobj,
+                                    &perspective, &smooth))
+        return NULL;
+    surf = pgSurface_AsSurface(surfobj);
+    tex = pgSurface_AsSurface(texobj);
 
-    xd = x2-x1;
-    yd = y2-y1;
+    if(surf->format->BytesPerPixel <= 0 || surf->format->BytesPerPixel > 4 ||
+       tex->format->BytesPerPixel <= 0 || tex->format->BytesPerPixel > 4)
+        return RAISE(PyExc_ValueError, "unsupport bit depth for drawing");
+    if(tex->w <= 0 || tex->h <= 0)
+        return RAISE(PyExc_ValueError, "texture must not be empty");
 
-    if (xd == 0 && yd == 0)
+    width = perspective ? 3 : 2;
+    if(!draw_read_floats(vertobj, width, &verts, &nverts, "vertices"))
+        return NULL;
+    if(!draw_read_floats(uvobj, 2, &uvs, &nuvs, "uvs"))
     {
-        /* Single point. Due to the nature of the aaline clipping, this
-         * is less exact than the normal line. */
+        PyMem_Del(verts);
+        return NULL;
+    }
+    if(nuvs != nverts)
+    {
+        PyMem_Del(verts); PyMem_Del(uvs);
+        return RAISE(PyExc_ValueError, "need one uv for each vertex");
+    }
+    if(indexobj == Py_None)
+        nindices = nverts - nverts % 3;
+    else
+    {
+        if(!draw_read_ints(indexobj, 1, &indices, &nindices, "indices"))
+        {
+            PyMem_Del(verts); PyMem_Del(uvs);
+            return NULL;
+        }
+        if(nindices % 3 != 0)
+        {
+            PyMem_Del(verts); PyMem_Del(uvs); PyMem_Del(indices);
+            return RAISE(PyExc_ValueError,
+                         "indices length must be a multiple of 3");
+        }
+        for(i = 0; i < nindices; ++i)
+        {
+            if(indices[i] < 0 || indices[i] >= nverts)
+            {
+                PyMem_Del(verts); PyMem_Del(uvs); PyMem_Del(indices);
+                return RAISE(PyExc_IndexError, "vertex index out of range");
+            }
+        }
+    }
+    if(perspective)
+    {
+        for(i = 0; i < nverts; ++i)
+        {
+            if(!(verts[i * 3 + 2] > 0))
+            {
+                PyMem_Del(verts); PyMem_Del(uvs); PyMem_Del(indices);
+                return RAISE(PyExc_ValueError, "vertex w must be positive");
+            }
+        }
+    }
+
+    memset(&job, 0, sizeof(job));
+    job.surf = surf;
+    job.tw = tex->w;
+    job.th = tex->h;
+    job.perspective = perspective;
+    job.smooth = smooth;
+    ntris = (int)(nindices / 3);
+    job.tris = PyMem_New(tex_triangle, ntris ? ntris : 1);
+    job.texels = PyMem_New(Uint8, (size_t)job.tw * job.th * 4);
+    if(job.tris == NULL || job.texels == NULL)
+    {
+        PyMem_Del(verts); PyMem_Del(uvs); PyMem_Del(indices);
+        PyMem_Del(job.tris); PyMem_Del(job.texels);
+        return PyErr_NoMemory();
+    }
+
+    /*set up the visible triangles, keeping their order*/
+    count = 0;
+    for(i = 0; i < ntris; ++i)
+    {
+        for(k = 0; k < 3; ++k)
+        {
+            int index = indices != NULL ? indices[i * 3 + k] : i * 3 + k;
+            pos[k] = verts + index * width;
+            uv[k] = uvs + index * 2;
+        }
+        if(tex_setup_triangle(job.tris + count, pos, uv, perspective,
+                              &surf->clip_rect))
+        {
+            tex_triangle *tri = job.tris + count++;
+            draw_union_bounds(box, &any, tri->left, tri->top,
+                              tri->right, tri->bottom);
+            area += (double)(tri->right - tri->left + 1) *
+                    (tri->bottom - tri->top + 1);
+        }
+    }
+    PyMem_Del(verts); PyMem_Del(uvs); PyMem_Del(indices);
+    if(!count)
+    {
+        PyMem_Del(job.tris); PyMem_Del(job.texels);
+        return draw_batch_result(surf, box, any);
+    }
+
+    /*sort the triangles into the tiles they touch*/
+    job.left = box[0]; job.top = box[1];
+    job.right = box[2]; job.bottom = box[3];
+    job.tiles_x = (job.right - job.left) / TEX_TILE + 1;
+    job.tiles = job.tiles_x * ((job.bottom - job.top) / TEX_TILE + 1);
+    job.bin_start = PyMem_New(int, job.tiles + 1);
+    bin_fill = PyMem_New(int, job.tiles);
+    if(job.bin_start == NULL || bin_fill == NULL)
+    {
+        PyMem_Del(job.tris); PyMem_Del(job.texels);
+        PyMem_Del(job.bin_start); PyMem_Del(bin_fill);
+        return PyErr_NoMemory();
+    }
+    memset(bin_fill, 0, job.tiles * sizeof(int));
+    for(pass = 0; pass < 2; ++pass)
+    {
+        for(i = 0; i < count; ++i)
+        {
+            tex_triangle *tri = job.tris + i;
+            tx1 = (tri->left - job.left) / TEX_TILE;
+            tx2 = (tri->right - job.left) / TEX_TILE;
+            ty1 = (tri->top - job.top) / TEX_TILE;
+            ty2 = (tri->bottom - job.top) / TEX_TILE;
+            for(ty = ty1; ty <= ty2; ++ty)
+            {
+                for(tx = tx1; tx <= tx2; ++tx)
+                {
+                    k = ty * job.tiles_x + tx;
+                    if(pass)
+                        job.bins[job.bin_start[k] + bin_fill[k]] = i;
+                    ++bin_fill[k];
+                }
+            }
+        }
+        if(pass)
+            break;
+        size = 0;
+        for(k = 0; k < job.tiles; ++k)
+        {
+            job.bin_start[k] = size;
+            size += bin_fill[k];
+            bin_fill[k] = 0;
+        }
+        job.bin_start[job.tiles] = size;
+        job.bins = PyMem_New(int, size);
+        if(job.bins == NULL)
+        {
+            PyMem_Del(job.tris); PyMem_Del(job.texels);
+            PyMem_Del(job.bin_start); PyMem_Del(bin_fill);
+            return PyErr_NoMemory();
+        }
+    }
+    PyMem_Del(bin_fill);
+
+    if(!pgSurface_Lock(texobj))
+    {
+        tex_job_free(&job);
+        return NULL;
+    }
+    tex_read_texture(tex, job.texels);
+    if(!pgSurface_Unlock(texobj) || !pgSurface_Lock(surfobj))
+    {
+        tex_job_free(&job);
+        return NULL;
+    }
+    job.threads = tex_thread_count(job.tiles, area);
+    Py_BEGIN_ALLOW_THREADS;
+    tex_draw(&job);
+    Py_END_ALLOW_THREADS;
+    tex_job_free(&job);
+    if(!pgSurface_Unlock(surfobj))
+        return NULL;
+
+    return draw_batch_result(surf, box, any);
+}
+
+
+
+
+/*internal drawing tools*/
+
+static int clip_and_draw_aaline(SDL_Surface* surf, SDL_Rect* rect, Uint32 color, float* pts, int blend)
+{
+    if(!clipaaline(pts, rect->x+1, rect->y+1, rect->x+rect->w-2, rect->y+rect->h-2))
+        return 0;
+    drawaaline(surf, color, pts[0], pts[1], pts[2], pts[3], blend);
+    return 1;
+}
+
+static int clip_and_draw_line(draw_target *t, int* pts)
+{
+    if(!clipline(pts, t->left, t->top, t->right, t->bottom))
+        return 0;
+    if(pts[1] == pts[3])
+        t->hspan(t, MIN(pts[0], pts[2]), MAX(pts[0], pts[2]), pts[1]);
+    else if(pts[0] == pts[2])
+        t->vspan(t, pts[0], MIN(pts[1], pts[3]), MAX(pts[1], pts[3]));
+    else
+        drawline(t, pts[0], pts[1], pts[2], pts[3]);
+    return 1;
+}
+
+/* Draws the thick line as one span across the width per step of the
+ * center line. Only used when the whole line is inside the clip rect,
+ * where this covers exactly the pixels of the offset lines.
+ */
+static void drawline_width(draw_target *t, int width, int *pts)
+{
+    int x1 = pts[0], y1 = pts[1], x2 = pts[2], y2 = pts[3];
+    int pos = width / 2, neg = (width - 1) / 2;
+    int deltax, deltay, signx, signy;
+    int e = 0, n;
+
+    deltax = x2 - x1;
+    deltay = y2 - y1;
+    signx = (deltax < 0) ? -1 : 1;
+    signy = (deltay < 0) ? -1 : 1;
+    deltax = signx * deltax + 1;
+    deltay = signy * deltay + 1;
+
+    if(deltax > deltay)
+    {
+        for(n = 0; n < deltax; ++n, x1 += signx) {
+            t->vspan(t, x1, y1 - neg, y1 + pos);
+            e += deltay; if(e >= deltax) {e -= deltax; y1 += signy;}
+        }
+    }
+    else
+    {
+        for(n = 0; n < deltay; ++n, y1 += signy) {
+            t->hspan(t, x1 - neg, x1 + pos, y1);
+            e += deltax; if(e >= deltay) {e -= deltay; x1 += signx;}
+        }
+    }
+}
+
+static int clip_and_draw_line_width(draw_target *t, int width, int* pts)
+{
+    int loop;
+    int xinc=0, yinc=0;
+    int newpts[4];
+    int range[4];
+    int anydrawn = 0;
+    int inside = 0;
+
+    if(abs(pts[0]-pts[2]) > abs(pts[1]-pts[3]))
+        yinc = 1;
+    else
+        xinc = 1;
+
+    if(width > 1)
+    {
+        int pos = width / 2, neg = (width - 1) / 2;
+        inside = MIN(pts[0], pts[2]) - xinc * neg >= t->left &&
+                 MAX(pts[0], pts[2]) + xinc * pos <= t->right &&
+                 MIN(pts[1], pts[3]) - yinc * neg >= t->top &&
+                 MAX(pts[1], pts[3]) + yinc * pos <= t->bottom;
+        if(inside)
+            drawline_width(t, width, pts);
+    }
+
+    /* with the fast path taken the loop below only computes the extent */
+    memcpy(newpts, pts, sizeof(int)*4);
+    if(inside || clip_and_draw_line(t, newpts))
+    {
+        anydrawn = 1;
+        memcpy(range, newpts, sizeof(int)*4);
+    }
+    else
+    {
+        range[0] = range[1] = 10000;
+        range[2] = range[3] = -10000;
+    }
+
+    for(loop = 1; loop < width; loop += 2)
+    {
+        newpts[0] = pts[0] + xinc*(loop/2+1);
+        newpts[1] = pts[1] + yinc*(loop/2+1);
+        newpts[2] = pts[2] + xinc*(loop/2+1);
+        newpts[3] = pts[3] + yinc*(loop/2+1);
+        if(inside || clip_and_draw_line(t, newpts))
+        {
+            anydrawn = 1;
+            range[0] = MIN(newpts[0], range[0]);
+            range[1] = MIN(newpts[1], range[1]);
+            range[2] = MAX(newpts[2], range[2]);
+            range[3] = MAX(newpts[3], range[3]);
+        }
+        if(loop+1<width)
+        {
+            newpts[0] = pts[0] - xinc*(loop/2+1);
+            newpts[1] = pts[1] - yinc*(loop/2+1);
+            newpts[2] = pts[2] - xinc*(loop/2+1);
+            newpts[3] = pts[3] - yinc*(loop/2+1);
+            if(inside || clip_and_draw_line(t, newpts))
+            {
+                anydrawn = 1;
+                range[0] = MIN(newpts[0], range[0]);
+                range[1] = MIN(newpts[1], range[1]);
+                range[2] = MAX(newpts[2], range[2]);
+                range[3] = MAX(newpts[3], range[3]);
+            }
+        }
+    }
+    if(anydrawn)
+        memcpy(pts, range, sizeof(int)*4);
+    return anydrawn;
+}
+
+
+/*this line clipping based heavily off of code from
+http://www.ncsa.uiuc.edu/Vis/Graphics/src/clipCohSuth.c */
+#define LEFT_EDGE   0x1
+#define RIGHT_EDGE  0x2
+#define BOTTOM_EDGE 0x4
+#define TOP_EDGE    0x8
+#define INSIDE(a)   (!a)
+#define REJECT(a,b) (a&b)
+#define ACCEPT(a,b) (!(a|b))
+
+static int encode(int x, int y, int left, int top, int right, int bottom)
+{
+    int code = 0;
+    if(x < left)  code |= LEFT_EDGE;
+    if(x > right) code |= RIGHT_EDGE;
+    if(y < top)   code |= TOP_EDGE;
+    if(y > bottom)code |= BOTTOM_EDGE;
+    return code;
+}
+
+static int encodeFloat(float x, float y, int left, int top, int right, int bottom)
+{
+    int code = 0;
+    if(x < left)  code |= LEFT_EDGE;
+    if(x > right) code |= RIGHT_EDGE;
+    if(y < top)   code |= TOP_EDGE;
+    if(y > bottom)code |= BOTTOM_EDGE;
+    return code;
+}
+
+static int clipaaline(float* pts, int left, int top, int right, int bottom)
+{
+    float x1 = pts[0];
+    float y1 = pts[1];
+    float x2 = pts[2];
+    float y2 = pts[3];
+    int code1, code2;
+    int draw = 0;
+    float swaptmp;
+    int intswaptmp;
+    float m; /*slope*/
+
+    while(1) {
+        code1 = encodeFloat(x1, y1, left, top, right, bottom);
+        code2 = encodeFloat(x2, y2, left, top, right, bottom);
+        if(ACCEPT(code1, code2)) {
+            draw = 1;
+            break;
+        }
+        else if(REJECT(code1, code2)) {
+            break;
+        }
+        else {
+            if(INSIDE(code1)) {
+                swaptmp = x2; x2 = x1; x1 = swaptmp;
+                swaptmp = y2; y2 = y1; y1 = swaptmp;
+                intswaptmp = code2; code2 = code1; code1 = intswaptmp;
+            }
+            if(x2 != x1)
+                m = (y2 - y1) / (x2 - x1);
+            else
+                m = 1.0f;
+            if(code1 & LEFT_EDGE) {
+                y1 += ((float)left - x1) * m;
+                x1 = (float)left;
+            }
+            else if(code1 & RIGHT_EDGE) {
+                y1 += ((float)right - x1) * m;
+                x1 = (float)right;
+            }
+            else if(code1 & BOTTOM_EDGE) {
+                if(x2 != x1)
+                    x1 += ((float)bottom - y1) / m;
+                y1 = (float)bottom;
+            }
+            else if(code1 & TOP_EDGE) {
+                if(x2 != x1)
+                    x1 += ((float)top - y1) / m;
+                y1 = (float)top;
+            }
+        }
+    }
+    if(draw) {
+        pts[0] = x1; pts[1] = y1;
+        pts[2] = x2; pts[3] = y2;
+    }
+    return draw;
+}
+
+static int clipline(int* pts, int left, int top, int right, int bottom)
+{
+    int x1 = pts[0];
+    int y1 = pts[1];
+    int x2 = pts[2];
+    int y2 = pts[3];
+    int code1, code2;
+    int draw = 0;
+    int swaptmp;
+    float m; /*slope*/
+
+    while(1)
+    {
+        code1 = encode(x1, y1, left, top, right, bottom);
+        code2 = encode(x2, y2, left, top, right, bottom);
+        if(ACCEPT(code1, code2)) {
+            draw = 1;
+            break;
+        }
+        else if(REJECT(code1, code2))
+            break;
+        else {
+            if(INSIDE(code1)) {
+                swaptmp = x2; x2 = x1; x1 = swaptmp;
+                swaptmp = y2; y2 = y1; y1 = swaptmp;
+                swaptmp = code2; code2 = code1; code1 = swaptmp;
+            }
+            if(x2 != x1)
+                m = (y2 - y1) / (float)(x2 - x1);
+            else
+                m = 1.0f;
+            if(code1 & LEFT_EDGE) {
+                y1 += (int)((left - x1) * m);
+                x1 = left;
+            }
+            else if(code1 & RIGHT_EDGE) {
+                y1 += (int)((right - x1) * m);
+                x1 = right;
+            }
+            else if(code1 & BOTTOM_EDGE) {
+                if(x2 != x1)
+                    x1 += (int)((bottom - y1) / m);
+                y1 = bottom;
+            }
+            else if(code1 & TOP_EDGE) {
+                if(x2 != x1)
+                    x1 += (int)((top - y1) / m);
+                y1 = top;
+            }
+        }
+    }
+    if(draw) {
+        pts[0] = x1; pts[1] = y1;
+        pts[2] = x2; pts[3] = y2;
+    }
+    return draw;
+}
+
+
+
+static int set_at(SDL_Surface* surf, int x, int y, Uint32 color)
+{
+    SDL_PixelFormat* format = surf->format;
+    Uint8* pixels = (Uint8*)surf->pixels;
+    Uint8* byte_buf, rgb[4];
+
+    if(x < surf->clip_rect.x || x >= surf->clip_rect.x + surf->clip_rect.w ||
+       y < surf->clip_rect.y || y >= surf->clip_rect.y + surf->clip_rect.h)
+        return 0;
+
+    switch(format->BytesPerPixel)
+    {
+    case 1:
+        *((Uint8*)pixels + y * surf->pitch + x) = (Uint8)color;
+        break;
+    case 2:
+        *((Uint16*)(pixels + y * surf->pitch) + x) = (Uint16)color;
+        break;
+    case 4:
+        *((Uint32*)(pixels + y * surf->pitch) + x) = color;
+/*              *((Uint32*)(pixels + y * surf->pitch) + x) =
+                ~(*((Uint32*)(pixels + y * surf->pitch) + x)) * 31;
+*/              break;
+    default:/*case 3:*/
+        SDL_GetRGB(color, format, rgb, rgb+1, rgb+2);
+        byte_buf = (Uint8*)(pixels + y * surf->pitch) + x * 3;
+#if (SDL_BYTEORDER == SDL_LIL_ENDIAN)
+        *(byte_buf + (format->Rshift >> 3)) = rgb[0];
+        *(byte_buf + (format->Gshift >> 3)) = rgb[1];
+        *(byte_buf + (format->Bshift >> 3)) = rgb[2];
+#else
+        *(byte_buf + 2 - (format->Rshift >> 3)) = rgb[0];
+        *(byte_buf + 2 - (format->Gshift >> 3)) = rgb[1];
+        *(byte_buf + 2 - (format->Bshift >> 3)) = rgb[2];
+#endif
+        break;
+    }
+    return 1;
+}
+
+#define DRAWPIX32(pixel,colorptr,br,blend) \
+    if (blend) { \
+        SDL_GetRGBA(*pixel, surf->format, &pixel_r, &pixel_g, &pixel_b, &pixel_a); \
+        tmp_r = color_r * br + pixel_r * nbr; \
+        tmp_g = color_g * br + pixel_g * nbr; \
+        tmp_b = color_b * br + pixel_b * nbr; \
+        tmp_a = color_a * br + pixel_a * nbr; \
+        *((Uint32*)pixel) = SDL_MapRGBA(surf->format, \
+            (Uint8)((tmp_r>254) ? 255: tmp_r), \
+            (Uint8)((tmp_g>254) ? 255: tmp_g), \
+            (Uint8)((tmp_b>254) ? 255: tmp_b), \
+            (Uint8)((tmp_a>254) ? 255: tmp_a)); \
+    } else { \
+        pixel[0]=(Uint8)(colorptr[0]*br); \
+        pixel[1]=(Uint8)(colorptr[1]*br); \
+        pixel[2]=(Uint8)(colorptr[2]*br); \
+        if(hasalpha) pixel[3] = br*255; \
+    }
+
+/* Adapted from http://freespace.virgin.net/hugo.elias/graphics/x_wuline.htm */
+static void drawaaline(SDL_Surface* surf, Uint32 color, float x1, float y1, float x2, float y2, int blend) {
+    float grad, xd, yd;
+    float xgap, ygap, xend, yend, xf, yf;
+    float brightness1, brightness2;
+    float swaptmp;
+    int x, y, ix1, ix2, iy1, iy2;
+    int pixx, pixy;
+
+    /* for D-RAWPIX32 */
+    int tmp_r, tmp_g, tmp_b, tmp_a;
+    float nbr = 0.0f;
+    Uint8 pixel_r, pixel_g, pixel_b, pixel_a;
+    Uint8 color_r, color_g, color_b, color_a;
+
+    Uint8* pixel;
+    Uint8* pm = (Uint8*)surf->pixels;
+    Uint8* colorptr = (Uint8*)&color;
+    const int hasalpha = surf->format->Amask;
+
+    if (hasalpha) {
+        SDL_GetRGBA(color, surf->format, &color_r, &color_g, &color_b, &color_a);
+    } else {
+        SDL_GetRGB(color, surf->format, &color_r, &color_g, &color_b);
+    }
+    pixx = surf->format->BytesPerPixel;
+    pixy = surf->pitch;
+
+    xd = x2-x1;
+    yd = y2-y1;
+
+    if (xd == 0 && yd == 0)
+    {
+        /* Single point. Due to the nature of the aaline clipping, this
+         * is less exact than the normal line. */
         set_at (surf, x1, y1, color);
         return;
     }
 
-    if(fabs(xd)>fabs(yd)) {
-        if(x1>x2) {
-            swaptmp=x1; x1=x2; x2=swaptmp;
-            swaptmp=y1; y1=y2; y2=swaptmp;
-            xd = (x2-x1);
-            yd = (y2-y1);
+    if(fabs(xd)>fabs(yd)) {
+        if(x1>x2) {
+            swaptmp=x1; x1=x2; x2=swaptmp;
+            swaptmp=y1; y1=y2; y2=swaptmp;
+            xd = (x2-x1);
+            yd = (y2-y1);
+        }
+        grad = yd/xd;
+        xend = trunc(x1)+0.5; /* This makes more sense than trunc(x1+0.5) */
+        yend = y1+grad*(xend-x1);
+        xgap = INVFRAC(x1);
+        ix1 = (int)xend;
+        iy1 = (int)yend;
+        yf = yend+grad;
+        brightness1 = INVFRAC(yend) * xgap;
+        brightness2 =    FRAC(yend) * xgap;
+        pixel = pm + pixx * ix1 + pixy * iy1;
+        DRAWPIX32(pixel, colorptr, brightness1, blend)
+            pixel += pixy;
+        DRAWPIX32(pixel, colorptr, brightness2, blend)
+            xend = trunc(x2)+0.5;
+        yend = y2+grad*(xend-x2);
+        xgap =    FRAC(x2); /* this also differs from Hugo's description. */
+        ix2 = (int)xend;
+        iy2 = (int)yend;
+        brightness1 = INVFRAC(yend) * xgap;
+        brightness2 =    FRAC(yend) * xgap;
+        pixel = pm + pixx * ix2 + pixy * iy2;
+        DRAWPIX32(pixel, colorptr, brightness1, blend)
+            pixel += pixy;
+        DRAWPIX32(pixel, colorptr, brightness2, blend)
+            for(x=ix1+1; x<ix2; ++x) {
+                brightness1=INVFRAC(yf);
+                brightness2=   FRAC(yf);
+                pixel = pm + pixx * x + pixy * (int)yf;
+                DRAWPIX32(pixel, colorptr, brightness1, blend)
+                    pixel += pixy;
+                DRAWPIX32(pixel, colorptr, brightness2, blend)
+                    yf += grad;
+            }
+    }
+    else {
+        if(y1>y2) {
+            swaptmp=y1; y1=y2; y2=swaptmp;
+            swaptmp=x1; x1=x2; x2=swaptmp;
+            yd = (y2-y1);
+            xd = (x2-x1);
+        }
+        grad = xd/yd;
+        yend = trunc(y1)+0.5;  /* This makes more sense than trunc(x1+0.5) */
+        xend = x1+grad*(yend-y1);
+        ygap = INVFRAC(y1);
+        iy1 = (int)yend;
+        ix1 = (int)xend;
+        xf = xend+grad;
+        brightness1 = INVFRAC(xend) * ygap;
+        brightness2 =    FRAC(xend) * ygap;
+        pixel = pm + pixx * ix1 + pixy * iy1;
+        DRAWPIX32(pixel, colorptr, brightness1, blend)
+            pixel += pixx;
+        DRAWPIX32(pixel, colorptr, brightness2, blend)
+            yend = trunc(y2)+0.5;
+        xend = x2+grad*(yend-y2);
+        ygap = FRAC(y2);
+        iy2 = (int)yend;
+        ix2 = (int)xend;
+        brightness1 = INVFRAC(xend) * ygap;
+        brightness2 =    FRAC(xend) * ygap;
+        pixel = pm + pixx * ix2 + pixy * iy2;
+        DRAWPIX32(pixel, colorptr, brightness1, blend)
+            pixel += pixx;
+        DRAWPIX32(pixel, colorptr, brightness2, blend)
+            for(y=iy1+1; y<iy2; ++y) {
+                brightness1=INVFRAC(xf);
+                brightness2=   FRAC(xf);
+                pixel = pm + pixx * (int)xf + pixy * y;
+                DRAWPIX32(pixel, colorptr, brightness1, blend)
+                    pixel += pixx;
+                DRAWPIX32(pixel, colorptr, brightness2, blend)
+                    xf += grad;
+            }
+    }
+}
+
+
+/*here's my sdl'ized version of bresenham*/
+static void drawline(draw_target *t, int x1, int y1, int x2, int y2)
+{
+    int deltax, deltay, signx, signy;
+    int pixx, pixy;
+    int x = 0, y = 0;
+    int swaptmp;
+    Uint8 *pixel;
+    Uint32 color = t->color;
+
+    deltax = x2 - x1;
+    deltay = y2 - y1;
+    signx = (deltax < 0) ? -1 : 1;
+    signy = (deltay < 0) ? -1 : 1;
+    deltax = signx * deltax + 1;
+    deltay = signy * deltay + 1;
+
+    pixx = t->bpp;
+    pixy = t->pitch;
+    pixel = t->pixels + pixx * x1 + pixy * y1;
+
+    pixx *= signx;
+    pixy *= signy;
+    if(deltax < deltay) /*swap axis if rise > run*/
+    {
+        swaptmp = deltax; deltax = deltay; deltay = swaptmp;
+        swaptmp = pixx; pixx = pixy; pixy = swaptmp;
+    }
+
+    switch(t->bpp)
+    {
+    case 1:
+        for(; x < deltax; x++, pixel += pixx) {
+            *pixel = (Uint8)color;
+            y += deltay; if(y >= deltax) {y -= deltax; pixel += pixy;}
+        }break;
+    case 2:
+        for(; x < deltax; x++, pixel += pixx) {
+            *(Uint16*)pixel = (Uint16)color;
+            y += deltay; if(y >= deltax) {y -= deltax; pixel += pixy;}
+        }break;
+    case 3:
+        for(; x < deltax; x++, pixel += pixx) {
+            pixel[0] = t->color3[0];
+            pixel[1] = t->color3[1];
+            pixel[2] = t->color3[2];
+            y += deltay; if(y >= deltax) {y -= deltax; pixel += pixy;}
+        }break;
+    default: /*case 4*/
+        for(; x < deltax; x++, pixel += pixx) {
+            *(Uint32*)pixel = (Uint32)color;
+            y += deltay; if(y >= deltax) {y -= deltax; pixel += pixy;}
+        }break;
+    }
+}
+
+
+
+/* Pixel writers specialized for each pixel size. The writers do no
+ * clipping; everything passed to them must be inside the clip rect.
+ */
+static void draw_pixel_1(draw_target *t, int x, int y)
+{
+    *(t->pixels + y * t->pitch + x) = (Uint8)t->color;
+}
+
+static void draw_pixel_2(draw_target *t, int x, int y)
+{
+    *((Uint16*)(t->pixels + y * t->pitch) + x) = (Uint16)t->color;
+}
+
+static void draw_pixel_3(draw_target *t, int x, int y)
+{
+    Uint8 *pixel = t->pixels + y * t->pitch + x * 3;
+    pixel[0] = t->color3[0];
+    pixel[1] = t->color3[1];
+    pixel[2] = t->color3[2];
+}
+
+static void draw_pixel_4(draw_target *t, int x, int y)
+{
+    *((Uint32*)(t->pixels + y * t->pitch) + x) = t->color;
+}
+
+static void draw_hspan_1(draw_target *t, int x1, int x2, int y)
+{
+    memset(t->pixels + y * t->pitch + x1, (Uint8)t->color, x2 - x1 + 1);
+}
+
+static void draw_hspan_2(draw_target *t, int x1, int x2, int y)
+{
+    Uint16 *pixel = (Uint16*)(t->pixels + y * t->pitch) + x1;
+    Uint16 *end = pixel + (x2 - x1) + 1;
+    Uint16 color = (Uint16)t->color;
+#ifdef PG_DRAW_SSE2
+    __m128i fill;
+
+    if (end - pixel >= 16) {
+        while (((size_t)pixel & 15) && pixel < end)
+            *pixel++ = color;
+        fill = _mm_set1_epi16((short)color);
+        for (; end - pixel >= 8; pixel += 8)
+            _mm_store_si128((__m128i*)pixel, fill);
+    }
+#endif
+    while (pixel < end)
+        *pixel++ = color;
+}
+
+static void draw_hspan_3(draw_target *t, int x1, int x2, int y)
+{
+    Uint8 *pixel = t->pixels + y * t->pitch + x1 * 3;
+    Uint8 *end = pixel + (x2 - x1) * 3;
+    Uint8 c0 = t->color3[0], c1 = t->color3[1], c2 = t->color3[2];
+
+    for (; pixel <= end; pixel += 3) {
+        pixel[0] = c0;
+        pixel[1] = c1;
+        pixel[2] = c2;
+    }
+}
+
+static void draw_hspan_4(draw_target *t, int x1, int x2, int y)
+{
+    Uint32 *pixel = (Uint32*)(t->pixels + y * t->pitch) + x1;
+    Uint32 *end = pixel + (x2 - x1) + 1;
+    Uint32 color = t->color;
+#ifdef PG_DRAW_SSE2
+    __m128i fill;
+
+    if (end - pixel >= 8) {
+        while (((size_t)pixel & 15) && pixel < end)
+            *pixel++ = color;
+        fill = _mm_set1_epi32((int)color);
+        for (; end - pixel >= 4; pixel += 4)
+            _mm_store_si128((__m128i*)pixel, fill);
+    }
+#endif
+    while (pixel < end)
+        *pixel++ = color;
+}
+
+static void draw_vspan_1(draw_target *t, int x, int y1, int y2)
+{
+    Uint8 *pixel = t->pixels + y1 * t->pitch + x;
+    Uint8 color = (Uint8)t->color;
+
+    for (; y1 <= y2; ++y1, pixel += t->pitch)
+        *pixel = color;
+}
+
+static void draw_vspan_2(draw_target *t, int x, int y1, int y2)
+{
+    Uint8 *pixel = t->pixels + y1 * t->pitch + x * 2;
+    Uint16 color = (Uint16)t->color;
+
+    for (; y1 <= y2; ++y1, pixel += t->pitch)
+        *(Uint16*)pixel = color;
+}
+
+static void draw_vspan_3(draw_target *t, int x, int y1, int y2)
+{
+    Uint8 *pixel = t->pixels + y1 * t->pitch + x * 3;
+    Uint8 c0 = t->color3[0], c1 = t->color3[1], c2 = t->color3[2];
+
+    for (; y1 <= y2; ++y1, pixel += t->pitch) {
+        pixel[0] = c0;
+        pixel[1] = c1;
+        pixel[2] = c2;
+    }
+}
+
+static void draw_vspan_4(draw_target *t, int x, int y1, int y2)
+{
+    Uint8 *pixel = t->pixels + y1 * t->pitch + x * 4;
+    Uint32 color = t->color;
+
+    for (; y1 <= y2; ++y1, pixel += t->pitch)
+        *(Uint32*)pixel = color;
+}
+
+/* Sets up <t> to draw <color> on <surf>. The surface must be locked. */
+static void draw_target_init(draw_target *t, SDL_Surface *surf, Uint32 color)
+{
+    t->pixels = (Uint8*)surf->pixels;
+    t->pitch = surf->pitch;
+    t->bpp = surf->format->BytesPerPixel;
+    t->left = surf->clip_rect.x;
+    t->top = surf->clip_rect.y;
+    t->right = surf->clip_rect.x + surf->clip_rect.w - 1;
+    t->bottom = surf->clip_rect.y + surf->clip_rect.h - 1;
+    draw_target_set_color(t, color);
+
+    switch(t->bpp)
+    {
+    case 1:
+        t->pixel = draw_pixel_1;
+        t->hspan = draw_hspan_1;
+        t->vspan = draw_vspan_1;
+        break;
+    case 2:
+        t->pixel = draw_pixel_2;
+        t->hspan = draw_hspan_2;
+        t->vspan = draw_vspan_2;
+        break;
+    case 3:
+        t->pixel = draw_pixel_3;
+        t->hspan = draw_hspan_3;
+        t->vspan = draw_vspan_3;
+        break;
+    default: /*case 4*/
+        t->pixel = draw_pixel_4;
+        t->hspan = draw_hspan_4;
+        t->vspan = draw_vspan_4;
+        break;
+    }
+}
+
+/* Changes the mapped color the writers of <t> draw with. */
+static void draw_target_set_color(draw_target *t, Uint32 color)
+{
+    Uint32 color3 = color;
+
+    t->color = color;
+    if(SDL_BYTEORDER == SDL_BIG_ENDIAN) color3 <<= 8;
+    memcpy(t->color3, &color3, 3);
+}
+
+static void draw_pixel_clip(draw_target *t, int x, int y)
+{
+    if(x < t->left || x > t->right || y < t->top || y > t->bottom)
+        return;
+    t->pixel(t, x, y);
+}
+
+static void draw_hspan_clip(draw_target *t, int x1, int x2, int y)
+{
+    int temp;
+
+    if(y < t->top || y > t->bottom)
+        return;
+    if(x2 < x1)
+    {
+        temp = x1;
+        x1 = x2; x2 = temp;
+    }
+    x1 = MAX(x1, t->left);
+    x2 = MIN(x2, t->right);
+    if(x1 <= x2)
+        t->hspan(t, x1, x2, y);
+}
+
+static void draw_vspan_clip(draw_target *t, int x, int y1, int y2)
+{
+    int temp;
+
+    if(x < t->left || x > t->right)
+        return;
+    if(y2 < y1)
+    {
+        temp = y1;
+        y1 = y2; y2 = temp;
+    }
+    y1 = MAX(y1, t->top);
+    y2 = MIN(y2, t->bottom);
+    if(y1 <= y2)
+        t->vspan(t, x, y1, y2);
+}
+
+static void draw_arc(draw_target *t, int x, int y, int radius1, int radius2,
+                     double angle_start, double angle_stop)
+{
+    double aStep;            // Angle Step (rad)
+    double a;                // Current Angle (rad)
+    int x_last, x_next, y_last, y_next;
+
+    // Angle step in rad
+    if (radius1<radius2) {
+        if (radius1<1.0e-4) {
+            aStep=1.0;
+        } else {
+            aStep=asin(2.0/radius1);
         }
-        grad = yd/xd;
-        xend = trunc(x1)+0.5; /* This makes more sense than trunc(x1+0.5) */
-        yend = y1+grad*(xend-x1);
-        xgap = INVFRAC(x1);
-        ix1 = (int)xend;
-        iy1 = (int)yend;
-        yf = yend+grad;
-        brightness1 = INVFRAC(yend) * xgap;
-        brightness2 =    FRAC(yend) * xgap;
-        pixel = pm + pixx * ix1 + pixy * iy1;
-        DRAWPIX32(pixel, colorptr, brightness1, blend)
-            pixel += pixy;
-        DRAWPIX32(pixel, colorptr, brightness2, blend)
-            xend = trunc(x2)+0.5;
-        yend = y2+grad*(xend-x2);
-        xgap =    FRAC(x2); /* this also differs from Hugo's description. */
-        ix2 = (int)xend;
-        iy2 = (int)yend;
-        brightness1 = INVFRAC(yend) * xgap;
-        brightness2 =    FRAC(yend) * xgap;
-        pixel = pm + pixx * ix2 + pixy * iy2;
-        DRAWPIX32(pixel, colorptr, brightness1, blend)
-            pixel += pixy;
-        DRAWPIX32(pixel, colorptr, brightness2, blend)
-            for(x=ix1+1; x<ix2; ++x) {
-                brightness1=INVFRAC(yf);
-                brightness2=   FRAC(yf);
-                pixel = pm + pixx * x + pixy * (int)yf;
-                DRAWPIX32(pixel, colorptr, brightness1, blend)
-                    pixel += pixy;
-                DRAWPIX32(pixel, colorptr, brightness2, blend)
-                    yf += grad;
+    } else {
+        if (radius2<1.0e-4) {
+            aStep=1.0;
+        } else {
+            aStep=asin(2.0/radius2);
+        }
+    }
+
+    if(aStep<0.05) {
+        aStep = 0.05;
+    }
+
+    x_last = x+cos(angle_start)*radius1;
+    y_last = y-sin(angle_start)*radius2;
+    for(a=angle_start+aStep; a<=angle_stop; a+=aStep) {
+        int points[4];
+        x_next = x+cos(a)*radius1;
+        y_next = y-sin(a)*radius2;
+        points[0] = x_last; points[1] = y_last;
+        points[2] = x_next; points[3] = y_next;
+        clip_and_draw_line(t, points);
+        x_last = x_next;
+        y_last = y_next;
+    }
+}
+
+static void draw_ellipse(draw_target *t, int x, int y, int rx, int ry)
+{
+    int ix, iy;
+    int h, i, j, k;
+    int oh, oi, oj, ok;
+    int xmh, xph, ypk, ymk;
+    int xmi, xpi, ymj, ypj;
+    int xmj, xpj, ymi, ypi;
+    int xmk, xpk, ymh, yph;
+
+    if (rx==0 && ry==0) {  /* Special case - draw a single pixel */
+        draw_pixel_clip(t, x, y);
+        return;
+    }
+    if (rx==0) { /* Special case for rx=0 - draw a vline */
+        draw_vspan_clip(t, x, (Sint16)(y-ry), (Sint16)(y+ry));
+        return;
+    }
+    if (ry==0) { /* Special case for ry=0 - draw a hline */
+        draw_hspan_clip(t, (Sint16)(x-rx), (Sint16)(x+rx), y);
+        return;
+    }
+
+
+    /* Init vars */
+    oh = oi = oj = ok = 0xFFFF;
+    if (rx > ry) {
+        ix = 0;
+        iy = rx * 64;
+        do {
+            h = (ix + 16) >> 6;
+            i = (iy + 16) >> 6;
+            j = (h * ry) / rx;
+            k = (i * ry) / rx;
+
+            if (((ok!=k) && (oj!=k)) || ((oj!=j) && (ok!=j)) || (k!=j)) {
+                xph=x+h-1;
+                xmh=x-h;
+                if (k>0) {
+                    ypk=y+k-1;
+                    ymk=y-k;
+                    if(h > 0) {
+                        draw_pixel_clip(t, xmh, ypk);
+                        draw_pixel_clip(t, xmh, ymk);
+                    }
+                    draw_pixel_clip(t, xph, ypk);
+                    draw_pixel_clip(t, xph, ymk);
+                }
+                ok=k;
+                xpi=x+i-1;
+                xmi=x-i;
+                if (j>0) {
+                    ypj=y+j-1;
+                    ymj=y-j;
+                    draw_pixel_clip(t, xmi, ypj);
+                    draw_pixel_clip(t, xpi, ypj);
+                    draw_pixel_clip(t, xmi, ymj);
+                    draw_pixel_clip(t, xpi, ymj);
+                }
+                oj=j;
+            }
+            ix = ix + iy / rx;
+            iy = iy - ix / rx;
+
+        } while (i > h);
+    } else {
+        ix = 0;
+        iy = ry * 64;
+        do {
+            h = (ix + 32) >> 6;
+            i = (iy + 32) >> 6;
+            j = (h * rx) / ry;
+            k = (i * rx) / ry;
+
+            if (((oi!=i) && (oh!=i)) || ((oh!=h) && (oi!=h) && (i!=h))) {
+                xmj=x-j;
+                xpj=x+j-1;
+                if (i>0) {
+                    ypi=y+i-1;
+                    ymi=y-i;
+                    if(j > 0) {
+                        draw_pixel_clip(t, xmj, ypi);
+                        draw_pixel_clip(t, xmj, ymi);
+                    }
+                    draw_pixel_clip(t, xpj, ypi);
+                    draw_pixel_clip(t, xpj, ymi);
+                }
+                oi=i;
+                xmk=x-k;
+                xpk=x+k-1;
+                if (h>0) {
+                    yph=y+h-1;
+                    ymh=y-h;
+                    draw_pixel_clip(t, xmk, yph);
+                    draw_pixel_clip(t, xpk, yph);
+                    draw_pixel_clip(t, xmk, ymh);
+                    draw_pixel_clip(t, xpk, ymh);
+                }
+                oh=h;
+            }
+            ix = ix + iy / ry;
+            iy = iy - ix / ry;
+        } while(i > h);
+    }
+}
+
+
+
+
+
+
+
+static void draw_fillellipse(draw_target *t, int x, int y, int rx, int ry)
+{
+    int ix, iy;
+    int h, i, j, k;
+    int oh, oi, oj, ok;
+
+    if (rx==0 && ry==0) {  /* Special case - draw a single pixel */
+        draw_pixel_clip(t, x, y);
+        return;
+    }
+    if (rx==0) { /* Special case for rx=0 - draw a vline */
+        draw_vspan_clip(t, x, (Sint16)(y-ry), (Sint16)(y+ry));
+        return;
+    }
+    if (ry==0) { /* Special case for ry=0 - draw a hline */
+        draw_hspan_clip(t, (Sint16)(x-rx), (Sint16)(x+rx), y);
+        return;
+    }
+
+    /* Init vars */
+    oh = oi = oj = ok = 0xFFFF;
+
+    /* Draw */
+    if (rx >= ry) {
+        ix = 0;
+        iy = rx * 64;
+
+        do {
+            h = (ix + 8) >> 6;
+            i = (iy + 8) >> 6;
+            j = (h * ry) / rx;
+            k = (i * ry) / rx;
+            if ((ok!=k) && (oj!=k) && (k<ry)) {
+                draw_hspan_clip(t, x-h, x+h-1, y-k-1);
+                draw_hspan_clip(t, x-h, x+h-1, y+k);
+                ok=k;
+            }
+            if ((oj!=j) && (ok!=j) && (k!=j))  {
+                draw_hspan_clip(t, x-i, x+i-1, y+j);
+                draw_hspan_clip(t, x-i, x+i-1, y-j-1);
+                oj=j;
+            }
+            ix = ix + iy / rx;
+            iy = iy - ix / rx;
+
+        } while (i > h);
+    } else {
+        ix = 0;
+        iy = ry * 64;
+
+        do {
+            h = (ix + 8) >> 6;
+            i = (iy + 8) >> 6;
+            j = (h * rx) / ry;
+            k = (i * rx) / ry;
+
+            if ((oi!=i) && (oh!=i) && (i<ry)) {
+                draw_hspan_clip(t, x-j, x+j-1, y+i);
+                draw_hspan_clip(t, x-j, x+j-1, y-i-1);
+                oi=i;
             }
-    }
-    else {
-        if(y1>y2) {
-            swaptmp=y1; y1=y2; y2=swaptmp;
-            swaptmp=x1; x1=x2; x2=swaptmp;
-            yd = (y2-y1);
-            xd = (x2-x1);
-        }
-        grad = xd/yd;
-        yend = trunc(y1)+0.5;  /* This makes more sense than trunc(x1+0.5) */
-        xend = x1+grad*(yend-y1);
-        ygap = INVFRAC(y1);
-        iy1 = (int)yend;
-        ix1 = (int)xend;
-        xf = xend+grad;
-        brightness1 = INVFRAC(xend) * ygap;
-        brightness2 =    FRAC(xend) * ygap;
-        pixel = pm + pixx * ix1 + pixy * iy1;
-        DRAWPIX32(pixel, colorptr, brightness1, blend)
-            pixel += pixx;
-        DRAWPIX32(pixel, colorptr, brightness2, blend)
-            yend = trunc(y2)+0.5;
-        xend = x2+grad*(yend-y2);
-        ygap = FRAC(y2);
-        iy2 = (int)yend;
-        ix2 = (int)xend;
-        brightness1 = INVFRAC(xend) * ygap;
-        brightness2 =    FRAC(xend) * ygap;
-        pixel = pm + pixx * ix2 + pixy * iy2;
-        DRAWPIX32(pixel, colorptr, brightness1, blend)
-            pixel += pixx;
-        DRAWPIX32(pixel, colorptr, brightness2, blend)
-            for(y=iy1+1; y<iy2; ++y) {
-                brightness1=INVFRAC(xf);
-                brightness2=   FRAC(xf);
-                pixel = pm + pixx * (int)xf + pixy * y;
-                DRAWPIX32(pixel, colorptr, brightness1, blend)
-                    pixel += pixx;
-                DRAWPIX32(pixel, colorptr, brightness2, blend)
-                    xf += grad;
+            if ((oh!=h) && (oi!=h) && (i!=h)) {
+                draw_hspan_clip(t, x-k, x+k-1, y+h);
+                draw_hspan_clip(t, x-k, x+k-1, y-h-1);
+                oh=h;
             }
+
+            ix = ix + iy / ry;
+            iy = iy - ix / ry;
+
+        } while(i > h);
     }
 }
 
 
-/*here's my sdl'ized version of bresenham*/
-static void drawline(SDL_Surface* surf, Uint32 color, int x1, int y1, int x2, int y2)
-{
-    int deltax, deltay, signx, signy;
-    int pixx, pixy;
-    int x = 0, y = 0;
-    int swaptmp;
-    Uint8 *pixel;
-    Uint8 *colorptr;
+/* Polygon edge for the scanline fill. x is stepped incrementally and
+ * always equals x1 + (y - y1) * (x2 - x1) / (y2 - y1) with C integer
+ * division, so the result is the same as computing every intersection.
+ */
+typedef struct {
+    int ymin, ymax;   /* first and last scanline of the edge */
+    int x;            /* intersection with the current scanline */
+    int r;            /* remainder of the division, same sign as dx */
+    int dx, dy;       /* x2 - x1 and y2 - y1, dy > 0 */
+    int qstep, rstep; /* dx / dy and dx % dy */
+    int x1, y1;
+    int dir;          /* 1 if the edge goes down, -1 if it goes up */
+} poly_edge;
 
-    deltax = x2 - x1;
-    deltay = y2 - y1;
-    signx = (deltax < 0) ? -1 : 1;
-    signy = (deltay < 0) ? -1 : 1;
-    deltax = signx * deltax + 1;
-    deltay = signy * deltay + 1;
+/* Same as poly_edge, for the anti-aliased fill which works on
+ * subscanlines and floating point coordinates.
+ */
+typedef struct {
+    int tmin, tmax;   /* subscanlines covered, tmax is exclusive */
+    double x;         /* intersection with the current subscanline */
+    double step;      /* x increment per subscanline */
+    int dir;
+} poly_aaedge;
 
-    pixx = surf->format->BytesPerPixel;
-    pixy = surf->pitch;
-    pixel = ((Uint8*)surf->pixels) + pixx * x1 + pixy * y1;
+#define AAPOLY_SUBSAMPLES 8
 
-    pixx *= signx;
-    pixy *= signy;
-    if(deltax < deltay) /*swap axis if rise > run*/
-    {
-        swaptmp = deltax; deltax = deltay; deltay = swaptmp;
-        swaptmp = pixx; pixx = pixy; pixy = swaptmp;
-    }
+static int compare_poly_edge(const void *a, const void *b)
+{
+    return (*(poly_edge * const *)a)->ymin - (*(poly_edge * const *)b)->ymin;
+}
 
-    switch(surf->format->BytesPerPixel)
-    {
-    case 1:
-        for(; x < deltax; x++, pixel += pixx) {
-            *pixel = (Uint8)color;
-            y += deltay; if(y >= deltax) {y -= deltax; pixel += pixy;}
-        }break;
-    case 2:
-        for(; x < deltax; x++, pixel += pixx) {
-            *(Uint16*)pixel = (Uint16)color;
-            y += deltay; if(y >= deltax) {y -= deltax; pixel += pixy;}
-        }break;
-    case 3:
-        if(SDL_BYTEORDER == SDL_BIG_ENDIAN) color <<= 8;
-        colorptr = (Uint8*)&color;
-        for(; x < deltax; x++, pixel += pixx) {
-            pixel[0] = colorptr[0];
-            pixel[1] = colorptr[1];
-            pixel[2] = colorptr[2];
-            y += deltay; if(y >= deltax) {y -= deltax; pixel += pixy;}
-        }break;
-    default: /*case 4*/
-        for(; x < deltax; x++, pixel += pixx) {
-            *(Uint32*)pixel = (Uint32)color;
-            y += deltay; if(y >= deltax) {y -= deltax; pixel += pixy;}
-        }break;
-    }
+static int compare_poly_aaedge(const void *a, const void *b)
+{
+    return (*(poly_aaedge * const *)a)->tmin -
+           (*(poly_aaedge * const *)b)->tmin;
 }
 
+static void poly_edge_start(poly_edge *e, int y)
+{
+    int num = (y - e->y1) * e->dx;
+    e->x = e->x1 + num / e->dy;
+    e->r = num % e->dy;
+}
 
+static void poly_edge_step(poly_edge *e)
+{
+    e->x += e->qstep;
+    e->r += e->rstep;
+    if (e->dx >= 0) {
+        if (e->r >= e->dy) {
+            ++e->x;
+            e->r -= e->dy;
+        }
+    }
+    else if (e->r <= -e->dy) {
+        --e->x;
+        e->r += e->dy;
+    }
+}
 
-static void drawhorzline(SDL_Surface* surf, Uint32 color, int x1, int y1, int x2)
+static void draw_fillpoly(draw_target *t, int *vx, int *vy, int n, int nonzero)
 {
-    Uint8 *pixel, *end;
-    Uint8 *colorptr;
+    int i, j, k, y, ystart, yend, count, active_count, winding;
+    int miny, maxy, minx, maxx, x1, y1, x2, y2;
+    poly_edge *edges, **sorted, **active, *e;
 
-    if(x1 == x2)
+    /* Determine Y maxima */
+    miny = maxy = vy[0];
+    minx = maxx = vx[0];
+    for (i = 1; i < n; i++)
     {
-        set_at(surf, x1, y1, color);
+        miny = MIN(miny, vy[i]);
+        maxy = MAX(maxy, vy[i]);
+        minx = MIN(minx, vx[i]);
+        maxx = MAX(maxx, vx[i]);
+    }
+
+    if (miny == maxy) {
+        /* Special case: polygon only 1 pixel high. */
+        draw_hspan_clip(t, minx, maxx, miny);
         return;
     }
 
-    pixel = ((Uint8*)surf->pixels) + surf->pitch * y1;
-    if(x1 < x2)
-    {
-        end = pixel + x2 * surf->format->BytesPerPixel;
-        pixel += x1 * surf->format->BytesPerPixel;
+    edges = PyMem_New(poly_edge, n);
+    sorted = PyMem_New(poly_edge *, n);
+    active = PyMem_New(poly_edge *, n);
+    if (edges == NULL || sorted == NULL || active == NULL) {
+        PyMem_Free(edges);
+        PyMem_Free(sorted);
+        PyMem_Free(active);
+        PyErr_NoMemory();
+        return;
     }
-    else
-    {
-        end = pixel + x1 * surf->format->BytesPerPixel;
-        pixel += x2 * surf->format->BytesPerPixel;
+
+    /* Build the edge table, horizontal edges are skipped */
+    count = 0;
+    for (i = 0; i < n; i++) {
+        j = i ? i - 1 : n - 1;
+        if (vy[j] == vy[i])
+            continue;
+        e = &edges[count];
+        if (vy[j] < vy[i]) {
+            x1 = vx[j]; y1 = vy[j];
+            x2 = vx[i]; y2 = vy[i];
+            e->dir = 1;
+        }
+        else {
+            x1 = vx[i]; y1 = vy[i];
+            x2 = vx[j]; y2 = vy[j];
+            e->dir = -1;
+        }
+        e->ymin = y1;
+        e->ymax = y2;
+        e->x1 = x1;
+        e->y1 = y1;
+        e->dx = x2 - x1;
+        e->dy = y2 - y1;
+        e->qstep = e->dx / e->dy;
+        e->rstep = e->dx % e->dy;
+        sorted[count++] = e;
+    }
+    qsort(sorted, count, sizeof(poly_edge *), compare_poly_edge);
+
+    /* Draw, scanning y. Edges cover ymin <= y < ymax, except on the last
+     * line where the edges ending there are used. */
+    ystart = MAX(miny, t->top);
+    yend = MIN(maxy, t->bottom);
+    active_count = 0;
+    j = 0;
+    for (y = ystart; y <= yend; y++) {
+        /* drop the edges that ended */
+        for (i = 0; i < active_count; ) {
+            if (active[i]->ymax <= y && y != maxy)
+                active[i] = active[--active_count];
+            else
+                ++i;
+        }
+        /* add the edges starting on this line */
+        while (j < count && sorted[j]->ymin <= y) {
+            e = sorted[j++];
+            if (e->ymax > y || (y == maxy && e->ymax == maxy)) {
+                poly_edge_start(e, y);
+                active[active_count++] = e;
+            }
+        }
+        /* insertion sort by x, the order rarely changes between lines */
+        for (i = 1; i < active_count; i++) {
+            e = active[i];
+            for (k = i; k > 0 && active[k - 1]->x > e->x; k--)
+                active[k] = active[k - 1];
+            active[k] = e;
+        }
+
+        if (nonzero) {
+            winding = 0;
+            for (i = 0; i < active_count; i++) {
+                if (winding == 0)
+                    x1 = active[i]->x;
+                winding += active[i]->dir;
+                if (winding == 0)
+                    draw_hspan_clip(t, x1, active[i]->x, y);
+            }
+        }
+        else {
+            for (i = 0; i + 1 < active_count; i += 2)
+                draw_hspan_clip(t, active[i]->x, active[i + 1]->x, y);
+        }
+
+        for (i = 0; i < active_count; i++)
+            poly_edge_step(active[i]);
     }
-    switch(surf->format->BytesPerPixel)
+
+    PyMem_Free(edges);
+    PyMem_Free(sorted);
+    PyMem_Free(active);
+}
+
+/* Mixes <rgba> into the pixel at (x, y) with the weight <alpha>. */
+static void blend_at(SDL_Surface *surf, int x, int y, Uint8 *rgba, float alpha)
+{
+    SDL_PixelFormat *format = surf->format;
+    Uint8 *pixel = (Uint8*)surf->pixels + y * surf->pitch + x * format->BytesPerPixel;
+    Uint32 value;
+    Uint8 r, g, b, a;
+    float nalpha = 1 - alpha;
+
+    switch (format->BytesPerPixel)
     {
     case 1:
-        for(; pixel <= end; ++pixel) {
-            *pixel = (Uint8)color;
-        }break;
+        value = *pixel;
+        break;
     case 2:
-        for(; pixel <= end; pixel+=2) {
-            *(Uint16*)pixel = (Uint16)color;
-        }break;
+        value = *(Uint16*)pixel;
+        break;
     case 3:
-        if(SDL_BYTEORDER == SDL_BIG_ENDIAN) color <<= 8;
-        colorptr = (Uint8*)&color;
-        for(; pixel <= end; pixel+=3) {
-            pixel[0] = colorptr[0];
-            pixel[1] = colorptr[1];
-            pixel[2] = colorptr[2];
-        }break;
+#if (SDL_BYTEORDER == SDL_LIL_ENDIAN)
+        value = pixel[0] | (pixel[1] << 8) | (pixel[2] << 16);
+#else
+        value = (pixel[0] << 16) | (pixel[1] << 8) | pixel[2];
+#endif
+        break;
     default: /*case 4*/
-        for(; pixel <= end; pixel+=4) {
-            *(Uint32*)pixel = color;
-          }break;
+        value = *(Uint32*)pixel;
+        break;
     }
+    SDL_GetRGBA(value, format, &r, &g, &b, &a);
+    set_at(surf, x, y, SDL_MapRGBA(format,
+                                   (Uint8)(rgba[0] * alpha + r * nalpha),
+                                   (Uint8)(rgba[1] * alpha + g * nalpha),
+                                   (Uint8)(rgba[2] * alpha + b * nalpha),
+                                   (Uint8)(rgba[3] * alpha + a * nalpha)));
 }
 
-static void drawhorzlineclip(SDL_Surface* surf, Uint32 color, int x1, int y1, int x2)
+/* Adds the horizontal span [xa, xb) of one subscanline to the coverage of
+ * the row. Pixels fully inside the span are added to <delta> as a run.
+ * [lo, hi] is grown to the range of touched pixels.
+ */
+static void aapoly_add_span(float *area, float *delta, int width, double xa, double xb,
+                            int *lo, int *hi)
 {
-    if(y1 < surf->clip_rect.y || y1 >= surf->clip_rect.y + surf->clip_rect.h)
+    const double weight = 1.0 / AAPOLY_SUBSAMPLES;
+    int ia, ib;
+
+    if (xa < 0)
+        xa = 0;
+    if (xb > width)
+        xb = width;
+    if (xb <= xa)
+        return;
+    ia = (int)xa;
+    ib = (int)xb;
+    *lo = MIN(*lo, ia);
+    *hi = MAX(*hi, ib);
+    if (ia == ib) {
+        area[ia] += (float)((xb - xa) * weight);
         return;
-
-    if( x2 < x1 )
-    {
-        int temp = x1;
-        x1 = x2; x2 = temp;
     }
-
-    x1 = MAX(x1, surf->clip_rect.x);
-    x2 = MIN(x2, surf->clip_rect.x + surf->clip_rect.w-1);
-
-        if(x2 < surf->clip_rect.x || x1 >= surf->clip_rect.x + surf->clip_rect.w)
-                return;
-
-    if(x1 == x2)
-        set_at(surf, x1, y1, color);
-    else
-        drawhorzline(surf, color, x1, y1, x2);
+    area[ia] += (float)((ia + 1 - xa) * weight);
+    delta[ia + 1] += (float)weight;
+    delta[ib] -= (float)weight;
+    area[ib] += (float)((xb - ib) * weight);
 }
 
-static void drawvertline(SDL_Surface* surf, Uint32 color, int x1, int y1, int y2)
+/* Fills the contours of <vx>, <vy> with coverage based antialiasing.
+ * Contour c ends before vertex ends[c] and starts where the previous one
+ * ended. Coverage is summed per row in <area> and <delta>, so the cost is
+ * linear in the covered area; fully covered runs go to the span writer.
+ */
+static void draw_aafillpath(SDL_Surface *dst, float *vx, float *vy, int *ends,
+                            int contours, Uint32 color, int nonzero)
 {
-    Uint8   *pixel, *end;
-    Uint8   *colorptr;
-    Uint32  pitch = surf->pitch;
+    int i, j, k, t, tstart, tend, count, active_count, winding, width, row;
+    int lo, hi, full, c, first, n;
+    double x1, y1, x2, y2, xa;
+    float *area, *delta, run, cover;
+    poly_aaedge *edges, **sorted, **active, *e;
+    Uint8 rgba[4];
+    draw_target target;
 
-    if(y1 == y2)
-    {
-        set_at(surf, x1, y1, color);
+    width = dst->clip_rect.w;
+    n = contours > 0 ? ends[contours - 1] : 0;
+    if (width <= 0 || dst->clip_rect.h <= 0 || n == 0)
+        return;
+    SDL_GetRGBA(color, dst->format, rgba, rgba+1, rgba+2, rgba+3);
+    draw_target_init(&target, dst, color);
+
+    edges = PyMem_New(poly_aaedge, n);
+    sorted = PyMem_New(poly_aaedge *, n);
+    active = PyMem_New(poly_aaedge *, n);
+    area = PyMem_New(float, width + 1);
+    delta = PyMem_New(float, width + 1);
+    if (edges == NULL || sorted == NULL || active == NULL ||
+        area == NULL || delta == NULL) {
+        PyMem_Free(edges);
+        PyMem_Free(sorted);
+        PyMem_Free(active);
+        PyMem_Free(area);
+        PyMem_Free(delta);
+        PyErr_NoMemory();
         return;
     }
 
-    pixel = ((Uint8*)surf->pixels) + x1 * surf->format->BytesPerPixel;
-    if(y1 < y2)
-    {
-        end      = pixel + surf->pitch * y2;
-        pixel += surf->pitch * y1;
-    }
-    else
-    {
-        end      = pixel + surf->pitch * y1;
-        pixel += surf->pitch * y2;
+    /* Pixel (x, y) covers the square from (x - 0.5, y - 0.5) to
+     * (x + 0.5, y + 0.5). Coordinates are moved by half a pixel (and by
+     * the clip origin horizontally) so pixels start at whole numbers.
+     * Every row is sampled at AAPOLY_SUBSAMPLES subscanlines t, at
+     * y = (t + 0.5) / AAPOLY_SUBSAMPLES.
+     */
+    count = 0;
+    tstart = INT_MAX;
+    tend = INT_MIN;
+    for (c = 0, first = 0, i = 0; i < n; i++) {
+        if (i == ends[c])
+            first = ends[c++];
+        j = i > first ? i - 1 : ends[c] - 1;
+        e = &edges[count];
+        if (vy[j] < vy[i]) {
+            x1 = vx[j]; y1 = vy[j];
+            x2 = vx[i]; y2 = vy[i];
+            e->dir = 1;
+        }
+        else {
+            x1 = vx[i]; y1 = vy[i];
+            x2 = vx[j]; y2 = vy[j];
+            e->dir = -1;
+        }
+        x1 += 0.5 - dst->clip_rect.x;
+        x2 += 0.5 - dst->clip_rect.x;
+        y1 += 0.5;
+        y2 += 0.5;
+        e->tmin = (int)ceil(y1 * AAPOLY_SUBSAMPLES - 0.5);
+        e->tmax = (int)ceil(y2 * AAPOLY_SUBSAMPLES - 0.5);
+        if (e->tmin >= e->tmax)
+            continue;
+        e->step = (x2 - x1) / (y2 - y1);
+        e->x = x1 + ((e->tmin + 0.5) / AAPOLY_SUBSAMPLES - y1) * e->step;
+        e->step /= AAPOLY_SUBSAMPLES;
+        tstart = MIN(tstart, e->tmin);
+        tend = MAX(tend, e->tmax);
+        sorted[count++] = e;
     }
+    qsort(sorted, count, sizeof(poly_aaedge *), compare_poly_aaedge);
+
+    tstart = MAX(tstart, dst->clip_rect.y * AAPOLY_SUBSAMPLES);
+    tend = MIN(tend, (dst->clip_rect.y + dst->clip_rect.h) * AAPOLY_SUBSAMPLES);
+    memset(area, 0, (width + 1) * sizeof(float));
+    memset(delta, 0, (width + 1) * sizeof(float));
+    lo = width;
+    hi = -1;
+    active_count = 0;
+    j = 0;
+    for (t = tstart; t < tend; t++) {
+        for (i = 0; i < active_count; ) {
+            if (active[i]->tmax <= t)
+                active[i] = active[--active_count];
+            else
+                ++i;
+        }
+        while (j < count && sorted[j]->tmin <= t) {
+            e = sorted[j++];
+            if (e->tmax > t) {
+                e->x += (t - e->tmin) * e->step;
+                active[active_count++] = e;
+            }
+        }
+        for (i = 1; i < active_count; i++) {
+            e = active[i];
+            for (k = i; k > 0 && active[k - 1]->x > e->x; k--)
+                active[k] = active[k - 1];
+            active[k] = e;
+        }
 
-    switch(surf->format->BytesPerPixel)
-    {
-    case 1:
-        for(; pixel <= end; pixel+=pitch) {
-            *pixel = (Uint8)color;
-        }break;
-    case 2:
-        for(; pixel <= end; pixel+=pitch) {
-            *(Uint16*)pixel = (Uint16)color;
-        }break;
-    case 3:
-        if(SDL_BYTEORDER == SDL_BIG_ENDIAN) color <<= 8;
-        colorptr = (Uint8*)&color;
-        for(; pixel <= end; pixel+=pitch) {
-            pixel[0] = colorptr[0];
-            pixel[1] = colorptr[1];
-            pixel[2] = colorptr[2];
-        }break;
-    default: /*case 4*/
-        for(; pixel <= end; pixel+=pitch) {
-            *(Uint32*)pixel = color;
-        }break;
+        if (nonzero) {
+            winding = 0;
+            xa = 0;
+            for (i = 0; i < active_count; i++) {
+                if (winding == 0)
+                    xa = active[i]->x;
+                winding += active[i]->dir;
+                if (winding == 0)
+                    aapoly_add_span(area, delta, width, xa, active[i]->x,
+                                    &lo, &hi);
+            }
+        }
+        else {
+            for (i = 0; i + 1 < active_count; i += 2)
+                aapoly_add_span(area, delta, width, active[i]->x,
+                                active[i + 1]->x, &lo, &hi);
+        }
+
+        for (i = 0; i < active_count; i++)
+            active[i]->x += active[i]->step;
+
+        /* write the row once all its subscanlines are done */
+        if (((t + 1) % AAPOLY_SUBSAMPLES == 0 || t + 1 == tend) && lo <= hi) {
+            row = t / AAPOLY_SUBSAMPLES;
+            run = 0;
+            full = -1;
+            for (i = lo; i <= hi && i < width; i++) {
+                run += delta[i];
+                cover = area[i] + run;
+                if (cover >= 0.999f) {
+                    if (full < 0)
+                        full = i;
+                    continue;
+                }
+                if (full >= 0) {
+                    target.hspan(&target, dst->clip_rect.x + full,
+                                 dst->clip_rect.x + i - 1, row);
+                    full = -1;
+                }
+                if (cover > 0.001f)
+                    blend_at(dst, dst->clip_rect.x + i, row, rgba, cover);
+            }
+            if (full >= 0)
+                target.hspan(&target, dst->clip_rect.x + full,
+                             dst->clip_rect.x + i - 1, row);
+            memset(area + lo, 0, (hi - lo + 1) * sizeof(float));
+            memset(delta + lo, 0, (hi - lo + 1) * sizeof(float));
+            lo = width;
+            hi = -1;
+        }
     }
+
+    PyMem_Free(edges);
+    PyMem_Free(sorted);
+    PyMem_Free(active);
+    PyMem_Free(area);
+    PyMem_Free(delta);
 }
 
 
-static void drawvertlineclip(SDL_Surface* surf, Uint32 color, int x1, int y1, int y2)
+#define AA_MITER_LIMIT 4.0
+
+static void aa_path_init(aa_path *p)
 {
-    if(x1 < surf->clip_rect.x || x1 >= surf->clip_rect.x + surf->clip_rect.w)
-        return;
-    if ( y2 < y1 )
-    {
-        int temp = y1;
-        y1 = y2; y2 = temp;
-    }
-    y1 = MAX(y1, surf->clip_rect.y);
-    y2 = MIN(y2, surf->clip_rect.y + surf->clip_rect.h-1);
-    if(y2 - y1 < 1)
-        set_at( surf, x1, y1, color);
-    else
-        drawvertline(surf, color, x1, y1, y2);
+    memset(p, 0, sizeof(aa_path));
 }
 
-static void draw_arc(SDL_Surface *dst, int x, int y, int radius1, int radius2,
-                     double angle_start, double angle_stop, Uint32 color)
+static void aa_path_free(aa_path *p)
 {
-    double aStep;            // Angle Step (rad)
-    double a;                // Current Angle (rad)
-    int x_last, x_next, y_last, y_next;
+    PyMem_Free(p->x);
+    PyMem_Free(p->y);
+    PyMem_Free(p->ends);
+    aa_path_init(p);
+}
 
-    // Angle step in rad
-    if (radius1<radius2) {
-        if (radius1<1.0e-4) {
-            aStep=1.0;
-        } else {
-            aStep=asin(2.0/radius1);
-        }
-    } else {
-        if (radius2<1.0e-4) {
-            aStep=1.0;
-        } else {
-            aStep=asin(2.0/radius2);
+static void aa_path_point(aa_path *p, double x, double y)
+{
+    float *nx, *ny;
+    int size;
+
+    if (p->failed)
+        return;
+    if (p->count == p->size) {
+        size = p->size ? p->size * 2 : 64;
+        nx = PyMem_Realloc(p->x, size * sizeof(float));
+        if (nx != NULL)
+            p->x = nx;
+        ny = PyMem_Realloc(p->y, size * sizeof(float));
+        if (ny != NULL)
+            p->y = ny;
+        if (nx == NULL || ny == NULL) {
+            p->failed = 1;
+            return;
         }
+        p->size = size;
     }
+    p->x[p->count] = (float)x;
+    p->y[p->count] = (float)y;
+    ++p->count;
+}
 
-    if(aStep<0.05) {
-        aStep = 0.05;
-    }
+/* Ends the contour of the points added since the last one. The contour is
+ * reversed if needed so the sign of its area matches <sign>; contours with
+ * a negative sign cut holes in the positive ones.
+ */
+static void aa_path_close(aa_path *p, int sign)
+{
+    int first = p->contours ? p->ends[p->contours - 1] : 0;
+    int i, j, size, *ends;
+    double area = 0;
+    float temp;
 
-    x_last = x+cos(angle_start)*radius1;
-    y_last = y-sin(angle_start)*radius2;
-    for(a=angle_start+aStep; a<=angle_stop; a+=aStep) {
-        int points[4];
-        x_next = x+cos(a)*radius1;
-        y_next = y-sin(a)*radius2;
-        points[0] = x_last; points[1] = y_last;
-        points[2] = x_next; points[3] = y_next;
-        clip_and_draw_line(dst, &dst->clip_rect, color, points);
-        x_last = x_next;
-        y_last = y_next;
+    if (p->failed)
+        return;
+    if (p->count - first < 3) {
+        p->count = first;
+        return;
+    }
+    for (i = first, j = p->count - 1; i < p->count; j = i++)
+        area += (double)p->x[j] * p->y[i] - (double)p->x[i] * p->y[j];
+    if (area * sign < 0) {
+        for (i = first, j = p->count - 1; i < j; i++, j--) {
+            temp = p->x[i]; p->x[i] = p->x[j]; p->x[j] = temp;
+            temp = p->y[i]; p->y[i] = p->y[j]; p->y[j] = temp;
+        }
+    }
+    if (p->contours == p->ends_size) {
+        size = p->ends_size ? p->ends_size * 2 : 16;
+        ends = PyMem_Realloc(p->ends, size * sizeof(int));
+        if (ends == NULL) {
+            p->failed = 1;
+            return;
+        }
+        p->ends = ends;
+        p->ends_size = size;
     }
+    p->ends[p->contours++] = p->count;
 }
 
-static void draw_ellipse(SDL_Surface *dst, int x, int y, int rx, int ry, Uint32 color)
+/* Adds an ellipse as a polygon with enough sides to be within 1/16 of a
+ * pixel of the curve, scaled so the polygon has the area of the ellipse.
+ */
+static void aa_path_add_ellipse(aa_path *p, double cx, double cy, double rx,
+                                double ry, int sign)
 {
-    int ix, iy;
-    int h, i, j, k;
-    int oh, oi, oj, ok;
-    int xmh, xph, ypk, ymk;
-    int xmi, xpi, ymj, ypj;
-    int xmj, xpj, ymi, ypi;
-    int xmk, xpk, ymh, yph;
+    double r = MAX(rx, ry), a, scale;
+    int i, n = 8;
 
-    if (rx==0 && ry==0) {  /* Special case - draw a single pixel */
-        set_at( dst, x, y, color);
+    if (rx <= 0 || ry <= 0)
         return;
+    if (r > 1.0 / 32)
+        n = (int)ceil(M_PI / acos(1.0 - 1.0 / (16.0 * r)));
+    n = MAX(8, MIN(n, 2048));
+    scale = sqrt(2.0 * M_PI / (n * sin(2.0 * M_PI / n)));
+    for (i = 0; i < n; i++) {
+        a = 2.0 * M_PI * i / n;
+        aa_path_point(p, cx + cos(a) * rx * scale, cy + sin(a) * ry * scale);
     }
-    if (rx==0) { /* Special case for rx=0 - draw a vline */
-        drawvertlineclip( dst, color, x, (Sint16)(y-ry), (Sint16)(y+ry) );
-        return;
+    aa_path_close(p, sign);
+}
+
+/* Adds a line of <width> through the <n> points as a quad per segment plus
+ * a join shape at each corner: a circle for round joins, otherwise a miter
+ * or, past AA_MITER_LIMIT, a bevel. The ends of open lines are cut square.
+ */
+static void aa_path_add_polyline(aa_path *p, float *px, float *py, int n,
+                                 int closed, double width, int round)
+{
+    double half = width / 2.0, *dx, *dy, len, nx, ny, ux, uy, vx, vy;
+    double cross, dot, mx, my;
+    float *qx, *qy;
+    int i, m, segs, a;
+
+    qx = PyMem_New(float, n);
+    qy = PyMem_New(float, n);
+    dx = PyMem_New(double, n);
+    dy = PyMem_New(double, n);
+    if (qx == NULL || qy == NULL || dx == NULL || dy == NULL) {
+        p->failed = 1;
+        goto done;
     }
-    if (ry==0) { /* Special case for ry=0 - draw a hline */
-        drawhorzlineclip( dst, color, (Sint16)(x-rx), y, (Sint16)(x+rx) );
-        return;
+
+    /* drop repeated points, they have no direction */
+    m = 0;
+    for (i = 0; i < n; i++) {
+        if (m && px[i] == qx[m - 1] && py[i] == qy[m - 1])
+            continue;
+        qx[m] = px[i];
+        qy[m] = py[i];
+        ++m;
+    }
+    if (closed && m > 2 && qx[0] == qx[m - 1] && qy[0] == qy[m - 1])
+        --m;
+    if (m < 2)
+        goto done;
+    segs = (closed && m > 2) ? m : m - 1;
+
+    for (i = 0; i < segs; i++) {
+        dx[i] = qx[(i + 1) % m] - qx[i];
+        dy[i] = qy[(i + 1) % m] - qy[i];
+        len = sqrt(dx[i] * dx[i] + dy[i] * dy[i]);
+        dx[i] /= len;
+        dy[i] /= len;
+        nx = -dy[i] * half;
+        ny = dx[i] * half;
+        aa_path_point(p, qx[i] + nx, qy[i] + ny);
+        aa_path_point(p, qx[(i + 1) % m] + nx, qy[(i + 1) % m] + ny);
+        aa_path_point(p, qx[(i + 1) % m] - nx, qy[(i + 1) % m] - ny);
+        aa_path_point(p, qx[i] - nx, qy[i] - ny);
+        aa_path_close(p, 1);
     }
 
+    for (i = (segs == m) ? 0 : 1; i < segs; i++) {
+        a = (i + segs - 1) % segs;  /* the segment ending at point i */
+        if (round) {
+            aa_path_add_ellipse(p, qx[i], qy[i], half, half, 1);
+            continue;
+        }
+        cross = dx[a] * dy[i] - dy[a] * dx[i];
+        if (fabs(cross) < 1e-9)
+            continue;
+        /* normals on the outer side of the corner */
+        ux = -dy[a]; uy = dx[a];
+        vx = -dy[i]; vy = dx[i];
+        if (cross > 0) {
+            ux = -ux; uy = -uy;
+            vx = -vx; vy = -vy;
+        }
+        aa_path_point(p, qx[i], qy[i]);
+        aa_path_point(p, qx[i] + ux * half, qy[i] + uy * half);
+        dot = ux * vx + uy * vy;
+        if (2.0 / (1.0 + dot) <= AA_MITER_LIMIT * AA_MITER_LIMIT) {
+            mx = (ux + vx) / (1.0 + dot);
+            my = (uy + vy) / (1.0 + dot);
+            aa_path_point(p, qx[i] + mx * half, qy[i] + my * half);
+        }
+        aa_path_point(p, qx[i] + vx * half, qy[i] + vy * half);
+        aa_path_close(p, 1);
+    }
 
-    /* Init vars */
-    oh = oi = oj = ok = 0xFFFF;
-    if (rx > ry) {
-        ix = 0;
-        iy = rx * 64;
-        do {
-            h = (ix + 16) >> 6;
-            i = (iy + 16) >> 6;
-            j = (h * ry) / rx;
-            k = (i * ry) / rx;
+done:
+    PyMem_Del(qx);
+    PyMem_Del(qy);
+    PyMem_Del(dx);
+    PyMem_Del(dy);
+}
 
-            if (((ok!=k) && (oj!=k)) || ((oj!=j) && (ok!=j)) || (k!=j)) {
-                xph=x+h-1;
-                xmh=x-h;
-                if (k>0) {
-                    ypk=y+k-1;
-                    ymk=y-k;
-                    if(h > 0) {
-                        set_at(dst, xmh, ypk, color);
-                        set_at(dst, xmh, ymk, color);
-                    }
-                    set_at(dst, xph, ypk, color);
-                    set_at(dst, xph, ymk, color);
-                }
-                ok=k;
-                xpi=x+i-1;
-                xmi=x-i;
-                if (j>0) {
-                    ypj=y+j-1;
-                    ymj=y-j;
-                    set_at(dst, xmi, ypj, color);
-                    set_at(dst, xpi, ypj, color);
-                    set_at(dst, xmi, ymj, color);
-                    set_at(dst, xpi, ymj, color);
-                }
-                oj=j;
-            }
-            ix = ix + iy / rx;
-            iy = iy - ix / rx;
+/* Fills the path on the surface and returns the Rect of the touched
+ * pixels inside the clip area, or a zero size Rect at (x, y).
+ */
+static PyObject* draw_aapath(PyObject *surfobj, aa_path *p, Uint32 color,
+                             int x, int y)
+{
+    SDL_Surface *surf = pgSurface_AsSurface(surfobj);
+    SDL_Rect *clip = &surf->clip_rect;
+    double minx, miny, maxx, maxy;
+    int i, l, t, r, b;
 
-        } while (i > h);
-    } else {
-        ix = 0;
-        iy = ry * 64;
-        do {
-            h = (ix + 32) >> 6;
-            i = (iy + 32) >> 6;
-            j = (h * rx) / ry;
-            k = (i * rx) / ry;
+    if (p->failed)
+        return PyErr_NoMemory();
+    if (p->count == 0)
+        return pgRect_New4(x, y, 0, 0);
 
-            if (((oi!=i) && (oh!=i)) || ((oh!=h) && (oi!=h) && (i!=h))) {
-                xmj=x-j;
-                xpj=x+j-1;
-                if (i>0) {
-                    ypi=y+i-1;
-                    ymi=y-i;
-                    if(j > 0) {
-                        set_at(dst, xmj, ypi, color);
-                        set_at(dst, xmj, ymi, color);
-                    }
-                    set_at(dst, xpj, ypi, color);
-                    set_at(dst, xpj, ymi, color);
-                }
-                oi=i;
-                xmk=x-k;
-                xpk=x+k-1;
-                if (h>0) {
-                    yph=y+h-1;
-                    ymh=y-h;
-                    set_at(dst, xmk, yph, color);
-                    set_at(dst, xpk, yph, color);
-                    set_at(dst, xmk, ymh, color);
-                    set_at(dst, xpk, ymh, color);
-                }
-                oh=h;
-            }
-            ix = ix + iy / ry;
-            iy = iy - ix / ry;
-        } while(i > h);
+    if (!pgSurface_Lock(surfobj))
+        return NULL;
+    draw_aafillpath(surf, p->x, p->y, p->ends, p->contours, color, 1);
+    if (!pgSurface_Unlock(surfobj))
+        return NULL;
+    if (PyErr_Occurred())
+        return NULL;
+
+    minx = maxx = p->x[0];
+    miny = maxy = p->y[0];
+    for (i = 1; i < p->count; i++) {
+        minx = MIN(minx, p->x[i]);
+        maxx = MAX(maxx, p->x[i]);
+        miny = MIN(miny, p->y[i]);
+        maxy = MAX(maxy, p->y[i]);
     }
+    /* pixel i covers [i - 0.5, i + 0.5) */
+    l = MAX((int)floor(minx + 0.5), clip->x);
+    t = MAX((int)floor(miny + 0.5), clip->y);
+    r = MIN((int)ceil(maxx + 0.5) - 1, clip->x + clip->w - 1);
+    b = MIN((int)ceil(maxy + 0.5) - 1, clip->y + clip->h - 1);
+    if (l > r || t > b)
+        return pgRect_New4(x, y, 0, 0);
+    return pgRect_New4(l, t, r - l + 1, b - t + 1);
 }
 
+/* Draws the points as one antialiased line of <width>, used by aaline,
+ * aalines and polygon for widths other than 1.
+ */
+static PyObject* draw_aathicklines(PyObject *surfobj, Uint32 color, PyObject *points,
+                                   int closed, float width, int round)
+{
+    PyObject *item, *ret;
+    float *px, *py, x, y;
+    int i, n, length, result;
+    aa_path path;
 
+    length = PySequence_Length(points);
+    px = PyMem_New(float, length);
+    py = PyMem_New(float, length);
+    if (px == NULL || py == NULL) {
+        PyMem_Del(px); PyMem_Del(py);
+        return PyErr_NoMemory();
+    }
+    n = 0;
+    for (i = 0; i < length; i++) {
+        item = PySequence_GetItem(points, i);
+        result = item != NULL && pg_TwoFloatsFromObj(item, &x, &y);
+        Py_XDECREF(item);
+        if (!result)
+            continue; /*note, we silently skip over bad points :[ */
+        px[n] = x;
+        py[n] = y;
+        ++n;
+    }
 
+    aa_path_init(&path);
+    if (n > 1 && width > 0)
+        aa_path_add_polyline(&path, px, py, n, closed, width, round);
+    ret = draw_aapath(surfobj, &path, color,
+                      n ? (int)px[0] : 0, n ? (int)py[0] : 0);
+    aa_path_free(&path);
+    PyMem_Del(px); PyMem_Del(py);
+    return ret;
+}
 
 
-
-
-static void draw_fillellipse(SDL_Surface *dst, int x, int y, int rx, int ry, Uint32 color)
+/* Sets up the triangle <pos>, <uv> for the rasterizer. <pos> holds x, y
+ * and, with <perspective>, w of each corner. Returns 0 for triangles
+ * that are degenerate or outside the clip area.
+ */
+static int tex_setup_triangle(tex_triangle *tri, float **pos, float **uv,
+                              int perspective, SDL_Rect *clip)
 {
-    int ix, iy;
-    int h, i, j, k;
-    int oh, oi, oj, ok;
+    double x[3], y[3], s[3], t[3], q[3], *plane[3], *values[3];
+    double area, orient, dx, dy, sign, minx, miny, maxx, maxy;
+    int i, j, a, b, p, n;
 
-    if (rx==0 && ry==0) {  /* Special case - draw a single pixel */
-        set_at( dst, x, y, color);
-        return;
+    for(i = 0; i < 3; ++i)
+    {
+        x[i] = pos[i][0];
+        y[i] = pos[i][1];
+        /*the bounds keep the pixel math in int range*/
+        if(!(fabs(x[i]) < 1e7 && fabs(y[i]) < 1e7))
+            return 0;
+        q[i] = perspective ? 1.0 / pos[i][2] : 1.0;
+        s[i] = uv[i][0] * q[i];
+        t[i] = uv[i][1] * q[i];
     }
-    if (rx==0) { /* Special case for rx=0 - draw a vline */
-        drawvertlineclip( dst, color, x, (Sint16)(y-ry), (Sint16)(y+ry) );
-        return;
+    area = (x[1] - x[0]) * (y[2] - y[0]) - (y[1] - y[0]) * (x[2] - x[0]);
+    if(area == 0)
+        return 0;
+    orient = area > 0 ? 1.0 : -1.0;
+
+    minx = MIN(x[0], MIN(x[1], x[2]));
+    maxx = MAX(x[0], MAX(x[1], x[2]));
+    miny = MIN(y[0], MIN(y[1], y[2]));
+    maxy = MAX(y[0], MAX(y[1], y[2]));
+    /* pixel i is drawn when its center i + 0.5 is inside */
+    tri->left = MAX((int)ceil(minx - 0.5), clip->x);
+    tri->right = MIN((int)ceil(maxx - 0.5) - 1, clip->x + clip->w - 1);
+    tri->top = MAX((int)ceil(miny - 0.5), clip->y);
+    tri->bottom = MIN((int)ceil(maxy - 0.5) - 1, clip->y + clip->h - 1);
+    if(tri->left > tri->right || tri->top > tri->bottom)
+        return 0;
+
+    /* Each edge is computed from its corners in a fixed order, so the
+     * two triangles sharing an edge split its pixels exactly.
+     */
+    for(i = 0; i < 3; ++i)
+    {
+        a = i;
+        b = (i + 1) % 3;
+        if(y[a] < y[b] || (y[a] == y[b] && x[a] < x[b]))
+        {
+            p = a; n = b; sign = orient;
+        }
+        else
+        {
+            p = b; n = a; sign = -orient;
+        }
+        dx = x[n] - x[p];
+        dy = y[n] - y[p];
+        tri->ex[i] = -dy * sign;
+        tri->ey[i] = dx * sign;
+        tri->ec[i] = (dy * x[p] - dx * y[p]) * sign;
     }
-    if (ry==0) { /* Special case for ry=0 - draw a hline */
-        drawhorzlineclip( dst, color, (Sint16)(x-rx), y, (Sint16)(x+rx) );
-        return;
+
+    plane[0] = tri->s; values[0] = s;
+    plane[1] = tri->t; values[1] = t;
+    plane[2] = tri->q; values[2] = q;
+    for(j = 0; j < 3; ++j)
+    {
+        double *v = values[j];
+        plane[j][0] = ((v[1] - v[0]) * (y[2] - y[0]) -
+                       (v[2] - v[0]) * (y[1] - y[0])) / area;
+        plane[j][1] = ((v[2] - v[0]) * (x[1] - x[0]) -
+                       (v[1] - v[0]) * (x[2] - x[0])) / area;
+        plane[j][2] = v[0] - plane[j][0] * x[0] - plane[j][1] * y[0];
     }
+    return 1;
+}
 
-    /* Init vars */
-    oh = oi = oj = ok = 0xFFFF;
+/* Copies the pixels of <tex> into <texels> as premultiplied r, g, b, a
+ * bytes. The texture must be locked.
+ */
+static void tex_read_texture(SDL_Surface *tex, Uint8 *texels)
+{
+    SDL_PixelFormat *format = tex->format;
+    int x, y, bpp = format->BytesPerPixel;
+    Uint8 *pixel, r, g, b, a;
+    Uint32 value;
 
-    /* Draw */
-    if (rx >= ry) {
-        ix = 0;
-        iy = rx * 64;
+    for(y = 0; y < tex->h; ++y)
+    {
+        pixel = (Uint8*)tex->pixels + y * tex->pitch;
+        for(x = 0; x < tex->w; ++x, pixel += bpp, texels += 4)
+        {
+            value = tex_load_pixel(pixel, bpp);
+            SDL_GetRGBA(value, format, &r, &g, &b, &a);
+            if(format->Amask == 0)
+                a = 255;
+            texels[0] = (Uint8)((r * a + 127) / 255);
+            texels[1] = (Uint8)((g * a + 127) / 255);
+            texels[2] = (Uint8)((b * a + 127) / 255);
+            texels[3] = a;
+        }
+    }
+}
 
-        do {
-            h = (ix + 8) >> 6;
-            i = (iy + 8) >> 6;
-            j = (h * ry) / rx;
-            k = (i * ry) / rx;
-            if ((ok!=k) && (oj!=k) && (k<ry)) {
-                drawhorzlineclip(dst, color, x-h, y-k-1, x+h-1);
-                drawhorzlineclip(dst, color, x-h, y+k, x+h-1);
-                ok=k;
-            }
-            if ((oj!=j) && (ok!=j) && (k!=j))  {
-                drawhorzlineclip(dst, color, x-i, y+j, x+i-1);
-                drawhorzlineclip(dst, color, x-i, y-j-1, x+i-1);
-                oj=j;
-            }
-            ix = ix + iy / rx;
-            iy = iy - ix / rx;
+static Uint32 tex_load_pixel(Uint8 *pixel, int bpp)
+{
+    switch(bpp)
+    {
+    case 1:
+        return *pixel;
+    case 2:
+        return *(Uint16*)pixel;
+    case 3:
+#if (SDL_BYTEORDER == SDL_LIL_ENDIAN)
+        return pixel[0] | (pixel[1] << 8) | (pixel[2] << 16);
+#else
+        return (pixel[0] << 16) | (pixel[1] << 8) | pixel[2];
+#endif
+    default: /*case 4*/
+        return *(Uint32*)pixel;
+    }
+}
 
-        } while (i > h);
-    } else {
-        ix = 0;
-        iy = ry * 64;
+static void tex_store_pixel(Uint8 *pixel, int bpp, Uint32 value)
+{
+    switch(bpp)
+    {
+    case 1:
+        *pixel = (Uint8)value;
+        break;
+    case 2:
+        *(Uint16*)pixel = (Uint16)value;
+        break;
+    case 3:
+#if (SDL_BYTEORDER == SDL_LIL_ENDIAN)
+        pixel[0] = (Uint8)value;
+        pixel[1] = (Uint8)(value >> 8);
+        pixel[2] = (Uint8)(value >> 16);
+#else
+        pixel[0] = (Uint8)(value >> 16);
+        pixel[1] = (Uint8)(value >> 8);
+        pixel[2] = (Uint8)value;
+#endif
+        break;
+    default: /*case 4*/
+        *(Uint32*)pixel = value;
+        break;
+    }
+}
 
-        do {
-            h = (ix + 8) >> 6;
-            i = (iy + 8) >> 6;
-            j = (h * rx) / ry;
-            k = (i * rx) / ry;
+/* The texel of the wrapped coordinate <u>, 0 when it is nan or lost the
+ * precision to wrap, so that no uv reads outside the texture.
+ */
+#define TEX_TEXEL(u, size) \
+    ((u) > 0 ? ((u) < (size) ? (int)(u) : (size) - 1) : 0)
 
-            if ((oi!=i) && (oh!=i) && (i<ry)) {
-                drawhorzlineclip(dst, color, x-j, y+i, x+j-1);
-                drawhorzlineclip(dst, color, x-j, y-i-1, x+j-1);
-                oi=i;
-            }
-            if ((oh!=h) && (oi!=h) && (i!=h)) {
-                drawhorzlineclip(dst, color, x-k, y+h, x+k-1);
-                drawhorzlineclip(dst, color, x-k, y-h-1, x+k-1);
-                oh=h;
-            }
+/* Writes the texture color <u>, <v> (in texture widths and heights,
+ * repeating) to <rgba> as premultiplied bytes.
+ */
+static void tex_sample(tex_job *job, double u, double v, Uint8 *rgba)
+{
+    int tw = job->tw, th = job->th;
+    int x1, y1, x2, y2, wx, wy, c, top, bottom;
+    Uint8 *p11, *p12, *p21, *p22;
 
-            ix = ix + iy / ry;
-            iy = iy - ix / ry;
+    u *= tw;
+    v *= th;
+    if(!job->smooth)
+    {
+        u -= floor(u / tw) * tw;
+        v -= floor(v / th) * th;
+        x1 = TEX_TEXEL(u, tw);
+        y1 = TEX_TEXEL(v, th);
+        memcpy(rgba, job->texels + (y1 * tw + x1) * 4, 4);
+        return;
+    }
 
-        } while(i > h);
+    /*bilinear, between the four texel centers around the point*/
+    u -= 0.5;
+    v -= 0.5;
+    u -= floor(u / tw) * tw;
+    v -= floor(v / th) * th;
+    x1 = TEX_TEXEL(u, tw);
+    y1 = TEX_TEXEL(v, th);
+    u = MIN(MAX(u, x1), x1 + 0.999);
+    v = MIN(MAX(v, y1), y1 + 0.999);
+    wx = (int)((u - x1) * 256);
+    wy = (int)((v - y1) * 256);
+    x2 = x1 + 1 < tw ? x1 + 1 : 0;
+    y2 = y1 + 1 < th ? y1 + 1 : 0;
+    p11 = job->texels + (y1 * tw + x1) * 4;
+    p12 = job->texels + (y1 * tw + x2) * 4;
+    p21 = job->texels + (y2 * tw + x1) * 4;
+    p22 = job->texels + (y2 * tw + x2) * 4;
+    for(c = 0; c < 4; ++c)
+    {
+        top = p11[c] * (256 - wx) + p12[c] * wx;
+        bottom = p21[c] * (256 - wx) + p22[c] * wx;
+        rgba[c] = (Uint8)((top * (256 - wy) + bottom * wy + 32768) >> 16);
     }
 }
 
+/* (v + 127) / 255 for 0 <= v <= 255 * 255 */
+#define TEX_DIV255(v) ((((v) + 128) + (((v) + 128) >> 8)) >> 8)
 
-static int compare_int(const void *a, const void *b)
+/* Draws the pixels xa to xb of row y of the triangle, blending the
+ * premultiplied texture colors over the surface.
+ */
+static void tex_draw_span(tex_job *job, tex_triangle *tri, int xa, int xb, int y)
 {
-    return (*(const int *)a) - (*(const int *)b);
+    SDL_Surface *surf = job->surf;
+    SDL_PixelFormat *format = surf->format;
+    int bpp = format->BytesPerPixel, x, inv;
+    int rgb8 = bpp == 4 && !format->Rloss && !format->Gloss && !format->Bloss;
+    double xc = xa + 0.5, yc = y + 0.5;
+    double s = tri->s[0] * xc + tri->s[1] * yc + tri->s[2];
+    double t = tri->t[0] * xc + tri->t[1] * yc + tri->t[2];
+    double q = tri->q[0] * xc + tri->q[1] * yc + tri->q[2];
+    Uint8 *pixel = (Uint8*)surf->pixels + y * surf->pitch + xa * bpp;
+    Uint8 src[4], r, g, b, a;
+    Uint32 value;
+
+    for(x = xa; x <= xb; ++x, pixel += bpp)
+    {
+        if(job->perspective)
+            tex_sample(job, s / q, t / q, src);
+        else
+            tex_sample(job, s, t, src);
+        s += tri->s[0];
+        t += tri->t[0];
+        q += tri->q[0];
+        if(src[3] == 0)
+            continue;
+
+        inv = 255 - src[3];
+        if(rgb8)
+        {
+            value = *(Uint32*)pixel;
+            if(inv)
+            {
+                src[0] += TEX_DIV255(((value >> format->Rshift) & 0xff) * inv);
+                src[1] += TEX_DIV255(((value >> format->Gshift) & 0xff) * inv);
+                src[2] += TEX_DIV255(((value >> format->Bshift) & 0xff) * inv);
+                src[3] += TEX_DIV255(((value & format->Amask) >> format->Ashift) * inv);
+            }
+            *(Uint32*)pixel = ((Uint32)src[0] << format->Rshift) |
+                              ((Uint32)src[1] << format->Gshift) |
+                              ((Uint32)src[2] << format->Bshift) |
+                              (((Uint32)src[3] << format->Ashift) & format->Amask);
+            continue;
+        }
+        if(inv)
+        {
+            SDL_GetRGBA(tex_load_pixel(pixel, bpp), format, &r, &g, &b, &a);
+            if(format->Amask == 0)
+                a = 0;
+            src[0] += TEX_DIV255(r * inv);
+            src[1] += TEX_DIV255(g * inv);
+            src[2] += TEX_DIV255(b * inv);
+            src[3] += TEX_DIV255(a * inv);
+        }
+        tex_store_pixel(pixel, bpp,
+                        SDL_MapRGBA(format, src[0], src[1], src[2], src[3]));
+    }
 }
 
-static void draw_fillpoly(SDL_Surface *dst, int *vx, int *vy, int n, Uint32 color)
+/* Finds the pixels of row <y> inside the triangle, limited to x1 to x2.
+ * Returns 0 when there are none.
+ */
+static int tex_span(tex_triangle *tri, int y, int x1, int x2, int *xa, int *xb)
 {
+    double yc = y + 0.5, lo = x1, hi = x2 + 1, k, edge;
     int i;
-    int y;
-    int miny, maxy;
-    int x1, y1;
-    int x2, y2;
-    int ind1, ind2;
-    int ints;
-    int *polyints = PyMem_New(int, n);
-    if (polyints == NULL) {
-        PyErr_NoMemory();
-        return;
-    }
 
+    for(i = 0; i < 3; ++i)
+    {
+        k = tri->ey[i] * yc + tri->ec[i];
+        if(tri->ex[i] > 0)
+        {
+            /*left edge, the pixel centers on it are inside*/
+            edge = ceil(-k / tri->ex[i] - 0.5);
+            if(edge > lo)
+                lo = edge;
+        }
+        else if(tri->ex[i] < 0)
+        {
+            edge = ceil(-k / tri->ex[i] - 0.5);
+            if(edge < hi)
+                hi = edge;
+        }
+        else if(k < 0 || (k == 0 && tri->ey[i] < 0))
+            return 0;  /*below a bottom edge or above a top edge*/
+    }
+    if(!(lo < hi))
+        return 0;
+    *xa = (int)lo;
+    *xb = (int)hi - 1;
+    return 1;
+}
 
-    /* Determine Y maxima */
-    miny = vy[0];
-    maxy = vy[0];
-    for (i=1; (i < n); i++)
+static void tex_draw_tile(tex_job *job, int tile)
+{
+    int left = job->left + (tile % job->tiles_x) * TEX_TILE;
+    int top = job->top + (tile / job->tiles_x) * TEX_TILE;
+    int right = MIN(left + TEX_TILE - 1, job->right);
+    int bottom = MIN(top + TEX_TILE - 1, job->bottom);
+    int i, y, y1, y2, xa, xb;
+    tex_triangle *tri;
+
+    for(i = job->bin_start[tile]; i < job->bin_start[tile + 1]; ++i)
     {
-        miny = MIN(miny, vy[i]);
-        maxy = MAX(maxy, vy[i]);
+        tri = job->tris + job->bins[i];
+        y1 = MAX(tri->top, top);
+        y2 = MIN(tri->bottom, bottom);
+        for(y = y1; y <= y2; ++y)
+        {
+            if(tex_span(tri, y, MAX(tri->left, left), MIN(tri->right, right),
+                        &xa, &xb))
+                tex_draw_span(job, tri, xa, xb, y);
+        }
     }
+}
 
-    /* Draw, scanning y */
-    for(y=miny; (y <= maxy); y++) {
-        ints = 0;
-        for (i=0; (i < n); i++) {
-            if (!i) {
-                ind1 = n-1;
-                ind2 = 0;
-            } else {
-                ind1 = i-1;
-                ind2 = i;
-            }
-            y1 = vy[ind1];
-            y2 = vy[ind2];
-            if (y1 < y2) {
-                x1 = vx[ind1];
-                x2 = vx[ind2];
-            } else if (y1 > y2) {
-                y2 = vy[ind1];
-                y1 = vy[ind2];
-                x2 = vx[ind1];
-                x1 = vx[ind2];
-            } else if (miny == maxy) {
-                /* Special case: polygon only 1 pixel high. */
-                int j;
-                int minx, maxx;
-
-                /* Determine X bounds */
-                minx = vx[0];
-                maxx = vx[0];
-                for (j=1; (j < n); j++) {
-                    minx = MIN(minx, vx[j]);
-                    maxx = MAX(maxx, vx[j]);
-                }
+/* Thread of tex_draw, drawing every job->threads'th tile. */
+static int tex_draw_thread(void *data)
+{
+    tex_worker *worker = (tex_worker*)data;
+    tex_job *job = worker->job;
+    int tile;
 
-                /* Just a line from minimum to maximum X */
-                polyints[ints++] = minx;
-                polyints[ints++] = maxx;
-                break;
-            } else {
-                continue;
-            }
-            if ((y >= y1) && (y < y2)) {
-                polyints[ints++] = (y-y1) * (x2-x1) / (y2-y1) + x1;
-            } else if ((y == maxy) && (y > y1) && (y <= y2)) {
-                polyints[ints++] = (y-y1) * (x2-x1) / (y2-y1) + x1;
-            }
-        }
-        qsort(polyints, ints, sizeof(int), compare_int);
+    for(tile = worker->first; tile < job->tiles; tile += job->threads)
+        tex_draw_tile(job, tile);
+    return 0;
+}
 
-        for (i=0; (i<ints); i+=2) {
-            drawhorzlineclip(dst, color, polyints[i], y, polyints[i+1]);
-        }
+/* Draws all tiles of the job, on job->threads threads including the
+ * calling one. A tile is only drawn by one thread, so the threads never
+ * touch the same pixels. Runs without the GIL.
+ */
+static void tex_draw(tex_job *job)
+{
+    tex_worker workers[TEX_MAX_THREADS];
+    SDL_Thread *threads[TEX_MAX_THREADS];
+    int i;
+
+    for(i = 0; i < job->threads; ++i)
+    {
+        workers[i].job = job;
+        workers[i].first = i;
+        threads[i] = NULL;
+    }
+    for(i = 1; i < job->threads; ++i)
+    {
+#if IS_SDLv2
+        threads[i] = SDL_CreateThread(tex_draw_thread, "pygame.draw",
+                                      workers + i);
+#else
+        threads[i] = SDL_CreateThread(tex_draw_thread, workers + i);
+#endif
+    }
+    tex_draw_thread(workers);
+    for(i = 1; i < job->threads; ++i)
+    {
+        if(threads[i] != NULL)
+            SDL_WaitThread(threads[i], NULL);
+        else
+            tex_draw_thread(workers + i); /*could not start the thread*/
     }
-    PyMem_Free(polyints);
 }
 
+/* Number of threads to draw <area> pixels in <tiles> tiles with. Small
+ * jobs are not worth starting threads for.
+ */
+static int tex_thread_count(int tiles, double area)
+{
+    int count = 1;
+
+#if IS_SDLv2
+    count = SDL_GetCPUCount();
+#endif
+    if(area < TEX_THREAD_AREA)
+        return 1;
+    count = MIN(count, TEX_MAX_THREADS);
+    count = MIN(count, tiles);
+    return MAX(count, 1);
+}
 
+static void tex_job_free(tex_job *job)
+{
+    PyMem_Del(job->tris);
+    PyMem_Del(job->texels);
+    PyMem_Del(job->bin_start);
+    PyMem_Del(job->bins);
+}
 
 static PyMethodDef _draw_methods[] =
 {
-    { "aaline", aaline, METH_VARARGS, DOC_PYGAMEDRAWAALINE },
+    { "aaline", (PyCFunction)aaline, METH_VARARGS | METH_KEYWORDS,
+      DOC_PYGAMEDRAWAALINE },
     { "line", line, METH_VARARGS, DOC_PYGAMEDRAWLINE },
-    { "aalines", aalines, METH_VARARGS, DOC_PYGAMEDRAWAALINES },
+    { "aalines", (PyCFunction)aalines, METH_VARARGS | METH_KEYWORDS,
+      DOC_PYGAMEDRAWAALINES },
     { "lines", lines, METH_VARARGS, DOC_PYGAMEDRAWLINES },
-    { "ellipse", ellipse, METH_VARARGS, DOC_PYGAMEDRAWELLIPSE },
+    { "ellipse", (PyCFunction)ellipse, METH_VARARGS | METH_KEYWORDS,
+      DOC_PYGAMEDRAWELLIPSE },
     { "arc", arc, METH_VARARGS, DOC_PYGAMEDRAWARC },
-    { "circle", circle, METH_VARARGS, DOC_PYGAMEDRAWCIRCLE },
-    { "polygon", polygon, METH_VARARGS, DOC_PYGAMEDRAWPOLYGON },
+    { "circle", (PyCFunction)circle, METH_VARARGS | METH_KEYWORDS,
+      DOC_PYGAMEDRAWCIRCLE },
+    { "polygon", (PyCFunction)polygon, METH_VARARGS | METH_KEYWORDS,
+      DOC_PYGAMEDRAWPOLYGON },
     { "rect", rect, METH_VARARGS, DOC_PYGAMEDRAWRECT },
+    { "lines_batch", lines_batch, METH_VARARGS, DOC_PYGAMEDRAWLINESBATCH },
+    { "circles", circles, METH_VARARGS, DOC_PYGAMEDRAWCIRCLES },
+    { "rects", rects, METH_VARARGS, DOC_PYGAMEDRAWRECTS },
+    { "textured_triangles", (PyCFunction)textured_triangles,
+      METH_VARARGS | METH_KEYWORDS, DOC_PYGAMEDRAWTEXTUREDTRIANGLES },
 
     { NULL, NULL, 0, NULL }
 };
@@ -30,6 +30,15 @@
 
 #include "structmember.h"
 
+#ifdef MS_WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 #if IS_SDLv2
 /*only register one block of user events.*/
 static int have_registered_events = 0;
@@ -39,20 +48,32 @@ static int have_registered_events = 0;
 //          include it there for now.
 #include <SDL_syswm.h>
 
-/*this user event object is for safely passing
- *objects through the event queue.
+/*this user event object table is for safely passing
+ *objects through the event queue. A posted event carries the handle of
+ *its slot in data1, the slot index in the low bits and the generation
+ *of the slot in the high bits, so stale or foreign handles are caught.
  */
 
 #define USEROBJECT_CHECK1 0xDEADBEEF
 #define USEROBJECT_CHECK2 0xFEEDF00D
+#define USEROBJECT_INDEX_BITS 20
+#define USEROBJECT_INDEX_MASK ((1 << USEROBJECT_INDEX_BITS) - 1)
+#define USEROBJECT_GENERATION_MASK (0x7FFFFFFF >> USEROBJECT_INDEX_BITS)
+
+#define IS_USEROBJECT_EVENT(e)                          \
+    ((e)->user.code == (Sint32)USEROBJECT_CHECK1 &&     \
+     (e)->user.data2 == (void*)USEROBJECT_CHECK2)
 
-typedef struct UserEventObject
+typedef struct
 {
-    struct UserEventObject* next;
-    PyObject* object;
-} UserEventObject;
+    PyObject* object;       /* NULL for free slots */
+    Uint32 generation;
+    int next_free;          /* next slot of the free list, -1 at the end */
+} UserEventSlot;
 
-static UserEventObject* user_event_objects = NULL;
+static UserEventSlot* user_event_slots = NULL;
+static int user_event_size = 0;
+static int user_event_free = -1;
 
 #if IS_SDLv2
 /*SDL 2 to SDL 1.2 event mapping and SDL 1.2 key repeat emulation*/
@@ -106,80 +127,529 @@ pg_GetKeyRepeat (int* delay, int* interval)
 }
 #endif /* IS_SDLv2 */
 
-/*must pass dictionary as this object*/
-static UserEventObject*
+/*must pass dictionary as this object. Returns the handle of its slot,
+ *or -1 with an exception set.
+ */
+static long
 user_event_addobject (PyObject* obj)
 {
-    UserEventObject* userobj = PyMem_New (UserEventObject, 1);
-    if (!userobj)
-        return NULL;
+    UserEventSlot* slot;
+    int index, i, size;
 
-    Py_INCREF (obj);
-    userobj->next = user_event_objects;
-    userobj->object = obj;
-    user_event_objects = userobj;
+    if (user_event_free < 0)
+    {
+        size = user_event_size ? user_event_size * 2 : 64;
+        if (size > USEROBJECT_INDEX_MASK + 1)
+        {
+            PyErr_SetString (pgExc_SDLError, "too many posted events");
+            return -1;
+        }
+        slot = user_event_slots;
+        if (!PyMem_Resize (slot, UserEventSlot, size))
+        {
+            PyErr_NoMemory ();
+            return -1;
+        }
+        user_event_slots = slot;
+        for (i = size - 1; i >= user_event_size; --i)
+        {
+            slot[i].object = NULL;
+            slot[i].generation = 0;
+            slot[i].next_free = user_event_free;
+            user_event_free = i;
+        }
+        user_event_size = size;
+    }
 
-    return userobj;
+    index = user_event_free;
+    slot = user_event_slots + index;
+    user_event_free = slot->next_free;
+    Py_INCREF (obj);
+    slot->object = obj;
+    return (long)((slot->generation << USEROBJECT_INDEX_BITS) | index);
 }
 
-/*note, we doublecheck to make sure the pointer is in our list,
- *not just some random pointer. this will keep us safe(r).
+/*note, we doublecheck the handle against its slot, so a handle that
+ *was already used, or some random value, gives NULL.
  */
+static UserEventSlot*
+user_event_slot (void* handle)
+{
+    Uint32 value = (Uint32)(size_t)handle;
+    int index = (int)(value & USEROBJECT_INDEX_MASK);
+    UserEventSlot* slot;
+
+    if (index >= user_event_size)
+        return NULL;
+    slot = user_event_slots + index;
+    if (!slot->object ||
+        slot->generation != value >> USEROBJECT_INDEX_BITS)
+        return NULL;
+    return slot;
+}
+
+/*borrowed reference to the object of a handle, it stays in its slot*/
 static PyObject*
-user_event_getobject (UserEventObject* userobj)
+user_event_peekobject (void* handle)
 {
-    PyObject* obj = NULL;
-    if (!user_event_objects) /*fail in most common case*/
+    UserEventSlot* slot = user_event_slot (handle);
+
+    return slot ? slot->object : NULL;
+}
+
+static PyObject*
+user_event_getobject (void* handle)
+{
+    UserEventSlot* slot = user_event_slot (handle);
+    int index;
+    PyObject* obj;
+
+    if (!slot)
         return NULL;
-    if (user_event_objects == userobj)
+    index = (int)(slot - user_event_slots);
+    obj = slot->object;
+    slot->object = NULL;
+    slot->generation = (slot->generation + 1) & USEROBJECT_GENERATION_MASK;
+    slot->next_free = user_event_free;
+    user_event_free = index;
+    return obj;
+}
+
+static void
+user_event_cleanup (void)
+{
+    int i;
+
+    for (i = 0; i < user_event_size; ++i)
+        Py_XDECREF (user_event_slots[i].object);
+    PyMem_Del (user_event_slots);
+    user_event_slots = NULL;
+    user_event_size = 0;
+    user_event_free = -1;
+}
+
+/*frees what an event taken off the queue holds, for events that are
+ *dropped without becoming an Event object.
+ */
+static void
+event_release (SDL_Event* event)
+{
+    if (IS_USEROBJECT_EVENT (event))
+        Py_XDECREF (user_event_getobject (event->user.data1));
+    else if (event->type == SDL_USEREVENT && event->user.code == 0x1000)
     {
-        obj = userobj->object;
-        user_event_objects = userobj->next;
+        free (event->user.data1);
+        event->user.data1 = NULL;
     }
-    else
+}
+
+/*the thread ring: a fixed ring of events that any thread can post to
+ *without the GIL, moved onto the SDL queue whenever pygame pumps events.
+ *On SDL 2 posting is lock-free, each cell has a sequence number telling
+ *if it is free for the current lap or holds an event to be read. The
+ *number is kept relative to the cell index, so a zeroed ring is empty.
+ *SDL 1.2 has no atomics, there a mutex guards the ring.
+ *Only the thread holding the GIL drains it.
+ */
+#define EVENT_RING_SIZE 4096  /* a power of two */
+#define EVENT_RING_MASK (EVENT_RING_SIZE - 1)
+
+static SDL_Event ring_events[EVENT_RING_SIZE];
+static Uint32 ring_head = 0;        /* next event to read */
+static Uint32 ring_high_water = 0;  /* most events waiting at a drain */
+#if IS_SDLv1
+static SDL_mutex* ring_lock = NULL;
+static Uint32 ring_tail = 0;
+static Uint32 ring_dropped = 0;
+#else /* IS_SDLv2 */
+static SDL_atomic_t ring_sequence[EVENT_RING_SIZE];
+static SDL_atomic_t ring_tail;      /* next cell to post to */
+static SDL_atomic_t ring_dropped;
+#endif /* IS_SDLv2 */
+
+/*puts a copy of <event> on the ring, returns 0 if the ring is full.
+ *Safe to call from any thread, with or without the GIL.
+ */
+static int
+pg_PostEventThreaded (SDL_Event* event)
+{
+#if IS_SDLv1
+    if (!ring_lock)
+        return 0;
+    SDL_mutexP (ring_lock);
+    if (ring_tail - ring_head == EVENT_RING_SIZE)
     {
-        UserEventObject* hunt = user_event_objects;
-        while (hunt && hunt->next != userobj)
-            hunt = hunt->next;
-        if (hunt)
+        ++ring_dropped;
+        SDL_mutexV (ring_lock);
+        return 0;
+    }
+    ring_events[ring_tail & EVENT_RING_MASK] = *event;
+    ++ring_tail;
+    SDL_mutexV (ring_lock);
+    return 1;
+#else /* IS_SDLv2 */
+    Uint32 pos = (Uint32)SDL_AtomicGet (&ring_tail);
+    Uint32 lap, seq;
+
+    for (;;)
+    {
+        lap = pos & ~EVENT_RING_MASK;
+        seq = (Uint32)SDL_AtomicGet (ring_sequence + (pos & EVENT_RING_MASK));
+        if (seq == lap)
+        {
+            /*the cell is free, claim it*/
+            if (SDL_AtomicCAS (&ring_tail, (int)pos, (int)(pos + 1)))
+                break;
+        }
+        else if ((Sint32)(seq - lap) < 0)
         {
-            hunt->next = userobj->next;
-            obj = userobj->object;
+            /*still holds an event from the lap before*/
+            SDL_AtomicAdd (&ring_dropped, 1);
+            return 0;
         }
+        pos = (Uint32)SDL_AtomicGet (&ring_tail);
     }
-    if (obj)
-        PyMem_Del (userobj);
-    return obj;
+    ring_events[pos & EVENT_RING_MASK] = *event;
+    SDL_AtomicSet (ring_sequence + (pos & EVENT_RING_MASK), (int)(lap + 1));
+    return 1;
+#endif /* IS_SDLv2 */
+}
+
+/*the number of events posted to the ring so far, wraps around*/
+static Uint32
+ring_posted (void)
+{
+#if IS_SDLv1
+    Uint32 posted;
+
+    if (!ring_lock)
+        return 0;
+    SDL_mutexP (ring_lock);
+    posted = ring_tail;
+    SDL_mutexV (ring_lock);
+    return posted;
+#else /* IS_SDLv2 */
+    return (Uint32)SDL_AtomicGet (&ring_tail);
+#endif /* IS_SDLv2 */
 }
 
+/*moves the events waiting on the ring onto the SDL queue, in the order
+ *they were posted. Blocked events are dropped like event.post() does,
+ *and events that do not fit stay on the ring for the next time.
+ */
 static void
-user_event_cleanup (void)
+ring_drain (void)
 {
-    if (user_event_objects)
+    SDL_Event* event;
+    Uint32 waiting;
+    int status;
+
+#if IS_SDLv1
+    if (!ring_lock)
+        return;
+    SDL_mutexP (ring_lock);
+    waiting = ring_tail - ring_head;
+#else /* IS_SDLv2 */
+    waiting = (Uint32)SDL_AtomicGet (&ring_tail) - ring_head;
+#endif /* IS_SDLv2 */
+    if (waiting > ring_high_water)
+        ring_high_water = waiting;
+
+    for (; waiting; --waiting)
     {
-        UserEventObject *hunt, *kill;
-        hunt = user_event_objects;
-        while (hunt)
+        event = ring_events + (ring_head & EVENT_RING_MASK);
+#if IS_SDLv2
+        /*claimed, but the poster is not done writing it yet*/
+        if ((Uint32)SDL_AtomicGet (ring_sequence +
+                                   (ring_head & EVENT_RING_MASK)) !=
+            (ring_head & ~EVENT_RING_MASK) + 1)
+            break;
+#endif /* IS_SDLv2 */
+        if (SDL_EventState (event->type, SDL_QUERY) == SDL_IGNORE)
+            event_release (event);
+        else
         {
-            kill = hunt;
-            hunt = hunt->next;
-            Py_DECREF (kill->object);
-            PyMem_Del (kill);
+            status = SDL_PushEvent (event);
+#if IS_SDLv1
+            if (status == -1)
+                break;
+#else /* IS_SDLv2 */
+            if (status < 0)
+                break;
+            if (status == 0)
+                event_release (event);
+#endif /* IS_SDLv2 */
         }
-        user_event_objects = NULL;
+#if IS_SDLv2
+        SDL_AtomicSet (ring_sequence + (ring_head & EVENT_RING_MASK),
+                       (int)((ring_head & ~EVENT_RING_MASK) +
+                             EVENT_RING_SIZE));
+#endif /* IS_SDLv2 */
+        ++ring_head;
+    }
+#if IS_SDLv1
+    SDL_mutexV (ring_lock);
+#endif /* IS_SDLv1 */
+}
+
+/*event logs of start_recording() and replay(): a header, then a record
+ *for every event taken off the queue with the ticks since the recording
+ *started and the raw SDL_Event. Events made by the program itself, user
+ *events and posted Events, are left out, and so are the ones carrying
+ *pointers. The records have a fixed size so a log is replayed straight
+ *from a memory map of the file.
+ */
+#define EVENTLOG_MAGIC "PGEVLOG1"
+
+typedef struct {
+    char magic[8];
+    Uint32 record_size;     /* differs between SDL versions and builds */
+    Uint32 reserved;
+} EventLogHeader;
+
+typedef struct {
+    Uint32 ticks;
+    SDL_Event event;
+} EventLogRecord;
+
+static FILE* record_file = NULL;
+static Uint32 record_start = 0;
+
+static const char* replay_base = NULL;  /* the mapped log */
+static size_t replay_size = 0;
+static const EventLogRecord* replay_records = NULL;
+static Py_ssize_t replay_count = 0;
+static Py_ssize_t replay_next = 0;
+static Uint32 replay_start = 0;
+static double replay_speed = 1.0;
+
+static void
+record_event (SDL_Event* event)
+{
+    EventLogRecord rec;
+
+    if (!record_file || event->type >= SDL_USEREVENT ||
+        event->type == SDL_SYSWMEVENT || IS_USEROBJECT_EVENT (event))
+        return;
+    memset (&rec, 0, sizeof (rec));
+    rec.ticks = SDL_GetTicks () - record_start;
+    rec.event = *event;
+    fwrite (&rec, sizeof (rec), 1, record_file);
+}
+
+static void
+stop_recording_file (void)
+{
+    if (record_file)
+        fclose (record_file);
+    record_file = NULL;
+}
+
+/*maps a whole file for reading, NULL if it cannot be opened or is empty*/
+static const char*
+map_file (const char* path, size_t* size)
+{
+#ifdef MS_WIN32
+    HANDLE file, map;
+    LARGE_INTEGER length;
+    void* base;
+
+    file = CreateFileA (path, GENERIC_READ, FILE_SHARE_READ, NULL,
+                        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+        return NULL;
+    if (!GetFileSizeEx (file, &length) || length.QuadPart == 0)
+    {
+        CloseHandle (file);
+        return NULL;
+    }
+    map = CreateFileMappingA (file, NULL, PAGE_READONLY, 0, 0, NULL);
+    CloseHandle (file);
+    if (!map)
+        return NULL;
+    base = MapViewOfFile (map, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle (map);
+    *size = (size_t)length.QuadPart;
+    return (const char*)base;
+#else
+    struct stat st;
+    void* base;
+    int fd = open (path, O_RDONLY);
+
+    if (fd < 0)
+        return NULL;
+    if (fstat (fd, &st) || st.st_size == 0)
+    {
+        close (fd);
+        return NULL;
+    }
+    base = mmap (NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close (fd);
+    if (base == MAP_FAILED)
+        return NULL;
+    *size = (size_t)st.st_size;
+    return (const char*)base;
+#endif
+}
+
+static void
+stop_replay_file (void)
+{
+    if (replay_base)
+    {
+#ifdef MS_WIN32
+        UnmapViewOfFile (replay_base);
+#else
+        munmap ((void*)replay_base, replay_size);
+#endif
+    }
+    replay_base = NULL;
+    replay_records = NULL;
+    replay_count = replay_next = 0;
+}
+
+/*puts the logged events that are due on the queue. The log is closed
+ *once all of it was replayed. Returns the milliseconds until the next
+ *logged event is due.
+ */
+static Uint32
+replay_pump (void)
+{
+    SDL_Event event;
+    double elapsed, due;
+    int status;
+
+    if (!replay_records)
+        return PG_TIMER_IDLE;
+    elapsed = (double)(SDL_GetTicks () - replay_start) * replay_speed;
+    for (; replay_next < replay_count; ++replay_next)
+    {
+        if (replay_speed > 0.0 &&
+            replay_records[replay_next].ticks > elapsed)
+            break;
+        event = replay_records[replay_next].event;
+        if (SDL_EventState (event.type, SDL_QUERY) == SDL_IGNORE)
+            continue;
+        status = SDL_PushEvent (&event);
+#if IS_SDLv1
+        if (status == -1)
+#else /* IS_SDLv2 */
+        if (status < 0)
+#endif /* IS_SDLv2 */
+            return 1;  /* the queue is full, try again soon */
+    }
+    if (replay_next == replay_count)
+    {
+        stop_replay_file ();
+        return PG_TIMER_IDLE;
+    }
+    due = (replay_records[replay_next].ticks - elapsed) / replay_speed;
+    if (due < 1.0)
+        return 1;
+    /*PG_TIMER_IDLE means nothing is due, a far event is still due*/
+    return due < (double)(PG_TIMER_IDLE - 1) ? (Uint32)due : PG_TIMER_IDLE - 1;
+}
+
+/*1 while event_log_cleanup is on the quit list, pygame.quit() clears it*/
+static int event_log_registered = 0;
+
+static void
+event_log_cleanup (void)
+{
+    stop_recording_file ();
+    stop_replay_file ();
+    event_log_registered = 0;
+}
+
+static void
+event_log_register (void)
+{
+    if (!event_log_registered)
+    {
+        pg_RegisterQuit (event_log_cleanup);
+        event_log_registered = 1;
+    }
+}
+
+/*the timers of the time module, see pg_SetTimerPump*/
+static Uint32 (*timer_pump) (void) = NULL;
+
+static void
+pg_SetTimerPump (Uint32 (*pump) (void))
+{
+    timer_pump = pump;
+}
+
+/*events from timers, other threads and a replayed log. Returns the
+ *milliseconds until the timers or the replay need to run again.
+ */
+static Uint32
+inject_events (void)
+{
+    Uint32 next = timer_pump ? timer_pump () : PG_TIMER_IDLE;
+    Uint32 due;
+
+    ring_drain ();
+    due = replay_pump ();
+    return MIN (next, due);
+}
+
+/*waits for an event without the GIL, for at most <timeout> ms. Returns
+ *1 for an event and 0 when the time ran out or an event was posted to
+ *the ring since it had <posted> events.
+ *Posting to the ring does not touch the SDL queue, so the wait goes in
+ *slices of a millisecond and looks at the ring in between, which is how
+ *SDL's own waits poll the queue.
+ */
+static int
+wait_event (SDL_Event* event, Uint32 timeout, Uint32 posted)
+{
+    Uint32 start = SDL_GetTicks ();
+
+    for (;;)
+    {
+#if IS_SDLv1
+        if (SDL_PollEvent (event))
+            return 1;
+#else /* IS_SDLv2 */
+        if (SDL_WaitEventTimeout (event, 1))
+            return 1;
+#endif /* IS_SDLv2 */
+        if (ring_posted () != posted)
+            return 0;
+        if (timeout != PG_TIMER_IDLE && SDL_GetTicks () - start >= timeout)
+            return 0;
+#if IS_SDLv1
+        SDL_Delay (1);
+#endif /* IS_SDLv1 */
     }
 }
 
+/*every function that pumps events takes those along*/
+static void
+pump_events (void)
+{
+    inject_events ();
+    SDL_PumpEvents ();
+}
+
+static int event_build_dict (pgEventObject* e);
+static void coalesce_queued (SDL_Event* event);
+
 static int pgEvent_FillUserEvent (pgEventObject *e, SDL_Event *event)
 {
-    UserEventObject *userobj = user_event_addobject (e->dict);
-    if (!userobj)
+    long handle;
+
+    if (event_build_dict (e))
+        return -1;
+    handle = user_event_addobject (e->dict);
+    if (handle < 0)
         return -1;
 
     event->type = e->type;
     event->user.code = USEROBJECT_CHECK1;
-    event->user.data1 = (void*)USEROBJECT_CHECK2;
-    event->user.data2 = userobj;
+    event->user.data1 = (void*)(size_t)handle;
+    event->user.data2 = (void*)USEROBJECT_CHECK2;
     return 0;
 }
 
@@ -300,20 +770,31 @@ our_empty_ustr (void)
 #endif /* Py_USING_UNICODE */
 
 #if IS_SDLv2
-/* Convert a KEYDOWN event to a Python unicode string */
-static PyObject*
-key_to_unicode (const SDL_Keysym* key)
+/* The character typed by a KEYDOWN event, 0 for none */
+static long
+key_to_codepoint (const SDL_Keysym* key)
 {
     static const SDL_Keymod ModMask = ~KMOD_SHIFT;
     SDL_Keycode c = key->sym;
     SDL_Keymod m = key->mod;
 
     if (c & 0x40000000)
-        return our_empty_ustr ();
+        return 0;
     if (m & ModMask)
-        return our_empty_ustr ();
+        return 0;
     if (m & KMOD_SHIFT)
         c = Py_UNICODE_TOUPPER (c);
+    return (long)c;
+}
+
+/* Convert a KEYDOWN event to a Python unicode string */
+static PyObject*
+key_to_unicode (const SDL_Keysym* key)
+{
+    long c = key_to_codepoint (key);
+
+    if (!c)
+        return our_empty_ustr ();
     return our_unichr (c);
 }
 #endif /* IS_SDLv2 */
@@ -329,10 +810,9 @@ dict_from_event (SDL_Event* event)
 #endif /* IS_SDLv2 */
 
     /*check if it is an event the user posted*/
-    if (event->user.code == USEROBJECT_CHECK1
-        && event->user.data1 == (void*)USEROBJECT_CHECK2)
+    if (IS_USEROBJECT_EVENT (event))
     {
-        dict = user_event_getobject ((UserEventObject*)event->user.data2);
+        dict = user_event_getobject (event->user.data1);
         if (dict)
             return dict;
     }
@@ -511,6 +991,16 @@ dict_from_event (SDL_Event* event)
     return dict;
 }
 
+/* Builds the dict of an event from the queue the first time it is used. */
+static int
+event_build_dict (pgEventObject* e)
+{
+    if (e->dict)
+        return 0;
+    e->dict = dict_from_event (&e->event);
+    return e->dict ? 0 : -1;
+}
+
 /* event object internals */
 
 static void
@@ -525,7 +1015,10 @@ event_dealloc (PyObject* self)
 /* Because pypy does not work with the __dict__ tp_dictoffset. */
 PyObject* pg_EventGetAttr(PyObject *o, PyObject *attr_name) {
     /* Try e->dict first, if not try the generic attribute. */
-    PyObject* result = PyDict_GetItem(((pgEventObject*)o)->dict, attr_name);
+    PyObject* result;
+    if (event_build_dict((pgEventObject*)o))
+        return NULL;
+    result = PyDict_GetItem(((pgEventObject*)o)->dict, attr_name);
     if (!result) {
         return PyObject_GenericGetAttr(o, attr_name);
     }
@@ -539,7 +1032,10 @@ int pg_EventSetAttr(PyObject *o, PyObject *name, PyObject *value) {
     */
     int dictResult;
     int setInDict = 0;
-    PyObject* result = PyDict_GetItem(((pgEventObject*)o)->dict, name);
+    PyObject* result;
+    if (event_build_dict((pgEventObject*)o))
+        return -1;
+    result = PyDict_GetItem(((pgEventObject*)o)->dict, name);
 
     if (result) {
         setInDict = 1;
@@ -560,6 +1056,28 @@ int pg_EventSetAttr(PyObject *o, PyObject *name, PyObject *value) {
         return PyObject_GenericSetAttr(o, name, value);
     }
 }
+#else
+/* Only names not found on the type look in the dict, so reading type
+ * does not build it.
+ */
+static PyObject*
+event_getattro (PyObject* o, PyObject* name)
+{
+    pgEventObject* e = (pgEventObject*)o;
+
+    if (!e->dict && !_PyType_Lookup (Py_TYPE (o), name) &&
+        event_build_dict (e))
+        return NULL;
+    return PyObject_GenericGetAttr (o, name);
+}
+
+static int
+event_setattro (PyObject* o, PyObject* name, PyObject* value)
+{
+    if (event_build_dict ((pgEventObject*)o))
+        return -1;
+    return PyObject_GenericSetAttr (o, name, value);
+}
 #endif
 
 PyObject*
@@ -575,6 +1093,8 @@ event_str (PyObject* self)
     PyObject *encodedobj;
 #endif
 
+    if (event_build_dict (e))
+        return NULL;
     strobj = PyObject_Str (e->dict);
     if (strobj == NULL) {
         return NULL;
@@ -643,12 +1163,25 @@ static PyNumberMethods event_as_number = {
 #define OFF(x) offsetof(pgEventObject, x)
 
 static PyMemberDef event_members[] = {
-    {"__dict__",  T_OBJECT, OFF(dict), READONLY},
     {"type",      T_INT,    OFF(type), READONLY},
-    {"dict",      T_OBJECT, OFF(dict), READONLY},
     {NULL}  /* Sentinel */
 };
 
+static PyObject*
+event_get_dict (pgEventObject* self, void* closure)
+{
+    if (event_build_dict (self))
+        return NULL;
+    Py_INCREF (self->dict);
+    return self->dict;
+}
+
+static PyGetSetDef event_getsets[] = {
+    {"__dict__", (getter)event_get_dict, NULL, NULL, NULL},
+    {"dict",     (getter)event_get_dict, NULL, NULL, NULL},
+    {NULL, NULL, NULL, NULL, NULL}  /* Sentinel */
+};
+
 /*
  * eventA == eventB
  * eventA != eventB
@@ -665,6 +1198,8 @@ event_richcompare(PyObject *o1, PyObject *o2, int opid)
 
     e1 = (pgEventObject *) o1;
     e2 = (pgEventObject *) o2;
+    if (event_build_dict (e1) || event_build_dict (e2))
+        return NULL;
     switch (opid)
     {
     case Py_EQ:
@@ -709,8 +1244,8 @@ static PyTypeObject pgEvent_Type =
     pg_EventGetAttr,                 /* tp_getattro */
     pg_EventSetAttr,                 /* tp_setattro */
 #else
-    PyObject_GenericGetAttr,         /* tp_getattro */
-    PyObject_GenericSetAttr,         /* tp_setattro */
+    event_getattro,                  /* tp_getattro */
+    event_setattro,                  /* tp_setattro */
 #endif
     0,                               /* tp_as_buffer */
 #if PY3
@@ -727,7 +1262,7 @@ static PyTypeObject pgEvent_Type =
     0,                               /* tp_iternext */
     0,                               /* tp_methods */
     event_members,                   /* tp_members */
-    0,                               /* tp_getset */
+    event_getsets,                   /* tp_getset */
     0,                               /* tp_base */
     0,                               /* tp_dict */
     0,                               /* tp_descr_get */
@@ -746,15 +1281,34 @@ pgEvent_New (SDL_Event* event)
     if(!e)
         return NULL;
 
+    e->dict = NULL;
     if (event)
     {
         e->type = event->type;
-        e->dict = dict_from_event (event);
+        e->event = *event;
+        /* Posted objects, dropped file names and window manager messages
+         * must be read now, the other dicts are built on first use.
+         */
+        if (IS_USEROBJECT_EVENT (event) ||
+            (event->type >= SDL_USEREVENT && event->type < SDL_NUMEVENTS) ||
+            event->type == SDL_SYSWMEVENT)
+        {
+            if (event_build_dict (e))
+            {
+                Py_DECREF (e);
+                return NULL;
+            }
+        }
     }
     else
     {
         e->type = SDL_NOEVENT;
-        e->dict = PyDict_New ();
+        memset (&e->event, 0, sizeof (SDL_Event));
+        if (!(e->dict = PyDict_New ()))
+        {
+            Py_DECREF (e);
+            return NULL;
+        }
     }
     return (PyObject*)e;
 }
@@ -767,6 +1321,7 @@ pgEvent_New2 (int type, PyObject* dict)
     if (e)
     {
         e->type = type;
+        memset (&e->event, 0, sizeof (SDL_Event));
         if (!dict)
             dict = PyDict_New ();
         else
@@ -873,7 +1428,7 @@ static PyObject*
 pygame_pump (PyObject* self, PyObject* args)
 {
     VIDEO_INIT_CHECK ();
-    SDL_PumpEvents ();
+    pump_events ();
     Py_RETURN_NONE;
 }
 
@@ -885,13 +1440,21 @@ pygame_wait (PyObject* self, PyObject* args)
 
     VIDEO_INIT_CHECK ();
 
-    Py_BEGIN_ALLOW_THREADS;
-    status = SDL_WaitEvent (&event);
-    Py_END_ALLOW_THREADS;
-
-    if (!status)
-        return RAISE (pgExc_SDLError, SDL_GetError ());
+    do
+    {
+        /*counted first, what is posted while draining wakes the wait*/
+        Uint32 posted = ring_posted ();
+        Uint32 timeout = inject_events ();
+
+        if (timeout == 0)
+            timeout = 1;
+        Py_BEGIN_ALLOW_THREADS;
+        status = wait_event (&event, timeout, posted);
+        Py_END_ALLOW_THREADS;
+    }
+    while (!status);
 
+    record_event (&event);
     return pgEvent_New (&event);
 }
 
@@ -902,8 +1465,13 @@ pygame_poll (PyObject* self, PyObject* args)
 
     VIDEO_INIT_CHECK ();
 
+    inject_events ();
     if (SDL_PollEvent (&event))
+    {
+        record_event (&event);
+        coalesce_queued (&event);
         return pgEvent_New (&event);
+    }
     return pgEvent_New (NULL);
 }
 
@@ -1085,79 +1653,776 @@ event_clear (PyObject* self, PyObject* args)
                           "get type must be numeric or a sequence");
     }
 
-    SDL_PumpEvents ();
+    pump_events ();
 
 #if IS_SDLv1
     while (SDL_PeepEvents (&event, 1, SDL_GETEVENT, mask) == 1)
 #else /* IS_SDLv2 */
     while (PG_PeepEvent (&event, SDL_GETEVENT, mask) == 1)
 #endif /* IS_SDLv2 */
-    {}
+        event_release (&event);
 
     Py_RETURN_NONE;
 }
 
-static PyObject*
-event_get (PyObject* self, PyObject* args)
+/* Layout of the records written by get_into(). The data fields depend
+ * on the event type, in the order of record_attrs().
+ */
+typedef struct {
+    Sint32 type;
+    Uint32 timestamp;
+    Sint32 data[6];
+} pgEventRecord;
+
+typedef struct {
+    const char* name;
+    int size;               /* number of data fields it fills */
+} RecordAttr;
+
+/* The event attributes stored in the data fields of a record, ending
+ * with a NULL name.
+ */
+static const RecordAttr*
+record_attrs (int type)
+{
+    static const RecordAttr active[] = {{"gain", 1}, {"state", 1}, {NULL}};
+#if IS_SDLv1
+    static const RecordAttr key[] = {{"key", 1}, {"mod", 1}, {"scancode", 1},
+                                     {"unicode", 1}, {NULL}};
+#else /* IS_SDLv2 */
+    static const RecordAttr key[] = {{"key", 1}, {"mod", 1}, {"symbol", 1},
+                                     {"unicode", 1}, {NULL}};
+#endif /* IS_SDLv2 */
+    static const RecordAttr motion[] = {{"pos", 2}, {"rel", 2}, {"buttons", 1},
+                                        {NULL}};
+    static const RecordAttr button[] = {{"pos", 2}, {"button", 1}, {NULL}};
+    static const RecordAttr jaxis[] = {{"joy", 1}, {"axis", 1}, {"value", 1},
+                                       {NULL}};
+    static const RecordAttr jball[] = {{"joy", 1}, {"ball", 1}, {"rel", 2},
+                                       {NULL}};
+    static const RecordAttr jhat[] = {{"joy", 1}, {"hat", 1}, {"value", 2},
+                                      {NULL}};
+    static const RecordAttr jbutton[] = {{"joy", 1}, {"button", 1}, {NULL}};
+    static const RecordAttr resize[] = {{"w", 1}, {"h", 1}, {NULL}};
+    static const RecordAttr user[] = {{"code", 1}, {NULL}};
+    static const RecordAttr none[] = {{NULL}};
+
+    switch (type)
+    {
+    case SDL_ACTIVEEVENT:
+        return active;
+    case SDL_KEYDOWN:
+    case SDL_KEYUP:
+        return key;
+    case SDL_MOUSEMOTION:
+        return motion;
+    case SDL_MOUSEBUTTONDOWN:
+    case SDL_MOUSEBUTTONUP:
+        return button;
+    case SDL_JOYAXISMOTION:
+        return jaxis;
+    case SDL_JOYBALLMOTION:
+        return jball;
+    case SDL_JOYHATMOTION:
+        return jhat;
+    case SDL_JOYBUTTONUP:
+    case SDL_JOYBUTTONDOWN:
+        return jbutton;
+    case SDL_VIDEORESIZE:
+        return resize;
+    }
+    if (type >= SDL_USEREVENT && type < SDL_NUMEVENTS)
+        return user;
+    return none;
+}
+
+/* Fills the data fields of <rec> from the attributes of a posted event.
+ * Missing or unusable attributes leave their fields 0.
+ */
+static void
+record_from_dict (pgEventRecord* rec, PyObject* dict)
+{
+    const RecordAttr* attr = record_attrs (rec->type);
+    Sint32* data = rec->data;
+    PyObject* value;
+    int i, n, pressed;
+    float f;
+
+    for (; attr->name; data += attr->size, ++attr)
+    {
+        value = PyDict_GetItemString (dict, attr->name);
+        if (!value)
+            continue;
+        if (!strcmp (attr->name, "unicode"))
+        {
+#if PY3
+            if (PyUnicode_Check (value) && PyUnicode_GET_LENGTH (value) == 1)
+                data[0] = (Sint32)PyUnicode_READ_CHAR (value, 0);
+#else
+            if (PyUnicode_Check (value) && PyUnicode_GET_SIZE (value) == 1)
+                data[0] = (Sint32)PyUnicode_AS_UNICODE (value)[0];
+#endif
+        }
+        else if (!strcmp (attr->name, "buttons"))
+        {
+            n = PySequence_Check (value) ? (int)PySequence_Size (value) : 0;
+            for (i = 0; i < n && i < 3; ++i)
+            {
+                if (pg_IntFromObjIndex (value, i, &pressed) && pressed)
+                    data[0] |= SDL_BUTTON (i + 1);
+            }
+        }
+        else if (rec->type == SDL_JOYAXISMOTION && attr->size == 1 &&
+                 !strcmp (attr->name, "value"))
+        {
+            if (pg_FloatFromObj (value, &f))
+                data[0] = (Sint32)(f * 32767.0f);
+        }
+        else if (attr->size == 1)
+            pg_IntFromObj (value, (int*)data);
+        else
+            pg_TwoIntsFromObj (value, (int*)data, (int*)data + 1);
+    }
+    PyErr_Clear ();
+}
+
+/* Fills <rec> from an event taken off the queue. The event keeps what
+ * it holds, see event_release().
+ */
+static void
+record_from_event (pgEventRecord* rec, SDL_Event* event)
+{
+    PyObject* dict;
+    Sint32* data = rec->data;
+
+    memset (rec, 0, sizeof (pgEventRecord));
+    rec->type = (Sint32)event->type;
+#if IS_SDLv1
+    rec->timestamp = SDL_GetTicks ();
+#else /* IS_SDLv2 */
+    rec->timestamp = event->common.timestamp;
+#endif /* IS_SDLv2 */
+
+    if (IS_USEROBJECT_EVENT (event))
+    {
+        /*posted with event.post(), the attributes are in its dict*/
+        dict = user_event_peekobject (event->user.data1);
+        if (dict)
+            record_from_dict (rec, dict);
+        return;
+    }
+
+    switch (event->type)
+    {
+#if IS_SDLv1
+    case SDL_ACTIVEEVENT:
+        data[0] = event->active.gain;
+        data[1] = event->active.state;
+        break;
+    case SDL_KEYDOWN:
+        data[3] = event->key.keysym.unicode;
+        /* fall through */
+    case SDL_KEYUP:
+        data[0] = event->key.keysym.sym;
+        data[1] = event->key.keysym.mod;
+        data[2] = event->key.keysym.scancode;
+        break;
+    case SDL_VIDEORESIZE:
+        data[0] = event->resize.w;
+        data[1] = event->resize.h;
+        break;
+#else /* IS_SDLv2 */
+    case SDL_ACTIVEEVENT:
+        switch (event->window.event)
+        {
+        case SDL_WINDOWEVENT_ENTER:
+        case SDL_WINDOWEVENT_LEAVE:
+            data[1] = SDL_APPFOCUSMOUSE;
+            break;
+        case SDL_WINDOWEVENT_FOCUS_GAINED:
+        case SDL_WINDOWEVENT_FOCUS_LOST:
+            data[1] = SDL_APPINPUTFOCUS;
+            break;
+        default:
+            data[1] = SDL_APPACTIVE;
+        }
+        data[0] = (event->window.event == SDL_WINDOWEVENT_ENTER ||
+                   event->window.event == SDL_WINDOWEVENT_FOCUS_GAINED ||
+                   event->window.event == SDL_WINDOWEVENT_RESTORED);
+        break;
+    case SDL_KEYDOWN:
+        data[3] = (Sint32)key_to_codepoint (&event->key.keysym);
+        /* fall through */
+    case SDL_KEYUP:
+        data[0] = event->key.keysym.scancode;
+        data[1] = event->key.keysym.mod;
+        data[2] = event->key.keysym.sym;
+        break;
+    case SDL_VIDEORESIZE:
+        data[0] = event->window.data1;
+        data[1] = event->window.data2;
+        break;
+#endif /* IS_SDLv2 */
+    case SDL_MOUSEMOTION:
+        data[0] = event->motion.x;
+        data[1] = event->motion.y;
+        data[2] = event->motion.xrel;
+        data[3] = event->motion.yrel;
+        data[4] = event->motion.state &
+            (SDL_BUTTON (1) | SDL_BUTTON (2) | SDL_BUTTON (3));
+        break;
+    case SDL_MOUSEBUTTONDOWN:
+    case SDL_MOUSEBUTTONUP:
+        data[0] = event->button.x;
+        data[1] = event->button.y;
+        data[2] = event->button.button;
+        break;
+    case SDL_JOYAXISMOTION:
+        data[0] = event->jaxis.which;
+        data[1] = event->jaxis.axis;
+        data[2] = event->jaxis.value;
+        break;
+    case SDL_JOYBALLMOTION:
+        data[0] = event->jball.which;
+        data[1] = event->jball.ball;
+        data[2] = event->jball.xrel;
+        data[3] = event->jball.yrel;
+        break;
+    case SDL_JOYHATMOTION:
+        data[0] = event->jhat.which;
+        data[1] = event->jhat.hat;
+        if (event->jhat.value&SDL_HAT_UP)
+            data[3] = 1;
+        else if (event->jhat.value&SDL_HAT_DOWN)
+            data[3] = -1;
+        if (event->jhat.value&SDL_HAT_RIGHT)
+            data[2] = 1;
+        else if (event->jhat.value&SDL_HAT_LEFT)
+            data[2] = -1;
+        break;
+    case SDL_JOYBUTTONUP:
+    case SDL_JOYBUTTONDOWN:
+        data[0] = event->jbutton.which;
+        data[1] = event->jbutton.button;
+        break;
+    }
+    if (event->type >= SDL_USEREVENT && event->type < SDL_NUMEVENTS)
+        data[0] = event->user.code;
+}
+
+/* Coalescing: events of the types given to set_coalesce() are merged
+ * as they are taken off the queue, before any Event is made for them.
+ * The policies are kept as event masks, like the blocked types.
+ */
+#define COALESCE_NONE 0
+#define COALESCE_LATEST 1
+#define COALESCE_RELATIVE 2
+
+static Uint32 coalesce_latest = 0;
+static Uint32 coalesce_relative = 0;
+
+static int
+coalesce_policy (Uint32 type)
+{
+    Uint32 bit;
+
+    if (type >= SDL_NUMEVENTS)
+        return COALESCE_NONE;
+    bit = SDL_EVENTMASK (type);
+    if (coalesce_relative & bit)
+        return COALESCE_RELATIVE;
+    if (coalesce_latest & bit)
+        return COALESCE_LATEST;
+    return COALESCE_NONE;
+}
+
+/* Tells if <event> replaces <prev>: the same type, and for joysticks
+ * the same axis, ball or hat. Posted events only merge with posted ones.
+ */
+static int
+coalesce_match (SDL_Event* prev, SDL_Event* event)
+{
+    if (prev->type != event->type)
+        return 0;
+    if (IS_USEROBJECT_EVENT (prev) || IS_USEROBJECT_EVENT (event))
+        return IS_USEROBJECT_EVENT (prev) && IS_USEROBJECT_EVENT (event);
+
+    switch (event->type)
+    {
+    case SDL_JOYAXISMOTION:
+        return (prev->jaxis.which == event->jaxis.which &&
+                prev->jaxis.axis == event->jaxis.axis);
+    case SDL_JOYBALLMOTION:
+        return (prev->jball.which == event->jball.which &&
+                prev->jball.ball == event->jball.ball);
+    case SDL_JOYHATMOTION:
+        return (prev->jhat.which == event->jhat.which &&
+                prev->jhat.hat == event->jhat.hat);
+    }
+    return 1;
+}
+
+/* Replaces <prev> with the later <event>. With the relative policy the
+ * motion of <prev> is added to the rel of mouse and ball events.
+ */
+static void
+coalesce_merge (SDL_Event* prev, SDL_Event* event, int policy)
+{
+    SDL_Event merged = *event;
+
+    if (policy == COALESCE_RELATIVE && !IS_USEROBJECT_EVENT (event))
+    {
+        if (event->type == SDL_MOUSEMOTION)
+        {
+            merged.motion.xrel += prev->motion.xrel;
+            merged.motion.yrel += prev->motion.yrel;
+        }
+        else if (event->type == SDL_JOYBALLMOTION)
+        {
+            merged.jball.xrel += prev->jball.xrel;
+            merged.jball.yrel += prev->jball.yrel;
+        }
+    }
+    event_release (prev);
+    *prev = merged;
+}
+
+/* Merges the <count> events in <events> in place and returns how many
+ * are left. Events are only merged across other coalesced events, never
+ * across one without a policy, so the order of those is kept. Each event
+ * is compared with at most one event per axis, ball or hat waiting.
+ */
+static int
+coalesce_events (SDL_Event* events, int count)
+{
+    int i, j, n = 0, run = 0, policy;
+
+    for (i = 0; i < count; ++i)
+    {
+        policy = coalesce_policy (events[i].type);
+        if (policy == COALESCE_NONE)
+        {
+            events[n++] = events[i];
+            run = n;
+            continue;
+        }
+        for (j = run; j < n; ++j)
+        {
+            if (coalesce_match (events + j, events + i))
+                break;
+        }
+        if (j < n)
+            coalesce_merge (events + j, events + i, policy);
+        else
+            events[n++] = events[i];
+    }
+    return n;
+}
+
+/* Merges the matching events at the front of the queue into <event>,
+ * which was just taken off it.
+ */
+static void
+coalesce_queued (SDL_Event* event)
+{
+    SDL_Event next;
+    int policy = coalesce_policy (event->type);
+
+    if (policy == COALESCE_NONE)
+        return;
+#if IS_SDLv1
+    while (SDL_PeepEvents (&next, 1, SDL_PEEKEVENT, SDL_ALLEVENTS) == 1 &&
+           coalesce_match (event, &next) &&
+           SDL_PeepEvents (&next, 1, SDL_GETEVENT,
+                           SDL_EVENTMASK (next.type)) == 1)
+#else /* IS_SDLv2 */
+    while (SDL_PeepEvents (&next, 1, SDL_PEEKEVENT,
+                           SDL_FIRSTEVENT, SDL_LASTEVENT) == 1 &&
+           coalesce_match (event, &next) &&
+           SDL_PeepEvents (&next, 1, SDL_GETEVENT,
+                           next.type, next.type) == 1)
+#endif /* IS_SDLv2 */
+    {
+        record_event (&next);
+        coalesce_merge (event, &next, policy);
+    }
+}
+
+/* The predicate table of get(filter=...). Each entry is one condition on
+ * an integer field of the event records, events of a type in the table
+ * are only kept when they pass all the conditions for their type.
+ */
+typedef struct {
+    int type;
+    int field;          /* data field of the record, -1 drops the type */
+    Py_ssize_t first;   /* the accepted values in EventFilter.values */
+    Py_ssize_t count;
+} EventPredicate;
+
+typedef struct {
+    EventPredicate* preds;
+    Py_ssize_t npreds;
+    Sint32* values;
+} EventFilter;
+
+static void
+filter_free (EventFilter* filter)
+{
+    PyMem_Del (filter->preds);
+    PyMem_Del (filter->values);
+    filter->preds = NULL;
+    filter->values = NULL;
+    filter->npreds = 0;
+}
+
+/* Reads the condition of one attribute, an int or a sequence of ints,
+ * into the value table.
+ */
+static int
+filter_add_values (EventFilter* filter, EventPredicate* pred,
+                   PyObject* cond, Py_ssize_t* nvalues)
+{
+    Py_ssize_t i, n;
+    int val;
+
+    pred->first = *nvalues;
+    if (pg_IntFromObj (cond, &val))
+    {
+        filter->values[(*nvalues)++] = val;
+        pred->count = 1;
+        return 0;
+    }
+    if (!PySequence_Check (cond))
+    {
+        PyErr_SetString (
+            PyExc_TypeError,
+            "filter values must be integers or sequences of integers");
+        return -1;
+    }
+    n = PySequence_Size (cond);
+    for (i = 0; i < n; ++i)
+    {
+        if (!pg_IntFromObjIndex (cond, (int)i, &val))
+        {
+            PyErr_SetString (
+                PyExc_TypeError,
+                "filter values must be integers or sequences of integers");
+            return -1;
+        }
+        filter->values[(*nvalues)++] = val;
+    }
+    pred->count = n;
+    return 0;
+}
+
+/* Builds the predicate table from a dict of {type: {attribute: values}}
+ * or {type: None}, for None all the events of the type are dropped.
+ */
+static int
+filter_from_dict (PyObject* table, EventFilter* filter)
+{
+    const RecordAttr* attr;
+    PyObject *key, *conds, *cond;
+    Py_ssize_t pos = 0, npreds = 0, nvalues = 0, found, n;
+    int type, field;
+
+    if (!PyDict_Check (table))
+    {
+        PyErr_SetString (PyExc_TypeError,
+                         "filter must be a dict of event types");
+        return -1;
+    }
+
+    /* size the tables first, sequences may hold any number of values */
+    while (PyDict_Next (table, &pos, &key, &conds))
+    {
+        if (!pg_IntFromObj (key, &type))
+        {
+            PyErr_SetString (PyExc_TypeError,
+                             "filter keys must be event types");
+            return -1;
+        }
+        if (conds == Py_None)
+        {
+            ++npreds;
+            continue;
+        }
+        if (!PyDict_Check (conds))
+        {
+            PyErr_SetString (PyExc_TypeError,
+                             "filter conditions must be a dict or None");
+            return -1;
+        }
+        found = 0;
+        while (PyDict_Next (conds, &found, NULL, &cond))
+        {
+            n = PySequence_Check (cond) ? PySequence_Size (cond) : 1;
+            if (n < 0)
+                return -1;
+            ++npreds;
+            nvalues += n;
+        }
+    }
+    filter->preds = PyMem_New (EventPredicate, npreds ? npreds : 1);
+    filter->values = PyMem_New (Sint32, nvalues ? nvalues : 1);
+    if (!filter->preds || !filter->values)
+    {
+        filter_free (filter);
+        PyErr_NoMemory ();
+        return -1;
+    }
+
+    pos = 0;
+    nvalues = 0;
+    while (PyDict_Next (table, &pos, &key, &conds))
+    {
+        pg_IntFromObj (key, &type);
+        if (conds == Py_None)
+        {
+            filter->preds[filter->npreds].type = type;
+            filter->preds[filter->npreds].field = -1;
+            filter->preds[filter->npreds].first = 0;
+            filter->preds[filter->npreds].count = 0;
+            ++filter->npreds;
+            continue;
+        }
+
+        /* only the attributes held in one record field can be tested */
+        found = 0;
+        field = 0;
+        for (attr = record_attrs (type); attr->name; field += attr->size,
+                 ++attr)
+        {
+            cond = PyDict_GetItemString (conds, attr->name);
+            if (!cond)
+                continue;
+            if (attr->size != 1)
+            {
+                PyErr_Format (PyExc_ValueError,
+                              "cannot filter on the '%s' attribute",
+                              attr->name);
+                goto error;
+            }
+            filter->preds[filter->npreds].type = type;
+            filter->preds[filter->npreds].field = field;
+            if (filter_add_values (filter, filter->preds + filter->npreds,
+                                   cond, &nvalues))
+                goto error;
+            ++filter->npreds;
+            ++found;
+        }
+        if (found != PyDict_Size (conds))
+        {
+            PyErr_SetString (PyExc_ValueError,
+                             "filter attribute not found for its event type");
+            goto error;
+        }
+    }
+    return 0;
+
+  error:
+    filter_free (filter);
+    return -1;
+}
+
+/* Tells if <event> passes the conditions for its type. */
+static int
+filter_accepts (EventFilter* filter, SDL_Event* event)
+{
+    pgEventRecord rec;
+    EventPredicate* pred = filter->preds;
+    EventPredicate* end = pred + filter->npreds;
+    Py_ssize_t i;
+    int filled = 0;
+
+    for (; pred < end; ++pred)
+    {
+        if (pred->type != (int)event->type)
+            continue;
+        if (pred->field < 0)
+            return 0;
+        if (!filled)
+        {
+            record_from_event (&rec, event);
+            filled = 1;
+        }
+        for (i = 0; i < pred->count; ++i)
+        {
+            if (filter->values[pred->first + i] == rec.data[pred->field])
+                break;
+        }
+        if (i == pred->count)
+            return 0;
+    }
+    return 1;
+}
+
+static PyObject*
+event_get (PyObject* self, PyObject* args, PyObject* kwds)
 {
     SDL_Event event;
+    SDL_Event* events = NULL;
+    SDL_Event* grown;
+    EventFilter filter = {NULL, 0, NULL};
     int mask = 0;
-    int loop, num;
-    PyObject* type, *list, *e;
+    int loop, num, count = 0, size = 0;
+    PyObject *type = Py_None, *table = Py_None, *list = NULL, *e;
     int val;
+    static char* kwids[] = {"type", "filter", NULL};
 
-    if (PyTuple_Size (args) != 0 && PyTuple_Size (args) != 1)
-        return RAISE (PyExc_ValueError, "get requires 0 or 1 argument");
+    if (!PyArg_ParseTupleAndKeywords (args, kwds, "|OO", kwids,
+                                      &type, &table))
+        return NULL;
 
     VIDEO_INIT_CHECK ();
 
-    if (PyTuple_Size (args) == 0)
+    if (type == Py_None)
         mask = SDL_ALLEVENTS;
-    else
+    else if (PySequence_Check (type))
     {
-        type = PyTuple_GET_ITEM (args, 0);
-        if (PySequence_Check (type))
+        num = PySequence_Size (type);
+        for(loop = 0; loop < num; ++loop)
         {
-            num = PySequence_Size (type);
-            for(loop = 0; loop < num; ++loop)
-            {
-                if (!pg_IntFromObjIndex (type, loop, &val))
-                    return RAISE
-                        (PyExc_TypeError,
-                         "type sequence must contain valid event types");
-                mask |= SDL_EVENTMASK (val);
-            }
+            if (!pg_IntFromObjIndex (type, loop, &val))
+                return RAISE
+                    (PyExc_TypeError,
+                     "type sequence must contain valid event types");
+            mask |= SDL_EVENTMASK (val);
         }
-        else if (pg_IntFromObj (type, &val))
-            mask = SDL_EVENTMASK (val);
-        else
-            return RAISE (PyExc_TypeError,
-                          "get type must be numeric or a sequence");
     }
+    else if (pg_IntFromObj (type, &val))
+        mask = SDL_EVENTMASK (val);
+    else
+        return RAISE (PyExc_TypeError,
+                      "get type must be numeric or a sequence");
 
-    list = PyList_New (0);
-    if (!list)
+    if (table != Py_None && filter_from_dict (table, &filter))
         return NULL;
 
-    SDL_PumpEvents ();
+    pump_events ();
 
+    /* take everything off the queue first, so it can be merged and
+     * filtered before any Event is made
+     */
 #if IS_SDLv1
     while (SDL_PeepEvents (&event, 1, SDL_GETEVENT, mask) == 1)
 #else /* IS_SDLv2 */
     while (PG_PeepEvent (&event, SDL_GETEVENT, mask) == 1)
 #endif /* IS_SDLv2 */
     {
-        e = pgEvent_New (&event);
-        if (!e)
+        record_event (&event);
+        if (count == size)
         {
-            Py_DECREF (list);
-            return NULL;
+            size = size ? size * 2 : 64;
+            grown = events;
+            if (!PyMem_Resize (grown, SDL_Event, size))
+            {
+                event_release (&event);
+                PyErr_NoMemory ();
+                loop = 0;
+                goto error;
+            }
+            events = grown;
         }
+        events[count++] = event;
+    }
+    count = coalesce_events (events, count);
 
-        PyList_Append (list, e);
+    loop = 0;
+    list = PyList_New (0);
+    if (!list)
+        goto error;
+    for (; loop < count; ++loop)
+    {
+        if (filter.preds && !filter_accepts (&filter, events + loop))
+        {
+            event_release (events + loop);
+            continue;
+        }
+        e = pgEvent_New (events + loop);
+        if (!e || PyList_Append (list, e))
+        {
+            Py_XDECREF (e);
+            Py_CLEAR (list);
+            ++loop;
+            goto error;
+        }
         Py_DECREF (e);
     }
+    PyMem_Del (events);
+    filter_free (&filter);
     return list;
+
+  error:
+    for (; loop < count; ++loop)
+        event_release (events + loop);
+    PyMem_Del (events);
+    filter_free (&filter);
+    return NULL;
+}
+
+static PyObject*
+event_get_into (PyObject* self, PyObject* args)
+{
+    SDL_Event event;
+    pgEventRecord rec;
+    Py_buffer view;
+    int mask = 0;
+    int loop, num;
+    PyObject *bufobj, *type = NULL;
+    Py_ssize_t size, count = 0;
+    int val;
+
+    if (!PyArg_ParseTuple (args, "O|O", &bufobj, &type))
+        return NULL;
+
+    VIDEO_INIT_CHECK ();
+
+    if (!type || type == Py_None)
+        mask = SDL_ALLEVENTS;
+    else if (PySequence_Check (type))
+    {
+        num = PySequence_Size (type);
+        for(loop = 0; loop < num; ++loop)
+        {
+            if (!pg_IntFromObjIndex (type, loop, &val))
+                return RAISE
+                    (PyExc_TypeError,
+                     "type sequence must contain valid event types");
+            mask |= SDL_EVENTMASK (val);
+        }
+    }
+    else if (pg_IntFromObj (type, &val))
+        mask = SDL_EVENTMASK (val);
+    else
+        return RAISE (PyExc_TypeError,
+                      "get_into type must be numeric or a sequence");
+
+    if (PyObject_GetBuffer (bufobj, &view,
+                            PyBUF_WRITABLE | PyBUF_C_CONTIGUOUS) != 0)
+        return NULL;
+    size = view.len / (Py_ssize_t)sizeof (pgEventRecord);
+
+    pump_events ();
+
+    /* the records are copied in as the buffer need not be aligned */
+    while (count < size &&
+#if IS_SDLv1
+           SDL_PeepEvents (&event, 1, SDL_GETEVENT, mask) == 1)
+#else /* IS_SDLv2 */
+           PG_PeepEvent (&event, SDL_GETEVENT, mask) == 1)
+#endif /* IS_SDLv2 */
+    {
+        record_event (&event);
+        coalesce_queued (&event);
+        record_from_event (&rec, &event);
+        event_release (&event);
+        memcpy ((char*)view.buf + count * sizeof (pgEventRecord), &rec,
+                sizeof (pgEventRecord));
+        ++count;
+    }
+    PyBuffer_Release (&view);
+    return PyInt_FromLong ((long)count);
 }
 
 static PyObject*
@@ -1202,7 +2467,7 @@ event_peek (PyObject* self, PyObject* args)
                           "peek type must be numeric or a sequence");
     }
 
-    SDL_PumpEvents ();
+    pump_events ();
 #if IS_SDLv1
     result = SDL_PeepEvents (&event, 1, SDL_PEEKEVENT, mask);
 #else /* IS_SDLv2 */
@@ -1248,6 +2513,147 @@ event_post (PyObject* self, PyObject* args)
     Py_RETURN_NONE;
 }
 
+static PyObject*
+event_post_threaded (PyObject* self, PyObject* args)
+{
+    pgEventObject* e;
+    SDL_Event event;
+
+    if (!PyArg_ParseTuple (args, "O!", &pgEvent_Type, &e))
+        return NULL;
+
+    if (pgEvent_FillUserEvent (e, &event))
+        return NULL;
+    if (!pg_PostEventThreaded (&event))
+    {
+        event_release (&event);
+        Py_RETURN_FALSE;
+    }
+    Py_RETURN_TRUE;
+}
+
+static PyObject*
+get_threaded_stats (PyObject* self)
+{
+    unsigned long posted, dropped;
+
+#if IS_SDLv1
+    if (ring_lock)
+        SDL_mutexP (ring_lock);
+    posted = ring_tail;
+    dropped = ring_dropped;
+    if (ring_lock)
+        SDL_mutexV (ring_lock);
+#else /* IS_SDLv2 */
+    posted = (Uint32)SDL_AtomicGet (&ring_tail);
+    dropped = (Uint32)SDL_AtomicGet (&ring_dropped);
+#endif /* IS_SDLv2 */
+    return Py_BuildValue ("(kkk)", posted, dropped,
+                          (unsigned long)ring_high_water);
+}
+
+static PyObject*
+start_recording (PyObject* self, PyObject* args)
+{
+    EventLogHeader header;
+    char* path;
+
+    if (!PyArg_ParseTuple (args, "s", &path))
+        return NULL;
+
+    VIDEO_INIT_CHECK ();
+
+    stop_recording_file ();
+    record_file = fopen (path, "wb");
+    if (!record_file)
+        return PyErr_SetFromErrnoWithFilename (PyExc_IOError, path);
+
+    memset (&header, 0, sizeof (header));
+    memcpy (header.magic, EVENTLOG_MAGIC, sizeof (header.magic));
+    header.record_size = (Uint32)sizeof (EventLogRecord);
+    if (fwrite (&header, sizeof (header), 1, record_file) != 1)
+    {
+        stop_recording_file ();
+        return PyErr_SetFromErrnoWithFilename (PyExc_IOError, path);
+    }
+    record_start = SDL_GetTicks ();
+    event_log_register ();
+    Py_RETURN_NONE;
+}
+
+static PyObject*
+stop_recording (PyObject* self)
+{
+    stop_recording_file ();
+    Py_RETURN_NONE;
+}
+
+static PyObject*
+event_replay (PyObject* self, PyObject* args, PyObject* kwds)
+{
+    const EventLogHeader* header;
+    char* path;
+    double speed = 1.0;
+    static char* kwids[] = {"path", "speed", NULL};
+
+    if (!PyArg_ParseTupleAndKeywords (args, kwds, "s|d", kwids,
+                                      &path, &speed))
+        return NULL;
+    if (speed < 0.0)
+        return RAISE (PyExc_ValueError, "speed must not be negative");
+
+    VIDEO_INIT_CHECK ();
+
+    stop_replay_file ();
+    replay_base = map_file (path, &replay_size);
+    if (!replay_base)
+        return RAISE (PyExc_IOError, "cannot read the event log");
+
+    header = (const EventLogHeader*)replay_base;
+    if (replay_size < sizeof (EventLogHeader) ||
+        memcmp (header->magic, EVENTLOG_MAGIC, sizeof (header->magic)))
+    {
+        stop_replay_file ();
+        return RAISE (PyExc_ValueError, "not an event log");
+    }
+    if (header->record_size != sizeof (EventLogRecord))
+    {
+        stop_replay_file ();
+        return RAISE (PyExc_ValueError,
+                      "the event log was written by another pygame build");
+    }
+
+    /* a record cut short at the end is left out */
+    replay_records = (const EventLogRecord*)(header + 1);
+    replay_count = (Py_ssize_t)((replay_size - sizeof (EventLogHeader)) /
+                                sizeof (EventLogRecord));
+    replay_next = 0;
+    replay_speed = speed;
+    replay_start = SDL_GetTicks ();
+    if (!replay_count)
+    {
+        stop_replay_file ();
+        return PyInt_FromLong (0);
+    }
+    event_log_register ();
+    return PyInt_FromSsize_t (replay_count);
+}
+
+static PyObject*
+stop_replay (PyObject* self)
+{
+    Py_ssize_t left = replay_count - replay_next;
+
+    stop_replay_file ();
+    return PyInt_FromSsize_t (left);
+}
+
+static PyObject*
+get_replay_pending (PyObject* self)
+{
+    return PyInt_FromSsize_t (replay_count - replay_next);
+}
+
 static int
 CheckEventInRange(int evt)
 {
@@ -1373,6 +2779,59 @@ get_blocked (PyObject* self, PyObject* args)
     return PyInt_FromLong (isblocked);
 }
 
+static PyObject*
+set_coalesce (PyObject* self, PyObject* args)
+{
+    int loop, num;
+    PyObject* type;
+    const char* name;
+    Uint32 mask = 0;
+    int val, policy;
+
+    if (!PyArg_ParseTuple (args, "Oz", &type, &name))
+        return NULL;
+
+    if (!name)
+        policy = COALESCE_NONE;
+    else if (!strcmp (name, "latest"))
+        policy = COALESCE_LATEST;
+    else if (!strcmp (name, "relative"))
+        policy = COALESCE_RELATIVE;
+    else
+        return RAISE (PyExc_ValueError,
+                      "policy must be None, 'latest' or 'relative'");
+
+    if (PySequence_Check (type))
+    {
+        num = PySequence_Length (type);
+        for (loop = 0; loop < num; ++loop)
+        {
+            if (!pg_IntFromObjIndex (type, loop, &val))
+                return RAISE (PyExc_TypeError,
+                              "type sequence must contain valid event types");
+            if (!CheckEventInRange (val) || SDL_EVENTMASK (val) == 0)
+                return RAISE (PyExc_ValueError, "Invalid event in sequence");
+            mask |= SDL_EVENTMASK (val);
+        }
+    }
+    else if (pg_IntFromObj (type, &val))
+    {
+        if (!CheckEventInRange (val) || SDL_EVENTMASK (val) == 0)
+            return RAISE (PyExc_ValueError, "Invalid event");
+        mask = SDL_EVENTMASK (val);
+    }
+    else
+        return RAISE (PyExc_TypeError, "type must be numeric or a sequence");
+
+    coalesce_latest &= ~mask;
+    coalesce_relative &= ~mask;
+    if (policy == COALESCE_LATEST)
+        coalesce_latest |= mask;
+    else if (policy == COALESCE_RELATIVE)
+        coalesce_relative |= mask;
+    Py_RETURN_NONE;
+}
+
 static PyMethodDef _event_methods[] =
 {
     { "Event", (PyCFunction)Event, 3, DOC_PYGAMEEVENTEVENT },
@@ -1385,13 +2844,31 @@ static PyMethodDef _event_methods[] =
     { "wait", (PyCFunction) pygame_wait, METH_NOARGS, DOC_PYGAMEEVENTWAIT },
     { "poll", (PyCFunction) pygame_poll, METH_NOARGS, DOC_PYGAMEEVENTPOLL },
     { "clear", event_clear, METH_VARARGS, DOC_PYGAMEEVENTCLEAR },
-    { "get", event_get, METH_VARARGS, DOC_PYGAMEEVENTGET },
+    { "get", (PyCFunction)event_get, METH_VARARGS | METH_KEYWORDS,
+      DOC_PYGAMEEVENTGET },
+    { "get_into", event_get_into, METH_VARARGS, DOC_PYGAMEEVENTGETINTO },
     { "peek", event_peek, METH_VARARGS, DOC_PYGAMEEVENTPEEK },
     { "post", event_post, METH_VARARGS, DOC_PYGAMEEVENTPOST },
+    { "post_threaded", event_post_threaded, METH_VARARGS,
+      DOC_PYGAMEEVENTPOSTTHREADED },
+    { "get_threaded_stats", (PyCFunction) get_threaded_stats, METH_NOARGS,
+      DOC_PYGAMEEVENTGETTHREADEDSTATS },
+
+    { "start_recording", start_recording, METH_VARARGS,
+      DOC_PYGAMEEVENTSTARTRECORDING },
+    { "stop_recording", (PyCFunction) stop_recording, METH_NOARGS,
+      DOC_PYGAMEEVENTSTOPRECORDING },
+    { "replay", (PyCFunction) event_replay, METH_VARARGS | METH_KEYWORDS,
+      DOC_PYGAMEEVENTREPLAY },
+    { "stop_replay", (PyCFunction) stop_replay, METH_NOARGS,
+      DOC_PYGAMEEVENTSTOPREPLAY },
+    { "get_replay_pending", (PyCFunction) get_replay_pending, METH_NOARGS,
+      DOC_PYGAMEEVENTGETREPLAYPENDING },
 
     { "set_allowed", set_allowed, METH_VARARGS, DOC_PYGAMEEVENTSETALLOWED },
     { "set_blocked", set_blocked, METH_VARARGS, DOC_PYGAMEEVENTSETBLOCKED },
     { "get_blocked", get_blocked, METH_VARARGS, DOC_PYGAMEEVENTGETBLOCKED },
+    { "set_coalesce", set_coalesce, METH_VARARGS, DOC_PYGAMEEVENTSETCOALESCE },
 
     { NULL, NULL, 0, NULL }
 };
@@ -1461,11 +2938,22 @@ MODINIT_DEFINE (event)
     }
 
     SDL_SetEventFilter (event_filter, NULL);
-#endif /* IS_SDLv2 */
+#else /* IS_SDLv1 */
+    if (!ring_lock) {
+        ring_lock = SDL_CreateMutex ();
+        if (!ring_lock) {
+            PyErr_SetString (pgExc_SDLError, SDL_GetError ());
+            DECREF_MOD (module);
+            MODINIT_ERROR;
+        }
+    }
+#endif /* IS_SDLv1 */
 
     /* export the c api */
-#if IS_SDLv2
-    assert (PYGAMEAPI_EVENT_NUMSLOTS == 6);
+#if IS_SDLv1
+    assert (PYGAMEAPI_EVENT_NUMSLOTS == 7);
+#else /* IS_SDLv2 */
+    assert (PYGAMEAPI_EVENT_NUMSLOTS == 9);
 #endif /* IS_SDLv2 */
     c_api[0] = &pgEvent_Type;
     c_api[1] = pgEvent_New;
@@ -1475,6 +2963,9 @@ MODINIT_DEFINE (event)
     c_api[4] = pg_EnableKeyRepeat;
     c_api[5] = pg_GetKeyRepeat;
 #endif /* IS_SDLv2 */
+    c_api[PYGAMEAPI_EVENT_NUMSLOTS - 3] = pump_events;
+    c_api[PYGAMEAPI_EVENT_NUMSLOTS - 2] = pg_SetTimerPump;
+    c_api[PYGAMEAPI_EVENT_NUMSLOTS - 1] = pg_PostEventThreaded;
     apiobj = encapsulate_api (c_api, "event");
     if (apiobj == NULL) {
         DECREF_MOD (module);
@@ -1490,7 +2981,7 @@ MODINIT_DEFINE (event)
     /* Assume if there are events in the user events list
      * there is also a registered cleanup callback for them.
      */
-    if (user_event_objects == NULL) {
+    if (user_event_slots == NULL) {
         pg_RegisterQuit (user_event_cleanup);
     }
     MODINIT_RETURN (module);
@@ -97,7 +97,8 @@ static PyObject *
 fastevent_pump (PyObject * self)
 {
     FE_INIT_CHECK ();
-    FE_PumpEvents ();
+    /*runs the timers of the time module and the event ring too*/
+    pg_PumpEvents ();
     Py_RETURN_NONE;
 }
 
@@ -119,6 +120,8 @@ fastevent_wait (PyObject * self)
 
     FE_INIT_CHECK ();
 
+    /*timers that fall due while blocked wait for the next call*/
+    pg_PumpEvents ();
     Py_BEGIN_ALLOW_THREADS;
     status = FE_WaitEvent (&event);
     Py_END_ALLOW_THREADS;
@@ -145,6 +148,7 @@ fastevent_poll (PyObject * self)
 
     FE_INIT_CHECK ();
 
+    pg_PumpEvents ();
     status = FE_PollEvent (&event);
     if (status == 1)
         return pgEvent_New (&event);
@@ -173,7 +177,7 @@ fastevent_get (PyObject * self)
     if (!list)
         return NULL;
 
-    FE_PumpEvents ();
+    pg_PumpEvents ();
 
     while (1)
     {
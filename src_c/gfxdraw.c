@@ -22,7 +22,6 @@
   from Pygame 2.
 
   TODO:
-  - fix filledPolygonRGBA to use MT versions for threaded use.
   - do a filled pie version using filledPieColor
   - Determine if SDL video must be initiated for all routines to work.
     Add check if required, else remove ASSERT_VIDEO_INIT.
@@ -59,6 +58,7 @@ static PyObject* _gfx_aapolygoncolor (PyObject *self, PyObject* args);
 static PyObject* _gfx_filledpolygoncolor (PyObject *self, PyObject* args);
 static PyObject* _gfx_texturedpolygon (PyObject *self, PyObject* args);
 static PyObject* _gfx_beziercolor (PyObject *self, PyObject* args);
+static PyObject* _gfx_setscalarblend (PyObject *self, PyObject* arg);
 
 static PyMethodDef _gfxdraw_methods[] = {
     { "pixel", _gfx_pixelcolor, METH_VARARGS, DOC_PYGAMEGFXDRAWPIXEL },
@@ -83,6 +83,9 @@ static PyMethodDef _gfxdraw_methods[] = {
     { "filled_polygon", _gfx_filledpolygoncolor, METH_VARARGS, DOC_PYGAMEGFXDRAWFILLEDPOLYGON },
     { "textured_polygon", _gfx_texturedpolygon, METH_VARARGS, DOC_PYGAMEGFXDRAWTEXTUREDPOLYGON },
     { "bezier", _gfx_beziercolor, METH_VARARGS, DOC_PYGAMEGFXDRAWBEZIER },
+    { "_set_scalar_blend", _gfx_setscalarblend, METH_O,
+      "_set_scalar_blend(scalar) -> bool\n"
+      "blend 32 bit spans one pixel at a time, for benchmarks" },
     { NULL, NULL, 0, NULL },
 };
 
@@ -267,6 +270,7 @@ _gfx_boxcolor (PyObject *self, PyObject* args)
     PyObject *surface, *color, *rect;
     GAME_Rect temprect, *sdlrect;
     Sint16 x1, x2, _y1, y2;
+    int ret;
     Uint8 rgba[4];
 
     ASSERT_VIDEO_INIT (NULL);
@@ -293,9 +297,16 @@ _gfx_boxcolor (PyObject *self, PyObject* args)
     x2 = (Sint16) (sdlrect->x + sdlrect->w - 1);
     y2 = (Sint16) (sdlrect->y + sdlrect->h - 1);
 
-    if (boxRGBA (pgSurface_AsSurface (surface), x1, _y1, x2, y2,
-                 rgba[0], rgba[1], rgba[2], rgba[3]) ==
-        -1) {
+    if (!pgSurface_Lock (surface))
+        return NULL;
+    Py_BEGIN_ALLOW_THREADS;
+    ret = boxRGBA (pgSurface_AsSurface (surface), x1, _y1, x2, y2,
+                   rgba[0], rgba[1], rgba[2], rgba[3]);
+    Py_END_ALLOW_THREADS;
+    if (!pgSurface_Unlock (surface))
+        return NULL;
+
+    if (ret == -1) {
         PyErr_SetString (pgExc_SDLError, SDL_GetError ());
         return NULL;
     }
@@ -438,6 +449,7 @@ _gfx_filledcirclecolor (PyObject *self, PyObject* args)
 {
     PyObject *surface, *color;
     Sint16 x, y, r;
+    int ret;
     Uint8 rgba[4];
 
     ASSERT_VIDEO_INIT (NULL);
@@ -457,8 +469,16 @@ _gfx_filledcirclecolor (PyObject *self, PyObject* args)
         return NULL;
     }
 
-    if (filledCircleRGBA (pgSurface_AsSurface (surface), x, y, r,
-                          rgba[0], rgba[1], rgba[2], rgba[3]) == -1)
+    if (!pgSurface_Lock (surface))
+        return NULL;
+    Py_BEGIN_ALLOW_THREADS;
+    ret = filledCircleRGBA (pgSurface_AsSurface (surface), x, y, r,
+                            rgba[0], rgba[1], rgba[2], rgba[3]);
+    Py_END_ALLOW_THREADS;
+    if (!pgSurface_Unlock (surface))
+        return NULL;
+
+    if (ret == -1)
     {
         PyErr_SetString (pgExc_SDLError, SDL_GetError ());
         return NULL;
@@ -537,6 +557,7 @@ _gfx_filledellipsecolor (PyObject *self, PyObject* args)
 {
     PyObject *surface, *color;
     Sint16 x, y, rx, ry;
+    int ret;
     Uint8 rgba[4];
 
     ASSERT_VIDEO_INIT (NULL);
@@ -556,9 +577,16 @@ _gfx_filledellipsecolor (PyObject *self, PyObject* args)
         return NULL;
     }
 
-    if (filledEllipseRGBA (pgSurface_AsSurface (surface), x, y, rx, ry,
-                           rgba[0], rgba[1], rgba[2], rgba[3]) ==
-        -1)
+    if (!pgSurface_Lock (surface))
+        return NULL;
+    Py_BEGIN_ALLOW_THREADS;
+    ret = filledEllipseRGBA (pgSurface_AsSurface (surface), x, y, rx, ry,
+                             rgba[0], rgba[1], rgba[2], rgba[3]);
+    Py_END_ALLOW_THREADS;
+    if (!pgSurface_Unlock (surface))
+        return NULL;
+
+    if (ret == -1)
     {
         PyErr_SetString (pgExc_SDLError, SDL_GetError ());
         return NULL;
@@ -571,6 +599,7 @@ _gfx_piecolor (PyObject *self, PyObject* args)
 {
     PyObject *surface, *color;
     Sint16 x, y, r, start, end;
+    int ret;
     Uint8 rgba[4];
 
     ASSERT_VIDEO_INIT (NULL);
@@ -590,8 +619,16 @@ _gfx_piecolor (PyObject *self, PyObject* args)
         return NULL;
     }
 
-    if (pieRGBA (pgSurface_AsSurface (surface), x, y, r, start, end,
-                 rgba[0], rgba[1], rgba[2], rgba[3]) == -1)
+    if (!pgSurface_Lock (surface))
+        return NULL;
+    Py_BEGIN_ALLOW_THREADS;
+    ret = pieRGBA (pgSurface_AsSurface (surface), x, y, r, start, end,
+                   rgba[0], rgba[1], rgba[2], rgba[3]);
+    Py_END_ALLOW_THREADS;
+    if (!pgSurface_Unlock (surface))
+        return NULL;
+
+    if (ret == -1)
     {
         PyErr_SetString (pgExc_SDLError, SDL_GetError ());
         return NULL;
@@ -671,6 +708,7 @@ _gfx_filledtrigoncolor (PyObject *self, PyObject* args)
 {
     PyObject *surface, *color;
     Sint16 x1, x2, x3, _y1, y2, y3;
+    int ret;
     Uint8 rgba[4];
 
     ASSERT_VIDEO_INIT (NULL);
@@ -690,8 +728,16 @@ _gfx_filledtrigoncolor (PyObject *self, PyObject* args)
         return NULL;
     }
 
-    if (filledTrigonRGBA (pgSurface_AsSurface (surface), x1, _y1, x2, y2,
-                          x3, y3, rgba[0], rgba[1], rgba[2], rgba[3]) == -1)
+    if (!pgSurface_Lock (surface))
+        return NULL;
+    Py_BEGIN_ALLOW_THREADS;
+    ret = filledTrigonRGBA (pgSurface_AsSurface (surface), x1, _y1, x2, y2,
+                            x3, y3, rgba[0], rgba[1], rgba[2], rgba[3]);
+    Py_END_ALLOW_THREADS;
+    if (!pgSurface_Unlock (surface))
+        return NULL;
+
+    if (ret == -1)
     {
         PyErr_SetString (pgExc_SDLError, SDL_GetError ());
         return NULL;
@@ -770,6 +816,12 @@ _gfx_polygoncolor (PyObject *self, PyObject* args)
         vy[i] = y;
     }
 
+    if (!pgSurface_Lock (surface))
+    {
+        PyMem_Free (vx);
+        PyMem_Free (vy);
+        return NULL;
+    }
     Py_BEGIN_ALLOW_THREADS;
     ret = polygonRGBA (pgSurface_AsSurface (surface), vx, vy, (int)count,
                        rgba[0], rgba[1], rgba[2], rgba[3]);
@@ -777,6 +829,8 @@ _gfx_polygoncolor (PyObject *self, PyObject* args)
 
     PyMem_Free (vx);
     PyMem_Free (vy);
+    if (!pgSurface_Unlock (surface))
+        return NULL;
 
     if (ret == -1)
     {
@@ -857,6 +911,12 @@ _gfx_aapolygoncolor (PyObject *self, PyObject* args)
         vy[i] = y;
     }
 
+    if (!pgSurface_Lock (surface))
+    {
+        PyMem_Free (vx);
+        PyMem_Free (vy);
+        return NULL;
+    }
     Py_BEGIN_ALLOW_THREADS;
     ret = aapolygonRGBA (pgSurface_AsSurface (surface), vx, vy, (int)count,
                          rgba[0], rgba[1], rgba[2], rgba[3]);
@@ -864,6 +924,8 @@ _gfx_aapolygoncolor (PyObject *self, PyObject* args)
 
     PyMem_Free (vx);
     PyMem_Free (vy);
+    if (!pgSurface_Unlock (surface))
+        return NULL;
 
     if (ret == -1)
     {
@@ -880,6 +942,8 @@ _gfx_filledpolygoncolor (PyObject *self, PyObject* args)
     Sint16 *vx, *vy, x, y;
     Py_ssize_t count, i;
     int ret;
+    int *polyints = NULL;
+    int polyallocated = 0;
     Uint8 rgba[4];
 
     ASSERT_VIDEO_INIT (NULL);
@@ -945,13 +1009,23 @@ _gfx_filledpolygoncolor (PyObject *self, PyObject* args)
         vy[i] = y;
     }
 
+    if (!pgSurface_Lock (surface))
+    {
+        PyMem_Free (vx);
+        PyMem_Free (vy);
+        return NULL;
+    }
     Py_BEGIN_ALLOW_THREADS;
-    ret = filledPolygonRGBA (pgSurface_AsSurface (surface), vx, vy,
-                             (int)count, rgba[0], rgba[1], rgba[2], rgba[3]);
+    ret = filledPolygonRGBAMT (pgSurface_AsSurface (surface), vx, vy,
+                               (int)count, rgba[0], rgba[1], rgba[2], rgba[3],
+                               &polyints, &polyallocated);
     Py_END_ALLOW_THREADS;
 
+    free (polyints);
     PyMem_Free (vx);
     PyMem_Free (vy);
+    if (!pgSurface_Unlock (surface))
+        return NULL;
 
     if (ret == -1)
     {
@@ -1042,6 +1116,19 @@ _gfx_texturedpolygon (PyObject *self, PyObject* args)
         vy[i] = y;
     }
 
+    if (!pgSurface_Lock (surface))
+    {
+        PyMem_Free (vx);
+        PyMem_Free (vy);
+        return NULL;
+    }
+    if (!pgSurface_Lock (texture))
+    {
+        pgSurface_Unlock (surface);
+        PyMem_Free (vx);
+        PyMem_Free (vy);
+        return NULL;
+    }
     Py_BEGIN_ALLOW_THREADS;
     ret = texturedPolygon (s_surface, vx, vy, (int)count,
                            s_texture, tdx, tdy);
@@ -1049,6 +1136,13 @@ _gfx_texturedpolygon (PyObject *self, PyObject* args)
 
     PyMem_Free (vx);
     PyMem_Free (vy);
+    if (!pgSurface_Unlock (texture))
+    {
+        pgSurface_Unlock (surface);
+        return NULL;
+    }
+    if (!pgSurface_Unlock (surface))
+        return NULL;
 
     if (ret == -1)
     {
@@ -1132,6 +1226,12 @@ _gfx_beziercolor (PyObject *self, PyObject* args)
         vy[i] = y;
     }
 
+    if (!pgSurface_Lock (surface))
+    {
+        PyMem_Free (vx);
+        PyMem_Free (vy);
+        return NULL;
+    }
     Py_BEGIN_ALLOW_THREADS;
     ret = bezierRGBA (pgSurface_AsSurface (surface), vx, vy, (int)count,
                       steps, rgba[0], rgba[1], rgba[2], rgba[3]);
@@ -1139,6 +1239,8 @@ _gfx_beziercolor (PyObject *self, PyObject* args)
 
     PyMem_Free (vx);
     PyMem_Free (vy);
+    if (!pgSurface_Unlock (surface))
+        return NULL;
 
     if (ret == -1)
     {
@@ -1148,6 +1250,16 @@ _gfx_beziercolor (PyObject *self, PyObject* args)
     Py_RETURN_NONE;
 }
 
+static PyObject*
+_gfx_setscalarblend (PyObject *self, PyObject* arg)
+{
+    int scalar = PyObject_IsTrue (arg);
+
+    if (scalar == -1)
+        return NULL;
+    return PyBool_FromLong (gfxPrimitivesSetScalarBlend (scalar));
+}
+
 MODINIT_DEFINE(gfxdraw)
 {
     PyObject *module;
@@ -31,8 +31,15 @@
 #include "pgopengl.h"
 #endif /* IS_SDLv1 */
 
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define PG_IMAGE_SSE2
+#endif
+
 struct _module_state {
     int is_extended;
+    PyObject *extload;          /* load_extended, or NULL */
 };
 
 #if PY3
@@ -104,6 +111,405 @@ image_load_basic(PyObject *self, PyObject *arg)
 }
 
 
+/*load(format_like=...) converts the loaded pixels right away. A 32 bit
+ *image going to another 32 bit layout is swizzled where it is, and the
+ *pixels are moved into a Surface of the new format, so no second copy of
+ *the image is made. Everything else goes through SDL_ConvertSurface.
+ */
+static int
+byte_mask_shift(Uint32 mask)
+{
+    switch (mask) {
+    case 0xffU:
+        return 0;
+    case 0xff00U:
+        return 8;
+    case 0xff0000U:
+        return 16;
+    case 0xff000000U:
+        return 24;
+    }
+    return -1;
+}
+
+/* Swizzles the w by h pixels in place. src and dst hold the shifts of the
+ * red, green, blue and alpha bytes, -1 for no alpha.
+ */
+static void
+swizzle_32(Uint8 *pixels, int w, int h, int pitch,
+           const int *src, const int *dst)
+{
+    Uint32 fill = (src[3] < 0 && dst[3] >= 0) ? 0xffU << dst[3] : 0;
+    int channels = (src[3] >= 0 && dst[3] >= 0) ? 4 : 3;
+    Uint32 *pixel, *end, p, out;
+    int y, c;
+#ifdef PG_IMAGE_SSE2
+    __m128i in, acc, sshift[4], dshift[4];
+    __m128i byte = _mm_set1_epi32(0xff);
+    __m128i vfill = _mm_set1_epi32((int)fill);
+
+    for (c = 0; c < channels; ++c) {
+        sshift[c] = _mm_cvtsi32_si128(src[c]);
+        dshift[c] = _mm_cvtsi32_si128(dst[c]);
+    }
+#endif
+
+    for (y = 0; y < h; ++y) {
+        pixel = (Uint32 *)(pixels + y * pitch);
+        end = pixel + w;
+#ifdef PG_IMAGE_SSE2
+        for (; end - pixel >= 4; pixel += 4) {
+            in = _mm_loadu_si128((__m128i *)pixel);
+            acc = vfill;
+            for (c = 0; c < channels; ++c) {
+                acc = _mm_or_si128(acc, _mm_sll_epi32(
+                    _mm_and_si128(_mm_srl_epi32(in, sshift[c]), byte),
+                    dshift[c]));
+            }
+            _mm_storeu_si128((__m128i *)pixel, acc);
+        }
+#endif
+        for (; pixel < end; ++pixel) {
+            p = *pixel;
+            out = fill;
+            for (c = 0; c < channels; ++c) {
+                out |= ((p >> src[c]) & 0xffU) << dst[c];
+            }
+            *pixel = out;
+        }
+    }
+}
+
+/*moves the pixels of surf into dst, a 0 by 0 Surface of the new format,
+ *after swizzling them. Returns 0 when the formats do not allow it.
+ */
+static int
+convert_in_place(SDL_Surface *surf, SDL_Surface *dst)
+{
+    SDL_PixelFormat *sf = surf->format;
+    SDL_PixelFormat *df = dst->format;
+    int src[4], dstsh[4];
+#if IS_SDLv2
+    Uint32 key;
+
+    if (SDL_GetColorKey(surf, &key) == 0) {
+        return 0;
+    }
+#else /* IS_SDLv1 */
+    if (surf->flags & (SDL_SRCCOLORKEY | SDL_RLEACCEL)) {
+        return 0;
+    }
+#endif /* IS_SDLv1 */
+    /*pixels SDL does not own can not change hands*/
+    if (sf->BytesPerPixel != 4 || df->BytesPerPixel != 4 ||
+        (surf->flags & SDL_PREALLOC) || surf->locked) {
+        return 0;
+    }
+    src[0] = byte_mask_shift(sf->Rmask);
+    src[1] = byte_mask_shift(sf->Gmask);
+    src[2] = byte_mask_shift(sf->Bmask);
+    src[3] = sf->Amask ? byte_mask_shift(sf->Amask) : -1;
+    dstsh[0] = byte_mask_shift(df->Rmask);
+    dstsh[1] = byte_mask_shift(df->Gmask);
+    dstsh[2] = byte_mask_shift(df->Bmask);
+    dstsh[3] = df->Amask ? byte_mask_shift(df->Amask) : -1;
+    if (src[0] < 0 || src[1] < 0 || src[2] < 0 ||
+        dstsh[0] < 0 || dstsh[1] < 0 || dstsh[2] < 0 ||
+        (sf->Amask && src[3] < 0) || (df->Amask && dstsh[3] < 0)) {
+        return 0;
+    }
+
+    swizzle_32((Uint8 *)surf->pixels, surf->w, surf->h, surf->pitch,
+               src, dstsh);
+    dst->w = surf->w;
+    dst->h = surf->h;
+    dst->pitch = surf->pitch;
+    dst->pixels = surf->pixels;
+#ifdef SDL_SIMD_ALIGNED
+    /*freed the way it was allocated*/
+    dst->flags |= surf->flags & SDL_SIMD_ALIGNED;
+#endif
+    surf->pixels = NULL;
+    SDL_SetClipRect(dst, NULL);
+    return 1;
+}
+
+/*the pixel format asked for by format_like, as a 0 by 0 Surface*/
+static SDL_Surface*
+format_like_surface(PyObject *format_like, SDL_Surface *image)
+{
+    SDL_Surface *like = NULL;
+    SDL_Surface *dst;
+    PyObject *oencoded;
+    Uint32 masks[4] = {0, 0, 0, 0};
+    int bits = 32;
+    int i, is_display = 0;
+
+    if (pgSurface_Check(format_like)) {
+        like = pgSurface_AsSurface(format_like);
+        if (!like) {
+            return (SDL_Surface *)RAISE(pgExc_SDLError,
+                                        "display Surface quit");
+        }
+    }
+    else if (IsTextObj(format_like)) {
+        oencoded = pgRWopsEncodeString(format_like, NULL, NULL, NULL);
+        if (oencoded == NULL) {
+            return NULL;
+        }
+        is_display = (oencoded != Py_None &&
+                      !strcmp(Bytes_AS_STRING(oencoded), "display"));
+        Py_DECREF(oencoded);
+        if (!is_display) {
+            return (SDL_Surface *)RAISE(PyExc_ValueError,
+                                        "format_like must be 'display'"
+                                        " when it is a string");
+        }
+#if IS_SDLv2
+        oencoded = pg_GetDefaultWindowSurface();
+        like = oencoded ? pgSurface_AsSurface(oencoded) : NULL;
+#else /* IS_SDLv1 */
+        like = SDL_GetVideoSurface();
+#endif /* IS_SDLv1 */
+        if (!like) {
+            return (SDL_Surface *)RAISE(pgExc_SDLError,
+                                        "No video mode has been set");
+        }
+    }
+    else if (PySequence_Check(format_like) &&
+             PySequence_Size(format_like) == 4) {
+        for (i = 0; i < 4; ++i) {
+            PyObject *item = PySequence_GetItem(format_like, i);
+
+            if (item == NULL) {
+                return NULL;
+            }
+            if (!pg_UintFromObj(item, masks + i)) {
+                Py_DECREF(item);
+                return (SDL_Surface *)RAISE(PyExc_TypeError,
+                                            "invalid mask values");
+            }
+            Py_DECREF(item);
+        }
+    }
+    else {
+        return (SDL_Surface *)RAISE(PyExc_TypeError,
+                                    "format_like must be a Surface,"
+                                    " 'display' or a sequence of 4 masks");
+    }
+
+    if (is_display && image->format->Amask) {
+        /*like convert_alpha(), red and blue in the order of the display*/
+        masks[3] = 0xff000000U;
+        masks[1] = 0x0000ff00U;
+        if (like->format->BytesPerPixel == 4 &&
+            like->format->Rmask == 0xffU) {
+            masks[0] = 0x000000ffU;
+            masks[2] = 0x00ff0000U;
+        }
+        else {
+            masks[0] = 0x00ff0000U;
+            masks[2] = 0x000000ffU;
+        }
+    }
+    else if (like) {
+        bits = like->format->BitsPerPixel;
+        masks[0] = like->format->Rmask;
+        masks[1] = like->format->Gmask;
+        masks[2] = like->format->Bmask;
+        masks[3] = like->format->Amask;
+    }
+
+    dst = SDL_CreateRGBSurface(0, 0, 0, bits, masks[0], masks[1], masks[2],
+                               masks[3]);
+    if (dst == NULL) {
+        return (SDL_Surface *)RAISE(pgExc_SDLError, SDL_GetError());
+    }
+    if (like && bits == 8 && like->format->palette) {
+#if IS_SDLv2
+        SDL_SetSurfacePalette(dst, like->format->palette);
+#else /* IS_SDLv1 */
+        SDL_SetColors(dst, like->format->palette->colors, 0,
+                      like->format->palette->ncolors);
+#endif /* IS_SDLv1 */
+    }
+    return dst;
+}
+
+/*changes the pixel format of the loaded Surface surfobj*/
+static int
+convert_loaded(PyObject *surfobj, PyObject *format_like)
+{
+    SDL_Surface *surf = pgSurface_AsSurface(surfobj);
+    SDL_Surface *dst;
+    SDL_Surface *converted;
+    SDL_PixelFormat *sf = surf->format;
+
+    dst = format_like_surface(format_like, surf);
+    if (dst == NULL) {
+        return -1;
+    }
+    if (dst->format->BitsPerPixel == sf->BitsPerPixel &&
+        dst->format->Rmask == sf->Rmask && dst->format->Gmask == sf->Gmask &&
+        dst->format->Bmask == sf->Bmask && dst->format->Amask == sf->Amask &&
+        sf->BitsPerPixel > 8) {
+        /*already in that format*/
+        SDL_FreeSurface(dst);
+        return 0;
+    }
+
+    if (convert_in_place(surf, dst)) {
+        converted = dst;
+    }
+    else {
+#if IS_SDLv2
+        converted = SDL_ConvertSurface(surf, dst->format, 0);
+#else /* IS_SDLv1 */
+        converted = SDL_ConvertSurface(surf, dst->format,
+                                       surf->flags & (SDL_SRCCOLORKEY |
+                                                      SDL_SRCALPHA));
+#endif /* IS_SDLv1 */
+        SDL_FreeSurface(dst);
+        if (converted == NULL) {
+            PyErr_SetString(pgExc_SDLError, SDL_GetError());
+            return -1;
+        }
+    }
+    pgSurface_AsSurface(surfobj) = converted;
+    SDL_FreeSurface(surf);
+    return 0;
+}
+
+static PyObject*
+image_load(PyObject *self, PyObject *arg, PyObject *kwds)
+{
+    static char *kwids[] = {"file", "namehint", "format_like", NULL};
+    struct _module_state *st = GETSTATE(self);
+    PyObject *obj;
+    PyObject *format_like = Py_None;
+    PyObject *args;
+    PyObject *final;
+    const char *name = NULL;
+
+    if (!PyArg_ParseTupleAndKeywords(arg, kwds, "O|zO", kwids,
+                                     &obj, &name, &format_like)) {
+        return NULL;
+    }
+    if (name != NULL) {
+        args = Py_BuildValue("(Os)", obj, name);
+    }
+    else {
+        args = PyTuple_Pack(1, obj);
+    }
+    if (args == NULL) {
+        return NULL;
+    }
+    if (st->extload != NULL) {
+        final = PyObject_Call(st->extload, args, NULL);
+    }
+    else {
+        final = image_load_basic(self, args);
+    }
+    Py_DECREF(args);
+
+    if (final != NULL && format_like != Py_None &&
+        convert_loaded(final, format_like)) {
+        Py_DECREF(final);
+        return NULL;
+    }
+    return final;
+}
+
+/*load_many without SDL_image. Decoding a BMP is little more than a copy,
+ *so the items are loaded one after the other and threads is not used.
+ */
+static PyObject*
+image_load_many_basic(PyObject *self, PyObject *arg, PyObject *kwds)
+{
+    static char *kwids[] = {"paths_or_files", "convert_to", "threads", NULL};
+    PyObject *seq;
+    PyObject *convert_to = Py_None;
+    PyObject *list;
+    PyObject *args;
+    PyObject *obj;
+    PyObject *type, *value, *traceback;
+    SDL_PixelFormat *format = NULL;
+    SDL_Surface *surf;
+    int threads = 0;
+    Py_ssize_t i;
+
+    if (!PyArg_ParseTupleAndKeywords(arg, kwds, "O|Oi", kwids,
+                                     &seq, &convert_to, &threads)) {
+        return NULL;
+    }
+    if (convert_to != Py_None && !pgSurface_Check(convert_to)) {
+        return RAISE(PyExc_TypeError, "convert_to must be a Surface or None");
+    }
+    if (threads < 0) {
+        return RAISE(PyExc_ValueError, "threads cannot be negative");
+    }
+    if (convert_to != Py_None) {
+        surf = pgSurface_AsSurface(convert_to);
+        if (surf == NULL) {
+            return RAISE(pgExc_SDLError, "display Surface quit");
+        }
+        format = surf->format;
+    }
+    seq = PySequence_Fast(seq, "paths_or_files must be a sequence");
+    if (seq == NULL) {
+        return NULL;
+    }
+    list = PyList_New(PySequence_Fast_GET_SIZE(seq));
+    if (list == NULL) {
+        Py_DECREF(seq);
+        return NULL;
+    }
+
+    for (i = 0; i < PySequence_Fast_GET_SIZE(seq); ++i) {
+        args = PyTuple_Pack(1, PySequence_Fast_GET_ITEM(seq, i));
+        if (args == NULL) {
+            break;
+        }
+        obj = image_load_basic(self, args);
+        Py_DECREF(args);
+        if (obj != NULL && format != NULL) {
+            surf = SDL_ConvertSurface(pgSurface_AsSurface(obj), format, 0);
+            Py_DECREF(obj);
+            if (surf == NULL) {
+                obj = PyObject_CallFunction(pgExc_SDLError, "s",
+                                            SDL_GetError());
+            }
+            else {
+                obj = pgSurface_New(surf);
+                if (obj == NULL) {
+                    SDL_FreeSurface(surf);
+                }
+            }
+        }
+        if (obj == NULL) {
+            /*errors of an item go in its place, but not a lack of memory*/
+            if (PyErr_ExceptionMatches(PyExc_MemoryError)) {
+                break;
+            }
+            PyErr_Fetch(&type, &value, &traceback);
+            PyErr_NormalizeException(&type, &value, &traceback);
+            Py_XDECREF(type);
+            Py_XDECREF(traceback);
+            if (value == NULL) {
+                break;
+            }
+            obj = value;
+        }
+        PyList_SET_ITEM(list, i, obj);
+    }
+    Py_DECREF(seq);
+    if (PyErr_Occurred()) {
+        Py_DECREF(list);
+        return NULL;
+    }
+    return list;
+}
+
 #if IS_SDLv1
 static SDL_Surface*
 opengltosdl ()
@@ -176,7 +582,7 @@ opengltosdl ()
 #endif /* IS_SDLv1 */
 
 PyObject*
-image_save(PyObject *self, PyObject *arg)
+image_save(PyObject *self, PyObject *arg, PyObject *kwds)
 {
     PyObject *surfobj;
     PyObject *obj;
@@ -207,7 +613,15 @@ image_save(PyObject *self, PyObject *arg)
 
     oencoded = pgRWopsEncodeFilePath(obj, pgExc_SDLError);
     if (oencoded == Py_None) {
-        SDL_RWops *rw = pgRWopsFromFileObject(obj);
+        SDL_RWops *rw = NULL;
+        if (kwds != NULL && PyDict_Size(kwds) != 0) {
+            PyErr_SetString(PyExc_TypeError,
+                            "save options are only supported for PNG and "
+                            "JPEG files");
+        }
+        else {
+            rw = pgRWopsFromFileObject(obj);
+        }
         if (rw != NULL) {
             result = SaveTGA_RW(surf, rw, 1);
         }
@@ -250,7 +664,7 @@ image_save(PyObject *self, PyObject *arg)
 
                     Py_DECREF(imgext);
                     if (extsave != NULL) {
-                        data = PyObject_CallObject(extsave, arg);
+                        data = PyObject_Call(extsave, arg, kwds);
                         Py_DECREF(extsave);
                         if (data == NULL) {
                             result = -2;
@@ -271,7 +685,13 @@ image_save(PyObject *self, PyObject *arg)
             }
         }
 
-        if (!written) {
+        if (!written && kwds != NULL && PyDict_Size(kwds) != 0) {
+            PyErr_SetString(PyExc_TypeError,
+                            "save options are only supported for PNG and "
+                            "JPEG files");
+            result = -2;
+        }
+        else if (!written) {
             Py_BEGIN_ALLOW_THREADS;
             result = SaveTGA(surf, name, 1);
             Py_END_ALLOW_THREADS;
@@ -1366,8 +1786,13 @@ SaveTGA (SDL_Surface *surface, const char *file, int rle)
 
 static PyMethodDef _image_methods[] =
 {
+    { "load", (PyCFunction) image_load, METH_VARARGS | METH_KEYWORDS,
+      DOC_PYGAMEIMAGELOAD },
     { "load_basic", image_load_basic, METH_VARARGS, DOC_PYGAMEIMAGELOAD },
-    { "save", image_save, METH_VARARGS, DOC_PYGAMEIMAGESAVE },
+    { "load_many_basic", (PyCFunction) image_load_many_basic,
+      METH_VARARGS | METH_KEYWORDS, DOC_PYGAMEIMAGELOADMANY },
+    { "save", (PyCFunction)image_save, METH_VARARGS | METH_KEYWORDS,
+      DOC_PYGAMEIMAGESAVE },
     { "get_extended", (PyCFunction) image_get_extended, METH_NOARGS,
       DOC_PYGAMEIMAGEGETEXTENDED },
 
@@ -1461,8 +1886,40 @@ MODINIT_DEFINE (image)
             Py_DECREF(extmodule);
             MODINIT_ERROR;
         }
+        /*load() calls it*/
         Py_INCREF (extload);
-        if (PyModule_AddObject (module, "load", extload))
+        st->extload = extload;
+        extload = PyObject_GetAttrString (extmodule, "load_many_extended");
+        if (!extload)
+        {
+            Py_DECREF (extmodule);
+            MODINIT_ERROR;
+        }
+        if (PyModule_AddObject (module, "load_many", extload))
+        {
+            Py_DECREF (extload);
+            Py_DECREF (extmodule);
+            MODINIT_ERROR;
+        }
+        extload = PyObject_GetAttrString (extmodule, "load_async_extended");
+        if (!extload)
+        {
+            Py_DECREF (extmodule);
+            MODINIT_ERROR;
+        }
+        if (PyModule_AddObject (module, "load_async", extload))
+        {
+            Py_DECREF (extload);
+            Py_DECREF (extmodule);
+            MODINIT_ERROR;
+        }
+        extload = PyObject_GetAttrString (extmodule, "AsyncLoad");
+        if (!extload)
+        {
+            Py_DECREF (extmodule);
+            MODINIT_ERROR;
+        }
+        if (PyModule_AddObject (module, "AsyncLoad", extload))
         {
             Py_DECREF (extload);
             Py_DECREF (extmodule);
@@ -1473,12 +1930,17 @@ MODINIT_DEFINE (image)
     }
     else
     {
-        PyObject* basicload = PyObject_GetAttrString (module, "load_basic");
+        PyObject* basicloadmany = PyObject_GetAttrString (module,
+                                                          "load_many_basic");
         PyErr_Clear ();
         PyModule_AddObject (module, "load_extended", Py_None);
         PyModule_AddObject (module, "save_extended", Py_None);
-        PyModule_AddObject (module, "load", basicload);
+        PyModule_AddObject (module, "load_many", basicloadmany);
+        /*loading in the background needs SDL_image*/
+        Py_INCREF (Py_None);
+        PyModule_AddObject (module, "load_async", Py_None);
         st->is_extended = 0;
+        st->extload = NULL;
     }
     MODINIT_RETURN (module);
 }
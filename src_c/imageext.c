@@ -31,6 +31,7 @@
 #include <stdio.h>
 #else
 #include <png.h>
+#include <zlib.h>
 #endif
 #include <jpeglib.h>
 #include <jerror.h>
@@ -68,16 +69,80 @@ find_extension(const char *fullname)
     return dot + 1;
 }
 
+/*an SDL_RWops reading the Python file object obj, the threaded kind when
+ *the RWops is used without the GIL. *ext is set to a copy of the file name
+ *extension, taken from name or else obj.name, for PyMem_Free.
+ */
+static SDL_RWops*
+rw_from_file_object(PyObject *obj, const char *name, char **ext,
+                    int threaded)
+{
+    PyObject *oencoded = NULL;
+    PyObject *oname;
+    const char *cext;
+    SDL_RWops *rw;
+
+    *ext = NULL;
+#if PY2
+    if (name == NULL && PyFile_Check(obj)) {
+        oencoded = PyFile_Name(obj);
+        if (oencoded == NULL) {
+            /* This should never happen */
+            return NULL;
+        }
+        Py_INCREF(oencoded);
+        name = Bytes_AS_STRING(oencoded);
+    }
+#endif
+    if (name == NULL) {
+        oname = PyObject_GetAttrString(obj, "name");
+        if (oname != NULL) {
+            oencoded = pgRWopsEncodeFilePath(oname, NULL);
+            Py_DECREF(oname);
+            if (oencoded == NULL) {
+                return NULL;
+            }
+            if (oencoded != Py_None) {
+                name = Bytes_AS_STRING(oencoded);
+            }
+        }
+        else {
+            PyErr_Clear();
+        }
+    }
+    if (threaded) {
+        rw = pgRWopsFromFileObjectThreaded(obj);
+    }
+    else {
+        rw = pgRWopsFromFileObject(obj);
+    }
+    if (rw == NULL) {
+        Py_XDECREF(oencoded);
+        return NULL;
+    }
+
+    cext = find_extension(name);
+    if (cext != NULL) {
+        *ext = (char *)PyMem_Malloc(strlen(cext) + 1);
+        if (*ext == NULL) {
+            Py_XDECREF(oencoded);
+            SDL_RWclose(rw);
+            return (SDL_RWops *)PyErr_NoMemory();
+        }
+        strcpy(*ext, cext);
+    }
+    Py_XDECREF(oencoded);
+    return rw;
+}
+
 static PyObject*
 image_load_ext(PyObject *self, PyObject *arg)
 {
     PyObject *obj;
     PyObject *final;
     PyObject *oencoded;
-    PyObject *oname;
     const char *name = NULL;
-    const char *cext;
-    char *ext = NULL;
+    char *ext;
     SDL_Surface *surf;
     SDL_RWops *rw;
 
@@ -97,50 +162,10 @@ image_load_ext(PyObject *self, PyObject *arg)
     }
     else {
         Py_DECREF(oencoded);
-        oencoded = NULL;
-#if PY2
-        if (name == NULL && PyFile_Check(obj)) {
-            oencoded = PyFile_Name(obj);
-            if (oencoded == NULL) {
-                /* This should never happen */
-                return NULL;
-            }
-            Py_INCREF(oencoded);
-            name = Bytes_AS_STRING(oencoded);
-        }
-#endif
-        if (name == NULL) {
-            oname = PyObject_GetAttrString(obj, "name");
-            if (oname != NULL) {
-                oencoded = pgRWopsEncodeFilePath(oname, NULL);
-                Py_DECREF(oname);
-                if (oencoded == NULL) {
-                    return NULL;
-                }
-                if (oencoded != Py_None) {
-                    name = Bytes_AS_STRING(oencoded);
-                }
-            }
-            else {
-                PyErr_Clear();
-            }
-        }
-        rw = pgRWopsFromFileObject(obj);
+        rw = rw_from_file_object(obj, name, &ext, 0);
         if (rw == NULL) {
-            Py_XDECREF(oencoded);
             return NULL;
         }
-
-        cext = find_extension(name);
-        if (cext != NULL) {
-            ext = (char *)PyMem_Malloc(strlen(cext) + 1);
-            if (ext == NULL) {
-                Py_XDECREF(oencoded);
-                return PyErr_NoMemory();
-            }
-            strcpy(ext, cext);
-        }
-        Py_XDECREF(oencoded);
         if (pgRWopsCheckObject(rw)) {
             surf = IMG_LoadTyped_RW(rw, 1, ext);
         }
@@ -159,29 +184,1174 @@ image_load_ext(PyObject *self, PyObject *arg)
     if (final == NULL) {
         SDL_FreeSurface(surf);
     }
-    return final;
+    return final;
+}
+
+/*load_many_extended decodes the images on a pool of threads without the
+ *GIL. The items are prepared and the Surfaces made with the GIL held, the
+ *threads only run the SDL_image loaders and the conversions.
+ */
+#define LOAD_MAX_THREADS 64
+
+typedef struct {
+    PyObject *path;             /* encoded file name, or NULL */
+    SDL_RWops *rw;              /* threaded RWops when there is no path */
+    char *ext;
+    SDL_Surface *surf;
+    PyObject *exc;              /* error of the preparation */
+    char error[256];
+} load_item;
+
+typedef struct {
+    load_item *items;
+    Py_ssize_t count;
+    Py_ssize_t next;            /* item taken next, under lock */
+    SDL_mutex *lock;
+    SDL_PixelFormat *format;    /* to convert to, or NULL */
+} load_job;
+
+static void
+load_item_run(load_job *job, load_item *item)
+{
+    SDL_Surface *surf;
+
+    if (item->path != NULL) {
+        surf = IMG_Load(Bytes_AS_STRING(item->path));
+    }
+    else {
+        surf = IMG_LoadTyped_RW(item->rw, 1, item->ext);
+        item->rw = NULL;
+    }
+    if (surf != NULL && job->format != NULL) {
+        item->surf = SDL_ConvertSurface(surf, job->format, 0);
+        SDL_FreeSurface(surf);
+    }
+    else {
+        item->surf = surf;
+    }
+    if (item->surf == NULL) {
+        /*the SDL error is kept for each thread*/
+        strncpy(item->error, IMG_GetError(), sizeof(item->error) - 1);
+    }
+}
+
+/* Thread of load_many_extended, loading items until none are left. */
+static int
+load_thread(void *data)
+{
+    load_job *job = (load_job *)data;
+    Py_ssize_t i;
+
+    for (;;) {
+        SDL_LockMutex(job->lock);
+        i = job->next++;
+        SDL_UnlockMutex(job->lock);
+        if (i >= job->count) {
+            break;
+        }
+        load_item_run(job, job->items + i);
+    }
+    return 0;
+}
+
+/* Runs func(data) on threads threads including the calling one. */
+static void
+run_threads(int (*func)(void *), void *data, int threads)
+{
+    SDL_Thread *pool[LOAD_MAX_THREADS];
+    int i;
+
+    for (i = 1; i < threads; ++i) {
+#if IS_SDLv2
+        pool[i] = SDL_CreateThread(func, "pygame.image", data);
+#else
+        pool[i] = SDL_CreateThread(func, data);
+#endif
+    }
+    /*work of threads that could not start is left to the others*/
+    func(data);
+    for (i = 1; i < threads; ++i) {
+        if (pool[i] != NULL) {
+            SDL_WaitThread(pool[i], NULL);
+        }
+    }
+}
+
+/*prepares item for obj, a file name or a file object. An error is kept
+ *in item->exc, only a failed allocation returns -1.
+ */
+static int
+load_item_init(load_item *item, PyObject *obj)
+{
+    PyObject *oencoded;
+    PyObject *type, *value, *traceback;
+
+    oencoded = pgRWopsEncodeFilePath(obj, pgExc_SDLError);
+    if (oencoded != NULL && oencoded != Py_None) {
+        item->path = oencoded;
+        return 0;
+    }
+    if (oencoded != NULL) {
+        Py_DECREF(oencoded);
+        item->rw = rw_from_file_object(obj, NULL, &item->ext, 1);
+        if (item->rw != NULL) {
+            return 0;
+        }
+    }
+    if (PyErr_ExceptionMatches(PyExc_MemoryError)) {
+        return -1;
+    }
+    PyErr_Fetch(&type, &value, &traceback);
+    PyErr_NormalizeException(&type, &value, &traceback);
+    Py_XDECREF(type);
+    Py_XDECREF(traceback);
+    item->exc = value;
+    return value != NULL ? 0 : -1;
+}
+
+static void
+load_items_free(load_item *items, Py_ssize_t count)
+{
+    Py_ssize_t i;
+
+    for (i = 0; i < count; ++i) {
+        Py_XDECREF(items[i].path);
+        Py_XDECREF(items[i].exc);
+        if (items[i].rw != NULL) {
+            SDL_RWclose(items[i].rw);
+        }
+        PyMem_Free(items[i].ext);
+        if (items[i].surf != NULL) {
+            SDL_FreeSurface(items[i].surf);
+        }
+    }
+    PyMem_Del(items);
+}
+
+static PyObject*
+load_many_ext(PyObject *self, PyObject *arg, PyObject *kwds)
+{
+    static char *kwids[] = {"paths_or_files", "convert_to", "threads", NULL};
+    PyObject *seq;
+    PyObject *convert_to = Py_None;
+    PyObject *list = NULL;
+    PyObject *obj;
+    load_job job;
+    int threads = 0;
+    Py_ssize_t i;
+
+    if (!PyArg_ParseTupleAndKeywords(arg, kwds, "O|Oi", kwids,
+                                     &seq, &convert_to, &threads)) {
+        return NULL;
+    }
+    if (convert_to != Py_None && !pgSurface_Check(convert_to)) {
+        return RAISE(PyExc_TypeError, "convert_to must be a Surface or None");
+    }
+    if (threads < 0) {
+        return RAISE(PyExc_ValueError, "threads cannot be negative");
+    }
+    seq = PySequence_Fast(seq, "paths_or_files must be a sequence");
+    if (seq == NULL) {
+        return NULL;
+    }
+
+    memset(&job, 0, sizeof(job));
+    job.count = PySequence_Fast_GET_SIZE(seq);
+    if (convert_to != Py_None) {
+        if (pgSurface_AsSurface(convert_to) == NULL) {
+            Py_DECREF(seq);
+            return RAISE(pgExc_SDLError, "display Surface quit");
+        }
+        job.format = pgSurface_AsSurface(convert_to)->format;
+    }
+    job.items = PyMem_New(load_item, job.count ? job.count : 1);
+    if (job.items == NULL) {
+        Py_DECREF(seq);
+        return PyErr_NoMemory();
+    }
+    memset(job.items, 0, sizeof(load_item) * job.count);
+    for (i = 0; i < job.count; ++i) {
+        if (load_item_init(job.items + i,
+                           PySequence_Fast_GET_ITEM(seq, i))) {
+            goto end;
+        }
+    }
+
+    if (threads == 0) {
+#if IS_SDLv2
+        threads = SDL_GetCPUCount();
+#else
+        threads = 4;
+#endif
+    }
+    threads = (int)MIN(threads, MIN(job.count, LOAD_MAX_THREADS));
+    job.lock = SDL_CreateMutex();
+    if (job.lock == NULL) {
+        PyErr_SetString(pgExc_SDLError, SDL_GetError());
+        goto end;
+    }
+#if IS_SDLv2 || SDL_IMAGE_PATCHLEVEL >= 8
+    /*load the decoder libraries now rather than racing in the threads*/
+    IMG_Init(IMG_INIT_JPG | IMG_INIT_PNG | IMG_INIT_TIF);
+#endif
+    Py_BEGIN_ALLOW_THREADS;
+    run_threads(load_thread, &job, threads);
+    Py_END_ALLOW_THREADS;
+    SDL_DestroyMutex(job.lock);
+
+    list = PyList_New(job.count);
+    if (list == NULL) {
+        goto end;
+    }
+    for (i = 0; i < job.count; ++i) {
+        load_item *item = job.items + i;
+
+        if (item->exc != NULL) {
+            obj = item->exc;
+            item->exc = NULL;
+        }
+        else if (item->surf == NULL) {
+            obj = PyObject_CallFunction(pgExc_SDLError, "s", item->error);
+        }
+        else {
+            obj = pgSurface_New(item->surf);
+            if (obj != NULL) {
+                item->surf = NULL;
+            }
+        }
+        if (obj == NULL) {
+            Py_DECREF(list);
+            list = NULL;
+            goto end;
+        }
+        PyList_SET_ITEM(list, i, obj);
+    }
+
+end:
+    load_items_free(job.items, job.count);
+    Py_DECREF(seq);
+    return list;
+}
+
+/*load_async hands the images to one loader thread. It decodes them
+ *without the GIL, then takes the GIL to make the Surface and deliver it.
+ *The queue and the states of the loads are guarded by async_state.lock.
+ */
+#define ASYNC_MAX_IN_FLIGHT 64
+
+#define ASYNC_QUEUED 0
+#define ASYNC_LOADING 1
+#define ASYNC_DONE 2
+#define ASYNC_CANCELLED 3
+
+typedef struct pgAsyncLoadObject {
+    PyObject_HEAD
+    struct pgAsyncLoadObject *next;     /* in the queue */
+    PyObject *path;
+    PyObject *encoded;          /* encoded file name, or NULL */
+    SDL_RWops *rw;              /* threaded RWops when there is no name */
+    char *ext;
+    PyObject *callback;
+    int event_type;             /* -1 for no event */
+    int state;
+    PyObject *result;           /* Surface or exception once done */
+} pgAsyncLoadObject;
+
+static PyTypeObject pgAsyncLoad_Type;
+
+static struct {
+    SDL_Thread *thread;
+    SDL_mutex *lock;
+    SDL_cond *cond;             /* a load is queued or has finished */
+    pgAsyncLoadObject *head, *tail;
+    int in_flight;              /* loads queued or loading */
+    int quit;
+} async_state;
+
+static void
+async_post(pgAsyncLoadObject *load)
+{
+    SDL_Event event;
+    PyObject *dict;
+    PyObject *e;
+    PyObject *dropped;
+    int is_surface = pgSurface_Check(load->result);
+
+    dict = Py_BuildValue("{sOsOsO}", "handle", (PyObject *)load,
+                         "surface", is_surface ? load->result : Py_None,
+                         "error", is_surface ? Py_None : load->result);
+    if (dict == NULL) {
+        PyErr_WriteUnraisable((PyObject *)load);
+        return;
+    }
+    e = pgEvent_New2(load->event_type, dict);
+    Py_DECREF(dict);
+    memset(&event, 0, sizeof(event));
+    if (e == NULL ||
+        pgEvent_FillUserEvent((pgEventObject *)e, &event)) {
+        Py_XDECREF(e);
+        PyErr_WriteUnraisable((PyObject *)load);
+        return;
+    }
+    Py_DECREF(e);
+    if (SDL_EventState(event.type, SDL_QUERY) == SDL_IGNORE ||
+#if IS_SDLv1
+        SDL_PushEvent(&event) == -1) {
+#else /* IS_SDLv2 */
+        SDL_PushEvent(&event) <= 0) {
+#endif /* IS_SDLv2 */
+        /*takes the attributes back out of the event module*/
+        dropped = pgEvent_New(&event);
+        Py_XDECREF(dropped);
+        PyErr_Clear();
+    }
+}
+
+/*finishes a load with the GIL held, drops the reference of the queue*/
+static void
+async_finish(pgAsyncLoadObject *load, SDL_Surface *surf, const char *error)
+{
+    PyObject *result;
+    PyObject *type, *value, *traceback;
+    int cancelled;
+
+    SDL_LockMutex(async_state.lock);
+    cancelled = load->state == ASYNC_CANCELLED;
+    --async_state.in_flight;
+    SDL_UnlockMutex(async_state.lock);
+
+    if (cancelled) {
+        if (surf != NULL) {
+            SDL_FreeSurface(surf);
+        }
+        Py_DECREF(load);
+        return;
+    }
+
+    if (surf == NULL) {
+        result = PyObject_CallFunction(pgExc_SDLError, "s", error);
+    }
+    else {
+        result = pgSurface_New(surf);
+        if (result == NULL) {
+            SDL_FreeSurface(surf);
+        }
+    }
+    if (result == NULL) {
+        PyErr_Fetch(&type, &value, &traceback);
+        PyErr_NormalizeException(&type, &value, &traceback);
+        Py_XDECREF(type);
+        Py_XDECREF(traceback);
+        result = value;
+    }
+    load->result = result;
+
+    SDL_LockMutex(async_state.lock);
+    load->state = ASYNC_DONE;
+    SDL_CondBroadcast(async_state.cond);
+    SDL_UnlockMutex(async_state.lock);
+
+    if (result != NULL && load->callback != NULL) {
+        result = PyObject_CallFunctionObjArgs(load->callback,
+                                              (PyObject *)load, NULL);
+        if (result == NULL) {
+            /*nobody to raise it to on this thread*/
+            PyErr_WriteUnraisable(load->callback);
+        }
+        Py_XDECREF(result);
+    }
+    if (load->result != NULL && load->event_type != -1) {
+        async_post(load);
+    }
+    Py_DECREF(load);
+}
+
+static int
+async_thread(void *data)
+{
+    pgAsyncLoadObject *load;
+    PyGILState_STATE gstate;
+    SDL_Surface *surf;
+    char error[256];
+
+    for (;;) {
+        SDL_LockMutex(async_state.lock);
+        while (async_state.head == NULL && !async_state.quit) {
+            SDL_CondWait(async_state.cond, async_state.lock);
+        }
+        if (async_state.quit) {
+            SDL_UnlockMutex(async_state.lock);
+            break;
+        }
+        load = async_state.head;
+        async_state.head = load->next;
+        if (async_state.head == NULL) {
+            async_state.tail = NULL;
+        }
+        load->next = NULL;
+        load->state = ASYNC_LOADING;
+        SDL_UnlockMutex(async_state.lock);
+
+        if (load->encoded != NULL) {
+            surf = IMG_Load(Bytes_AS_STRING(load->encoded));
+        }
+        else {
+            surf = IMG_LoadTyped_RW(load->rw, 1, load->ext);
+            load->rw = NULL;
+        }
+        error[0] = '\0';
+        if (surf == NULL) {
+            strncpy(error, IMG_GetError(), sizeof(error) - 1);
+            error[sizeof(error) - 1] = '\0';
+        }
+
+        gstate = PyGILState_Ensure();
+        async_finish(load, surf, error);
+        PyGILState_Release(gstate);
+    }
+    return 0;
+}
+
+/*the quit hook, cancels the queued loads and stops the thread*/
+static void
+async_quit(void)
+{
+    pgAsyncLoadObject *load;
+    pgAsyncLoadObject *queued;
+
+    if (async_state.thread == NULL) {
+        return;
+    }
+    SDL_LockMutex(async_state.lock);
+    queued = async_state.head;
+    async_state.head = async_state.tail = NULL;
+    for (load = queued; load != NULL; load = load->next) {
+        load->state = ASYNC_CANCELLED;
+        --async_state.in_flight;
+    }
+    async_state.quit = 1;
+    SDL_CondBroadcast(async_state.cond);
+    SDL_UnlockMutex(async_state.lock);
+
+    /*a load being finished needs the GIL*/
+    Py_BEGIN_ALLOW_THREADS;
+    SDL_WaitThread(async_state.thread, NULL);
+    Py_END_ALLOW_THREADS;
+    async_state.thread = NULL;
+
+    while (queued != NULL) {
+        load = queued;
+        queued = load->next;
+        load->next = NULL;
+        Py_DECREF(load);
+    }
+}
+
+static int
+async_start(void)
+{
+    if (async_state.lock == NULL) {
+        async_state.lock = SDL_CreateMutex();
+        async_state.cond = SDL_CreateCond();
+        if (async_state.lock == NULL || async_state.cond == NULL) {
+            PyErr_SetString(pgExc_SDLError, SDL_GetError());
+            return -1;
+        }
+    }
+    PyEval_InitThreads();
+    async_state.quit = 0;
+#if IS_SDLv2
+    async_state.thread = SDL_CreateThread(async_thread, "pygame.image",
+                                          NULL);
+#else
+    async_state.thread = SDL_CreateThread(async_thread, NULL);
+#endif
+    if (async_state.thread == NULL) {
+        PyErr_SetString(pgExc_SDLError, SDL_GetError());
+        return -1;
+    }
+    pg_RegisterQuit(async_quit);
+    return 0;
+}
+
+static PyObject*
+load_async_ext(PyObject *self, PyObject *arg, PyObject *kwds)
+{
+    static char *kwids[] = {"path", "callback", "event_type", NULL};
+    PyObject *path;
+    PyObject *callback = Py_None;
+    PyObject *event_type = Py_None;
+    PyObject *oencoded;
+    pgAsyncLoadObject *load;
+    int type = -1;
+
+    if (!PyArg_ParseTupleAndKeywords(arg, kwds, "O|OO", kwids,
+                                     &path, &callback, &event_type)) {
+        return NULL;
+    }
+    if (callback != Py_None && !PyCallable_Check(callback)) {
+        return RAISE(PyExc_TypeError, "callback must be callable or None");
+    }
+    if (event_type != Py_None) {
+        if (!pg_IntFromObj(event_type, &type) || type < 0) {
+            return RAISE(PyExc_ValueError, "invalid event type");
+        }
+    }
+    if (async_state.in_flight >= ASYNC_MAX_IN_FLIGHT) {
+        return RAISE(pgExc_SDLError, "too many images loading at once");
+    }
+
+    load = PyObject_GC_New(pgAsyncLoadObject, &pgAsyncLoad_Type);
+    if (load == NULL) {
+        return NULL;
+    }
+    load->next = NULL;
+    Py_INCREF(path);
+    load->path = path;
+    load->encoded = NULL;
+    load->rw = NULL;
+    load->ext = NULL;
+    load->callback = NULL;
+    if (callback != Py_None) {
+        Py_INCREF(callback);
+        load->callback = callback;
+    }
+    load->event_type = type;
+    load->state = ASYNC_QUEUED;
+    load->result = NULL;
+    PyObject_GC_Track((PyObject *)load);
+
+    oencoded = pgRWopsEncodeFilePath(path, pgExc_SDLError);
+    if (oencoded == NULL) {
+        Py_DECREF(load);
+        return NULL;
+    }
+    if (oencoded != Py_None) {
+        load->encoded = oencoded;
+    }
+    else {
+        Py_DECREF(oencoded);
+        load->rw = rw_from_file_object(path, NULL, &load->ext, 1);
+        if (load->rw == NULL) {
+            Py_DECREF(load);
+            return NULL;
+        }
+    }
+
+    if (async_state.thread == NULL && async_start()) {
+        Py_DECREF(load);
+        return NULL;
+    }
+
+    /*the queue keeps a reference until the load is finished*/
+    Py_INCREF(load);
+    SDL_LockMutex(async_state.lock);
+    if (async_state.tail != NULL) {
+        async_state.tail->next = load;
+    }
+    else {
+        async_state.head = load;
+    }
+    async_state.tail = load;
+    ++async_state.in_flight;
+    SDL_CondBroadcast(async_state.cond);
+    SDL_UnlockMutex(async_state.lock);
+    return (PyObject *)load;
+}
+
+static PyObject*
+async_done(PyObject *self)
+{
+    return PyBool_FromLong(((pgAsyncLoadObject *)self)->state >= ASYNC_DONE);
+}
+
+static PyObject*
+async_cancelled(PyObject *self)
+{
+    return PyBool_FromLong(((pgAsyncLoadObject *)self)->state ==
+                           ASYNC_CANCELLED);
+}
+
+static PyObject*
+async_cancel(PyObject *self)
+{
+    pgAsyncLoadObject *load = (pgAsyncLoadObject *)self;
+    pgAsyncLoadObject **link;
+    int queued = 0;
+
+    if (load->state == ASYNC_DONE) {
+        Py_RETURN_FALSE;
+    }
+    if (load->state == ASYNC_CANCELLED) {
+        Py_RETURN_TRUE;
+    }
+    SDL_LockMutex(async_state.lock);
+    if (load->state == ASYNC_QUEUED) {
+        for (link = &async_state.head; *link != load;
+             link = &(*link)->next) {
+        }
+        *link = load->next;
+        if (async_state.tail == load) {
+            async_state.tail = NULL;
+            for (link = &async_state.head; *link != NULL;
+                 link = &(*link)->next) {
+                async_state.tail = *link;
+            }
+        }
+        load->next = NULL;
+        --async_state.in_flight;
+        queued = 1;
+    }
+    /*a load on the thread is dropped when it is finished*/
+    load->state = ASYNC_CANCELLED;
+    SDL_CondBroadcast(async_state.cond);
+    SDL_UnlockMutex(async_state.lock);
+
+    if (queued) {
+        if (load->rw != NULL) {
+            SDL_RWclose(load->rw);
+            load->rw = NULL;
+        }
+        Py_DECREF(load);
+    }
+    Py_RETURN_TRUE;
+}
+
+static PyObject*
+async_result(PyObject *self, PyObject *arg)
+{
+    pgAsyncLoadObject *load = (pgAsyncLoadObject *)self;
+    int timeout = -1;
+    int state;
+    Uint32 start, waited;
+
+    if (!PyArg_ParseTuple(arg, "|i", &timeout)) {
+        return NULL;
+    }
+    if (load->state < ASYNC_DONE && timeout != 0) {
+        Py_BEGIN_ALLOW_THREADS;
+        start = SDL_GetTicks();
+        SDL_LockMutex(async_state.lock);
+        while (load->state < ASYNC_DONE) {
+            if (timeout < 0) {
+                SDL_CondWait(async_state.cond, async_state.lock);
+                continue;
+            }
+            /*every load that finishes wakes all the waiters, only the
+              time left of the timeout is waited again*/
+            waited = SDL_GetTicks() - start;
+            if (waited >= (Uint32)timeout ||
+                SDL_CondWaitTimeout(async_state.cond, async_state.lock,
+                                    (Uint32)timeout - waited) ==
+                    SDL_MUTEX_TIMEDOUT) {
+                break;
+            }
+        }
+        SDL_UnlockMutex(async_state.lock);
+        Py_END_ALLOW_THREADS;
+    }
+
+    state = load->state;
+    if (state == ASYNC_CANCELLED) {
+        return RAISE(pgExc_SDLError, "image load was cancelled");
+    }
+    if (state != ASYNC_DONE) {
+        return RAISE(pgExc_SDLError, "image not loaded yet");
+    }
+    if (!pgSurface_Check(load->result)) {
+        PyErr_SetObject((PyObject *)Py_TYPE(load->result), load->result);
+        return NULL;
+    }
+    Py_INCREF(load->result);
+    return load->result;
+}
+
+static PyObject*
+async_get_path(PyObject *self, void *closure)
+{
+    PyObject *path = ((pgAsyncLoadObject *)self)->path;
+
+    Py_INCREF(path);
+    return path;
+}
+
+static PyMethodDef async_methods[] =
+{
+    { "done", (PyCFunction)async_done, METH_NOARGS, DOC_ASYNCLOADDONE },
+    { "cancelled", (PyCFunction)async_cancelled, METH_NOARGS,
+      DOC_ASYNCLOADCANCELLED },
+    { "cancel", (PyCFunction)async_cancel, METH_NOARGS,
+      DOC_ASYNCLOADCANCEL },
+    { "result", async_result, METH_VARARGS, DOC_ASYNCLOADRESULT },
+    { NULL, NULL, 0, NULL }
+};
+
+static PyGetSetDef async_getsets[] =
+{
+    { "path", async_get_path, NULL, DOC_ASYNCLOADPATH, NULL },
+    { NULL, 0, NULL, NULL, NULL }
+};
+
+static int
+async_traverse(pgAsyncLoadObject *self, visitproc visit, void *arg)
+{
+    Py_VISIT(self->path);
+    Py_VISIT(self->callback);
+    Py_VISIT(self->result);
+    return 0;
+}
+
+static int
+async_clear(pgAsyncLoadObject *self)
+{
+    Py_CLEAR(self->callback);
+    Py_CLEAR(self->result);
+    return 0;
+}
+
+static void
+async_dealloc(PyObject *self)
+{
+    pgAsyncLoadObject *load = (pgAsyncLoadObject *)self;
+
+    PyObject_GC_UnTrack(self);
+    async_clear(load);
+    Py_XDECREF(load->path);
+    Py_XDECREF(load->encoded);
+    if (load->rw != NULL) {
+        SDL_RWclose(load->rw);
+    }
+    PyMem_Free(load->ext);
+    PyObject_GC_Del(self);
+}
+
+static PyTypeObject pgAsyncLoad_Type =
+{
+    TYPE_HEAD(NULL, 0)
+    "AsyncLoad",                /* name */
+    sizeof(pgAsyncLoadObject),  /* basic size */
+    0,                          /* itemsize */
+    async_dealloc,              /* dealloc */
+    0,                          /* print */
+    0,                          /* getattr */
+    0,                          /* setattr */
+    0,                          /* compare */
+    0,                          /* repr */
+    0,                          /* as_number */
+    0,                          /* as_sequence */
+    0,                          /* as_mapping */
+    (hashfunc)0,                /* hash */
+    (ternaryfunc)0,             /* call */
+    0,                          /* str */
+    0,                          /* tp_getattro */
+    0,                          /* tp_setattro */
+    0,                          /* tp_as_buffer */
+    Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HAVE_GC, /* flags */
+    DOC_PYGAMEIMAGEASYNCLOAD,   /* Documentation string */
+    (traverseproc)async_traverse, /* tp_traverse */
+    (inquiry)async_clear,       /* tp_clear */
+    0,                          /* tp_richcompare */
+    0,                          /* tp_weaklistoffset */
+    0,                          /* tp_iter */
+    0,                          /* tp_iternext */
+    async_methods,              /* tp_methods */
+    0,                          /* tp_members */
+    async_getsets,              /* tp_getset */
+    0,                          /* tp_base */
+    0,                          /* tp_dict */
+    0,                          /* tp_descr_get */
+    0,                          /* tp_descr_set */
+    0,                          /* tp_dictoffset */
+    0,                          /* tp_init */
+    0,                          /* tp_alloc */
+    0,                          /* tp_new */
+};
+
+#ifdef PNG_H
+
+static void
+png_write_fn (png_structp png_ptr, png_bytep data, png_size_t length)
+{
+    FILE *fp = (FILE *)png_get_io_ptr(png_ptr);
+    if (fwrite(data, 1, length, fp) != length) {
+        fclose(fp);
+        png_error(png_ptr, "Error while writing to the PNG file (fwrite)");
+    }
+}
+
+static void
+png_flush_fn (png_structp png_ptr)
+{
+    FILE *fp = (FILE *)png_get_io_ptr(png_ptr);
+    if (fflush(fp) == EOF) {
+        fclose(fp);
+        png_error(png_ptr, "Error while writing to PNG file (fflush)");
+    }
+}
+
+/*options of save_extended for PNG files*/
+typedef struct {
+    int compression;            /* zlib level, or -1 for the default */
+    int filter;                 /* PNG_FILTER_ mask, or 0 for the default */
+    int threads;
+} png_options;
+
+/*The threaded encoder filters and deflates blocks of rows on their own.
+ *Each block is a raw deflate stream primed with the 32K of filtered rows
+ *in front of it and ended with a sync flush, so that the blocks joined
+ *between a zlib header and the combined adler32 make one zlib stream.
+ */
+#define PNG_BLOCK_SIZE (256 * 1024)     /* filtered bytes of a block */
+#define PNG_WINDOW 32768
+
+typedef struct {
+    int first;                  /* first row */
+    int last;                   /* row after the last one */
+    unsigned char *out;         /* header room, deflated rows, trailer room */
+    size_t outlen;
+    uLong adler;                /* of the filtered rows */
+    uLong inlen;
+    int failed;
+} png_block;
+
+typedef struct {
+    png_bytep *rows;
+    size_t rowbytes;
+    int bpp;
+    int filter;
+    int level;
+    int strategy;
+    png_block *blocks;
+    int count;
+    int next;                   /* block taken next, under lock */
+    SDL_mutex *lock;
+} png_job;
+
+/* The Paeth predictor of the PNG specification. */
+static png_byte
+png_paeth(png_byte a, png_byte b, png_byte c)
+{
+    int pa = b - c;
+    int pb = a - c;
+    int pc = pa + pb;
+
+    pa = pa < 0 ? -pa : pa;
+    pb = pb < 0 ? -pb : pb;
+    pc = pc < 0 ? -pc : pc;
+    if (pb < pa) {
+        pa = pb;
+        a = b;
+    }
+    return pc < pa ? c : a;
+}
+
+/* Writes the row filtered with type to out, prev is NULL for row 0. */
+static void
+png_filter_row(png_bytep out, png_bytep row, png_bytep prev,
+               size_t rowbytes, int bpp, int type)
+{
+    size_t i, n = MIN((size_t)bpp, rowbytes);
+
+    out[0] = (png_byte)type;
+    ++out;
+    if (prev == NULL && type >= 2) {
+        /*above is zero: up is none, average halves left, paeth is sub*/
+        if (type == 3) {
+            memcpy(out, row, n);
+            for (i = n; i < rowbytes; ++i) {
+                out[i] = row[i] - (row[i - bpp] >> 1);
+            }
+            return;
+        }
+        type = type == 2 ? 0 : 1;
+    }
+    switch (type) {
+    case 1:
+        memcpy(out, row, n);
+        for (i = n; i < rowbytes; ++i) {
+            out[i] = row[i] - row[i - bpp];
+        }
+        break;
+    case 2:
+        for (i = 0; i < rowbytes; ++i) {
+            out[i] = row[i] - prev[i];
+        }
+        break;
+    case 3:
+        for (i = 0; i < n; ++i) {
+            out[i] = row[i] - (prev[i] >> 1);
+        }
+        for (; i < rowbytes; ++i) {
+            out[i] = row[i] - (png_byte)((row[i - bpp] + prev[i]) >> 1);
+        }
+        break;
+    case 4:
+        for (i = 0; i < n; ++i) {
+            out[i] = row[i] - prev[i];
+        }
+        for (; i < rowbytes; ++i) {
+            out[i] = row[i] - png_paeth(row[i - bpp], prev[i],
+                                        prev[i - bpp]);
+        }
+        break;
+    default:
+        memcpy(out, row, rowbytes);
+    }
+}
+
+/*Filters the row with the type of the filter mask that gives the smallest
+ *sum of absolute differences, the heuristic libpng uses. tmp holds a row.
+ */
+static void
+png_filter_best(png_job *job, png_bytep out, png_bytep tmp,
+                png_bytep row, png_bytep prev)
+{
+    size_t stride = job->rowbytes + 1;
+    unsigned long sum, best = 0;
+    size_t i;
+    int type, found = 0;
+
+    for (type = 0; type < 5; ++type) {
+        if (!(job->filter & (PNG_FILTER_NONE << type))) {
+            continue;
+        }
+        png_filter_row(tmp, row, prev, job->rowbytes, job->bpp, type);
+        if (job->filter == (PNG_FILTER_NONE << type)) {
+            memcpy(out, tmp, stride);
+            return;
+        }
+        for (sum = 0, i = 1; i < stride; ++i) {
+            sum += tmp[i] < 128 ? tmp[i] : 256 - tmp[i];
+        }
+        if (!found || sum < best) {
+            memcpy(out, tmp, stride);
+            best = sum;
+            found = 1;
+        }
+    }
+}
+
+static void
+png_block_run(png_job *job, png_block *block)
+{
+    size_t stride = job->rowbytes + 1;
+    size_t head = block->first == 0 ? 2 : 0;
+    size_t tail = block == job->blocks + job->count - 1 ? 4 : 0;
+    size_t dictlen = 0, cap;
+    int flush = tail ? Z_FINISH : Z_SYNC_FLUSH;
+    int dictrows = 0;
+    int r, ret;
+    unsigned char *in, *tmp, *out;
+    z_stream strm;
+
+    if (block->first > 0) {
+        dictrows = (int)((PNG_WINDOW + stride - 1) / stride);
+        dictrows = MIN(dictrows, block->first);
+        dictlen = MIN(stride * dictrows, PNG_WINDOW);
+    }
+    in = (unsigned char *)malloc(
+        stride * (dictrows + block->last - block->first + 1));
+    if (in == NULL) {
+        return;
+    }
+    tmp = in + stride * (dictrows + block->last - block->first);
+    for (r = block->first - dictrows; r < block->last; ++r) {
+        png_filter_best(job, in + stride * (r - block->first + dictrows),
+                        tmp, job->rows[r], r ? job->rows[r - 1] : NULL);
+    }
+    block->inlen = (uLong)(stride * (block->last - block->first));
+    block->adler = adler32(adler32(0L, Z_NULL, 0), in + stride * dictrows,
+                           (uInt)block->inlen);
+
+    memset(&strm, 0, sizeof(strm));
+    if (deflateInit2(&strm, job->level, Z_DEFLATED, -15, 8,
+                     job->strategy) != Z_OK) {
+        free(in);
+        return;
+    }
+    if (dictlen != 0) {
+        deflateSetDictionary(&strm, in + stride * dictrows - dictlen,
+                             (uInt)dictlen);
+    }
+    cap = head + deflateBound(&strm, block->inlen) + 16 + tail;
+    out = (unsigned char *)malloc(cap);
+    strm.next_in = in + stride * dictrows;
+    strm.avail_in = (uInt)block->inlen;
+    while (out != NULL) {
+        strm.next_out = out + head + strm.total_out;
+        strm.avail_out = (uInt)(cap - head - tail - strm.total_out);
+        ret = deflate(&strm, flush);
+        if (ret == Z_STREAM_ERROR) {
+            break;
+        }
+        if (flush == Z_FINISH ? ret == Z_STREAM_END : strm.avail_out != 0) {
+            block->out = out;
+            block->outlen = head + strm.total_out + tail;
+            block->failed = 0;
+            out = NULL;
+            break;
+        }
+        cap *= 2;
+        tmp = (unsigned char *)realloc(out, cap);
+        if (tmp == NULL) {
+            break;
+        }
+        out = tmp;
+    }
+    deflateEnd(&strm);
+    free(out);
+    free(in);
 }
 
-#ifdef PNG_H
+/* Thread of write_png_threaded, encoding blocks until none are left. */
+static int
+png_thread(void *data)
+{
+    png_job *job = (png_job *)data;
+    int i;
 
-static void
-png_write_fn (png_structp png_ptr, png_bytep data, png_size_t length)
+    for (;;) {
+        SDL_LockMutex(job->lock);
+        i = job->next++;
+        SDL_UnlockMutex(job->lock);
+        if (i >= job->count) {
+            break;
+        }
+        job->blocks[i].failed = 1;
+        png_block_run(job, job->blocks + i);
+    }
+    return 0;
+}
+
+static int
+png_write_chunk_fp(FILE *fp, const char *type, png_bytep data, size_t len)
 {
-    FILE *fp = (FILE *)png_get_io_ptr(png_ptr);
-    if (fwrite(data, 1, length, fp) != length) {
-        fclose(fp);
-        png_error(png_ptr, "Error while writing to the PNG file (fwrite)");
+    png_byte head[8], tail[4];
+    uLong crc;
+
+    png_save_uint_32(head, (png_uint_32)len);
+    memcpy(head + 4, type, 4);
+    crc = crc32(crc32(0L, Z_NULL, 0), head + 4, 4);
+    if (len)
+        crc = crc32(crc, data, (uInt)len);
+    png_save_uint_32(tail, (png_uint_32)crc);
+    if (fwrite(head, 1, 8, fp) != 8 ||
+        (len && fwrite(data, 1, len, fp) != len) ||
+        fwrite(tail, 1, 4, fp) != 4) {
+        return -1;
     }
+    return 0;
 }
 
-static void
-png_flush_fn (png_structp png_ptr)
+static int
+write_png_threaded (const char *file_name,
+                    png_bytep *rows,
+                    int w,
+                    int h,
+                    int colortype,
+                    const png_options *opts,
+                    int count)
 {
-    FILE *fp = (FILE *)png_get_io_ptr(png_ptr);
-    if (fflush(fp) == EOF) {
-        fclose(fp);
-        png_error(png_ptr, "Error while writing to PNG file (fflush)");
+    static const png_byte signature[8] = {137, 80, 78, 71, 13, 10, 26, 10};
+    png_job job;
+    png_byte ihdr[13];
+    png_block *last;
+    FILE *fp = NULL;
+    uLong adler;
+    unsigned header;
+    int rows_per_block;
+    int i, r = -1;
+    char *doing = "allocate memory";
+
+    job.rows = rows;
+    job.bpp = colortype == PNG_COLOR_TYPE_RGB_ALPHA ? 4 : 3;
+    job.rowbytes = (size_t)w * job.bpp;
+    job.filter = opts->filter ? opts->filter : PNG_ALL_FILTERS;
+    job.level = opts->compression;
+    job.strategy =
+        job.filter == PNG_FILTER_NONE ? Z_DEFAULT_STRATEGY : Z_FILTERED;
+    job.count = count;
+    job.next = 0;
+    job.blocks = (png_block *)calloc(count, sizeof(png_block));
+    job.lock = SDL_CreateMutex();
+    if (job.blocks == NULL || job.lock == NULL) {
+        goto end;
+    }
+    rows_per_block = (h + count - 1) / count;
+    count = job.count = (h + rows_per_block - 1) / rows_per_block;
+    for (i = 0; i < count; ++i) {
+        job.blocks[i].first = i * rows_per_block;
+        job.blocks[i].last = MIN(h, (i + 1) * rows_per_block);
+    }
+
+    doing = "write image";
+    run_threads(png_thread, &job, MIN(opts->threads, count));
+    for (i = 0; i < count; ++i) {
+        if (job.blocks[i].failed) {
+            goto end;
+        }
     }
+
+    /*the zlib header and trailer go in the room left in the end blocks*/
+    i = job.level < 0 ? 6 : job.level;
+    header = 0x7800 | ((i < 2 ? 0 : i < 6 ? 1 : i == 6 ? 2 : 3) << 6);
+    header += 31 - header % 31;
+    job.blocks[0].out[0] = (png_byte)(header >> 8);
+    job.blocks[0].out[1] = (png_byte)header;
+    adler = adler32(0L, Z_NULL, 0);
+    for (i = 0; i < count; ++i) {
+        adler = adler32_combine(adler, job.blocks[i].adler,
+                                (z_off_t)job.blocks[i].inlen);
+    }
+    last = job.blocks + count - 1;
+    png_save_uint_32(last->out + last->outlen - 4, (png_uint_32)adler);
+
+    doing = "open for writing";
+    if (!(fp = fopen (file_name, "wb")))
+        goto end;
+
+    doing = "write header";
+    png_save_uint_32(ihdr, (png_uint_32)w);
+    png_save_uint_32(ihdr + 4, (png_uint_32)h);
+    ihdr[8] = 8;
+    ihdr[9] = (png_byte)colortype;
+    ihdr[10] = PNG_COMPRESSION_TYPE_BASE;
+    ihdr[11] = PNG_FILTER_TYPE_BASE;
+    ihdr[12] = PNG_INTERLACE_NONE;
+    if (fwrite(signature, 1, 8, fp) != 8 ||
+        png_write_chunk_fp(fp, "IHDR", ihdr, 13))
+        goto end;
+
+    doing = "write image";
+    for (i = 0; i < count; ++i) {
+        if (png_write_chunk_fp(fp, "IDAT", job.blocks[i].out,
+                               job.blocks[i].outlen))
+            goto end;
+    }
+
+    doing = "write end";
+    if (png_write_chunk_fp(fp, "IEND", NULL, 0))
+        goto end;
+    r = 0;
+
+end:
+    if (fp != NULL && fclose(fp) != 0 && r == 0) {
+        doing = "closing file";
+        r = -1;
+    }
+    if (job.blocks != NULL) {
+        for (i = 0; i < count; ++i) {
+            free(job.blocks[i].out);
+        }
+        free(job.blocks);
+    }
+    if (job.lock != NULL) {
+        SDL_DestroyMutex(job.lock);
+    }
+    if (r) {
+        SDL_SetError ("SavePNG: could not %s", doing);
+    }
+    return r;
 }
 
 static int
@@ -190,12 +1360,24 @@ write_png (const char *file_name,
            int w,
            int h,
            int colortype,
-           int bitdepth)
+           int bitdepth,
+           const png_options *opts)
 {
     png_structp png_ptr = NULL;
     png_infop info_ptr =  NULL;
     FILE *fp = NULL;
     char *doing = "open for writing";
+    size_t rowbytes = (size_t)w * (colortype == PNG_COLOR_TYPE_RGB_ALPHA ?
+                                   4 : 3) + 1;
+    int count;
+
+    /*blocks of whole rows, more of them than threads to even out the work*/
+    count = (int)MIN((size_t)h, (rowbytes * h + PNG_BLOCK_SIZE - 1) /
+                                PNG_BLOCK_SIZE);
+    if (opts->threads > 1 && count > 1 && bitdepth == 8) {
+        return write_png_threaded (file_name, rows, w, h, colortype, opts,
+                                   count);
+    }
 
     if (!(fp = fopen (file_name, "wb")))
         goto fail;
@@ -214,6 +1396,11 @@ write_png (const char *file_name,
     doing = "init IO";
     png_set_write_fn (png_ptr, fp, png_write_fn, png_flush_fn);
 
+    if (opts->compression >= 0)
+        png_set_compression_level (png_ptr, opts->compression);
+    if (opts->filter)
+        png_set_filter (png_ptr, PNG_FILTER_TYPE_BASE, opts->filter);
+
     doing = "write header";
     png_set_IHDR (png_ptr, info_ptr, w, h, bitdepth, colortype,
                   PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_BASE,
@@ -250,7 +1437,7 @@ fail:
 }
 
 static int
-SavePNG (SDL_Surface *surface, const char *file)
+SavePNG (SDL_Surface *surface, const char *file, const png_options *opts)
 {
     static unsigned char** ss_rows;
     static int ss_size;
@@ -374,12 +1561,12 @@ SavePNG (SDL_Surface *surface, const char *file)
     if (alpha)
     {
         r = write_png (file, ss_rows, surface->w, surface->h,
-                       PNG_COLOR_TYPE_RGB_ALPHA, 8);
+                       PNG_COLOR_TYPE_RGB_ALPHA, 8, opts);
     }
     else
     {
         r = write_png (file, ss_rows, surface->w, surface->h,
-                       PNG_COLOR_TYPE_RGB, 8);
+                       PNG_COLOR_TYPE_RGB, 8, opts);
     }
 
     free (ss_rows);
@@ -388,11 +1575,37 @@ SavePNG (SDL_Surface *surface, const char *file)
     return r;
 }
 
+/* Returns the PNG_FILTER_ mask for a filter name, or 0 if unknown. */
+static int
+png_filter_from_name(const char *name)
+{
+    static const struct {
+        const char *name;
+        int mask;
+    } filters[] = {
+        {"none", PNG_FILTER_NONE},
+        {"sub", PNG_FILTER_SUB},
+        {"up", PNG_FILTER_UP},
+        {"average", PNG_FILTER_AVG},
+        {"paeth", PNG_FILTER_PAETH},
+        {"adaptive", PNG_ALL_FILTERS},
+    };
+    size_t i;
+
+    for (i = 0; i < sizeof(filters) / sizeof(filters[0]); ++i) {
+        if (strcmp(name, filters[i].name) == 0) {
+            return filters[i].mask;
+        }
+    }
+    return 0;
+}
+
 #endif /* end if PNG_H */
 
 #ifdef JPEGLIB_H
 
-#define NUM_LINES_TO_WRITE 500
+/*rows converted and written at once, the tallest MCU of a subsampled image*/
+#define JPEG_BATCH 16
 
 /* Avoid conflicts with the libjpeg libraries C runtime bindings.
  * Adapted from code in the libjpeg file jdatadst.c .
@@ -483,68 +1696,14 @@ j_stdio_dest (j_compress_ptr cinfo, FILE *outfile)
 /* End borrowed code
  */
 
-int write_jpeg (const char *file_name, unsigned char** image_buffer,
-                int image_width, int image_height, int quality) {
-
-    struct jpeg_compress_struct cinfo;
-    struct jpeg_error_mgr jerr;
-    FILE * outfile;
-    JSAMPROW row_pointer[NUM_LINES_TO_WRITE];
-    int num_lines_to_write;
-    int i;
-
-    num_lines_to_write = NUM_LINES_TO_WRITE;
-
-
-    cinfo.err = jpeg_std_error (&jerr);
-    jpeg_create_compress (&cinfo);
-
-    if ((outfile = fopen (file_name, "wb")) == NULL) {
-
-        SDL_SetError ("SaveJPEG: could not open %s", file_name);
-        return -1;
-    }
-    j_stdio_dest (&cinfo, outfile);
-
-    cinfo.image_width = image_width;
-    cinfo.image_height = image_height;
-    cinfo.input_components = 3;
-    cinfo.in_color_space = JCS_RGB;
-    /* cinfo.optimize_coding = FALSE;
-     */
-    /* cinfo.optimize_coding = FALSE;
-     */
-
-    jpeg_set_defaults (&cinfo);
-    jpeg_set_quality (&cinfo, quality, TRUE);
-
-    jpeg_start_compress (&cinfo, TRUE);
-
-
-
-    /* try and write many scanlines at once.  */
-    while (cinfo.next_scanline < cinfo.image_height) {
-        if (num_lines_to_write > (cinfo.image_height - cinfo.next_scanline) -1) {
-            num_lines_to_write = (cinfo.image_height - cinfo.next_scanline);
-        }
-        /* copy the memory from the buffers */
-        for(i =0; i < num_lines_to_write; i++) {
-            row_pointer[i] = image_buffer[cinfo.next_scanline + i];
-        }
-
-        jpeg_write_scanlines (&cinfo, row_pointer, num_lines_to_write);
-
-    }
-
-    jpeg_finish_compress (&cinfo);
-    fclose (outfile);
-    jpeg_destroy_compress (&cinfo);
-    return 0;
-}
-
-
-
-int SaveJPEG (SDL_Surface *surface, const char *file) {
+/*options of save_extended for JPEG files*/
+typedef struct {
+    int quality;
+    int h_samp;                 /* luma sampling factors, 0 for the default */
+    int v_samp;
+    int progressive;
+    int optimize;
+} jpeg_options;
 
 #if SDL_BYTEORDER == SDL_BIG_ENDIAN
 #define RED_MASK 0xff0000
@@ -556,111 +1715,248 @@ int SaveJPEG (SDL_Surface *surface, const char *file) {
 #define BLUE_MASK 0xff0000
 #endif
 
-    static unsigned char** ss_rows;
-    static int ss_size;
-    static int ss_w, ss_h;
-    SDL_Surface *ss_surface;
-    SDL_Rect ss_rect;
-    int r, i;
-    int pixel_bits = 32;
-    int free_ss_surface = 1;
-
+/*Finds the byte offsets of red, green and blue in the pixels of a 24 or
+ *32 bit surface whose rows can be read as they are, without the blending
+ *or colorkey of a blit. Returns -1 for other surfaces.
+ */
+static int
+jpeg_channel_offsets (SDL_Surface *surface, int offsets[3])
+{
+    SDL_PixelFormat *fmt = surface->format;
+    Uint32 masks[3];
+    Uint8 shifts[3];
+    int i;
+#if IS_SDLv2
+    SDL_BlendMode mode;
+    Uint32 key;
+#endif
 
+#if IS_SDLv1
+    if (surface->flags & (SDL_SRCALPHA | SDL_SRCCOLORKEY))
+        return -1;
+#else /* IS_SDLv2 */
+    if (SDL_GetSurfaceBlendMode (surface, &mode) != 0 ||
+        mode != SDL_BLENDMODE_NONE || SDL_GetColorKey (surface, &key) == 0)
+        return -1;
+#endif /* IS_SDLv2 */
+    if (fmt->BytesPerPixel != 3 && fmt->BytesPerPixel != 4)
+        return -1;
 
-    ss_rows = 0;
-    ss_size = 0;
-    ss_surface = NULL;
+    masks[0] = fmt->Rmask;
+    masks[1] = fmt->Gmask;
+    masks[2] = fmt->Bmask;
+    shifts[0] = fmt->Rshift;
+    shifts[1] = fmt->Gshift;
+    shifts[2] = fmt->Bshift;
+    for (i = 0; i < 3; ++i) {
+        if (shifts[i] % 8 || masks[i] != (Uint32)0xff << shifts[i])
+            return -1;
+#if SDL_BYTEORDER == SDL_BIG_ENDIAN
+        offsets[i] = fmt->BytesPerPixel - 1 - shifts[i] / 8;
+#else
+        offsets[i] = shifts[i] / 8;
+#endif
+    }
+    return 0;
+}
 
-    ss_w = surface->w;
-    ss_h = surface->h;
+/*Picks the libjpeg input color space reading the surface rows directly,
+ *libjpeg-turbo takes 32 bit and BGR pixels as well. Returns -1 when the
+ *rows have to be converted to RGB first.
+ */
+static int
+jpeg_direct_space (int bpp, const int offsets[3], J_COLOR_SPACE *space)
+{
+    static const struct {
+        int bpp;
+        int offsets[3];
+        J_COLOR_SPACE space;
+    } spaces[] = {
+        {3, {0, 1, 2}, JCS_RGB},
+#ifdef JCS_EXTENSIONS
+        {3, {2, 1, 0}, JCS_EXT_BGR},
+        {4, {0, 1, 2}, JCS_EXT_RGBX},
+        {4, {2, 1, 0}, JCS_EXT_BGRX},
+        {4, {1, 2, 3}, JCS_EXT_XRGB},
+        {4, {3, 2, 1}, JCS_EXT_XBGR},
+#endif
+    };
+    size_t i;
+
+    for (i = 0; i < sizeof(spaces) / sizeof(spaces[0]); ++i) {
+        if (spaces[i].bpp == bpp &&
+            spaces[i].offsets[0] == offsets[0] &&
+            spaces[i].offsets[1] == offsets[1] &&
+            spaces[i].offsets[2] == offsets[2]) {
+            *space = spaces[i].space;
+            return 0;
+        }
+    }
+    return -1;
+}
 
-    pixel_bits = 24;
+/*Encodes the surface in batches of JPEG_BATCH rows. The rows are passed
+ *to libjpeg as they are when it can read them, picked into an RGB row
+ *buffer when they are byte aligned, or else blitted into a small RGB
+ *surface, as the whole surface used to be.
+ */
+static int
+write_jpeg (const char *file_name, SDL_Surface *surface,
+            const jpeg_options *opts)
+{
+    struct jpeg_compress_struct cinfo;
+    struct jpeg_error_mgr jerr;
+    FILE *outfile;
+    JSAMPROW row_pointer[JPEG_BATCH];
+    J_COLOR_SPACE space = JCS_RGB;
+    SDL_Surface *batch = NULL;
+    SDL_Rect rect;
+    unsigned char *rgb = NULL;
+    unsigned char *src;
+    int offsets[3];
+    int bpp = surface->format->BytesPerPixel;
+    int direct = 0;
+    int num_lines_to_write;
+    int i, x;
+
+    if (jpeg_channel_offsets (surface, offsets) == 0) {
+        direct = jpeg_direct_space (bpp, offsets, &space) == 0;
+        if (!direct) {
+            rgb = (unsigned char *)malloc ((size_t)surface->w * 3 *
+                                           JPEG_BATCH);
+            if (rgb == NULL) {
+                SDL_SetError ("SaveJPEG: out of memory");
+                return -1;
+            }
+        }
+    }
+    else {
+#if IS_SDLv1
+        batch = SDL_CreateRGBSurface (SDL_SWSURFACE, surface->w, JPEG_BATCH,
+                                      24, RED_MASK, GREEN_MASK, BLUE_MASK, 0);
+#else /* IS_SDLv2 */
+        batch = SDL_CreateRGBSurface (0, surface->w, JPEG_BATCH,
+                                      24, RED_MASK, GREEN_MASK, BLUE_MASK, 0);
+#endif /* IS_SDLv2 */
+        if (batch == NULL)
+            return -1;
+    }
 
-    if(!surface) {
+    if ((outfile = fopen (file_name, "wb")) == NULL) {
+        SDL_SetError ("SaveJPEG: could not open %s", file_name);
+        free (rgb);
+        if (batch != NULL)
+            SDL_FreeSurface (batch);
         return -1;
     }
 
-    /* See if the Surface is suitable for using directly.
-       So no conversion is needed.  24bit, RGB
-    */
-
-#if IS_SDLv1
-    if((surface->format->BytesPerPixel == 3) && !(surface->flags & SDL_SRCALPHA) && (surface->format->Rmask == RED_MASK)) {
-        /*
-           printf("not creating...\n");
-        */
-        ss_surface = surface;
+    cinfo.err = jpeg_std_error (&jerr);
+    jpeg_create_compress (&cinfo);
+    j_stdio_dest (&cinfo, outfile);
 
-        free_ss_surface = 0;
-    }
-#else /* IS_SDLv2 */
-    if (surface->format->format == SDL_PIXELFORMAT_RGB24) {
-        /*
-           printf("not creating...\n");
-        */
-        ss_surface = surface;
+    cinfo.image_width = surface->w;
+    cinfo.image_height = surface->h;
+    cinfo.input_components = direct ? bpp : 3;
+    cinfo.in_color_space = space;
 
-        free_ss_surface = 0;
+    jpeg_set_defaults (&cinfo);
+    jpeg_set_quality (&cinfo, opts->quality, TRUE);
+    if (opts->h_samp) {
+        cinfo.comp_info[0].h_samp_factor = opts->h_samp;
+        cinfo.comp_info[0].v_samp_factor = opts->v_samp;
     }
-#endif /* IS_SDLv2 */
-    else {
-        /*
-        printf("creating...\n");
-        */
-
-        /* If it is not, then we need to make a new surface.
-         */
+    if (opts->progressive)
+        jpeg_simple_progression (&cinfo);
+    cinfo.optimize_coding = opts->optimize ? TRUE : FALSE;
 
+    jpeg_start_compress (&cinfo, TRUE);
 
+    if (batch == NULL)
+        SDL_LockSurface (surface);
+    while (cinfo.next_scanline < cinfo.image_height) {
+        num_lines_to_write =
+            MIN (JPEG_BATCH, (int)(cinfo.image_height - cinfo.next_scanline));
+        if (batch != NULL) {
+            /*cleared as the whole surface was, for the alpha blending*/
+            rect.x = 0;
 #if IS_SDLv1
-        ss_surface = SDL_CreateRGBSurface (SDL_SWSURFACE,
-                                           ss_w, ss_h, pixel_bits,
-                                           RED_MASK, GREEN_MASK, BLUE_MASK, 0);
+            rect.y = (Sint16)cinfo.next_scanline;
+            rect.w = (Uint16)surface->w;
+            rect.h = (Uint16)num_lines_to_write;
 #else /* IS_SDLv2 */
-        ss_surface = SDL_CreateRGBSurface (0,
-                                           ss_w, ss_h, pixel_bits,
-                                           RED_MASK, GREEN_MASK, BLUE_MASK, 0);
+            rect.y = (int)cinfo.next_scanline;
+            rect.w = surface->w;
+            rect.h = num_lines_to_write;
 #endif /* IS_SDLv2 */
-        if (ss_surface == NULL) {
-            return -1;
+            SDL_FillRect (batch, NULL, 0);
+            SDL_BlitSurface (surface, &rect, batch, NULL);
+        }
+        for (i = 0; i < num_lines_to_write; i++) {
+            src = (unsigned char *)surface->pixels +
+                (size_t)(cinfo.next_scanline + i) * surface->pitch;
+            if (batch != NULL) {
+                row_pointer[i] = (unsigned char *)batch->pixels +
+                    (size_t)i * batch->pitch;
+            }
+            else if (direct) {
+                row_pointer[i] = src;
+            }
+            else {
+                row_pointer[i] = rgb + (size_t)i * surface->w * 3;
+                for (x = 0; x < surface->w; ++x, src += bpp) {
+                    row_pointer[i][x * 3] = src[offsets[0]];
+                    row_pointer[i][x * 3 + 1] = src[offsets[1]];
+                    row_pointer[i][x * 3 + 2] = src[offsets[2]];
+                }
+            }
         }
 
-        ss_rect.x = 0;
-        ss_rect.y = 0;
-        ss_rect.w = ss_w;
-        ss_rect.h = ss_h;
-        SDL_BlitSurface (surface, &ss_rect, ss_surface, NULL);
-
-        free_ss_surface = 1;
+        jpeg_write_scanlines (&cinfo, row_pointer, num_lines_to_write);
     }
+    if (batch == NULL)
+        SDL_UnlockSurface (surface);
 
+    jpeg_finish_compress (&cinfo);
+    fclose (outfile);
+    jpeg_destroy_compress (&cinfo);
+    free (rgb);
+    if (batch != NULL)
+        SDL_FreeSurface (batch);
+    return 0;
+}
 
-    ss_size = ss_h;
-    ss_rows = (unsigned char**) malloc (sizeof (unsigned char*) * ss_size);
-    if(ss_rows == NULL) {
-        /* clean up the allocated surface too */
-        if(free_ss_surface) {
-            SDL_FreeSurface (ss_surface);
-        }
+static int
+SaveJPEG (SDL_Surface *surface, const char *file, const jpeg_options *opts)
+{
+    if (!surface) {
         return -1;
     }
+    return write_jpeg (file, surface, opts);
+}
 
-    /* copy pointers to the scanlines... since they might not be packed.
-     */
-    for (i = 0; i < ss_h; i++) {
-        ss_rows[i] = ((unsigned char*)ss_surface->pixels) +
-            i * ss_surface->pitch;
-    }
-    r = write_jpeg (file, ss_rows, surface->w, surface->h, 85);
-
-
-    free (ss_rows);
+/* Returns the luma sampling factors for a subsampling name, -1 if unknown. */
+static int
+jpeg_subsampling_from_name (const char *name, int *h_samp, int *v_samp)
+{
+    static const struct {
+        const char *name;
+        int h_samp;
+        int v_samp;
+    } samplings[] = {
+        {"4:4:4", 1, 1},
+        {"4:2:2", 2, 1},
+        {"4:2:0", 2, 2},
+    };
+    size_t i;
 
-    if(free_ss_surface) {
-        SDL_FreeSurface (ss_surface);
-        ss_surface = NULL;
+    for (i = 0; i < sizeof(samplings) / sizeof(samplings[0]); ++i) {
+        if (strcmp(name, samplings[i].name) == 0) {
+            *h_samp = samplings[i].h_samp;
+            *v_samp = samplings[i].v_samp;
+            return 0;
+        }
     }
-    return r;
+    return -1;
 }
 
 #endif /* end if JPEGLIB_H */
@@ -735,19 +2031,103 @@ opengltosdl (void)
 
 #endif /* IS_SDLv1 */
 
+/*the save options of image_save_ext, the PNG ones before the JPEG ones*/
+static char *save_kwids[] = {"surface", "file", "compression", "filter",
+                             "threads", "quality", "subsampling",
+                             "progressive", "optimize", NULL};
+#define SAVE_FIRST_PNG_OPTION 2
+#define SAVE_FIRST_JPEG_OPTION 5
+#define SAVE_OPTIONS_END 9
+
+/*raises TypeError and returns -1 if an option from save_kwids[first] up
+  to save_kwids[last - 1] was given, by position or keyword*/
+static int
+save_check_options(PyObject *arg, PyObject *kwds, int first, int last,
+                   const char *format)
+{
+    int i;
+
+    for (i = first; i < last; ++i) {
+        if (i < PyTuple_GET_SIZE(arg) ||
+            (kwds != NULL &&
+             PyDict_GetItemString(kwds, save_kwids[i]) != NULL)) {
+            PyErr_Format(PyExc_TypeError,
+                         "'%s' is not a save option for %s files",
+                         save_kwids[i], format);
+            return -1;
+        }
+    }
+    return 0;
+}
+
 static PyObject*
-image_save_ext(PyObject *self, PyObject *arg)
+image_save_ext(PyObject *self, PyObject *arg, PyObject *kwds)
 {
     PyObject *surfobj;
     PyObject *obj;
     PyObject *oencoded = NULL;
     SDL_Surface *surf;
     SDL_Surface *temp = NULL;
+    const char *filter = NULL;
+    const char *subsampling = NULL;
+    int compression = -1;
+    int threads = 1;
     int result = 1;
+#ifdef PNG_H
+    png_options png_opts;
+#endif
+#ifdef JPEGLIB_H
+    jpeg_options jpeg_opts = {85, 0, 0, 0, 0};
+#else
+    struct {
+        int quality, progressive, optimize;
+    } jpeg_opts = {85, 0, 0};
+#endif
 
-    if (!PyArg_ParseTuple(arg, "O!O", &pgSurface_Type, &surfobj, &obj)) {
+    if (!PyArg_ParseTupleAndKeywords(arg, kwds, "O!O|iziizii", save_kwids,
+                                     &pgSurface_Type, &surfobj, &obj,
+                                     &compression, &filter, &threads,
+                                     &jpeg_opts.quality, &subsampling,
+                                     &jpeg_opts.progressive,
+                                     &jpeg_opts.optimize)) {
         return NULL;
     }
+    if (compression < -1 || compression > 9) {
+        return RAISE(PyExc_ValueError,
+                     "compression must be -1 or from 0 to 9");
+    }
+    if (threads < 0) {
+        return RAISE(PyExc_ValueError, "threads cannot be negative");
+    }
+    if (threads == 0) {
+#if IS_SDLv2
+        threads = SDL_GetCPUCount();
+#else
+        threads = 4;
+#endif
+    }
+#ifdef PNG_H
+    png_opts.compression = compression;
+    png_opts.threads = MIN(threads, LOAD_MAX_THREADS);
+    png_opts.filter = 0;
+    if (filter != NULL &&
+        !(png_opts.filter = png_filter_from_name(filter))) {
+        return RAISE(PyExc_ValueError,
+                     "filter must be 'none', 'sub', 'up', 'average', "
+                     "'paeth' or 'adaptive'");
+    }
+#endif
+    if (jpeg_opts.quality < 1 || jpeg_opts.quality > 100) {
+        return RAISE(PyExc_ValueError, "quality must be from 1 to 100");
+    }
+#ifdef JPEGLIB_H
+    if (subsampling != NULL &&
+        jpeg_subsampling_from_name(subsampling, &jpeg_opts.h_samp,
+                                   &jpeg_opts.v_samp)) {
+        return RAISE(PyExc_ValueError,
+                     "subsampling must be '4:4:4', '4:2:2' or '4:2:0'");
+    }
+#endif
 
     surf = pgSurface_AsSurface(surfobj);
 #if IS_SDLv1
@@ -784,14 +2164,21 @@ image_save_ext(PyObject *self, PyObject *arg)
               (name[namelen - 2]=='p' || name[namelen - 2]=='P') &&
               (name[namelen - 3]=='j' || name[namelen - 3]=='J'))))  {
 #ifdef JPEGLIB_H
-            /* jpg save functions seem *NOT* thread safe at least on windows. */
-            /*
-            Py_BEGIN_ALLOW_THREADS;
-            */
-            result = SaveJPEG(surf, name);
-            /*
-            Py_END_ALLOW_THREADS;
-            */
+            if (save_check_options(arg, kwds, SAVE_FIRST_PNG_OPTION,
+                                   SAVE_FIRST_JPEG_OPTION, "JPEG")) {
+                result = -2;
+            }
+            else {
+                /* jpg save functions seem *NOT* thread safe at least on
+                   windows. */
+                /*
+                Py_BEGIN_ALLOW_THREADS;
+                */
+                result = SaveJPEG(surf, name, &jpeg_opts);
+                /*
+                Py_END_ALLOW_THREADS;
+                */
+            }
 #else
             RAISE(pgExc_SDLError, "No support for jpg compiled in.");
             result = -2;
@@ -803,9 +2190,15 @@ image_save_ext(PyObject *self, PyObject *arg)
                   (name[namelen - 2]=='n' || name[namelen - 2]=='N') &&
                   (name[namelen - 3]=='p' || name[namelen - 3]=='P')))  {
 #ifdef PNG_H
-            /*Py_BEGIN_ALLOW_THREADS; */
-            result = SavePNG(surf, name);
-            /*Py_END_ALLOW_THREADS; */
+            if (save_check_options(arg, kwds, SAVE_FIRST_JPEG_OPTION,
+                                   SAVE_OPTIONS_END, "PNG")) {
+                result = -2;
+            }
+            else {
+                /*Py_BEGIN_ALLOW_THREADS; */
+                result = SavePNG(surf, name, &png_opts);
+                /*Py_END_ALLOW_THREADS; */
+            }
 #else
             RAISE(pgExc_SDLError, "No support for png compiled in.");
             result = -2;
@@ -842,7 +2235,12 @@ image_save_ext(PyObject *self, PyObject *arg)
 static PyMethodDef _imageext_methods[] =
 {
     { "load_extended", image_load_ext, METH_VARARGS, DOC_PYGAMEIMAGE },
-    { "save_extended", image_save_ext, METH_VARARGS, DOC_PYGAMEIMAGE },
+    { "save_extended", (PyCFunction)image_save_ext,
+      METH_VARARGS | METH_KEYWORDS, DOC_PYGAMEIMAGE },
+    { "load_many_extended", (PyCFunction)load_many_ext,
+      METH_VARARGS | METH_KEYWORDS, DOC_PYGAMEIMAGELOADMANY },
+    { "load_async_extended", (PyCFunction)load_async_ext,
+      METH_VARARGS | METH_KEYWORDS, DOC_PYGAMEIMAGELOADASYNC },
     { NULL, NULL, 0, NULL }
 };
 
@@ -852,6 +2250,8 @@ static PyMethodDef _imageext_methods[] =
 
 MODINIT_DEFINE (imageext)
 {
+    PyObject *module;
+
 #if PY3
     static struct PyModuleDef _module = {
         PyModuleDef_HEAD_INIT,
@@ -875,18 +2275,35 @@ MODINIT_DEFINE (imageext)
         MODINIT_ERROR;
     }
     import_pygame_rwobject ();
-
-
     if (PyErr_Occurred ()) {
         MODINIT_ERROR;
     }
+    import_pygame_event ();
+    if (PyErr_Occurred ()) {
+        MODINIT_ERROR;
+    }
+
+    if (PyType_Ready (&pgAsyncLoad_Type) < 0) {
+        MODINIT_ERROR;
+    }
 
     /* create the module */
 #if PY3
-    return PyModule_Create (&_module);
+    module = PyModule_Create (&_module);
 #else
-    Py_InitModule3(MODPREFIX "imageext",
-                   _imageext_methods,
-                   _imageext_doc);
+    module = Py_InitModule3(MODPREFIX "imageext",
+                            _imageext_methods,
+                            _imageext_doc);
 #endif
+    if (module == NULL) {
+        MODINIT_ERROR;
+    }
+    Py_INCREF (&pgAsyncLoad_Type);
+    if (PyModule_AddObject (module, "AsyncLoad",
+                            (PyObject *)&pgAsyncLoad_Type)) {
+        Py_DECREF (&pgAsyncLoad_Type);
+        DECREF_MOD (module);
+        MODINIT_ERROR;
+    }
+    MODINIT_RETURN (module);
 }
@@ -38,6 +38,12 @@
 #include <stddef.h>
 #include <string.h>
 
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define PG_MATH_SSE2 1
+#endif
+
 /* on some windows platforms math.h doesn't define M_PI */
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
@@ -71,12 +77,17 @@ static PyTypeObject pgVector2_Type;
 static PyTypeObject pgVector3_Type;
 static PyTypeObject pgVectorElementwiseProxy_Type;
 static PyTypeObject pgVectorIter_Type;
+static PyTypeObject pgAffine2_Type;
+static PyTypeObject pgMatrix44_Type;
+static PyTypeObject pgPointIndex_Type;
 
 #define pgVector2_Check(x) (Py_TYPE(x) == &pgVector2_Type)
 #define pgVector3_Check(x) (Py_TYPE(x) == &pgVector3_Type)
 #define pgVector_Check(x) (pgVector2_Check(x) || pgVector3_Check(x))
 #define vector_elementwiseproxy_Check(x) \
     (Py_TYPE(x) == &pgVectorElementwiseProxy_Type)
+#define pgAffine2_Check(x) PyObject_TypeCheck(x, &pgAffine2_Type)
+#define pgMatrix44_Check(x) PyObject_TypeCheck(x, &pgMatrix44_Type)
 
 #define DEG2RAD(angle) ((angle) * M_PI / 180.)
 #define RAD2DEG(angle) ((angle) * 180. / M_PI)
@@ -100,6 +111,26 @@ typedef struct {
     pgVector *vec;
 } vector_elementwiseproxy;
 
+typedef struct {
+    PyObject_HEAD
+    double m[6];        /* a, b, c, d, e, f as in the SVG matrix() notation */
+} pgAffine2;
+
+typedef struct {
+    PyObject_HEAD
+    double m[16];       /* row-major, applied to column vectors */
+} pgMatrix44;
+
+typedef struct {
+    PyObject_HEAD
+    double *points;         /* x, y pairs */
+    Py_ssize_t *order;      /* point indices in k-d tree order */
+    unsigned char *axis;    /* split axis of each tree node */
+    Py_ssize_t count;       /* number of points */
+    int dirty;              /* points moved since the tree was built */
+    int busy;               /* number of queries running without the GIL */
+} pgPointIndex;
+
 
 /* further forward declerations */
 /* generic helper functions */
@@ -1522,12 +1553,135 @@ vector_str(pgVector *self)
 }
 
 
-/* This method first tries normal attribute access. If successful we're
- * done. If not we try swizzling. Here we have 3 different outcomes:
- *  1) swizzling works. we return the result as a tuple
+/* Parsed swizzle patterns are cached by attribute name. Only interned
+ * names are cached (which covers every plain ``v.xy`` access), so the
+ * cache can be keyed by object identity.
+ */
+#define SWIZZLE_CACHE_SIZE 64
+#define SWIZZLE_CACHE_MAX_LEN 8
+
+typedef struct {
+    PyObject *name;     /* interned attribute name; owned reference */
+    Py_ssize_t len;     /* number of components; 0 if name is no swizzle */
+    char idx[SWIZZLE_CACHE_MAX_LEN];
+} swizzle_pattern;
+
+/* one table per vector dimension, indexed with dim - 2 */
+static swizzle_pattern swizzle_cache[2][SWIZZLE_CACHE_SIZE];
+
+/* Returns the cached pattern for <attr_name>, parsing it on a cache miss.
+ * Returns NULL if the name can not be cached.
+ */
+static swizzle_pattern *
+_vector_get_swizzle_pattern(Py_ssize_t dim, PyObject *attr_name,
+                            Py_ssize_t len)
+{
+    swizzle_pattern *pattern;
+    PyObject *old_name;
+    Py_ssize_t i;
+    long c;
+
+#if PY3
+    if (!PyUnicode_CheckExact(attr_name) ||
+        !PyUnicode_CHECK_INTERNED(attr_name)) {
+        return NULL;
+    }
+#else
+    if (!PyString_CheckExact(attr_name) ||
+        !PyString_CHECK_INTERNED(attr_name)) {
+        return NULL;
+    }
+#endif
+    if (len > SWIZZLE_CACHE_MAX_LEN || dim < 2 || dim > 3) {
+        return NULL;
+    }
+    pattern = &swizzle_cache[dim - 2][((size_t)attr_name >> 4) &
+                                      (SWIZZLE_CACHE_SIZE - 1)];
+    if (pattern->name == attr_name) {
+        return pattern;
+    }
+
+    old_name = pattern->name;
+    Py_INCREF(attr_name);
+    pattern->name = attr_name;
+    pattern->len = len;
+    for (i = 0; i < len; ++i) {
+#if PY3
+        c = (long)PyUnicode_READ_CHAR(attr_name, i);
+#else
+        c = (long)(unsigned char)PyString_AS_STRING(attr_name)[i];
+#endif
+        switch (c) {
+        case 'x':
+        case 'y':
+        case 'z':
+            pattern->idx[i] = (char)(c - 'x');
+            break;
+        case 'w':
+            pattern->idx[i] = 3;
+            break;
+        default:
+            pattern->len = 0;
+            break;
+        }
+        if (pattern->len == 0 || pattern->idx[i] >= dim) {
+            pattern->len = 0;
+            break;
+        }
+    }
+    Py_XDECREF(old_name);
+    return pattern;
+}
+
+/* Builds the swizzle result from the component indices <idx>. */
+static PyObject *
+_vector_swizzle_from_indices(pgVector *self, const char *idx, Py_ssize_t len)
+{
+    const double *coords = self->coords;
+    pgVector *vec;
+    PyObject *tuple, *item;
+    Py_ssize_t i;
+
+    switch (len) {
+    case 2:
+        vec = (pgVector *)pgVector_NEW(2);
+        if (vec == NULL)
+            return NULL;
+        vec->coords[0] = coords[(int)idx[0]];
+        vec->coords[1] = coords[(int)idx[1]];
+        return (PyObject *)vec;
+    case 3:
+        vec = (pgVector *)pgVector_NEW(3);
+        if (vec == NULL)
+            return NULL;
+        vec->coords[0] = coords[(int)idx[0]];
+        vec->coords[1] = coords[(int)idx[1]];
+        vec->coords[2] = coords[(int)idx[2]];
+        return (PyObject *)vec;
+    default:
+        /* More than 3, we return a tuple. */
+        tuple = PyTuple_New(len);
+        if (tuple == NULL)
+            return NULL;
+        for (i = 0; i < len; ++i) {
+            item = PyFloat_FromDouble(coords[(int)idx[i]]);
+            if (item == NULL) {
+                Py_DECREF(tuple);
+                return NULL;
+            }
+            PyTuple_SET_ITEM(tuple, i, item);
+        }
+        return tuple;
+    }
+}
+
+/* This method first tries swizzling. Here we have 3 different outcomes:
+ *  1) swizzling works. we return the result as a vector or tuple
  *  2) swizzling fails because it wasn't a valid swizzle. we return the
- *     original AttributeError
+ *     result of normal attribute access
  *  3) swizzling fails due to some internal error. we return this error.
+ * Valid and invalid swizzles of interned names are remembered in
+ * swizzle_cache so repeated accesses skip the parsing.
  */
 static PyObject*
 vector_getAttr_swizzle(pgVector *self, PyObject *attr_name)
@@ -1537,6 +1691,7 @@ vector_getAttr_swizzle(pgVector *self, PyObject *attr_name)
     PyObject *attr_unicode = NULL;
     Py_UNICODE *attr = NULL;
     PyObject *res = NULL;
+    swizzle_pattern *pattern;
 
     len = PySequence_Length(attr_name);
 
@@ -1546,6 +1701,15 @@ vector_getAttr_swizzle(pgVector *self, PyObject *attr_name)
 
     if (len < 0)
         goto swizzle_failed;
+
+    pattern = _vector_get_swizzle_pattern(self->dim, attr_name, len);
+    if (pattern != NULL) {
+        if (pattern->len == 0) {
+            return PyObject_GenericGetAttr((PyObject*)self, attr_name);
+        }
+        return _vector_swizzle_from_indices(self, pattern->idx, len);
+    }
+
     coords = self->coords;
     attr_unicode = PyUnicode_FromObject(attr_name);
     if (attr_unicode == NULL)
@@ -1582,16 +1746,16 @@ vector_getAttr_swizzle(pgVector *self, PyObject *attr_name)
         default:
             goto swizzle_failed;
         }
+        if (idx >= self->dim) {
+            goto swizzle_failed;
+        }
         if (len == 2 || len == 3) {
             ((pgVector*)res)->coords[i] = coords[idx];
         }
-        else if (idx < self->dim) {
+        else {
             if (PyTuple_SetItem(res, i, PyFloat_FromDouble(coords[idx])) != 0)
                 goto internal_error;
         }
-        else {
-            goto swizzle_failed;
-        }
     }
     /* swizzling succeeded! */
     Py_DECREF(attr_unicode);
@@ -3664,6 +3828,2279 @@ vector_elementwise(pgVector *vec)
 
 
 
+/*************************************************************
+ *  Affine2 / Matrix44 helper functions
+ *************************************************************/
+
+/* Fills <coords> with the <size> real numbers of the sequence <seq>.
+ * Returns 1 on success and 0 with an exception set otherwise.
+ */
+static int
+_math_coords_from_seq(PyObject *seq, double *coords, Py_ssize_t size,
+                      const char *errmsg)
+{
+    PyObject *fast;
+    PyObject *item;
+    Py_ssize_t i;
+
+    fast = PySequence_Fast(seq, errmsg);
+    if (fast == NULL) {
+        return 0;
+    }
+    if (PySequence_Fast_GET_SIZE(fast) != size) {
+        Py_DECREF(fast);
+        PyErr_SetString(PyExc_ValueError, errmsg);
+        return 0;
+    }
+    for (i = 0; i < size; ++i) {
+        item = PySequence_Fast_GET_ITEM(fast, i);
+        if (!RealNumber_Check(item)) {
+            Py_DECREF(fast);
+            PyErr_SetString(PyExc_ValueError, errmsg);
+            return 0;
+        }
+        coords[i] = PyFloat_AsDouble(item);
+        if (PyErr_Occurred()) {
+            Py_DECREF(fast);
+            return 0;
+        }
+    }
+    Py_DECREF(fast);
+    return 1;
+}
+
+/* Reads a <dim> dimensional vector argument into <coords>.
+ * Returns 1 on success and 0 with an exception set otherwise.
+ */
+static int
+_math_vector_arg(PyObject *obj, double *coords, Py_ssize_t dim)
+{
+    if (!pgVectorCompatible_Check(obj, dim)) {
+        PyErr_Format(PyExc_TypeError,
+                     "expected a Vector%d or a sequence of %d real numbers",
+                     (int)dim, (int)dim);
+        return 0;
+    }
+    return PySequence_AsVectorCoords(obj, coords, dim);
+}
+
+/* Gets a C contiguous buffer of native doubles whose number of items is a
+ * multiple of <width>.
+ * return
+ *    1 on success. The buffer has to be released with PyBuffer_Release.
+ *    0 if <obj> does not export a buffer.
+ *   -1 if an error occured and an exception was set.
+ */
+static int
+_math_get_double_buffer(PyObject *obj, Py_buffer *view, Py_ssize_t width,
+                        int writable)
+{
+    int flags = PyBUF_C_CONTIGUOUS | PyBUF_FORMAT;
+    char *format;
+
+    if (!PyObject_CheckBuffer(obj)) {
+        return 0;
+    }
+    if (writable) {
+        flags |= PyBUF_WRITABLE;
+    }
+    if (PyObject_GetBuffer(obj, view, flags) != 0) {
+        return -1;
+    }
+    format = view->format;
+    if (format != NULL && (format[0] == '@' || format[0] == '=')) {
+        ++format;
+    }
+    if (format == NULL || format[0] != 'd' || format[1] != '\0' ||
+        view->itemsize != sizeof(double)) {
+        PyBuffer_Release(view);
+        PyErr_SetString(PyExc_TypeError,
+                        "expected a buffer of C doubles (format 'd')");
+        return -1;
+    }
+    if (view->len % (width * (Py_ssize_t)sizeof(double)) != 0) {
+        PyBuffer_Release(view);
+        PyErr_Format(PyExc_ValueError,
+                     "buffer length must be a multiple of %d doubles",
+                     (int)width);
+        return -1;
+    }
+    return 1;
+}
+
+/* Applies the affine map <m> to <count> (x, y) pairs from <src> and stores
+ * the results in <dst>. <src> and <dst> may be the same array. If
+ * <translate> is 0 the translation part is ignored (direction vectors).
+ */
+static void
+_affine2_transform_array(const double *m, double *dst, const double *src,
+                         Py_ssize_t count, int translate)
+{
+    Py_ssize_t i;
+#ifdef PG_MATH_SSE2
+    __m128d col0 = _mm_setr_pd(m[0], m[1]);
+    __m128d col1 = _mm_setr_pd(m[2], m[3]);
+    __m128d offset = translate ? _mm_setr_pd(m[4], m[5]) : _mm_setzero_pd();
+    __m128d point;
+
+    for (i = 0; i < count; ++i, src += 2, dst += 2) {
+        point = _mm_loadu_pd(src);
+        _mm_storeu_pd(dst,
+            _mm_add_pd(_mm_add_pd(_mm_mul_pd(col0,
+                                             _mm_unpacklo_pd(point, point)),
+                                  _mm_mul_pd(col1,
+                                             _mm_unpackhi_pd(point, point))),
+                       offset));
+    }
+#else
+    double x, y;
+    double e = translate ? m[4] : 0.;
+    double f = translate ? m[5] : 0.;
+
+    for (i = 0; i < count; ++i, src += 2, dst += 2) {
+        x = src[0];
+        y = src[1];
+        dst[0] = m[0] * x + m[2] * y + e;
+        dst[1] = m[1] * x + m[3] * y + f;
+    }
+#endif
+}
+
+/* Applies the 4x4 matrix <m> to <count> (x, y, z) triples from <src> and
+ * stores the results in <dst>. <src> and <dst> may be the same array.
+ * With <w> == 1 the triples are points and the result is divided by the
+ * resulting w coordinate; with <w> == 0 they are directions.
+ */
+static void
+_matrix44_transform_array(const double *m, double *dst, const double *src,
+                          Py_ssize_t count, double w)
+{
+    Py_ssize_t i;
+#ifdef PG_MATH_SSE2
+    __m128d c0_xy = _mm_setr_pd(m[0], m[4]);
+    __m128d c0_zw = _mm_setr_pd(m[8], m[12]);
+    __m128d c1_xy = _mm_setr_pd(m[1], m[5]);
+    __m128d c1_zw = _mm_setr_pd(m[9], m[13]);
+    __m128d c2_xy = _mm_setr_pd(m[2], m[6]);
+    __m128d c2_zw = _mm_setr_pd(m[10], m[14]);
+    __m128d c3_xy = _mm_setr_pd(m[3] * w, m[7] * w);
+    __m128d c3_zw = _mm_setr_pd(m[11] * w, m[15] * w);
+    __m128d x, y, z, xy, zw;
+    double out_w;
+
+    for (i = 0; i < count; ++i, src += 3, dst += 3) {
+        x = _mm_set1_pd(src[0]);
+        y = _mm_set1_pd(src[1]);
+        z = _mm_set1_pd(src[2]);
+        xy = _mm_add_pd(_mm_add_pd(_mm_mul_pd(c0_xy, x), _mm_mul_pd(c1_xy, y)),
+                        _mm_add_pd(_mm_mul_pd(c2_xy, z), c3_xy));
+        zw = _mm_add_pd(_mm_add_pd(_mm_mul_pd(c0_zw, x), _mm_mul_pd(c1_zw, y)),
+                        _mm_add_pd(_mm_mul_pd(c2_zw, z), c3_zw));
+        if (w != 0.) {
+            out_w = _mm_cvtsd_f64(_mm_unpackhi_pd(zw, zw));
+            if (out_w != 1. && out_w != 0.) {
+                x = _mm_set1_pd(1. / out_w);
+                xy = _mm_mul_pd(xy, x);
+                zw = _mm_mul_pd(zw, x);
+            }
+        }
+        _mm_storeu_pd(dst, xy);
+        _mm_store_sd(dst + 2, zw);
+    }
+#else
+    double x, y, z, out_w;
+
+    for (i = 0; i < count; ++i, src += 3, dst += 3) {
+        x = src[0];
+        y = src[1];
+        z = src[2];
+        dst[0] = m[0] * x + m[1] * y + m[2] * z + m[3] * w;
+        dst[1] = m[4] * x + m[5] * y + m[6] * z + m[7] * w;
+        dst[2] = m[8] * x + m[9] * y + m[10] * z + m[11] * w;
+        if (w != 0.) {
+            out_w = m[12] * x + m[13] * y + m[14] * z + m[15] * w;
+            if (out_w != 1. && out_w != 0.) {
+                out_w = 1. / out_w;
+                dst[0] *= out_w;
+                dst[1] *= out_w;
+                dst[2] *= out_w;
+            }
+        }
+    }
+#endif
+}
+
+/* Transforms either a buffer of doubles (in place or into <out_obj>) or a
+ * sequence of vectors (into a new list of vectors). This is the common
+ * implementation of the transform_points/transform_vectors methods.
+ */
+static PyObject *
+_math_transform_many(const double *m, Py_ssize_t dim, int translate,
+                     PyObject *src_obj, PyObject *out_obj)
+{
+    Py_buffer src_view, out_view;
+    Py_buffer *dst_view = &src_view;
+    PyObject *fast, *ret;
+    double coords[3];
+    Py_ssize_t i, count;
+    pgVector *vec;
+    int is_buffer;
+
+    if (out_obj == Py_None) {
+        out_obj = NULL;
+    }
+    is_buffer = _math_get_double_buffer(src_obj, &src_view, dim,
+                                        out_obj == NULL);
+    if (is_buffer < 0) {
+        return NULL;
+    }
+    if (is_buffer) {
+        if (out_obj != NULL) {
+            is_buffer = _math_get_double_buffer(out_obj, &out_view, dim, 1);
+            if (is_buffer <= 0) {
+                if (is_buffer == 0) {
+                    PyErr_SetString(PyExc_TypeError,
+                                    "out must be a writable buffer");
+                }
+                PyBuffer_Release(&src_view);
+                return NULL;
+            }
+            if (out_view.len != src_view.len) {
+                PyBuffer_Release(&out_view);
+                PyBuffer_Release(&src_view);
+                return RAISE(PyExc_ValueError,
+                             "out must have the same size as the input");
+            }
+            dst_view = &out_view;
+        }
+        count = src_view.len / (dim * (Py_ssize_t)sizeof(double));
+        Py_BEGIN_ALLOW_THREADS;
+        if (dim == 2) {
+            _affine2_transform_array(m, (double *)dst_view->buf,
+                                     (double *)src_view.buf, count, translate);
+        }
+        else {
+            _matrix44_transform_array(m, (double *)dst_view->buf,
+                                      (double *)src_view.buf, count,
+                                      translate ? 1. : 0.);
+        }
+        Py_END_ALLOW_THREADS;
+        if (dst_view != &src_view) {
+            PyBuffer_Release(&out_view);
+        }
+        PyBuffer_Release(&src_view);
+        ret = out_obj != NULL ? out_obj : src_obj;
+        Py_INCREF(ret);
+        return ret;
+    }
+
+    if (out_obj != NULL) {
+        return RAISE(PyExc_TypeError,
+                     "out is only supported for buffer arguments");
+    }
+    fast = PySequence_Fast(src_obj, "expected a sequence of vectors or a "
+                                    "buffer of doubles");
+    if (fast == NULL) {
+        return NULL;
+    }
+    count = PySequence_Fast_GET_SIZE(fast);
+    ret = PyList_New(count);
+    if (ret == NULL) {
+        Py_DECREF(fast);
+        return NULL;
+    }
+    for (i = 0; i < count; ++i) {
+        if (!_math_vector_arg(PySequence_Fast_GET_ITEM(fast, i), coords,
+                              dim)) {
+            Py_DECREF(ret);
+            Py_DECREF(fast);
+            return NULL;
+        }
+        vec = (pgVector *)pgVector_NEW(dim);
+        if (vec == NULL) {
+            Py_DECREF(ret);
+            Py_DECREF(fast);
+            return NULL;
+        }
+        if (dim == 2) {
+            _affine2_transform_array(m, vec->coords, coords, 1, translate);
+        }
+        else {
+            _matrix44_transform_array(m, vec->coords, coords, 1,
+                                      translate ? 1. : 0.);
+        }
+        PyList_SET_ITEM(ret, i, (PyObject *)vec);
+    }
+    Py_DECREF(fast);
+    return ret;
+}
+
+/* Formats <size> doubles as "<name(a, b, ...)>" */
+static PyObject *
+_math_matrix_repr(const char *name, const double *m, Py_ssize_t size)
+{
+    /* large enough for 16 "%g" formatted doubles and the separators */
+    char buffer[STRING_BUF_SIZE * 4];
+    Py_ssize_t i;
+    int pos;
+
+    pos = PyOS_snprintf(buffer, sizeof(buffer), "<%s(%g", name, m[0]);
+    for (i = 1; i < size && pos >= 0; ++i) {
+        pos += PyOS_snprintf(buffer + pos, sizeof(buffer) - pos, ", %g", m[i]);
+    }
+    if (pos < 0 || pos + 3 > (int)sizeof(buffer)) {
+        return RAISE(PyExc_SystemError,
+                     "Internal buffer to small for snprintf! Please report "
+                     "this to pygame-users@seul.org");
+    }
+    buffer[pos++] = ')';
+    buffer[pos++] = '>';
+    buffer[pos] = '\0';
+    return Text_FromUTF8(buffer);
+}
+
+static PyObject *
+_math_matrix_richcompare(const double *m1, const double *m2, Py_ssize_t size,
+                         int op)
+{
+    Py_ssize_t i;
+    int equal = 1;
+
+    if (op != Py_EQ && op != Py_NE) {
+        Py_INCREF(Py_NotImplemented);
+        return Py_NotImplemented;
+    }
+    for (i = 0; i < size; ++i) {
+        if (m1[i] != m2[i]) {
+            equal = 0;
+            break;
+        }
+    }
+    if (equal == (op == Py_EQ)) {
+        Py_RETURN_TRUE;
+    }
+    Py_RETURN_FALSE;
+}
+
+
+/*************************************************************
+ *  pgAffine2 specific functions
+ *************************************************************/
+
+static const double _affine2_identity[6] = {1., 0., 0., 1., 0., 0.};
+
+static PyObject *
+pgAffine2_New(PyTypeObject *type, const double *m)
+{
+    pgAffine2 *ret = (pgAffine2 *)type->tp_alloc(type, 0);
+    if (ret != NULL) {
+        memcpy(ret->m, m, sizeof(ret->m));
+    }
+    return (PyObject *)ret;
+}
+
+/* dst = lhs * rhs, i.e. rhs is applied first. dst may alias lhs or rhs. */
+static void
+_affine2_multiply(double *dst, const double *lhs, const double *rhs)
+{
+    double tmp[6];
+    tmp[0] = lhs[0] * rhs[0] + lhs[2] * rhs[1];
+    tmp[1] = lhs[1] * rhs[0] + lhs[3] * rhs[1];
+    tmp[2] = lhs[0] * rhs[2] + lhs[2] * rhs[3];
+    tmp[3] = lhs[1] * rhs[2] + lhs[3] * rhs[3];
+    tmp[4] = lhs[0] * rhs[4] + lhs[2] * rhs[5] + lhs[4];
+    tmp[5] = lhs[1] * rhs[4] + lhs[3] * rhs[5] + lhs[5];
+    memcpy(dst, tmp, sizeof(tmp));
+}
+
+static PyObject *
+affine2_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
+{
+    return pgAffine2_New(type, _affine2_identity);
+}
+
+static int
+affine2_init(pgAffine2 *self, PyObject *args, PyObject *kwds)
+{
+    if (kwds != NULL && PyDict_Size(kwds) != 0) {
+        PyErr_SetString(PyExc_TypeError,
+                        "Affine2 does not take keyword arguments");
+        return -1;
+    }
+    if (PyTuple_GET_SIZE(args) == 0) {
+        memcpy(self->m, _affine2_identity, sizeof(self->m));
+        return 0;
+    }
+    if (PyTuple_GET_SIZE(args) == 1 &&
+        pgAffine2_Check(PyTuple_GET_ITEM(args, 0))) {
+        memcpy(self->m, ((pgAffine2 *)PyTuple_GET_ITEM(args, 0))->m,
+               sizeof(self->m));
+        return 0;
+    }
+    if (PyTuple_GET_SIZE(args) == 1) {
+        args = PyTuple_GET_ITEM(args, 0);
+    }
+    if (!_math_coords_from_seq(args, self->m, 6,
+                               "Affine2 must be initialized with 6 real "
+                               "numbers or a sequence of 6 real numbers")) {
+        return -1;
+    }
+    return 0;
+}
+
+static void
+affine2_dealloc(pgAffine2 *self)
+{
+    Py_TYPE(self)->tp_free((PyObject *)self);
+}
+
+static PyObject *
+affine2_identity(PyTypeObject *cls)
+{
+    return pgAffine2_New(cls, _affine2_identity);
+}
+
+static PyObject *
+affine2_translation(PyTypeObject *cls, PyObject *offset)
+{
+    double m[6] = {1., 0., 0., 1., 0., 0.};
+    if (!_math_vector_arg(offset, m + 4, 2)) {
+        return NULL;
+    }
+    return pgAffine2_New(cls, m);
+}
+
+static PyObject *
+affine2_rotation(PyTypeObject *cls, PyObject *args)
+{
+    double angle;
+    double m[6] = {1., 0., 0., 1., 0., 0.};
+
+    if (!PyArg_ParseTuple(args, "d:rotation", &angle)) {
+        return NULL;
+    }
+    /* rotate the basis vectors to share the exact 90 degree cases */
+    if (!_vector2_rotate_helper(m, _affine2_identity, angle, VECTOR_EPSILON) ||
+        !_vector2_rotate_helper(m + 2, _affine2_identity + 2, angle,
+                                VECTOR_EPSILON)) {
+        return NULL;
+    }
+    return pgAffine2_New(cls, m);
+}
+
+static PyObject *
+affine2_scaling(PyTypeObject *cls, PyObject *factor)
+{
+    double m[6] = {1., 0., 0., 1., 0., 0.};
+    double s[2];
+
+    if (RealNumber_Check(factor)) {
+        s[0] = s[1] = PyFloat_AsDouble(factor);
+        if (PyErr_Occurred()) {
+            return NULL;
+        }
+    }
+    else if (!_math_vector_arg(factor, s, 2)) {
+        return NULL;
+    }
+    m[0] = s[0];
+    m[3] = s[1];
+    return pgAffine2_New(cls, m);
+}
+
+static PyObject *
+affine2_mul(PyObject *o1, PyObject *o2)
+{
+    double m[6];
+
+    if (!pgAffine2_Check(o1) || !pgAffine2_Check(o2)) {
+        Py_INCREF(Py_NotImplemented);
+        return Py_NotImplemented;
+    }
+    _affine2_multiply(m, ((pgAffine2 *)o1)->m, ((pgAffine2 *)o2)->m);
+    return pgAffine2_New(&pgAffine2_Type, m);
+}
+
+static PyObject *
+affine2_inplace_mul(pgAffine2 *self, PyObject *other)
+{
+    if (!pgAffine2_Check(other)) {
+        Py_INCREF(Py_NotImplemented);
+        return Py_NotImplemented;
+    }
+    _affine2_multiply(self->m, self->m, ((pgAffine2 *)other)->m);
+    Py_INCREF(self);
+    return (PyObject *)self;
+}
+
+static PyObject *
+affine2_determinant(pgAffine2 *self)
+{
+    return PyFloat_FromDouble(self->m[0] * self->m[3] -
+                              self->m[1] * self->m[2]);
+}
+
+static PyObject *
+affine2_inverse(pgAffine2 *self)
+{
+    const double *m = self->m;
+    double inv[6];
+    double det = m[0] * m[3] - m[1] * m[2];
+
+    if (det == 0. || det != det) {
+        return RAISE(PyExc_ValueError, "Affine2 is not invertible");
+    }
+    det = 1. / det;
+    inv[0] = m[3] * det;
+    inv[1] = -m[1] * det;
+    inv[2] = -m[2] * det;
+    inv[3] = m[0] * det;
+    inv[4] = (m[2] * m[5] - m[3] * m[4]) * det;
+    inv[5] = (m[1] * m[4] - m[0] * m[5]) * det;
+    return pgAffine2_New(&pgAffine2_Type, inv);
+}
+
+static PyObject *
+affine2_decompose(pgAffine2 *self)
+{
+    /* Splits the map into translate * rotate * shear(x by y) * scale */
+    const double *m = self->m;
+    double sx, sy, angle, shear;
+
+    sx = sqrt(m[0] * m[0] + m[1] * m[1]);
+    if (sx == 0.) {
+        return RAISE(PyExc_ValueError, "cannot decompose a degenerate Affine2");
+    }
+    angle = RAD2DEG(atan2(m[1], m[0]));
+    sy = (m[0] * m[3] - m[1] * m[2]) / sx;
+    shear = sy != 0. ? (m[0] * m[2] + m[1] * m[3]) / (sx * sy) : 0.;
+    return Py_BuildValue("(dd)d(dd)d", m[4], m[5], angle, sx, sy, shear);
+}
+
+static PyObject *
+affine2_transform_point(pgAffine2 *self, PyObject *point)
+{
+    pgVector *ret;
+    double coords[2];
+
+    if (!_math_vector_arg(point, coords, 2)) {
+        return NULL;
+    }
+    ret = (pgVector *)pgVector_NEW(2);
+    if (ret != NULL) {
+        _affine2_transform_array(self->m, ret->coords, coords, 1, 1);
+    }
+    return (PyObject *)ret;
+}
+
+static PyObject *
+affine2_transform_vector(pgAffine2 *self, PyObject *vector)
+{
+    pgVector *ret;
+    double coords[2];
+
+    if (!_math_vector_arg(vector, coords, 2)) {
+        return NULL;
+    }
+    ret = (pgVector *)pgVector_NEW(2);
+    if (ret != NULL) {
+        _affine2_transform_array(self->m, ret->coords, coords, 1, 0);
+    }
+    return (PyObject *)ret;
+}
+
+static PyObject *
+affine2_transform_points(pgAffine2 *self, PyObject *args)
+{
+    PyObject *points, *out = NULL;
+
+    if (!PyArg_ParseTuple(args, "O|O:transform_points", &points, &out)) {
+        return NULL;
+    }
+    return _math_transform_many(self->m, 2, 1, points, out);
+}
+
+static PyObject *
+affine2_transform_vectors(pgAffine2 *self, PyObject *args)
+{
+    PyObject *vectors, *out = NULL;
+
+    if (!PyArg_ParseTuple(args, "O|O:transform_vectors", &vectors, &out)) {
+        return NULL;
+    }
+    return _math_transform_many(self->m, 2, 0, vectors, out);
+}
+
+static Py_ssize_t
+affine2_len(pgAffine2 *self)
+{
+    return 6;
+}
+
+static PyObject *
+affine2_GetItem(pgAffine2 *self, Py_ssize_t index)
+{
+    if (index < 0 || index >= 6) {
+        return RAISE(PyExc_IndexError, "subscript out of range.");
+    }
+    return PyFloat_FromDouble(self->m[index]);
+}
+
+static int
+affine2_SetItem(pgAffine2 *self, Py_ssize_t index, PyObject *value)
+{
+    double tmp;
+
+    if (index < 0 || index >= 6) {
+        PyErr_SetString(PyExc_IndexError, "subscript out of range.");
+        return -1;
+    }
+    if (value == NULL) {
+        PyErr_SetString(PyExc_TypeError, "item deletion is not supported");
+        return -1;
+    }
+    tmp = PyFloat_AsDouble(value);
+    if (PyErr_Occurred()) {
+        return -1;
+    }
+    self->m[index] = tmp;
+    return 0;
+}
+
+static PyObject *
+affine2_richcompare(PyObject *o1, PyObject *o2, int op)
+{
+    if (!pgAffine2_Check(o1) || !pgAffine2_Check(o2)) {
+        Py_INCREF(Py_NotImplemented);
+        return Py_NotImplemented;
+    }
+    return _math_matrix_richcompare(((pgAffine2 *)o1)->m,
+                                    ((pgAffine2 *)o2)->m, 6, op);
+}
+
+static PyObject *
+affine2_repr(pgAffine2 *self)
+{
+    return _math_matrix_repr("Affine2", self->m, 6);
+}
+
+static PyObject *
+affine2_reduce(pgAffine2 *self)
+{
+    return Py_BuildValue("(O(dddddd))", Py_TYPE(self),
+                         self->m[0], self->m[1], self->m[2],
+                         self->m[3], self->m[4], self->m[5]);
+}
+
+static PyNumberMethods affine2_as_number = {
+    (binaryfunc)0,                  /* nb_add;       __add__ */
+    (binaryfunc)0,                  /* nb_subtract;  __sub__ */
+    (binaryfunc)affine2_mul,        /* nb_multiply;  __mul__ */
+#if !PY3
+    (binaryfunc)0,                  /* nb_divide;    __div__ */
+#endif
+    (binaryfunc)0,                  /* nb_remainder; __mod__ */
+    (binaryfunc)0,                  /* nb_divmod;    __divmod__ */
+    (ternaryfunc)0,                 /* nb_power;     __pow__ */
+    (unaryfunc)0,                   /* nb_negative;  __neg__ */
+    (unaryfunc)0,                   /* nb_positive;  __pos__ */
+    (unaryfunc)0,                   /* nb_absolute;  __abs__ */
+    (inquiry)0,                     /* nb_nonzero;   __nonzero__ */
+    (unaryfunc)0,                   /* nb_invert;    __invert__ */
+    (binaryfunc)0,                  /* nb_lshift;    __lshift__ */
+    (binaryfunc)0,                  /* nb_rshift;    __rshift__ */
+    (binaryfunc)0,                  /* nb_and;       __and__ */
+    (binaryfunc)0,                  /* nb_xor;       __xor__ */
+    (binaryfunc)0,                  /* nb_or;        __or__ */
+#if !PY3
+    (coercion)0,                    /* nb_coerce;    __coerce__ */
+#endif
+    (unaryfunc)0,                   /* nb_int;       __int__ */
+    (unaryfunc)0,                   /* nb_long;      __long__ */
+    (unaryfunc)0,                   /* nb_float;     __float__ */
+#if !PY3
+    (unaryfunc)0,                   /* nb_oct;       __oct__ */
+    (unaryfunc)0,                   /* nb_hex;       __hex__ */
+#endif
+    /* Added in release 2.0 */
+    (binaryfunc)0,                  /* nb_inplace_add;       __iadd__ */
+    (binaryfunc)0,                  /* nb_inplace_subtract;  __isub__ */
+    (binaryfunc)affine2_inplace_mul, /* nb_inplace_multiply;  __imul__ */
+#if !PY3
+    (binaryfunc)0,                  /* nb_inplace_divide;    __idiv__ */
+#endif
+    (binaryfunc)0,                  /* nb_inplace_remainder; __imod__ */
+    (ternaryfunc)0,                 /* nb_inplace_power;     __pow__ */
+    (binaryfunc)0,                  /* nb_inplace_lshift;    __ilshift__ */
+    (binaryfunc)0,                  /* nb_inplace_rshift;    __irshift__ */
+    (binaryfunc)0,                  /* nb_inplace_and;       __iand__ */
+    (binaryfunc)0,                  /* nb_inplace_xor;       __ixor__ */
+    (binaryfunc)0,                  /* nb_inplace_or;        __ior__ */
+
+    /* Added in release 2.2 */
+    (binaryfunc)0,                  /* nb_floor_divide;         __floor__ */
+    (binaryfunc)0,                  /* nb_true_divide;          __truediv__ */
+    (binaryfunc)0,                  /* nb_inplace_floor_divide; __ifloor__ */
+    (binaryfunc)0,                  /* nb_inplace_true_divide;  __itruediv__ */
+};
+
+static PySequenceMethods affine2_as_sequence = {
+    (lenfunc)affine2_len,             /* sq_length;    __len__ */
+    (binaryfunc)0,                    /* sq_concat;    __add__ */
+    (ssizeargfunc)0,                  /* sq_repeat;    __mul__ */
+    (ssizeargfunc)affine2_GetItem,    /* sq_item;      __getitem__ */
+    (ssizessizeargfunc)0,             /* sq_slice;     __getslice__ */
+    (ssizeobjargproc)affine2_SetItem, /* sq_ass_item;  __setitem__ */
+    (ssizessizeobjargproc)0,          /* sq_ass_slice; __setslice__ */
+};
+
+static PyMethodDef affine2_methods[] = {
+    {"identity", (PyCFunction)affine2_identity, METH_NOARGS | METH_CLASS,
+     DOC_AFFINE2IDENTITY
+    },
+    {"translation", (PyCFunction)affine2_translation, METH_O | METH_CLASS,
+     DOC_AFFINE2TRANSLATION
+    },
+    {"rotation", (PyCFunction)affine2_rotation, METH_VARARGS | METH_CLASS,
+     DOC_AFFINE2ROTATION
+    },
+    {"scaling", (PyCFunction)affine2_scaling, METH_O | METH_CLASS,
+     DOC_AFFINE2SCALING
+    },
+    {"determinant", (PyCFunction)affine2_determinant, METH_NOARGS,
+     DOC_AFFINE2DETERMINANT
+    },
+    {"inverse", (PyCFunction)affine2_inverse, METH_NOARGS,
+     DOC_AFFINE2INVERSE
+    },
+    {"decompose", (PyCFunction)affine2_decompose, METH_NOARGS,
+     DOC_AFFINE2DECOMPOSE
+    },
+    {"transform_point", (PyCFunction)affine2_transform_point, METH_O,
+     DOC_AFFINE2TRANSFORMPOINT
+    },
+    {"transform_vector", (PyCFunction)affine2_transform_vector, METH_O,
+     DOC_AFFINE2TRANSFORMVECTOR
+    },
+    {"transform_points", (PyCFunction)affine2_transform_points, METH_VARARGS,
+     DOC_AFFINE2TRANSFORMPOINTS
+    },
+    {"transform_vectors", (PyCFunction)affine2_transform_vectors,
+     METH_VARARGS, DOC_AFFINE2TRANSFORMVECTORS
+    },
+    { "__reduce__", (PyCFunction)affine2_reduce, METH_NOARGS, NULL },
+
+    {NULL}  /* Sentinel */
+};
+
+
+/********************************
+ * pgAffine2 type definition
+ ********************************/
+
+static PyTypeObject pgAffine2_Type = {
+    TYPE_HEAD(NULL, 0)
+    "pygame.math.Affine2",     /* tp_name */
+    sizeof(pgAffine2),         /* tp_basicsize */
+    0,                         /* tp_itemsize */
+    /* Methods to implement standard operations */
+    (destructor)affine2_dealloc, /* tp_dealloc */
+    0,                         /* tp_print */
+    0,                         /* tp_getattr */
+    0,                         /* tp_setattr */
+    0,                         /* tp_compare */
+    (reprfunc)affine2_repr,    /* tp_repr */
+    /* Method suites for standard classes */
+    &affine2_as_number,        /* tp_as_number */
+    &affine2_as_sequence,      /* tp_as_sequence */
+    0,                         /* tp_as_mapping */
+    /* More standard operations (here for binary compatibility) */
+    0,                         /* tp_hash */
+    0,                         /* tp_call */
+    (reprfunc)affine2_repr,    /* tp_str */
+    0,                         /* tp_getattro */
+    0,                         /* tp_setattro */
+    /* Functions to access object as input/output buffer */
+    0,                         /* tp_as_buffer */
+    /* Flags to define presence of optional/expanded features */
+#if PY3
+    Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE,
+#else
+    Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE |
+    Py_TPFLAGS_CHECKTYPES, /* tp_flags */
+#endif
+    /* Documentation string */
+    DOC_PYGAMEMATHAFFINE2,     /* tp_doc */
+
+    /* Assigned meaning in release 2.0 */
+    /* call function for all accessible objects */
+    0,                         /* tp_traverse */
+    /* delete references to contained objects */
+    0,                         /* tp_clear */
+
+    /* Assigned meaning in release 2.1 */
+    /* rich comparisons */
+    (richcmpfunc)affine2_richcompare, /* tp_richcompare */
+    /* weak reference enabler */
+    0,                         /* tp_weaklistoffset */
+
+    /* Added in release 2.2 */
+    /* Iterators */
+    0,                         /* tp_iter */
+    0,                         /* tp_iternext */
+    /* Attribute descriptor and subclassing stuff */
+    affine2_methods,           /* tp_methods */
+    0,                         /* tp_members */
+    0,                         /* tp_getset */
+    0,                         /* tp_base */
+    0,                         /* tp_dict */
+    0,                         /* tp_descr_get */
+    0,                         /* tp_descr_set */
+    0,                         /* tp_dictoffset */
+    (initproc)affine2_init,    /* tp_init */
+    0,                         /* tp_alloc */
+    (newfunc)affine2_new,      /* tp_new */
+    0,                         /* tp_free */
+    0,                         /* tp_is_gc */
+    0,                         /* tp_bases */
+    0,                         /* tp_mro */
+    0,                         /* tp_cache */
+    0,                         /* tp_subclasses */
+    0,                         /* tp_weaklist */
+};
+
+
+/*************************************************************
+ *  pgMatrix44 specific functions
+ *************************************************************/
+
+static const double _matrix44_identity[16] = {
+    1., 0., 0., 0.,
+    0., 1., 0., 0.,
+    0., 0., 1., 0.,
+    0., 0., 0., 1.
+};
+
+static PyObject *
+pgMatrix44_New(PyTypeObject *type, const double *m)
+{
+    pgMatrix44 *ret = (pgMatrix44 *)type->tp_alloc(type, 0);
+    if (ret != NULL) {
+        memcpy(ret->m, m, sizeof(ret->m));
+    }
+    return (PyObject *)ret;
+}
+
+/* dst = lhs * rhs, i.e. rhs is applied first. dst may alias lhs or rhs. */
+static void
+_matrix44_multiply(double *dst, const double *lhs, const double *rhs)
+{
+    double tmp[16];
+    int row, col;
+
+    for (row = 0; row < 4; ++row) {
+        for (col = 0; col < 4; ++col) {
+            tmp[row * 4 + col] = (lhs[row * 4 + 0] * rhs[0 * 4 + col] +
+                                  lhs[row * 4 + 1] * rhs[1 * 4 + col] +
+                                  lhs[row * 4 + 2] * rhs[2 * 4 + col] +
+                                  lhs[row * 4 + 3] * rhs[3 * 4 + col]);
+        }
+    }
+    memcpy(dst, tmp, sizeof(tmp));
+}
+
+/* Stores the adjugate of <m> in <adj> and returns the determinant. */
+static double
+_matrix44_adjugate(const double *m, double *adj)
+{
+    /* 2x2 sub-determinants of the upper and lower two rows */
+    double s0 = m[0] * m[5] - m[4] * m[1];
+    double s1 = m[0] * m[6] - m[4] * m[2];
+    double s2 = m[0] * m[7] - m[4] * m[3];
+    double s3 = m[1] * m[6] - m[5] * m[2];
+    double s4 = m[1] * m[7] - m[5] * m[3];
+    double s5 = m[2] * m[7] - m[6] * m[3];
+    double c5 = m[10] * m[15] - m[14] * m[11];
+    double c4 = m[9] * m[15] - m[13] * m[11];
+    double c3 = m[9] * m[14] - m[13] * m[10];
+    double c2 = m[8] * m[15] - m[12] * m[11];
+    double c1 = m[8] * m[14] - m[12] * m[10];
+    double c0 = m[8] * m[13] - m[12] * m[9];
+
+    adj[0] = m[5] * c5 - m[6] * c4 + m[7] * c3;
+    adj[1] = -m[1] * c5 + m[2] * c4 - m[3] * c3;
+    adj[2] = m[13] * s5 - m[14] * s4 + m[15] * s3;
+    adj[3] = -m[9] * s5 + m[10] * s4 - m[11] * s3;
+    adj[4] = -m[4] * c5 + m[6] * c2 - m[7] * c1;
+    adj[5] = m[0] * c5 - m[2] * c2 + m[3] * c1;
+    adj[6] = -m[12] * s5 + m[14] * s2 - m[15] * s1;
+    adj[7] = m[8] * s5 - m[10] * s2 + m[11] * s1;
+    adj[8] = m[4] * c4 - m[5] * c2 + m[7] * c0;
+    adj[9] = -m[0] * c4 + m[1] * c2 - m[3] * c0;
+    adj[10] = m[12] * s4 - m[13] * s2 + m[15] * s0;
+    adj[11] = -m[8] * s4 + m[9] * s2 - m[11] * s0;
+    adj[12] = -m[4] * c3 + m[5] * c1 - m[6] * c0;
+    adj[13] = m[0] * c3 - m[1] * c1 + m[2] * c0;
+    adj[14] = -m[12] * s3 + m[13] * s1 - m[14] * s0;
+    adj[15] = m[8] * s3 - m[9] * s1 + m[10] * s0;
+
+    return s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+}
+
+static PyObject *
+matrix44_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
+{
+    return pgMatrix44_New(type, _matrix44_identity);
+}
+
+static int
+matrix44_init(pgMatrix44 *self, PyObject *args, PyObject *kwds)
+{
+    static const char *errmsg = "Matrix44 must be initialized with 16 real "
+                                "numbers or a sequence of 16 real numbers or "
+                                "4 rows of 4 real numbers";
+    PyObject *seq, *row;
+    Py_ssize_t i;
+
+    if (kwds != NULL && PyDict_Size(kwds) != 0) {
+        PyErr_SetString(PyExc_TypeError,
+                        "Matrix44 does not take keyword arguments");
+        return -1;
+    }
+    if (PyTuple_GET_SIZE(args) == 0) {
+        memcpy(self->m, _matrix44_identity, sizeof(self->m));
+        return 0;
+    }
+    seq = PyTuple_GET_ITEM(args, 0);
+    if (PyTuple_GET_SIZE(args) == 1 && pgMatrix44_Check(seq)) {
+        memcpy(self->m, ((pgMatrix44 *)seq)->m, sizeof(self->m));
+        return 0;
+    }
+    if (PyTuple_GET_SIZE(args) == 1 && PySequence_Check(seq) &&
+        PySequence_Length(seq) == 4) {
+        for (i = 0; i < 4; ++i) {
+            row = PySequence_GetItem(seq, i);
+            if (row == NULL) {
+                return -1;
+            }
+            if (!_math_coords_from_seq(row, self->m + i * 4, 4, errmsg)) {
+                Py_DECREF(row);
+                return -1;
+            }
+            Py_DECREF(row);
+        }
+        return 0;
+    }
+    if (PyTuple_GET_SIZE(args) == 1) {
+        args = seq;
+    }
+    if (!_math_coords_from_seq(args, self->m, 16, errmsg)) {
+        return -1;
+    }
+    return 0;
+}
+
+static void
+matrix44_dealloc(pgMatrix44 *self)
+{
+    Py_TYPE(self)->tp_free((PyObject *)self);
+}
+
+static PyObject *
+matrix44_identity(PyTypeObject *cls)
+{
+    return pgMatrix44_New(cls, _matrix44_identity);
+}
+
+static PyObject *
+matrix44_translation(PyTypeObject *cls, PyObject *offset)
+{
+    double m[16];
+    double t[3];
+
+    if (!_math_vector_arg(offset, t, 3)) {
+        return NULL;
+    }
+    memcpy(m, _matrix44_identity, sizeof(m));
+    m[3] = t[0];
+    m[7] = t[1];
+    m[11] = t[2];
+    return pgMatrix44_New(cls, m);
+}
+
+static PyObject *
+matrix44_rotation(PyTypeObject *cls, PyObject *args)
+{
+    static const double basis[3][3] = {{1., 0., 0.},
+                                       {0., 1., 0.},
+                                       {0., 0., 1.}};
+    PyObject *axis_obj;
+    double axis[3];
+    double column[3];
+    double angle;
+    double m[16];
+    int i;
+
+    if (!PyArg_ParseTuple(args, "dO:rotation", &angle, &axis_obj)) {
+        return NULL;
+    }
+    if (!_math_vector_arg(axis_obj, axis, 3)) {
+        return NULL;
+    }
+    memcpy(m, _matrix44_identity, sizeof(m));
+    /* the columns are the rotated basis vectors */
+    for (i = 0; i < 3; ++i) {
+        if (!_vector3_rotate_helper(column, basis[i], axis, angle,
+                                    VECTOR_EPSILON)) {
+            return NULL;
+        }
+        m[i] = column[0];
+        m[4 + i] = column[1];
+        m[8 + i] = column[2];
+    }
+    return pgMatrix44_New(cls, m);
+}
+
+static PyObject *
+matrix44_scaling(PyTypeObject *cls, PyObject *factor)
+{
+    double m[16];
+    double s[3];
+
+    if (RealNumber_Check(factor)) {
+        s[0] = s[1] = s[2] = PyFloat_AsDouble(factor);
+        if (PyErr_Occurred()) {
+            return NULL;
+        }
+    }
+    else if (!_math_vector_arg(factor, s, 3)) {
+        return NULL;
+    }
+    memcpy(m, _matrix44_identity, sizeof(m));
+    m[0] = s[0];
+    m[5] = s[1];
+    m[10] = s[2];
+    return pgMatrix44_New(cls, m);
+}
+
+static PyObject *
+matrix44_perspective(PyTypeObject *cls, PyObject *args)
+{
+    double fovy, aspect, z_near, z_far, f;
+    double m[16];
+
+    if (!PyArg_ParseTuple(args, "dddd:perspective",
+                          &fovy, &aspect, &z_near, &z_far)) {
+        return NULL;
+    }
+    if (aspect == 0. || z_near == z_far || fmod(fovy, 180.) == 0.) {
+        return RAISE(PyExc_ValueError, "invalid perspective parameters");
+    }
+    f = 1. / tan(DEG2RAD(fovy) / 2.);
+    memset(m, 0, sizeof(m));
+    m[0] = f / aspect;
+    m[5] = f;
+    m[10] = (z_far + z_near) / (z_near - z_far);
+    m[11] = 2. * z_far * z_near / (z_near - z_far);
+    m[14] = -1.;
+    return pgMatrix44_New(cls, m);
+}
+
+static PyObject *
+matrix44_orthographic(PyTypeObject *cls, PyObject *args)
+{
+    double left, right, bottom, top, z_near, z_far;
+    double m[16];
+
+    if (!PyArg_ParseTuple(args, "dddddd:orthographic",
+                          &left, &right, &bottom, &top, &z_near, &z_far)) {
+        return NULL;
+    }
+    if (left == right || bottom == top || z_near == z_far) {
+        return RAISE(PyExc_ValueError, "invalid orthographic parameters");
+    }
+    memcpy(m, _matrix44_identity, sizeof(m));
+    m[0] = 2. / (right - left);
+    m[3] = -(right + left) / (right - left);
+    m[5] = 2. / (top - bottom);
+    m[7] = -(top + bottom) / (top - bottom);
+    m[10] = -2. / (z_far - z_near);
+    m[11] = -(z_far + z_near) / (z_far - z_near);
+    return pgMatrix44_New(cls, m);
+}
+
+static PyObject *
+matrix44_mul(PyObject *o1, PyObject *o2)
+{
+    double m[16];
+
+    if (!pgMatrix44_Check(o1) || !pgMatrix44_Check(o2)) {
+        Py_INCREF(Py_NotImplemented);
+        return Py_NotImplemented;
+    }
+    _matrix44_multiply(m, ((pgMatrix44 *)o1)->m, ((pgMatrix44 *)o2)->m);
+    return pgMatrix44_New(&pgMatrix44_Type, m);
+}
+
+static PyObject *
+matrix44_inplace_mul(pgMatrix44 *self, PyObject *other)
+{
+    if (!pgMatrix44_Check(other)) {
+        Py_INCREF(Py_NotImplemented);
+        return Py_NotImplemented;
+    }
+    _matrix44_multiply(self->m, self->m, ((pgMatrix44 *)other)->m);
+    Py_INCREF(self);
+    return (PyObject *)self;
+}
+
+static PyObject *
+matrix44_determinant(pgMatrix44 *self)
+{
+    double adj[16];
+    return PyFloat_FromDouble(_matrix44_adjugate(self->m, adj));
+}
+
+static PyObject *
+matrix44_inverse(pgMatrix44 *self)
+{
+    double inv[16];
+    double det = _matrix44_adjugate(self->m, inv);
+    int i;
+
+    if (det == 0. || det != det) {
+        return RAISE(PyExc_ValueError, "Matrix44 is not invertible");
+    }
+    det = 1. / det;
+    for (i = 0; i < 16; ++i) {
+        inv[i] *= det;
+    }
+    return pgMatrix44_New(&pgMatrix44_Type, inv);
+}
+
+static PyObject *
+matrix44_transpose(pgMatrix44 *self)
+{
+    double m[16];
+    int row, col;
+
+    for (row = 0; row < 4; ++row) {
+        for (col = 0; col < 4; ++col) {
+            m[col * 4 + row] = self->m[row * 4 + col];
+        }
+    }
+    return pgMatrix44_New(&pgMatrix44_Type, m);
+}
+
+static PyObject *
+matrix44_decompose(pgMatrix44 *self)
+{
+    /* Splits an affine matrix into translate * rotate * scale. Shear and
+     * projection parts are not representable and get folded into the
+     * rotation part.
+     */
+    const double *m = self->m;
+    double rot[16];
+    double scale[3];
+    double det;
+    PyObject *rot_obj, *ret;
+    int i;
+
+    for (i = 0; i < 3; ++i) {
+        scale[i] = sqrt(m[i] * m[i] + m[4 + i] * m[4 + i] +
+                        m[8 + i] * m[8 + i]);
+        if (scale[i] == 0.) {
+            return RAISE(PyExc_ValueError,
+                         "cannot decompose a degenerate Matrix44");
+        }
+    }
+    /* a mirroring is expressed as a negative x scale */
+    det = (m[0] * (m[5] * m[10] - m[6] * m[9]) -
+           m[1] * (m[4] * m[10] - m[6] * m[8]) +
+           m[2] * (m[4] * m[9] - m[5] * m[8]));
+    if (det < 0.) {
+        scale[0] = -scale[0];
+    }
+    memcpy(rot, _matrix44_identity, sizeof(rot));
+    for (i = 0; i < 3; ++i) {
+        rot[i] = m[i] / scale[i];
+        rot[4 + i] = m[4 + i] / scale[i];
+        rot[8 + i] = m[8 + i] / scale[i];
+    }
+    rot_obj = pgMatrix44_New(&pgMatrix44_Type, rot);
+    if (rot_obj == NULL) {
+        return NULL;
+    }
+    ret = Py_BuildValue("(ddd)O(ddd)", m[3], m[7], m[11], rot_obj,
+                        scale[0], scale[1], scale[2]);
+    Py_DECREF(rot_obj);
+    return ret;
+}
+
+static PyObject *
+matrix44_transform_point(pgMatrix44 *self, PyObject *point)
+{
+    pgVector *ret;
+    double coords[3];
+
+    if (!_math_vector_arg(point, coords, 3)) {
+        return NULL;
+    }
+    ret = (pgVector *)pgVector_NEW(3);
+    if (ret != NULL) {
+        _matrix44_transform_array(self->m, ret->coords, coords, 1, 1.);
+    }
+    return (PyObject *)ret;
+}
+
+static PyObject *
+matrix44_transform_vector(pgMatrix44 *self, PyObject *vector)
+{
+    pgVector *ret;
+    double coords[3];
+
+    if (!_math_vector_arg(vector, coords, 3)) {
+        return NULL;
+    }
+    ret = (pgVector *)pgVector_NEW(3);
+    if (ret != NULL) {
+        _matrix44_transform_array(self->m, ret->coords, coords, 1, 0.);
+    }
+    return (PyObject *)ret;
+}
+
+static PyObject *
+matrix44_transform_points(pgMatrix44 *self, PyObject *args)
+{
+    PyObject *points, *out = NULL;
+
+    if (!PyArg_ParseTuple(args, "O|O:transform_points", &points, &out)) {
+        return NULL;
+    }
+    return _math_transform_many(self->m, 3, 1, points, out);
+}
+
+static PyObject *
+matrix44_transform_vectors(pgMatrix44 *self, PyObject *args)
+{
+    PyObject *vectors, *out = NULL;
+
+    if (!PyArg_ParseTuple(args, "O|O:transform_vectors", &vectors, &out)) {
+        return NULL;
+    }
+    return _math_transform_many(self->m, 3, 0, vectors, out);
+}
+
+static Py_ssize_t
+matrix44_len(pgMatrix44 *self)
+{
+    return 16;
+}
+
+static PyObject *
+matrix44_GetItem(pgMatrix44 *self, Py_ssize_t index)
+{
+    if (index < 0 || index >= 16) {
+        return RAISE(PyExc_IndexError, "subscript out of range.");
+    }
+    return PyFloat_FromDouble(self->m[index]);
+}
+
+static int
+matrix44_SetItem(pgMatrix44 *self, Py_ssize_t index, PyObject *value)
+{
+    double tmp;
+
+    if (index < 0 || index >= 16) {
+        PyErr_SetString(PyExc_IndexError, "subscript out of range.");
+        return -1;
+    }
+    if (value == NULL) {
+        PyErr_SetString(PyExc_TypeError, "item deletion is not supported");
+        return -1;
+    }
+    tmp = PyFloat_AsDouble(value);
+    if (PyErr_Occurred()) {
+        return -1;
+    }
+    self->m[index] = tmp;
+    return 0;
+}
+
+static PyObject *
+matrix44_richcompare(PyObject *o1, PyObject *o2, int op)
+{
+    if (!pgMatrix44_Check(o1) || !pgMatrix44_Check(o2)) {
+        Py_INCREF(Py_NotImplemented);
+        return Py_NotImplemented;
+    }
+    return _math_matrix_richcompare(((pgMatrix44 *)o1)->m,
+                                    ((pgMatrix44 *)o2)->m, 16, op);
+}
+
+static PyObject *
+matrix44_repr(pgMatrix44 *self)
+{
+    return _math_matrix_repr("Matrix44", self->m, 16);
+}
+
+static PyObject *
+matrix44_reduce(pgMatrix44 *self)
+{
+    PyObject *values, *ret;
+    int i;
+
+    values = PyTuple_New(16);
+    if (values == NULL) {
+        return NULL;
+    }
+    for (i = 0; i < 16; ++i) {
+        PyTuple_SET_ITEM(values, i, PyFloat_FromDouble(self->m[i]));
+    }
+    ret = Py_BuildValue("(O(O))", Py_TYPE(self), values);
+    Py_DECREF(values);
+    return ret;
+}
+
+static PyNumberMethods matrix44_as_number = {
+    (binaryfunc)0,                  /* nb_add;       __add__ */
+    (binaryfunc)0,                  /* nb_subtract;  __sub__ */
+    (binaryfunc)matrix44_mul,       /* nb_multiply;  __mul__ */
+#if !PY3
+    (binaryfunc)0,                  /* nb_divide;    __div__ */
+#endif
+    (binaryfunc)0,                  /* nb_remainder; __mod__ */
+    (binaryfunc)0,                  /* nb_divmod;    __divmod__ */
+    (ternaryfunc)0,                 /* nb_power;     __pow__ */
+    (unaryfunc)0,                   /* nb_negative;  __neg__ */
+    (unaryfunc)0,                   /* nb_positive;  __pos__ */
+    (unaryfunc)0,                   /* nb_absolute;  __abs__ */
+    (inquiry)0,                     /* nb_nonzero;   __nonzero__ */
+    (unaryfunc)0,                   /* nb_invert;    __invert__ */
+    (binaryfunc)0,                  /* nb_lshift;    __lshift__ */
+    (binaryfunc)0,                  /* nb_rshift;    __rshift__ */
+    (binaryfunc)0,                  /* nb_and;       __and__ */
+    (binaryfunc)0,                  /* nb_xor;       __xor__ */
+    (binaryfunc)0,                  /* nb_or;        __or__ */
+#if !PY3
+    (coercion)0,                    /* nb_coerce;    __coerce__ */
+#endif
+    (unaryfunc)0,                   /* nb_int;       __int__ */
+    (unaryfunc)0,                   /* nb_long;      __long__ */
+    (unaryfunc)0,                   /* nb_float;     __float__ */
+#if !PY3
+    (unaryfunc)0,                   /* nb_oct;       __oct__ */
+    (unaryfunc)0,                   /* nb_hex;       __hex__ */
+#endif
+    /* Added in release 2.0 */
+    (binaryfunc)0,                  /* nb_inplace_add;       __iadd__ */
+    (binaryfunc)0,                  /* nb_inplace_subtract;  __isub__ */
+    (binaryfunc)matrix44_inplace_mul, /* nb_inplace_multiply;  __imul__ */
+#if !PY3
+    (binaryfunc)0,                  /* nb_inplace_divide;    __idiv__ */
+#endif
+    (binaryfunc)0,                  /* nb_inplace_remainder; __imod__ */
+    (ternaryfunc)0,                 /* nb_inplace_power;     __pow__ */
+    (binaryfunc)0,                  /* nb_inplace_lshift;    __ilshift__ */
+    (binaryfunc)0,                  /* nb_inplace_rshift;    __irshift__ */
+    (binaryfunc)0,                  /* nb_inplace_and;       __iand__ */
+    (binaryfunc)0,                  /* nb_inplace_xor;       __ixor__ */
+    (binaryfunc)0,                  /* nb_inplace_or;        __ior__ */
+
+    /* Added in release 2.2 */
+    (binaryfunc)0,                  /* nb_floor_divide;         __floor__ */
+    (binaryfunc)0,                  /* nb_true_divide;          __truediv__ */
+    (binaryfunc)0,                  /* nb_inplace_floor_divide; __ifloor__ */
+    (binaryfunc)0,                  /* nb_inplace_true_divide;  __itruediv__ */
+};
+
+static PySequenceMethods matrix44_as_sequence = {
+    (lenfunc)matrix44_len,             /* sq_length;    __len__ */
+    (binaryfunc)0,                     /* sq_concat;    __add__ */
+    (ssizeargfunc)0,                   /* sq_repeat;    __mul__ */
+    (ssizeargfunc)matrix44_GetItem,    /* sq_item;      __getitem__ */
+    (ssizessizeargfunc)0,              /* sq_slice;     __getslice__ */
+    (ssizeobjargproc)matrix44_SetItem, /* sq_ass_item;  __setitem__ */
+    (ssizessizeobjargproc)0,           /* sq_ass_slice; __setslice__ */
+};
+
+static PyMethodDef matrix44_methods[] = {
+    {"identity", (PyCFunction)matrix44_identity, METH_NOARGS | METH_CLASS,
+     DOC_MATRIX44IDENTITY
+    },
+    {"translation", (PyCFunction)matrix44_translation, METH_O | METH_CLASS,
+     DOC_MATRIX44TRANSLATION
+    },
+    {"rotation", (PyCFunction)matrix44_rotation, METH_VARARGS | METH_CLASS,
+     DOC_MATRIX44ROTATION
+    },
+    {"scaling", (PyCFunction)matrix44_scaling, METH_O | METH_CLASS,
+     DOC_MATRIX44SCALING
+    },
+    {"perspective", (PyCFunction)matrix44_perspective,
+     METH_VARARGS | METH_CLASS, DOC_MATRIX44PERSPECTIVE
+    },
+    {"orthographic", (PyCFunction)matrix44_orthographic,
+     METH_VARARGS | METH_CLASS, DOC_MATRIX44ORTHOGRAPHIC
+    },
+    {"determinant", (PyCFunction)matrix44_determinant, METH_NOARGS,
+     DOC_MATRIX44DETERMINANT
+    },
+    {"inverse", (PyCFunction)matrix44_inverse, METH_NOARGS,
+     DOC_MATRIX44INVERSE
+    },
+    {"transpose", (PyCFunction)matrix44_transpose, METH_NOARGS,
+     DOC_MATRIX44TRANSPOSE
+    },
+    {"decompose", (PyCFunction)matrix44_decompose, METH_NOARGS,
+     DOC_MATRIX44DECOMPOSE
+    },
+    {"transform_point", (PyCFunction)matrix44_transform_point, METH_O,
+     DOC_MATRIX44TRANSFORMPOINT
+    },
+    {"transform_vector", (PyCFunction)matrix44_transform_vector, METH_O,
+     DOC_MATRIX44TRANSFORMVECTOR
+    },
+    {"transform_points", (PyCFunction)matrix44_transform_points,
+     METH_VARARGS, DOC_MATRIX44TRANSFORMPOINTS
+    },
+    {"transform_vectors", (PyCFunction)matrix44_transform_vectors,
+     METH_VARARGS, DOC_MATRIX44TRANSFORMVECTORS
+    },
+    { "__reduce__", (PyCFunction)matrix44_reduce, METH_NOARGS, NULL },
+
+    {NULL}  /* Sentinel */
+};
+
+
+/********************************
+ * pgMatrix44 type definition
+ ********************************/
+
+static PyTypeObject pgMatrix44_Type = {
+    TYPE_HEAD(NULL, 0)
+    "pygame.math.Matrix44",    /* tp_name */
+    sizeof(pgMatrix44),        /* tp_basicsize */
+    0,                         /* tp_itemsize */
+    /* Methods to implement standard operations */
+    (destructor)matrix44_dealloc, /* tp_dealloc */
+    0,                         /* tp_print */
+    0,                         /* tp_getattr */
+    0,                         /* tp_setattr */
+    0,                         /* tp_compare */
+    (reprfunc)matrix44_repr,   /* tp_repr */
+    /* Method suites for standard classes */
+    &matrix44_as_number,       /* tp_as_number */
+    &matrix44_as_sequence,     /* tp_as_sequence */
+    0,                         /* tp_as_mapping */
+    /* More standard operations (here for binary compatibility) */
+    0,                         /* tp_hash */
+    0,                         /* tp_call */
+    (reprfunc)matrix44_repr,   /* tp_str */
+    0,                         /* tp_getattro */
+    0,                         /* tp_setattro */
+    /* Functions to access object as input/output buffer */
+    0,                         /* tp_as_buffer */
+    /* Flags to define presence of optional/expanded features */
+#if PY3
+    Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE,
+#else
+    Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE |
+    Py_TPFLAGS_CHECKTYPES, /* tp_flags */
+#endif
+    /* Documentation string */
+    DOC_PYGAMEMATHMATRIX44,    /* tp_doc */
+
+    /* Assigned meaning in release 2.0 */
+    /* call function for all accessible objects */
+    0,                         /* tp_traverse */
+    /* delete references to contained objects */
+    0,                         /* tp_clear */
+
+    /* Assigned meaning in release 2.1 */
+    /* rich comparisons */
+    (richcmpfunc)matrix44_richcompare, /* tp_richcompare */
+    /* weak reference enabler */
+    0,                         /* tp_weaklistoffset */
+
+    /* Added in release 2.2 */
+    /* Iterators */
+    0,                         /* tp_iter */
+    0,                         /* tp_iternext */
+    /* Attribute descriptor and subclassing stuff */
+    matrix44_methods,          /* tp_methods */
+    0,                         /* tp_members */
+    0,                         /* tp_getset */
+    0,                         /* tp_base */
+    0,                         /* tp_dict */
+    0,                         /* tp_descr_get */
+    0,                         /* tp_descr_set */
+    0,                         /* tp_dictoffset */
+    (initproc)matrix44_init,   /* tp_init */
+    0,                         /* tp_alloc */
+    (newfunc)matrix44_new,     /* tp_new */
+    0,                         /* tp_free */
+    0,                         /* tp_is_gc */
+    0,                         /* tp_bases */
+    0,                         /* tp_mro */
+    0,                         /* tp_cache */
+    0,                         /* tp_subclasses */
+    0,                         /* tp_weaklist */
+};
+
+
+/*************************************************************
+ *  pgPointIndex specific functions
+ *************************************************************/
+
+/* The index is a k-d tree stored implicitly in <order>: the node covering
+ * order[lo:hi] splits at mid = lo + (hi - lo) / 2 along axis[mid], the
+ * left subtree being order[lo:mid] and the right one order[mid + 1:hi].
+ * Ranges of at most POINTINDEX_LEAF_SIZE points are scanned linearly.
+ */
+#define POINTINDEX_LEAF_SIZE 8
+
+#define POINTINDEX_KEY(pts, i, ax) ((pts)[2 * (i) + (ax)])
+
+/* Growable array of point indices. Uses malloc so it can be filled while
+ * the GIL is released.
+ */
+typedef struct {
+    Py_ssize_t *items;
+    Py_ssize_t len;
+    Py_ssize_t size;
+} _pointindex_result;
+
+/* State of a k nearest neighbour search. dist and idx form a max-heap. */
+typedef struct {
+    const double *pts;
+    const Py_ssize_t *order;
+    const unsigned char *axis;
+    double x, y;
+    Py_ssize_t k;
+    Py_ssize_t found;
+    double *dist;
+    Py_ssize_t *idx;
+} _pointindex_knn;
+
+/* Moves the point with the <k>-th smallest coordinate along <ax> within
+ * order[lo:hi] to order[k]. Smaller ones end up left, larger ones right.
+ */
+static void
+_pointindex_select(const double *pts, Py_ssize_t *order, Py_ssize_t lo,
+                   Py_ssize_t hi, Py_ssize_t k, int ax)
+{
+    Py_ssize_t i, j, tmp;
+    double pivot;
+
+    --hi;
+    while (lo < hi) {
+        pivot = POINTINDEX_KEY(pts, order[lo + (hi - lo) / 2], ax);
+        i = lo;
+        j = hi;
+        while (i <= j) {
+            while (POINTINDEX_KEY(pts, order[i], ax) < pivot)
+                ++i;
+            while (POINTINDEX_KEY(pts, order[j], ax) > pivot)
+                --j;
+            if (i <= j) {
+                tmp = order[i];
+                order[i] = order[j];
+                order[j] = tmp;
+                ++i;
+                --j;
+            }
+        }
+        if (k <= j)
+            hi = j;
+        else if (k >= i)
+            lo = i;
+        else
+            break;
+    }
+}
+
+static void
+_pointindex_build(const double *pts, Py_ssize_t *order, unsigned char *axis,
+                  Py_ssize_t lo, Py_ssize_t hi)
+{
+    double min_x, max_x, min_y, max_y, x, y;
+    Py_ssize_t i, mid;
+    int ax;
+
+    while (hi - lo > POINTINDEX_LEAF_SIZE) {
+        /* split along the axis with the larger extent */
+        min_x = max_x = POINTINDEX_KEY(pts, order[lo], 0);
+        min_y = max_y = POINTINDEX_KEY(pts, order[lo], 1);
+        for (i = lo + 1; i < hi; ++i) {
+            x = POINTINDEX_KEY(pts, order[i], 0);
+            y = POINTINDEX_KEY(pts, order[i], 1);
+            if (x < min_x)
+                min_x = x;
+            else if (x > max_x)
+                max_x = x;
+            if (y < min_y)
+                min_y = y;
+            else if (y > max_y)
+                max_y = y;
+        }
+        ax = (max_y - min_y > max_x - min_x) ? 1 : 0;
+        mid = lo + (hi - lo) / 2;
+        _pointindex_select(pts, order, lo, hi, mid, ax);
+        axis[mid] = (unsigned char)ax;
+        _pointindex_build(pts, order, axis, lo, mid);
+        lo = mid + 1;
+    }
+}
+
+static int
+_pointindex_result_append(_pointindex_result *res, Py_ssize_t value)
+{
+    Py_ssize_t *items;
+    Py_ssize_t size;
+
+    if (res->len == res->size) {
+        size = res->size ? res->size * 2 : 64;
+        items = (Py_ssize_t *)realloc(res->items, size * sizeof(Py_ssize_t));
+        if (items == NULL) {
+            return -1;
+        }
+        res->items = items;
+        res->size = size;
+    }
+    res->items[res->len++] = value;
+    return 0;
+}
+
+static int
+_pointindex_compare_index(const void *a, const void *b)
+{
+    Py_ssize_t lhs = *(const Py_ssize_t *)a;
+    Py_ssize_t rhs = *(const Py_ssize_t *)b;
+    return (lhs > rhs) - (lhs < rhs);
+}
+
+/* Appends the indices of all points within sqrt(<r2>) of (<x>, <y>) which
+ * are larger than <min_index> to <res>. Returns -1 if out of memory.
+ */
+static int
+_pointindex_within(const double *pts, const Py_ssize_t *order,
+                   const unsigned char *axis, Py_ssize_t lo, Py_ssize_t hi,
+                   double x, double y, double r, Py_ssize_t min_index,
+                   _pointindex_result *res)
+{
+    double dx, dy, diff;
+    Py_ssize_t i, p, mid;
+
+    while (hi - lo > POINTINDEX_LEAF_SIZE) {
+        mid = lo + (hi - lo) / 2;
+        p = order[mid];
+        dx = POINTINDEX_KEY(pts, p, 0) - x;
+        dy = POINTINDEX_KEY(pts, p, 1) - y;
+        if (p > min_index && dx * dx + dy * dy <= r * r &&
+            _pointindex_result_append(res, p) != 0) {
+            return -1;
+        }
+        diff = (axis[mid] ? y : x) - POINTINDEX_KEY(pts, p, axis[mid]);
+        if (diff <= r) {
+            if (diff >= -r &&
+                _pointindex_within(pts, order, axis, mid + 1, hi, x, y, r,
+                                   min_index, res) != 0) {
+                return -1;
+            }
+            hi = mid;
+        }
+        else {
+            lo = mid + 1;
+        }
+    }
+    for (i = lo; i < hi; ++i) {
+        p = order[i];
+        dx = POINTINDEX_KEY(pts, p, 0) - x;
+        dy = POINTINDEX_KEY(pts, p, 1) - y;
+        if (p > min_index && dx * dx + dy * dy <= r * r &&
+            _pointindex_result_append(res, p) != 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/* Stores (<d>, <p>) at the top of the max-heap of <n> entries and sifts it
+ * down to its place.
+ */
+static void
+_pointindex_heap_replace_top(double *dist, Py_ssize_t *idx, Py_ssize_t n,
+                             double d, Py_ssize_t p)
+{
+    Py_ssize_t i = 0, child;
+
+    while ((child = 2 * i + 1) < n) {
+        if (child + 1 < n && dist[child + 1] > dist[child])
+            ++child;
+        if (dist[child] <= d)
+            break;
+        dist[i] = dist[child];
+        idx[i] = idx[child];
+        i = child;
+    }
+    dist[i] = d;
+    idx[i] = p;
+}
+
+static void
+_pointindex_knn_consider(_pointindex_knn *s, Py_ssize_t p)
+{
+    double dx = POINTINDEX_KEY(s->pts, p, 0) - s->x;
+    double dy = POINTINDEX_KEY(s->pts, p, 1) - s->y;
+    double d = dx * dx + dy * dy;
+    Py_ssize_t i;
+
+    if (s->found < s->k) {
+        /* sift up */
+        i = s->found++;
+        while (i > 0 && s->dist[(i - 1) / 2] < d) {
+            s->dist[i] = s->dist[(i - 1) / 2];
+            s->idx[i] = s->idx[(i - 1) / 2];
+            i = (i - 1) / 2;
+        }
+        s->dist[i] = d;
+        s->idx[i] = p;
+    }
+    else if (d < s->dist[0]) {
+        _pointindex_heap_replace_top(s->dist, s->idx, s->found, d, p);
+    }
+}
+
+static void
+_pointindex_nearest(_pointindex_knn *s, Py_ssize_t lo, Py_ssize_t hi)
+{
+    Py_ssize_t i, mid, p;
+    double diff;
+
+    if (hi - lo <= POINTINDEX_LEAF_SIZE) {
+        for (i = lo; i < hi; ++i) {
+            _pointindex_knn_consider(s, s->order[i]);
+        }
+        return;
+    }
+    mid = lo + (hi - lo) / 2;
+    p = s->order[mid];
+    _pointindex_knn_consider(s, p);
+    diff = (s->axis[mid] ? s->y : s->x) -
+           POINTINDEX_KEY(s->pts, p, s->axis[mid]);
+    if (diff < 0) {
+        _pointindex_nearest(s, lo, mid);
+        if (s->found < s->k || diff * diff < s->dist[0])
+            _pointindex_nearest(s, mid + 1, hi);
+    }
+    else {
+        _pointindex_nearest(s, mid + 1, hi);
+        if (s->found < s->k || diff * diff < s->dist[0])
+            _pointindex_nearest(s, lo, mid);
+    }
+}
+
+/* Reads the points of a buffer of doubles or a sequence of vectors into a
+ * newly allocated array of x, y pairs.
+ * Returns 1 on success and 0 with an exception set otherwise.
+ */
+static int
+_pointindex_read_points(PyObject *obj, double **points, Py_ssize_t *count)
+{
+    Py_buffer view;
+    PyObject *fast;
+    Py_ssize_t i, n;
+    double *pts;
+    int is_buffer;
+
+    is_buffer = _math_get_double_buffer(obj, &view, 2, 0);
+    if (is_buffer < 0) {
+        return 0;
+    }
+    if (is_buffer) {
+        n = view.len / (2 * (Py_ssize_t)sizeof(double));
+        pts = PyMem_New(double, n * 2 + 2);
+        if (pts == NULL) {
+            PyBuffer_Release(&view);
+            PyErr_NoMemory();
+            return 0;
+        }
+        memcpy(pts, view.buf, n * 2 * sizeof(double));
+        PyBuffer_Release(&view);
+    }
+    else {
+        fast = PySequence_Fast(obj, "expected a sequence of vectors or a "
+                                    "buffer of doubles");
+        if (fast == NULL) {
+            return 0;
+        }
+        n = PySequence_Fast_GET_SIZE(fast);
+        pts = PyMem_New(double, n * 2 + 2);
+        if (pts == NULL) {
+            Py_DECREF(fast);
+            PyErr_NoMemory();
+            return 0;
+        }
+        for (i = 0; i < n; ++i) {
+            if (!_math_vector_arg(PySequence_Fast_GET_ITEM(fast, i),
+                                  pts + 2 * i, 2)) {
+                PyMem_Free(pts);
+                Py_DECREF(fast);
+                return 0;
+            }
+        }
+        Py_DECREF(fast);
+    }
+    *points = pts;
+    *count = n;
+    return 1;
+}
+
+/* Replaces the points of <self> by <obj>.
+ * Returns 0 on success and -1 with an exception set otherwise.
+ */
+static int
+_pointindex_set_points(pgPointIndex *self, PyObject *obj)
+{
+    double *pts;
+    Py_ssize_t *order;
+    unsigned char *axis;
+    Py_ssize_t i, count;
+
+    if (self->busy) {
+        PyErr_SetString(PyExc_RuntimeError,
+                        "PointIndex can not be changed during a query");
+        return -1;
+    }
+    if (!_pointindex_read_points(obj, &pts, &count)) {
+        return -1;
+    }
+    order = PyMem_New(Py_ssize_t, count + 1);
+    axis = PyMem_New(unsigned char, count + 1);
+    if (order == NULL || axis == NULL) {
+        PyMem_Free(order);
+        PyMem_Free(axis);
+        PyMem_Free(pts);
+        PyErr_NoMemory();
+        return -1;
+    }
+    for (i = 0; i < count; ++i) {
+        order[i] = i;
+    }
+    PyMem_Free(self->points);
+    PyMem_Free(self->order);
+    PyMem_Free(self->axis);
+    self->points = pts;
+    self->order = order;
+    self->axis = axis;
+    self->count = count;
+    self->dirty = 1;
+    return 0;
+}
+
+/* Rebuilds the tree if points changed since the last query. The previous
+ * tree order is kept, which makes rebuilding after small moves cheap.
+ */
+static int
+_pointindex_ensure_built(pgPointIndex *self)
+{
+    if (!self->dirty) {
+        return 0;
+    }
+    if (self->busy) {
+        PyErr_SetString(PyExc_RuntimeError,
+                        "PointIndex can not be changed during a query");
+        return -1;
+    }
+    _pointindex_build(self->points, self->order, self->axis, 0, self->count);
+    self->dirty = 0;
+    return 0;
+}
+
+/* Converts the first <len> indices of <items> to a list of ints. */
+static PyObject *
+_pointindex_index_list(const Py_ssize_t *items, Py_ssize_t len)
+{
+    PyObject *ret, *item;
+    Py_ssize_t i;
+
+    ret = PyList_New(len);
+    if (ret == NULL) {
+        return NULL;
+    }
+    for (i = 0; i < len; ++i) {
+        item = PyInt_FromSsize_t(items[i]);
+        if (item == NULL) {
+            Py_DECREF(ret);
+            return NULL;
+        }
+        PyList_SET_ITEM(ret, i, item);
+    }
+    return ret;
+}
+
+static PyObject *
+pointindex_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
+{
+    pgPointIndex *self = (pgPointIndex *)type->tp_alloc(type, 0);
+    if (self != NULL) {
+        self->points = NULL;
+        self->order = NULL;
+        self->axis = NULL;
+        self->count = 0;
+        self->dirty = 0;
+        self->busy = 0;
+    }
+    return (PyObject *)self;
+}
+
+static int
+pointindex_init(pgPointIndex *self, PyObject *args, PyObject *kwds)
+{
+    PyObject *points;
+    static char *kwlist[] = {"points", NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O:PointIndex", kwlist,
+                                     &points)) {
+        return -1;
+    }
+    return _pointindex_set_points(self, points);
+}
+
+static void
+pointindex_dealloc(pgPointIndex *self)
+{
+    PyMem_Free(self->points);
+    PyMem_Free(self->order);
+    PyMem_Free(self->axis);
+    Py_TYPE(self)->tp_free((PyObject *)self);
+}
+
+static PyObject *
+pointindex_update(pgPointIndex *self, PyObject *points)
+{
+    if (_pointindex_set_points(self, points) != 0) {
+        return NULL;
+    }
+    Py_RETURN_NONE;
+}
+
+static PyObject *
+pointindex_nearest(pgPointIndex *self, PyObject *args, PyObject *kwds)
+{
+    PyObject *point, *ret;
+    Py_ssize_t k = 1, i, tmp_idx;
+    double coords[2], tmp_dist;
+    _pointindex_knn s;
+    static char *kwlist[] = {"point", "k", NULL};
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|n:nearest", kwlist,
+                                     &point, &k)) {
+        return NULL;
+    }
+    if (k < 1) {
+        return RAISE(PyExc_ValueError, "k must be at least 1");
+    }
+    if (!_math_vector_arg(point, coords, 2) ||
+        _pointindex_ensure_built(self) != 0) {
+        return NULL;
+    }
+    if (k > self->count) {
+        k = self->count;
+    }
+    s.pts = self->points;
+    s.order = self->order;
+    s.axis = self->axis;
+    s.x = coords[0];
+    s.y = coords[1];
+    s.k = k;
+    s.found = 0;
+    s.dist = PyMem_New(double, k + 1);
+    s.idx = PyMem_New(Py_ssize_t, k + 1);
+    if (s.dist == NULL || s.idx == NULL) {
+        PyMem_Free(s.dist);
+        PyMem_Free(s.idx);
+        return PyErr_NoMemory();
+    }
+    _pointindex_nearest(&s, 0, self->count);
+
+    /* heap sort, nearest first */
+    for (i = s.found - 1; i > 0; --i) {
+        tmp_dist = s.dist[0];
+        tmp_idx = s.idx[0];
+        _pointindex_heap_replace_top(s.dist, s.idx, i, s.dist[i], s.idx[i]);
+        s.dist[i] = tmp_dist;
+        s.idx[i] = tmp_idx;
+    }
+    ret = _pointindex_index_list(s.idx, k);
+    PyMem_Free(s.dist);
+    PyMem_Free(s.idx);
+    return ret;
+}
+
+static PyObject *
+pointindex_within(pgPointIndex *self, PyObject *args)
+{
+    PyObject *point, *ret;
+    double coords[2], radius;
+    _pointindex_result res = {NULL, 0, 0};
+    int rc;
+
+    if (!PyArg_ParseTuple(args, "Od:within", &point, &radius)) {
+        return NULL;
+    }
+    if (radius < 0) {
+        return RAISE(PyExc_ValueError, "radius must not be negative");
+    }
+    if (!_math_vector_arg(point, coords, 2) ||
+        _pointindex_ensure_built(self) != 0) {
+        return NULL;
+    }
+    ++self->busy;
+    Py_BEGIN_ALLOW_THREADS;
+    rc = _pointindex_within(self->points, self->order, self->axis, 0,
+                            self->count, coords[0], coords[1], radius, -1,
+                            &res);
+    if (rc == 0 && res.len > 1) {
+        qsort(res.items, res.len, sizeof(Py_ssize_t),
+              _pointindex_compare_index);
+    }
+    Py_END_ALLOW_THREADS;
+    --self->busy;
+    if (rc != 0) {
+        free(res.items);
+        return PyErr_NoMemory();
+    }
+    ret = _pointindex_index_list(res.items, res.len);
+    free(res.items);
+    return ret;
+}
+
+static PyObject *
+pointindex_pairs_within(pgPointIndex *self, PyObject *args)
+{
+    PyObject *ret, *pair;
+    double radius;
+    _pointindex_result found = {NULL, 0, 0};
+    _pointindex_result pairs = {NULL, 0, 0};
+    Py_ssize_t i, j;
+    int rc = 0;
+
+    if (!PyArg_ParseTuple(args, "d:pairs_within", &radius)) {
+        return NULL;
+    }
+    if (radius < 0) {
+        return RAISE(PyExc_ValueError, "radius must not be negative");
+    }
+    if (_pointindex_ensure_built(self) != 0) {
+        return NULL;
+    }
+    ++self->busy;
+    Py_BEGIN_ALLOW_THREADS;
+    for (i = 0; i < self->count && rc == 0; ++i) {
+        found.len = 0;
+        rc = _pointindex_within(self->points, self->order, self->axis, 0,
+                                self->count, self->points[2 * i],
+                                self->points[2 * i + 1], radius, i, &found);
+        if (found.len > 1) {
+            qsort(found.items, found.len, sizeof(Py_ssize_t),
+                  _pointindex_compare_index);
+        }
+        for (j = 0; j < found.len && rc == 0; ++j) {
+            rc = _pointindex_result_append(&pairs, i) ||
+                 _pointindex_result_append(&pairs, found.items[j]);
+        }
+    }
+    Py_END_ALLOW_THREADS;
+    --self->busy;
+    free(found.items);
+    if (rc != 0) {
+        free(pairs.items);
+        return PyErr_NoMemory();
+    }
+
+    ret = PyList_New(pairs.len / 2);
+    if (ret == NULL) {
+        free(pairs.items);
+        return NULL;
+    }
+    for (i = 0; i < pairs.len / 2; ++i) {
+        pair = Py_BuildValue("(nn)", pairs.items[2 * i],
+                             pairs.items[2 * i + 1]);
+        if (pair == NULL) {
+            Py_DECREF(ret);
+            free(pairs.items);
+            return NULL;
+        }
+        PyList_SET_ITEM(ret, i, pair);
+    }
+    free(pairs.items);
+    return ret;
+}
+
+static Py_ssize_t
+pointindex_len(pgPointIndex *self)
+{
+    return self->count;
+}
+
+static PyObject *
+pointindex_GetItem(pgPointIndex *self, Py_ssize_t index)
+{
+    pgVector *vec;
+
+    if (index < 0 || index >= self->count) {
+        return RAISE(PyExc_IndexError, "subscript out of range.");
+    }
+    vec = (pgVector *)pgVector_NEW(2);
+    if (vec != NULL) {
+        vec->coords[0] = self->points[2 * index];
+        vec->coords[1] = self->points[2 * index + 1];
+    }
+    return (PyObject *)vec;
+}
+
+static int
+pointindex_SetItem(pgPointIndex *self, Py_ssize_t index, PyObject *value)
+{
+    double coords[2];
+
+    if (index < 0 || index >= self->count) {
+        PyErr_SetString(PyExc_IndexError, "subscript out of range.");
+        return -1;
+    }
+    if (value == NULL) {
+        PyErr_SetString(PyExc_TypeError, "item deletion is not supported");
+        return -1;
+    }
+    if (self->busy) {
+        PyErr_SetString(PyExc_RuntimeError,
+                        "PointIndex can not be changed during a query");
+        return -1;
+    }
+    if (!_math_vector_arg(value, coords, 2)) {
+        return -1;
+    }
+    self->points[2 * index] = coords[0];
+    self->points[2 * index + 1] = coords[1];
+    self->dirty = 1;
+    return 0;
+}
+
+static PyObject *
+pointindex_repr(pgPointIndex *self)
+{
+    char buffer[STRING_BUF_SIZE];
+
+    PyOS_snprintf(buffer, STRING_BUF_SIZE, "<PointIndex(%ld points)>",
+                  (long)self->count);
+    return Text_FromUTF8(buffer);
+}
+
+static PySequenceMethods pointindex_as_sequence = {
+    (lenfunc)pointindex_len,             /* sq_length;    __len__ */
+    (binaryfunc)0,                       /* sq_concat;    __add__ */
+    (ssizeargfunc)0,                     /* sq_repeat;    __mul__ */
+    (ssizeargfunc)pointindex_GetItem,    /* sq_item;      __getitem__ */
+    (ssizessizeargfunc)0,                /* sq_slice;     __getslice__ */
+    (ssizeobjargproc)pointindex_SetItem, /* sq_ass_item;  __setitem__ */
+    (ssizessizeobjargproc)0,             /* sq_ass_slice; __setslice__ */
+};
+
+static PyMethodDef pointindex_methods[] = {
+    {"update", (PyCFunction)pointindex_update, METH_O,
+     DOC_POINTINDEXUPDATE
+    },
+    {"nearest", (PyCFunction)pointindex_nearest,
+     METH_VARARGS | METH_KEYWORDS, DOC_POINTINDEXNEAREST
+    },
+    {"within", (PyCFunction)pointindex_within, METH_VARARGS,
+     DOC_POINTINDEXWITHIN
+    },
+    {"pairs_within", (PyCFunction)pointindex_pairs_within, METH_VARARGS,
+     DOC_POINTINDEXPAIRSWITHIN
+    },
+
+    {NULL}  /* Sentinel */
+};
+
+
+/********************************
+ * pgPointIndex type definition
+ ********************************/
+
+static PyTypeObject pgPointIndex_Type = {
+    TYPE_HEAD(NULL, 0)
+    "pygame.math.PointIndex",  /* tp_name */
+    sizeof(pgPointIndex),      /* tp_basicsize */
+    0,                         /* tp_itemsize */
+    /* Methods to implement standard operations */
+    (destructor)pointindex_dealloc, /* tp_dealloc */
+    0,                         /* tp_print */
+    0,                         /* tp_getattr */
+    0,                         /* tp_setattr */
+    0,                         /* tp_compare */
+    (reprfunc)pointindex_repr, /* tp_repr */
+    /* Method suites for standard classes */
+    0,                         /* tp_as_number */
+    &pointindex_as_sequence,   /* tp_as_sequence */
+    0,                         /* tp_as_mapping */
+    /* More standard operations (here for binary compatibility) */
+    0,                         /* tp_hash */
+    0,                         /* tp_call */
+    (reprfunc)pointindex_repr, /* tp_str */
+    0,                         /* tp_getattro */
+    0,                         /* tp_setattro */
+    /* Functions to access object as input/output buffer */
+    0,                         /* tp_as_buffer */
+    /* Flags to define presence of optional/expanded features */
+    Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE, /* tp_flags */
+    /* Documentation string */
+    DOC_PYGAMEMATHPOINTINDEX,  /* tp_doc */
+
+    /* Assigned meaning in release 2.0 */
+    /* call function for all accessible objects */
+    0,                         /* tp_traverse */
+    /* delete references to contained objects */
+    0,                         /* tp_clear */
+
+    /* Assigned meaning in release 2.1 */
+    /* rich comparisons */
+    0,                         /* tp_richcompare */
+    /* weak reference enabler */
+    0,                         /* tp_weaklistoffset */
+
+    /* Added in release 2.2 */
+    /* Iterators */
+    0,                         /* tp_iter */
+    0,                         /* tp_iternext */
+    /* Attribute descriptor and subclassing stuff */
+    pointindex_methods,        /* tp_methods */
+    0,                         /* tp_members */
+    0,                         /* tp_getset */
+    0,                         /* tp_base */
+    0,                         /* tp_dict */
+    0,                         /* tp_descr_get */
+    0,                         /* tp_descr_set */
+    0,                         /* tp_dictoffset */
+    (initproc)pointindex_init, /* tp_init */
+    0,                         /* tp_alloc */
+    (newfunc)pointindex_new,   /* tp_new */
+    0,                         /* tp_free */
+    0,                         /* tp_is_gc */
+    0,                         /* tp_bases */
+    0,                         /* tp_mro */
+    0,                         /* tp_cache */
+    0,                         /* tp_subclasses */
+    0,                         /* tp_weaklist */
+};
+
+
+
+
+
+
 static PyObject *
 math_enable_swizzling(pgVector *self)
 {
@@ -3714,7 +6151,10 @@ MODINIT_DEFINE (math)
     if ((PyType_Ready(&pgVector2_Type) < 0) ||
         (PyType_Ready(&pgVector3_Type) < 0) ||
         (PyType_Ready(&pgVectorIter_Type) < 0) ||
-        (PyType_Ready(&pgVectorElementwiseProxy_Type) < 0) /*||
+        (PyType_Ready(&pgVectorElementwiseProxy_Type) < 0) ||
+        (PyType_Ready(&pgAffine2_Type) < 0) ||
+        (PyType_Ready(&pgMatrix44_Type) < 0) ||
+        (PyType_Ready(&pgPointIndex_Type) < 0) /*||
         (PyType_Ready(&pgVector4_Type) < 0)*/) {
         MODINIT_ERROR;
     }
@@ -3735,18 +6175,27 @@ MODINIT_DEFINE (math)
     Py_INCREF(&pgVector3_Type);
     Py_INCREF(&pgVectorIter_Type);
     Py_INCREF(&pgVectorElementwiseProxy_Type);
+    Py_INCREF(&pgAffine2_Type);
+    Py_INCREF(&pgMatrix44_Type);
+    Py_INCREF(&pgPointIndex_Type);
     /*
     Py_INCREF(&pgVector4_Type);
     */
     if ((PyModule_AddObject(module, "Vector2", (PyObject *)&pgVector2_Type) != 0) ||
         (PyModule_AddObject(module, "Vector3", (PyObject *)&pgVector3_Type) != 0) ||
         (PyModule_AddObject(module, "VectorElementwiseProxy", (PyObject *)&pgVectorElementwiseProxy_Type) != 0) ||
-        (PyModule_AddObject(module, "VectorIterator", (PyObject *)&pgVectorIter_Type) != 0) /*||
+        (PyModule_AddObject(module, "VectorIterator", (PyObject *)&pgVectorIter_Type) != 0) ||
+        (PyModule_AddObject(module, "Affine2", (PyObject *)&pgAffine2_Type) != 0) ||
+        (PyModule_AddObject(module, "Matrix44", (PyObject *)&pgMatrix44_Type) != 0) ||
+        (PyModule_AddObject(module, "PointIndex", (PyObject *)&pgPointIndex_Type) != 0) /*||
         (PyModule_AddObject(module, "Vector4", (PyObject *)&pgVector4_Type) != 0)*/) {
         Py_DECREF(&pgVector2_Type);
         Py_DECREF(&pgVector3_Type);
         Py_DECREF(&pgVectorElementwiseProxy_Type);
         Py_DECREF(&pgVectorIter_Type);
+        Py_DECREF(&pgAffine2_Type);
+        Py_DECREF(&pgMatrix44_Type);
+        Py_DECREF(&pgPointIndex_Type);
         /*
         Py_DECREF(&pgVector4_Type);
         */
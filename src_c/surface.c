@@ -366,6 +366,7 @@ surface_new (PyTypeObject *type, PyObject *args, PyObject *kwds)
         self->weakreflist = NULL;
         self->dependency = NULL;
         self->locklist = NULL;
+        self->subsurfaces = 0;
     }
     return (PyObject *) self;
 }
@@ -391,6 +392,8 @@ surface_cleanup (pgSurfaceObject *self)
     }
 #endif /* IS_SDLv2 */
     if (self->subsurface) {
+        if (self->subsurface->owner)
+            ((pgSurfaceObject *) self->subsurface->owner)->subsurfaces--;
         Py_XDECREF (self->subsurface->owner);
         PyMem_Del (self->subsurface);
         self->subsurface = NULL;
@@ -2614,6 +2617,7 @@ surf_subsurface (PyObject *self, PyObject *args)
     }
     Py_INCREF (self);
     data->owner = self;
+    ((pgSurfaceObject *) self)->subsurfaces++;
     data->pixeloffset = pixeloffset;
     data->offsetx = rect->x;
     data->offsety = rect->y;
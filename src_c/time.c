@@ -24,7 +24,17 @@
 #include "pgcompat.h"
 #include "doc/time_doc.h"
 
+#if IS_SDLv1
+#ifdef MS_WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+#endif /* IS_SDLv1 */
+
 #define WORST_CLOCK_ACCURACY 12
+#define NS_PER_SEC ((Uint64)1000000000)
+#define NS_PER_MS ((Uint64)1000000)
 
 #if IS_SDLv2
 #define pgNUMEVENTS (16 + (SDL_NUMEVENTS - SDL_USEREVENT))
@@ -32,7 +42,41 @@
 #define pgNUMEVENTS SDL_NUMEVENTS
 #endif /* IS_SDLv1 */
 
-static SDL_TimerID event_timers[pgNUMEVENTS] = {NULL};
+/*the timers of set_timer() and add_timer() are kept in a hierarchical
+ *timer wheel that the event module runs each time it pumps events. The
+ *wheel counts in milliseconds of SDL_GetTicks(). Level 0 has a slot for
+ *each of the next 64 ms, each higher level a slot for 64 slots of the
+ *level below; when a level wraps around, the next slot of the level
+ *above is spread over the levels below it. Adding and cancelling a timer
+ *only links it in or out of a slot list.
+ */
+#define WHEEL_BITS 6
+#define WHEEL_SLOTS (1 << WHEEL_BITS)
+#define WHEEL_MASK (WHEEL_SLOTS - 1)
+#define WHEEL_LEVELS 4
+#define WHEEL_SPAN ((Uint32)1 << (WHEEL_BITS * WHEEL_LEVELS))
+
+typedef struct pgTimerObject
+{
+    PyObject_HEAD
+    struct pgTimerObject* next;
+    struct pgTimerObject** pprev; /* link to this one, NULL when idle */
+    Uint32 expires;             /* tick it fires at */
+    Uint32 interval;
+    int loops;                  /* firings left, 0 repeats forever */
+    int type;
+    PyObject* event;            /* Event with the attributes or NULL */
+    size_t index;               /* slot in event_timers or 0 */
+} pgTimerObject;
+
+static PyTypeObject pgTimer_Type;
+
+static pgTimerObject* wheel[WHEEL_LEVELS][WHEEL_SLOTS];
+static Uint32 wheel_now;        /* next tick to run */
+static int wheel_count = 0;     /* scheduled timers */
+
+/*the timer of each event id for set_timer()*/
+static pgTimerObject* event_timers[pgNUMEVENTS] = {NULL};
 
 #if IS_SDLv2
 static size_t
@@ -78,17 +122,218 @@ enumerate_event (Uint32 type)
 }
 #endif /* IS_SDLv2 */
 
+/*links a timer into its slot, the wheel holds a reference*/
+static void
+wheel_insert (pgTimerObject* timer)
+{
+    Uint32 delta = timer->expires - wheel_now;
+    Uint32 at = timer->expires;
+    pgTimerObject** slot;
+    int level;
+
+    if ((Sint32)delta < 0)
+    {
+        /*behind, runs with the next tick*/
+        delta = 0;
+        at = wheel_now;
+    }
+    else if (delta >= WHEEL_SPAN)
+    {
+        /*too far away, comes back down to the highest level until near*/
+        delta = WHEEL_SPAN - 1;
+        at = wheel_now + delta;
+    }
+    for (level = 0; delta >> (WHEEL_BITS * (level + 1)); ++level)
+        ;
+    slot = &wheel[level][(at >> (WHEEL_BITS * level)) & WHEEL_MASK];
+
+    timer->next = *slot;
+    if (timer->next)
+        timer->next->pprev = &timer->next;
+    timer->pprev = slot;
+    *slot = timer;
+    wheel_count++;
+    Py_INCREF (timer);
+}
+
+/*unlinks a timer, dropping the reference of the wheel*/
+static void
+wheel_remove (pgTimerObject* timer)
+{
+    if (!timer->pprev)
+        return;
+    *timer->pprev = timer->next;
+    if (timer->next)
+        timer->next->pprev = timer->pprev;
+    timer->next = NULL;
+    timer->pprev = NULL;
+    wheel_count--;
+    Py_DECREF (timer);
+}
+
+static void wheel_cleanup (void);
+static int wheel_registered = 0;  /* pygame.quit() clears the quit list */
+
+static void
+wheel_start (pgTimerObject* timer, Uint32 delay)
+{
+    if (!wheel_registered)
+    {
+        pg_RegisterQuit (wheel_cleanup);
+        wheel_registered = 1;
+    }
+    if (!wheel_count)
+        wheel_now = SDL_GetTicks ();
+    timer->expires = SDL_GetTicks () + delay;
+    wheel_insert (timer);
+}
+
+/*spreads the timers of a slot over the levels below it*/
+static void
+wheel_cascade (int level)
+{
+    pgTimerObject** slot =
+        &wheel[level][(wheel_now >> (WHEEL_BITS * level)) & WHEEL_MASK];
+    pgTimerObject* timer;
+
+    while ((timer = *slot))
+    {
+        /*keep it alive between the unlink and the insert*/
+        Py_INCREF (timer);
+        wheel_remove (timer);
+        wheel_insert (timer);
+        Py_DECREF (timer);
+    }
+}
+
+/*posts the event of a timer*/
+static void
+timer_fire (pgTimerObject* timer)
+{
+    SDL_Event event;
+    PyObject* dropped;
+
+    memset (&event, 0, sizeof (event));
+    if (!timer->event)
+        event.type = timer->type;
+    else if (pgEvent_FillUserEvent ((pgEventObject*) timer->event, &event))
+    {
+        /*nothing to report the error to, the event is lost*/
+        PyErr_Clear ();
+        return;
+    }
+    if (SDL_EventState (event.type, SDL_QUERY) == SDL_IGNORE ||
+#if IS_SDLv1
+        SDL_PushEvent (&event) == -1)
+#else /* IS_SDLv2 */
+        SDL_PushEvent (&event) <= 0)
+#endif /* IS_SDLv2 */
+    {
+        if (timer->event)
+        {
+            /*takes the attributes back out of the event module*/
+            dropped = pgEvent_New (&event);
+            Py_XDECREF (dropped);
+            PyErr_Clear ();
+        }
+    }
+}
+
+/*the timer pump given to the event module*/
 static Uint32
-timer_callback (Uint32 interval, void* param)
+wheel_run (void)
 {
-    if (SDL_WasInit (SDL_INIT_VIDEO))
+    Uint32 now, i;
+    pgTimerObject** slot;
+    pgTimerObject* timer;
+    int level;
+
+    if (!wheel_count)
+        return PG_TIMER_IDLE;
+
+    now = SDL_GetTicks ();
+    while ((Sint32)(now - wheel_now) >= 0)
+    {
+        for (level = 1; level < WHEEL_LEVELS; ++level)
+        {
+            if ((wheel_now >> (WHEEL_BITS * (level - 1))) & WHEEL_MASK)
+                break;
+            wheel_cascade (level);
+        }
+
+        slot = &wheel[0][wheel_now & WHEEL_MASK];
+        while ((timer = *slot))
+        {
+            Py_INCREF (timer);
+            wheel_remove (timer);
+            if ((Sint32)(timer->expires - wheel_now) > 0)
+            {
+                /*came down from a far slot, not due yet*/
+                wheel_insert (timer);
+                Py_DECREF (timer);
+                continue;
+            }
+            timer_fire (timer);
+            /*set_timer() may have replaced it meanwhile*/
+            if ((!timer->loops || --timer->loops) &&
+                (!timer->index || event_timers[timer->index] == timer))
+            {
+                timer->expires += timer->interval;
+                wheel_insert (timer);
+            }
+            Py_DECREF (timer);
+        }
+        wheel_now++;
+        if (!wheel_count)
+            return PG_TIMER_IDLE;
+    }
+
+    /*the next due slot of level 0, or the time until it wraps*/
+    for (i = 0; i < WHEEL_SLOTS; ++i)
     {
-        SDL_Event event;
-        memset (&event, 0, sizeof (event));
-        event.type = (intptr_t) param;
-        SDL_PushEvent (&event);
+        if (wheel[0][(wheel_now + i) & WHEEL_MASK])
+            break;
+        if (((wheel_now + i) & WHEEL_MASK) == WHEEL_MASK)
+        {
+            i++;
+            break;
+        }
     }
-    return interval;
+    return wheel_now + i - now;
+}
+
+/*drops every timer, when pygame quits*/
+static void
+wheel_cleanup (void)
+{
+    pgTimerObject* timer;
+    int level, i;
+
+    for (level = 0; level < WHEEL_LEVELS; ++level)
+        for (i = 0; i < WHEEL_SLOTS; ++i)
+            while ((timer = wheel[level][i]))
+                wheel_remove (timer);
+    memset (event_timers, 0, sizeof (event_timers));
+    wheel_registered = 0;
+}
+
+static pgTimerObject*
+timer_new (int type, PyObject* event, Uint32 interval, int loops)
+{
+    pgTimerObject* timer = PyObject_NEW (pgTimerObject, &pgTimer_Type);
+
+    if (!timer)
+        return NULL;
+    timer->next = NULL;
+    timer->pprev = NULL;
+    timer->expires = 0;
+    timer->interval = interval;
+    timer->loops = loops;
+    timer->type = type;
+    Py_XINCREF (event);
+    timer->event = event;
+    timer->index = 0;
+    return timer;
 }
 
 static int
@@ -127,6 +372,81 @@ accurate_delay (int ticks)
     return SDL_GetTicks () - funcstart;
 }
 
+/*a monotonic time in nanoseconds from the performance counter. SDL 1.2
+ *has none, there the one of the platform is used.
+ */
+static Uint64
+ticks_ns (void)
+{
+#if IS_SDLv2
+    static Uint64 freq = 0;
+    Uint64 count = SDL_GetPerformanceCounter ();
+
+    if (!freq)
+        freq = SDL_GetPerformanceFrequency ();
+    return (count / freq) * NS_PER_SEC + (count % freq) * NS_PER_SEC / freq;
+#elif defined(MS_WIN32)
+    LARGE_INTEGER freq, count;
+    Uint64 f, c;
+
+    QueryPerformanceFrequency (&freq);
+    QueryPerformanceCounter (&count);
+    f = (Uint64)freq.QuadPart;
+    c = (Uint64)count.QuadPart;
+    return (c / f) * NS_PER_SEC + (c % f) * NS_PER_SEC / f;
+#else
+    struct timespec ts;
+
+    clock_gettime (CLOCK_MONOTONIC, &ts);
+    return (Uint64)ts.tv_sec * NS_PER_SEC + (Uint64)ts.tv_nsec;
+#endif
+}
+
+/*the sleep-then-spin wait of the precise clocks. SDL_Delay wakes up late
+ *by an amount that depends on the system, so it only sleeps until that
+ *much before the target and the rest is spun on the performance counter.
+ *How late each sleep was is measured, the slack follows an increase at
+ *once and a decrease slowly.
+ */
+static Uint64 sleep_slack_ns = 2 * NS_PER_MS;
+
+/*waits until <target>, called without the GIL. Returns the time it woke
+ *up and sets <late> to how late the sleep was, 0 if it did not sleep.
+ */
+static Uint64
+wait_until_ns (Uint64 target, Uint64 slack, Uint64* late)
+{
+    Uint64 now = ticks_ns ();
+    Uint64 start, asked;
+
+    *late = 0;
+    if (target > now + slack + NS_PER_MS)
+    {
+        asked = (target - now - slack) / NS_PER_MS;
+        start = now;
+        SDL_Delay ((Uint32)asked);
+        now = ticks_ns ();
+        if (now - start > asked * NS_PER_MS)
+            *late = now - start - asked * NS_PER_MS;
+    }
+    while (now < target)
+        now = ticks_ns ();
+    return now;
+}
+
+static void
+calibrate_sleep (Uint64 late)
+{
+    if (!late)
+        return;
+    if (late > sleep_slack_ns)
+        sleep_slack_ns = late;
+    else
+        sleep_slack_ns -= (sleep_slack_ns - late) / 8;
+    if (sleep_slack_ns > WORST_CLOCK_ACCURACY * NS_PER_MS)
+        sleep_slack_ns = WORST_CLOCK_ACCURACY * NS_PER_MS;
+}
+
 static PyObject*
 time_get_ticks (PyObject* self)
 {
@@ -135,6 +455,27 @@ time_get_ticks (PyObject* self)
     return PyInt_FromLong (SDL_GetTicks ());
 }
 
+static PyObject*
+time_get_ticks_ns (PyObject* self)
+{
+    static Uint64 base = 0;
+    static Uint32 last_ticks = 0;
+    Uint64 now;
+    Uint32 ticks;
+
+    if (!SDL_WasInit (SDL_INIT_TIMER))
+        return PyLong_FromUnsignedLongLong (0);
+
+    /*counted from the same start as get_ticks(), which starts over when
+      the timer is initialized again*/
+    now = ticks_ns ();
+    ticks = SDL_GetTicks ();
+    if (!base || ticks < last_ticks)
+        base = now - (Uint64)ticks * NS_PER_MS;
+    last_ticks = ticks;
+    return PyLong_FromUnsignedLongLong ((unsigned PY_LONG_LONG)(now - base));
+}
+
 static PyObject*
 time_delay (PyObject* self, PyObject* arg)
 {
@@ -193,26 +534,32 @@ time_wait (PyObject* self, PyObject* arg)
     return PyInt_FromLong (SDL_GetTicks () - start);
 }
 
-#if IS_SDLv2
 static PyObject*
 time_set_timer (PyObject* self, PyObject* arg)
 {
-    SDL_TimerID newtimer;
+    pgTimerObject* timer;
     int ticks = 0;
-    SDL_EventType event;
+    int event;
     size_t index;
     if (!PyArg_ParseTuple (arg, "ii", &event, &ticks))
         return NULL;
 
+#if IS_SDLv1
+    if (event <= SDL_NOEVENT || event >= SDL_NUMEVENTS)
+        return RAISE (PyExc_ValueError,
+                      "Event id must be between NOEVENT(0) and NUMEVENTS(32)");
+    index = event;
+#else /* IS_SDLv2 */
     index = enumerate_event (event);
     if (index == 0)
         return RAISE (PyExc_ValueError, "Unrecognized event type");
+#endif /* IS_SDLv2 */
 
     /*stop original timer*/
     if (event_timers[index])
     {
-        SDL_RemoveTimer (event_timers[event]);
-        event_timers[event] = 0;
+        wheel_remove (event_timers[index]);
+        event_timers[index] = NULL;
     }
 
     if (ticks <= 0)
@@ -225,52 +572,78 @@ time_set_timer (PyObject* self, PyObject* arg)
             return RAISE (pgExc_SDLError, SDL_GetError ());
     }
 
-    newtimer = SDL_AddTimer (ticks, timer_callback, (void*) event);
-    if (!newtimer)
-        return RAISE (pgExc_SDLError, SDL_GetError ());
-    event_timers[index] = newtimer;
+    timer = timer_new (event, NULL, (Uint32)ticks, 0);
+    if (!timer)
+        return NULL;
+    timer->index = index;
+    wheel_start (timer, (Uint32)ticks);
+    event_timers[index] = timer;
+    Py_DECREF (timer);
 
     Py_RETURN_NONE;
 }
-#else /* IS_SDLv1 */
+
 static PyObject*
-time_set_timer (PyObject* self, PyObject* arg)
+time_add_timer (PyObject* self, PyObject* args, PyObject* kwds)
 {
-    SDL_TimerID newtimer;
-    int ticks = 0;
-    intptr_t event = SDL_NOEVENT;
-    if (!PyArg_ParseTuple (arg, "ii", &event, &ticks))
+    pgTimerObject* timer;
+    PyObject* obj;
+    PyObject* event = NULL;
+    int ticks, loops = 0, type;
+    static char* kwids[] = {"event", "millis", "loops", NULL};
+
+    if (!PyArg_ParseTupleAndKeywords (args, kwds, "Oi|i", kwids,
+                                      &obj, &ticks, &loops))
         return NULL;
 
-    if (event <= SDL_NOEVENT || event >= SDL_NUMEVENTS)
-        return RAISE (PyExc_ValueError,
-                      "Event id must be between NOEVENT(0) and NUMEVENTS(32)");
-
-    /*stop original timer*/
-    if (event_timers[event])
+    if (pgEvent_Check (obj))
     {
-        SDL_RemoveTimer (event_timers[event]);
-        event_timers[event] = NULL;
+        event = obj;
+        type = ((pgEventObject*) obj)->type;
     }
-
+    else if (PyInt_Check (obj))
+        type = (int) PyInt_AsLong (obj);
+    else
+        return RAISE (PyExc_TypeError,
+                      "event must be an event type or an Event");
     if (ticks <= 0)
-        Py_RETURN_NONE;
+        return RAISE (PyExc_ValueError, "millis must be positive");
+    if (loops < 0)
+        return RAISE (PyExc_ValueError, "loops must not be negative");
 
-    /*just doublecheck that timer is initialized*/
     if (!SDL_WasInit (SDL_INIT_TIMER))
     {
         if (SDL_InitSubSystem (SDL_INIT_TIMER))
             return RAISE (pgExc_SDLError, SDL_GetError ());
     }
 
-    newtimer = SDL_AddTimer (ticks, timer_callback, (void*) event);
-    if (!newtimer)
-        return RAISE (pgExc_SDLError, SDL_GetError ());
-    event_timers[event] = newtimer;
-
-    Py_RETURN_NONE;
+    timer = timer_new (type, event, (Uint32)ticks, loops);
+    if (!timer)
+        return NULL;
+    wheel_start (timer, (Uint32)ticks);
+    return (PyObject*) timer;
 }
-#endif /* IS_SDLv1 */
+
+/*frame statistics. Every tick stores the frame time in a ring of the
+ *last STATS_FRAMES frames, get_stats() sorts a copy of it. The ring is
+ *only written by tick with the GIL held, so it needs no lock.
+ */
+#define STATS_FRAMES 1024
+#define HISTOGRAM_BUCKETS 32
+#define HISTOGRAM_WIDTH_US 2000
+#define MISSED_MARGIN_US 1000
+
+typedef struct
+{
+    Uint32 frame_us;            /* time of the frame */
+    Uint32 target_us;           /* frame time asked for, 0 for none */
+} ClockFrame;
+
+typedef struct
+{
+    ClockFrame frames[STATS_FRAMES];
+    Uint32 count;               /* frames stored, the ring wraps */
+} ClockStats;
 
 /*clock object interface*/
 typedef struct
@@ -281,8 +654,240 @@ typedef struct
     float fps;
     int timepassed, rawpassed;
     PyObject* rendered;
+    int precise;
+    Uint64 last_ns, fps_ns;     /* the precise clock counts in ns */
+    Uint64 timepassed_ns, rawpassed_ns;
+    int ticked;
+    ClockStats stats;
+    PyObject* sections;         /* dict of name: ClockSection or NULL */
 } PyClockObject;
 
+/*a named timer inside the frames of a clock*/
+typedef struct
+{
+    PyObject_HEAD
+    PyObject* name;
+    int depth;                  /* nesting of with blocks */
+    int entered;                /* was entered in this frame */
+    Uint64 start_ns, frame_ns;
+    ClockStats stats;
+} PyClockSectionObject;
+
+static void
+stats_add (ClockStats* stats, Uint64 frame_ns, Uint32 target_us)
+{
+    ClockFrame* frame = &stats->frames[stats->count % STATS_FRAMES];
+    Uint64 us = frame_ns / 1000;
+
+    frame->frame_us = us > 0xFFFFFFFF ? 0xFFFFFFFF : (Uint32)us;
+    frame->target_us = target_us;
+    stats->count++;
+    /*keep the count from wrapping, the ring index stays the same*/
+    if (stats->count >= 2 * STATS_FRAMES)
+        stats->count -= STATS_FRAMES;
+}
+
+static int
+compare_uint32 (const void* a, const void* b)
+{
+    Uint32 x = *(const Uint32*)a, y = *(const Uint32*)b;
+    return x < y ? -1 : x > y;
+}
+
+static int
+stats_set_ms (PyObject* dict, const char* key, double us)
+{
+    PyObject* value = PyFloat_FromDouble (us / 1000.0);
+    int result;
+
+    if (!value)
+        return -1;
+    result = PyDict_SetItemString (dict, key, value);
+    Py_DECREF (value);
+    return result;
+}
+
+static int
+stats_set_int (PyObject* dict, const char* key, long count)
+{
+    PyObject* value = PyInt_FromLong (count);
+    int result;
+
+    if (!value)
+        return -1;
+    result = PyDict_SetItemString (dict, key, value);
+    Py_DECREF (value);
+    return result;
+}
+
+/*the statistics dict of a ring, times are in milliseconds*/
+static PyObject*
+stats_to_dict (ClockStats* stats)
+{
+    static const int percentiles[] = {50, 95, 99};
+    static const char* names[] = {"p50", "p95", "p99"};
+    Uint32 n, first, i;
+    Uint32* sorted = NULL;
+    long buckets[HISTOGRAM_BUCKETS];
+    long missed = 0;
+    double jitter = 0.0;
+    PyObject* dict = NULL;
+    PyObject* histogram;
+    PyObject* value;
+
+    n = stats->count < STATS_FRAMES ? stats->count : STATS_FRAMES;
+    first = stats->count < STATS_FRAMES ? 0 : stats->count % STATS_FRAMES;
+    memset (buckets, 0, sizeof (buckets));
+
+    if (n)
+    {
+        /*PyMem_New checks a signed count, n is unsigned and small*/
+        sorted = (Uint32*)PyMem_Malloc (n * sizeof (Uint32));
+        if (!sorted)
+            return PyErr_NoMemory ();
+    }
+    for (i = 0; i < n; ++i)
+    {
+        ClockFrame* frame = &stats->frames[(first + i) % STATS_FRAMES];
+        Uint32 bucket = frame->frame_us / HISTOGRAM_WIDTH_US;
+
+        sorted[i] = frame->frame_us;
+        if (frame->target_us &&
+            frame->frame_us > frame->target_us + MISSED_MARGIN_US)
+            missed++;
+        buckets[bucket < HISTOGRAM_BUCKETS ?
+                bucket : HISTOGRAM_BUCKETS - 1]++;
+        if (i)
+        {
+            Uint32 last = sorted[i - 1];
+            jitter += last > frame->frame_us ?
+                last - frame->frame_us : frame->frame_us - last;
+        }
+    }
+    if (n > 1)
+        jitter /= n - 1;
+    if (n)
+        qsort (sorted, n, sizeof (Uint32), compare_uint32);
+
+    dict = PyDict_New ();
+    if (!dict)
+        goto fail;
+    if (stats_set_int (dict, "frames", (long)n))
+        goto fail;
+    for (i = 0; i < 3; ++i)
+    {
+        /*nearest rank*/
+        Uint32 rank = (percentiles[i] * n + 99) / 100;
+        if (stats_set_ms (dict, names[i], n ? sorted[rank - 1] : 0))
+            goto fail;
+    }
+    if (stats_set_ms (dict, "max", n ? sorted[n - 1] : 0) ||
+        stats_set_ms (dict, "jitter", jitter) ||
+        stats_set_int (dict, "missed", missed))
+        goto fail;
+
+    histogram = PyList_New (HISTOGRAM_BUCKETS);
+    if (!histogram)
+        goto fail;
+    for (i = 0; i < HISTOGRAM_BUCKETS; ++i)
+    {
+        value = PyInt_FromLong (buckets[i]);
+        if (!value)
+        {
+            Py_DECREF (histogram);
+            goto fail;
+        }
+        PyList_SET_ITEM (histogram, i, value);
+    }
+    i = PyDict_SetItemString (dict, "histogram", histogram);
+    Py_DECREF (histogram);
+    if (i)
+        goto fail;
+
+    PyMem_Free (sorted);
+    return dict;
+
+fail:
+    PyMem_Free (sorted);
+    Py_XDECREF (dict);
+    return NULL;
+}
+
+/*stores a frame of the clock and of every section used in it*/
+static void
+clock_add_frame (PyClockObject* _clock, Uint64 frame_ns, float framerate)
+{
+    Py_ssize_t pos = 0;
+    PyObject* key;
+    PyObject* value;
+
+    if (!_clock->ticked)
+    {
+        /*the first tick ends no frame*/
+        _clock->ticked = 1;
+        frame_ns = 0;
+    }
+    else
+        stats_add (&_clock->stats, frame_ns,
+                   framerate > 0.0f ? (Uint32)(1000000.0f / framerate) : 0);
+
+    if (!_clock->sections)
+        return;
+    while (PyDict_Next (_clock->sections, &pos, &key, &value))
+    {
+        PyClockSectionObject* section = (PyClockSectionObject*) value;
+
+        if (section->entered && frame_ns)
+            stats_add (&section->stats, section->frame_ns, 0);
+        section->entered = 0;
+        section->frame_ns = 0;
+    }
+}
+
+/*tick of a precise clock, paced on the performance counter*/
+static PyObject*
+clock_tick_precise (PyClockObject* _clock, float framerate)
+{
+    Uint64 now = ticks_ns ();
+    Uint64 target, slack, late = 0;
+
+    if (framerate > 0.0f)
+    {
+        _clock->rawpassed_ns = now - _clock->last_ns;
+        target = _clock->last_ns + (Uint64)(NS_PER_SEC / framerate);
+        slack = sleep_slack_ns;
+        Py_BEGIN_ALLOW_THREADS;
+        now = wait_until_ns (target, slack, &late);
+        Py_END_ALLOW_THREADS;
+        calibrate_sleep (late);
+    }
+
+    _clock->timepassed_ns = now - _clock->last_ns;
+    _clock->last_ns = now;
+    if (framerate <= 0.0f)
+        _clock->rawpassed_ns = _clock->timepassed_ns;
+    _clock->timepassed = (int)((_clock->timepassed_ns + NS_PER_MS / 2) /
+                               NS_PER_MS);
+    _clock->rawpassed = (int)((_clock->rawpassed_ns + NS_PER_MS / 2) /
+                              NS_PER_MS);
+
+    _clock->fps_count += 1;
+    if (!_clock->fps_ns)
+    {
+        _clock->fps_count = 0;
+        _clock->fps_ns = now;
+    }
+    else if (_clock->fps_count >= 10)
+    {
+        _clock->fps = (float)(_clock->fps_count * (double)NS_PER_SEC /
+                              (double)(now - _clock->fps_ns));
+        _clock->fps_count = 0;
+        _clock->fps_ns = now;
+    }
+    clock_add_frame (_clock, _clock->timepassed_ns, framerate);
+    return PyInt_FromLong (_clock->timepassed);
+}
+
 // to be called by the other tick functions.
 static PyObject*
 clock_tick_base(PyObject* self, PyObject* arg, int use_accurate_delay)
@@ -294,6 +899,9 @@ clock_tick_base(PyObject* self, PyObject* arg, int use_accurate_delay)
     if (!PyArg_ParseTuple (arg, "|f", &framerate))
         return NULL;
 
+    if (_clock->precise)
+        return clock_tick_precise (_clock, framerate);
+
     if (framerate)
     {
         int delay, endtime = (int) ((1.0f / framerate) * 1000.0f);
@@ -347,6 +955,8 @@ clock_tick_base(PyObject* self, PyObject* arg, int use_accurate_delay)
         _clock->fps_tick = nowtime;
         Py_XDECREF (_clock->rendered);
     }
+    clock_add_frame (_clock, (Uint64)_clock->timepassed * NS_PER_MS,
+                     framerate);
     return PyInt_FromLong (_clock->timepassed);
 }
 
@@ -383,6 +993,112 @@ clock_get_rawtime (PyObject* self)
     return PyInt_FromLong (_clock->rawpassed);
 }
 
+static PyObject*
+clock_get_time_ns (PyObject* self)
+{
+    PyClockObject* _clock = (PyClockObject*) self;
+    if (!_clock->precise)
+        return PyLong_FromUnsignedLongLong (
+            (unsigned PY_LONG_LONG)_clock->timepassed * NS_PER_MS);
+    return PyLong_FromUnsignedLongLong (
+        (unsigned PY_LONG_LONG)_clock->timepassed_ns);
+}
+
+static PyObject*
+clock_get_rawtime_ns (PyObject* self)
+{
+    PyClockObject* _clock = (PyClockObject*) self;
+    if (!_clock->precise)
+        return PyLong_FromUnsignedLongLong (
+            (unsigned PY_LONG_LONG)_clock->rawpassed * NS_PER_MS);
+    return PyLong_FromUnsignedLongLong (
+        (unsigned PY_LONG_LONG)_clock->rawpassed_ns);
+}
+
+static PyObject*
+clock_get_stats (PyObject* self)
+{
+    PyClockObject* _clock = (PyClockObject*) self;
+    PyObject* dict;
+    PyObject* sections;
+    PyObject* key;
+    PyObject* value;
+    Py_ssize_t pos = 0;
+
+    dict = stats_to_dict (&_clock->stats);
+    if (!dict)
+        return NULL;
+    sections = PyDict_New ();
+    if (!sections || PyDict_SetItemString (dict, "sections", sections))
+    {
+        Py_XDECREF (sections);
+        Py_DECREF (dict);
+        return NULL;
+    }
+    Py_DECREF (sections);
+
+    while (_clock->sections &&
+           PyDict_Next (_clock->sections, &pos, &key, &value))
+    {
+        PyObject* stats = stats_to_dict (
+            &((PyClockSectionObject*) value)->stats);
+        if (!stats || PyDict_SetItem (sections, key, stats))
+        {
+            Py_XDECREF (stats);
+            Py_DECREF (dict);
+            return NULL;
+        }
+        Py_DECREF (stats);
+    }
+    return dict;
+}
+
+static PyTypeObject PyClockSection_Type;
+
+static PyObject*
+clock_section (PyObject* self, PyObject* args)
+{
+    PyClockObject* _clock = (PyClockObject*) self;
+    PyClockSectionObject* section;
+    PyObject* name;
+
+    if (!PyArg_ParseTuple (args, "O", &name))
+        return NULL;
+    if (!Text_Check (name))
+        return RAISE (PyExc_TypeError, "section name must be a string");
+
+    if (!_clock->sections)
+    {
+        _clock->sections = PyDict_New ();
+        if (!_clock->sections)
+            return NULL;
+    }
+    section = (PyClockSectionObject*) PyDict_GetItem (_clock->sections,
+                                                      name);
+    if (section)
+    {
+        Py_INCREF (section);
+        return (PyObject*) section;
+    }
+
+    section = PyObject_NEW (PyClockSectionObject, &PyClockSection_Type);
+    if (!section)
+        return NULL;
+    Py_INCREF (name);
+    section->name = name;
+    section->depth = 0;
+    section->entered = 0;
+    section->start_ns = 0;
+    section->frame_ns = 0;
+    section->stats.count = 0;
+    if (PyDict_SetItem (_clock->sections, name, (PyObject*) section))
+    {
+        Py_DECREF (section);
+        return NULL;
+    }
+    return (PyObject*) section;
+}
+
 /* clock object internals */
 
 static struct PyMethodDef clock_methods[] =
@@ -393,8 +1109,15 @@ static struct PyMethodDef clock_methods[] =
       DOC_CLOCKGETTIME },
     { "get_rawtime", (PyCFunction) clock_get_rawtime, METH_NOARGS,
       DOC_CLOCKGETRAWTIME },
+    { "get_time_ns", (PyCFunction) clock_get_time_ns, METH_NOARGS,
+      DOC_CLOCKGETTIMENS },
+    { "get_rawtime_ns", (PyCFunction) clock_get_rawtime_ns, METH_NOARGS,
+      DOC_CLOCKGETRAWTIMENS },
     { "tick_busy_loop", clock_tick_busy_loop, METH_VARARGS,
       DOC_CLOCKTICKBUSYLOOP },
+    { "get_stats", (PyCFunction) clock_get_stats, METH_NOARGS,
+      DOC_CLOCKGETSTATS },
+    { "section", clock_section, METH_VARARGS, DOC_CLOCKSECTION },
     { NULL, NULL, 0, NULL}
 };
 
@@ -403,6 +1126,7 @@ clock_dealloc (PyObject* self)
 {
     PyClockObject* _clock = (PyClockObject*) self;
     Py_XDECREF (_clock->rendered);
+    Py_XDECREF (_clock->sections);
     PyObject_DEL (self);
 }
 
@@ -459,11 +1183,471 @@ static PyTypeObject PyClock_Type =
     0,                          /* tp_new */
 };
 
+/* clock section object */
+
+static PyObject*
+section_enter (PyObject* self)
+{
+    PyClockSectionObject* section = (PyClockSectionObject*) self;
+
+    if (!section->depth++)
+        section->start_ns = ticks_ns ();
+    Py_INCREF (self);
+    return self;
+}
+
+static PyObject*
+section_exit (PyObject* self, PyObject* args)
+{
+    PyClockSectionObject* section = (PyClockSectionObject*) self;
+
+    if (section->depth && !--section->depth)
+    {
+        section->frame_ns += ticks_ns () - section->start_ns;
+        section->entered = 1;
+    }
+    Py_RETURN_NONE;
+}
+
+static struct PyMethodDef section_methods[] =
+{
+    { "__enter__", (PyCFunction) section_enter, METH_NOARGS, NULL },
+    { "__exit__", section_exit, METH_VARARGS, NULL },
+    { NULL, NULL, 0, NULL}
+};
+
+static void
+section_dealloc (PyObject* self)
+{
+    Py_XDECREF (((PyClockSectionObject*) self)->name);
+    PyObject_DEL (self);
+}
+
+static PyObject*
+section_repr (PyObject* self)
+{
+    PyObject* name = ((PyClockSectionObject*) self)->name;
+
+#if PY3
+    return PyUnicode_FromFormat ("<ClockSection(%U)>", name);
+#else
+    return PyString_FromFormat ("<ClockSection(%s)>",
+                                PyString_AS_STRING (name));
+#endif
+}
+
+static PyTypeObject PyClockSection_Type =
+{
+    TYPE_HEAD (NULL, 0)
+    "ClockSection",             /* name */
+    sizeof(PyClockSectionObject), /* basic size */
+    0,                          /* itemsize */
+    section_dealloc,            /* dealloc */
+    0,                          /* print */
+    0,                          /* getattr */
+    0,                          /* setattr */
+    0,                          /* compare */
+    section_repr,               /* repr */
+    0,                          /* as_number */
+    0,                          /* as_sequence */
+    0,                          /* as_mapping */
+    (hashfunc)0,                /* hash */
+    (ternaryfunc)0,             /* call */
+    0,                          /* str */
+    0,                          /* tp_getattro */
+    0,                          /* tp_setattro */
+    0,                          /* tp_as_buffer */
+    0,                          /* flags */
+    DOC_CLOCKSECTION,           /* Documentation string */
+    0,                          /* tp_traverse */
+    0,                          /* tp_clear */
+    0,                          /* tp_richcompare */
+    0,                          /* tp_weaklistoffset */
+    0,                          /* tp_iter */
+    0,                          /* tp_iternext */
+    section_methods,            /* tp_methods */
+    0,                          /* tp_members */
+    0,                          /* tp_getset */
+    0,                          /* tp_base */
+    0,                          /* tp_dict */
+    0,                          /* tp_descr_get */
+    0,                          /* tp_descr_set */
+    0,                          /* tp_dictoffset */
+    0,                          /* tp_init */
+    0,                          /* tp_alloc */
+    0,                          /* tp_new */
+};
+
+/* timer object */
+
+static PyObject*
+timer_cancel (PyObject* self)
+{
+    pgTimerObject* timer = (pgTimerObject*) self;
+
+    if (!timer->pprev)
+        Py_RETURN_FALSE;
+    wheel_remove (timer);
+    Py_RETURN_TRUE;
+}
+
+static struct PyMethodDef timer_methods[] =
+{
+    { "cancel", (PyCFunction) timer_cancel, METH_NOARGS, DOC_TIMERCANCEL },
+    { NULL, NULL, 0, NULL}
+};
+
+static void
+timer_dealloc (PyObject* self)
+{
+    Py_XDECREF (((pgTimerObject*) self)->event);
+    PyObject_DEL (self);
+}
+
+static PyObject*
+timer_repr (PyObject* self)
+{
+    pgTimerObject* timer = (pgTimerObject*) self;
+    char str[128];
+
+    PyOS_snprintf (str, sizeof (str), "<Timer(type=%d, millis=%u, %s)>",
+                   timer->type, (unsigned int)timer->interval,
+                   timer->pprev ? "scheduled" : "idle");
+    return Text_FromUTF8 (str);
+}
+
+static PyTypeObject pgTimer_Type =
+{
+    TYPE_HEAD (NULL, 0)
+    "Timer",                    /* name */
+    sizeof(pgTimerObject),      /* basic size */
+    0,                          /* itemsize */
+    timer_dealloc,              /* dealloc */
+    0,                          /* print */
+    0,                          /* getattr */
+    0,                          /* setattr */
+    0,                          /* compare */
+    timer_repr,                 /* repr */
+    0,                          /* as_number */
+    0,                          /* as_sequence */
+    0,                          /* as_mapping */
+    (hashfunc)0,                /* hash */
+    (ternaryfunc)0,             /* call */
+    0,                          /* str */
+    0,                          /* tp_getattro */
+    0,                          /* tp_setattro */
+    0,                          /* tp_as_buffer */
+    0,                          /* flags */
+    DOC_PYGAMETIMETIMER,        /* Documentation string */
+    0,                          /* tp_traverse */
+    0,                          /* tp_clear */
+    0,                          /* tp_richcompare */
+    0,                          /* tp_weaklistoffset */
+    0,                          /* tp_iter */
+    0,                          /* tp_iternext */
+    timer_methods,              /* tp_methods */
+    0,                          /* tp_members */
+    0,                          /* tp_getset */
+    0,                          /* tp_base */
+    0,                          /* tp_dict */
+    0,                          /* tp_descr_get */
+    0,                          /* tp_descr_set */
+    0,                          /* tp_dictoffset */
+    0,                          /* tp_init */
+    0,                          /* tp_alloc */
+    0,                          /* tp_new */
+};
+
+/* fixed step loop object */
+
+/*runs update() at a fixed rate and render() once per frame, with the
+ *time left over between the updates as a fraction of a step. The frame
+ *pacing is the sleep-then-spin wait of the precise clocks.
+ */
+typedef struct
+{
+    PyObject_HEAD
+    PyObject* update;
+    PyObject* render;
+    double hz;
+    double framerate;           /* 0 renders once per step */
+    int max_catchup;            /* updates in one frame at most */
+    int running, stopping;
+    unsigned long updates, dropped;
+    ClockStats stats;
+} pgFixedStepLoopObject;
+
+static PyTypeObject pgFixedStepLoop_Type;
+
+static int
+loop_run_frames (pgFixedStepLoopObject* loop, PyObject* update,
+                 PyObject* render, long frames)
+{
+    Uint64 step_ns = (Uint64)(NS_PER_SEC / loop->hz);
+    Uint64 frame_ns = loop->framerate > 0.0 ?
+        (Uint64)(NS_PER_SEC / loop->framerate) : step_ns;
+    Uint64 now, last, next_frame, slack, late;
+    Uint64 accumulated = step_ns; /*the first frame has an update*/
+    PyObject* update_args;
+    PyObject* result;
+    long count = 0;
+    int steps;
+
+    update_args = Py_BuildValue ("(d)", 1.0 / loop->hz);
+    if (!update_args)
+        return -1;
+
+    last = next_frame = ticks_ns ();
+    for (;;)
+    {
+        /*the timers and the queue are kept going like a Python loop
+         *reading the events would*/
+        if (SDL_WasInit (SDL_INIT_VIDEO))
+            pg_PumpEvents ();
+        for (steps = 0; accumulated >= step_ns; ++steps)
+        {
+            if (steps == loop->max_catchup)
+            {
+                /*too far behind, the simulation slows down instead*/
+                loop->dropped += (unsigned long)(accumulated / step_ns);
+                accumulated %= step_ns;
+                break;
+            }
+            result = PyObject_Call (update, update_args, NULL);
+            if (!result)
+                goto fail;
+            Py_DECREF (result);
+            accumulated -= step_ns;
+            loop->updates++;
+        }
+
+        result = PyObject_CallFunction (render, "d",
+                                        (double)accumulated / step_ns);
+        if (!result)
+            goto fail;
+        Py_DECREF (result);
+        if (PyErr_CheckSignals ())
+            goto fail;
+        if (loop->stopping || ++count == frames)
+            break;
+
+        now = ticks_ns ();
+        next_frame += frame_ns;
+        if (next_frame < now)
+            next_frame = now;
+        slack = sleep_slack_ns;
+        Py_BEGIN_ALLOW_THREADS;
+        now = wait_until_ns (next_frame, slack, &late);
+        Py_END_ALLOW_THREADS;
+        calibrate_sleep (late);
+
+        stats_add (&loop->stats, now - last, (Uint32)(frame_ns / 1000));
+        accumulated += now - last;
+        last = now;
+    }
+
+    Py_DECREF (update_args);
+    return 0;
+
+fail:
+    Py_DECREF (update_args);
+    return -1;
+}
+
+static PyObject*
+loop_run (PyObject* self, PyObject* args)
+{
+    pgFixedStepLoopObject* loop = (pgFixedStepLoopObject*) self;
+    PyObject* update = loop->update;
+    PyObject* render = loop->render;
+    long frames = 0;
+    int status;
+
+    if (!PyArg_ParseTuple (args, "|l", &frames))
+        return NULL;
+    if (loop->running)
+        return RAISE (PyExc_RuntimeError, "the loop is already running");
+    if (!update || !render)
+        return RAISE (PyExc_RuntimeError, "the loop has no callbacks");
+
+    /*the callbacks may drop the attributes of the loop*/
+    Py_INCREF (update);
+    Py_INCREF (render);
+    loop->running = 1;
+    loop->stopping = 0;
+    status = loop_run_frames (loop, update, render, frames);
+    loop->running = 0;
+    loop->stopping = 0;
+    Py_DECREF (update);
+    Py_DECREF (render);
+
+    if (status)
+        return NULL;
+    Py_RETURN_NONE;
+}
+
+static PyObject*
+loop_stop (PyObject* self)
+{
+    ((pgFixedStepLoopObject*) self)->stopping = 1;
+    Py_RETURN_NONE;
+}
+
+static PyObject*
+loop_get_stats (PyObject* self)
+{
+    pgFixedStepLoopObject* loop = (pgFixedStepLoopObject*) self;
+    PyObject* dict = stats_to_dict (&loop->stats);
+
+    if (!dict)
+        return NULL;
+    if (stats_set_int (dict, "updates", (long)loop->updates) ||
+        stats_set_int (dict, "dropped", (long)loop->dropped))
+    {
+        Py_DECREF (dict);
+        return NULL;
+    }
+    return dict;
+}
+
+static struct PyMethodDef loop_methods[] =
+{
+    { "run", loop_run, METH_VARARGS, DOC_FIXEDSTEPLOOPRUN },
+    { "stop", (PyCFunction) loop_stop, METH_NOARGS, DOC_FIXEDSTEPLOOPSTOP },
+    { "get_stats", (PyCFunction) loop_get_stats, METH_NOARGS,
+      DOC_FIXEDSTEPLOOPGETSTATS },
+    { NULL, NULL, 0, NULL}
+};
+
+static int
+loop_traverse (pgFixedStepLoopObject* self, visitproc visit, void* arg)
+{
+    Py_VISIT (self->update);
+    Py_VISIT (self->render);
+    return 0;
+}
+
+static int
+loop_clear (pgFixedStepLoopObject* self)
+{
+    Py_CLEAR (self->update);
+    Py_CLEAR (self->render);
+    return 0;
+}
+
+static void
+loop_dealloc (PyObject* self)
+{
+    PyObject_GC_UnTrack (self);
+    loop_clear ((pgFixedStepLoopObject*) self);
+    PyObject_GC_Del (self);
+}
+
+static PyTypeObject pgFixedStepLoop_Type =
+{
+    TYPE_HEAD (NULL, 0)
+    "FixedStepLoop",            /* name */
+    sizeof(pgFixedStepLoopObject), /* basic size */
+    0,                          /* itemsize */
+    loop_dealloc,               /* dealloc */
+    0,                          /* print */
+    0,                          /* getattr */
+    0,                          /* setattr */
+    0,                          /* compare */
+    0,                          /* repr */
+    0,                          /* as_number */
+    0,                          /* as_sequence */
+    0,                          /* as_mapping */
+    (hashfunc)0,                /* hash */
+    (ternaryfunc)0,             /* call */
+    0,                          /* str */
+    0,                          /* tp_getattro */
+    0,                          /* tp_setattro */
+    0,                          /* tp_as_buffer */
+    Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HAVE_GC, /* flags */
+    DOC_PYGAMETIMEFIXEDSTEPLOOP, /* Documentation string */
+    (traverseproc)loop_traverse, /* tp_traverse */
+    (inquiry)loop_clear,        /* tp_clear */
+    0,                          /* tp_richcompare */
+    0,                          /* tp_weaklistoffset */
+    0,                          /* tp_iter */
+    0,                          /* tp_iternext */
+    loop_methods,               /* tp_methods */
+    0,                          /* tp_members */
+    0,                          /* tp_getset */
+    0,                          /* tp_base */
+    0,                          /* tp_dict */
+    0,                          /* tp_descr_get */
+    0,                          /* tp_descr_set */
+    0,                          /* tp_dictoffset */
+    0,                          /* tp_init */
+    0,                          /* tp_alloc */
+    0,                          /* tp_new */
+};
+
+static PyObject*
+FixedStepLoopInit (PyObject* self, PyObject* args, PyObject* kwds)
+{
+    pgFixedStepLoopObject* loop;
+    PyObject* update;
+    PyObject* render;
+    double hz, framerate = 0.0;
+    int max_catchup = 5;
+    static char* kwids[] = {"update", "render", "hz", "max_catchup",
+                            "framerate", NULL};
+
+    if (!PyArg_ParseTupleAndKeywords (args, kwds, "OOd|id", kwids,
+                                      &update, &render, &hz, &max_catchup,
+                                      &framerate))
+        return NULL;
+    if (!PyCallable_Check (update) || !PyCallable_Check (render))
+        return RAISE (PyExc_TypeError, "update and render must be callable");
+    /*negated so nan fails too, at 1e9 a step is still 1 ns*/
+    if (!(hz > 0.0 && hz <= 1e9))
+        return RAISE (PyExc_ValueError,
+                      "hz must be positive and at most 1e9");
+    if (max_catchup < 1)
+        return RAISE (PyExc_ValueError, "max_catchup must be at least 1");
+    if (!(framerate >= 0.0 && framerate <= 1e9))
+        return RAISE (PyExc_ValueError,
+                      "framerate must be from 0 to 1e9");
+
+    if (!SDL_WasInit (SDL_INIT_TIMER))
+    {
+        if (SDL_InitSubSystem (SDL_INIT_TIMER))
+            return RAISE (pgExc_SDLError, SDL_GetError ());
+    }
+
+    loop = PyObject_GC_New (pgFixedStepLoopObject, &pgFixedStepLoop_Type);
+    if (!loop)
+        return NULL;
+    Py_INCREF (update);
+    loop->update = update;
+    Py_INCREF (render);
+    loop->render = render;
+    loop->hz = hz;
+    loop->framerate = framerate;
+    loop->max_catchup = max_catchup;
+    loop->running = 0;
+    loop->stopping = 0;
+    loop->updates = 0;
+    loop->dropped = 0;
+    loop->stats.count = 0;
+    PyObject_GC_Track ((PyObject*) loop);
+    return (PyObject*) loop;
+}
+
 PyObject*
-ClockInit (PyObject* self)
+ClockInit (PyObject* self, PyObject* args, PyObject* kwds)
 {
-    PyClockObject* _clock = PyObject_NEW (PyClockObject, &PyClock_Type);
+    PyClockObject* _clock;
+    int precise = 0;
+    static char* kwids[] = {"precise", NULL};
 
+    if (!PyArg_ParseTupleAndKeywords (args, kwds, "|i", kwids, &precise))
+        return NULL;
+
+    _clock = PyObject_NEW (PyClockObject, &PyClock_Type);
     if (!_clock) {
         return NULL;
     }
@@ -482,6 +1666,14 @@ ClockInit (PyObject* self)
     _clock->fps = 0.0f;
     _clock->fps_count = 0;
     _clock->rendered = NULL;
+    _clock->precise = precise;
+    _clock->last_ns = ticks_ns ();
+    _clock->fps_ns = 0;
+    _clock->timepassed_ns = 0;
+    _clock->rawpassed_ns = 0;
+    _clock->ticked = 0;
+    _clock->stats.count = 0;
+    _clock->sections = NULL;
 
     return (PyObject*) _clock;
 }
@@ -490,11 +1682,18 @@ static PyMethodDef _time_methods[] =
 {
     { "get_ticks", (PyCFunction) time_get_ticks, METH_NOARGS,
       DOC_PYGAMETIMEGETTICKS },
+    { "get_ticks_ns", (PyCFunction) time_get_ticks_ns, METH_NOARGS,
+      DOC_PYGAMETIMEGETTICKSNS },
     { "delay", time_delay, METH_VARARGS, DOC_PYGAMETIMEDELAY },
     { "wait", time_wait, METH_VARARGS, DOC_PYGAMETIMEWAIT },
     { "set_timer", time_set_timer, METH_VARARGS, DOC_PYGAMETIMESETTIMER },
+    { "add_timer", (PyCFunction) time_add_timer,
+      METH_VARARGS | METH_KEYWORDS, DOC_PYGAMETIMEADDTIMER },
 
-    { "Clock", (PyCFunction) ClockInit, METH_NOARGS, DOC_PYGAMETIMECLOCK },
+    { "Clock", (PyCFunction) ClockInit, METH_VARARGS | METH_KEYWORDS,
+      DOC_PYGAMETIMECLOCK },
+    { "FixedStepLoop", (PyCFunction) FixedStepLoopInit,
+      METH_VARARGS | METH_KEYWORDS, DOC_PYGAMETIMEFIXEDSTEPLOOP },
 
     { NULL, NULL, 0, NULL }
 };
@@ -524,17 +1723,27 @@ MODINIT_DEFINE (time)
     if (PyErr_Occurred ()) {
         MODINIT_ERROR;
     }
-#if IS_SDLv2
     import_pygame_event ();
     if (PyErr_Occurred ()) {
         MODINIT_ERROR;
     }
-#endif /* IS_SDLv2 */
 
     /* type preparation */
     if (PyType_Ready (&PyClock_Type) < 0) {
         MODINIT_ERROR;
     }
+    if (PyType_Ready (&PyClockSection_Type) < 0) {
+        MODINIT_ERROR;
+    }
+    if (PyType_Ready (&pgTimer_Type) < 0) {
+        MODINIT_ERROR;
+    }
+    if (PyType_Ready (&pgFixedStepLoop_Type) < 0) {
+        MODINIT_ERROR;
+    }
+
+    /* the event module runs the timers */
+    pg_SetTimerPump (wheel_run);
 
     /* create the module */
 #if PY3
@@ -115,6 +115,100 @@ class DisplayModuleTest( unittest.TestCase ):
         
             #pygame.quit()
 
+    def test_set_present_thread(self):
+        pygame.init()
+        try:
+            screen = pygame.display.set_mode((100, 100))
+            if not pygame.display.set_present_thread(True):
+                # SDL 1.2 and some video drivers have no present thread
+                return
+            self.assertTrue(pygame.display.set_present_thread(True))
+            for i in range(5):
+                screen.fill((i * 40, 0, 0))
+                pygame.display.flip()
+            pygame.display.update(pygame.Rect(-10, 0, 50, 50))
+            pygame.display.update([pygame.Rect(0, 0, 10, 10), None])
+            # the screen keeps what was drawn, with or without the thread
+            self.assertEqual(screen.get_at((5, 5))[:3], (160, 0, 0))
+            screen.fill((0, 0, 200))
+            self.assertFalse(pygame.display.set_present_thread(False))
+            self.assertEqual(screen.get_at((5, 5))[:3], (0, 0, 200))
+            pygame.display.flip()
+        finally:
+            pygame.quit()
+
+    def test_set_present_thread__subsurfaces(self):
+        pygame.init()
+        try:
+            screen = pygame.display.set_mode((100, 100))
+            sub = screen.subsurface((10, 10, 20, 20))
+            try:
+                started = pygame.display.set_present_thread(True)
+            except pygame.error:
+                started = None
+            if started is False:
+                # SDL 1.2 and some video drivers have no present thread
+                return
+            self.assertIsNone(started)
+            del sub
+            self.assertTrue(pygame.display.set_present_thread(True))
+
+            sub = screen.subsurface((10, 10, 20, 20))
+            self.assertRaises(pygame.error,
+                              pygame.display.set_present_thread, False)
+            del sub
+            screen.lock()
+            self.assertRaises(pygame.error,
+                              pygame.display.set_present_thread, False)
+            screen.unlock()
+            self.assertFalse(pygame.display.set_present_thread(False))
+
+            # set_mode stops the thread, the subsurface pixels stay valid
+            self.assertTrue(pygame.display.set_present_thread(True))
+            sub = screen.subsurface((10, 10, 20, 20))
+            screen = pygame.display.set_mode((50, 50))
+            sub.fill((1, 2, 3))
+            self.assertEqual(sub.get_at((19, 19))[:3], (1, 2, 3))
+            del sub
+            pygame.display.quit()
+        finally:
+            pygame.quit()
+
+    def test_start_capture(self):
+        pygame.init()
+        try:
+            screen = pygame.display.set_mode((20, 10))
+            self.assertEqual(pygame.display.get_captured(), [])
+            pygame.display.start_capture(3, every_n=2)
+            self.assertEqual(pygame.display.get_captured(), [])
+            shown = []
+            for i in range(8):
+                screen.fill((i * 30, 0, 0))
+                shown.append(screen.get_view('2').raw)
+                pygame.display.flip()
+            # flips 0, 2, 4 and 6 were captured, the ring keeps three
+            frames = pygame.display.get_captured()
+            self.assertEqual([f.raw for f in frames],
+                             [shown[2], shown[4], shown[6]])
+            self.assertEqual(frames[0].length, len(shown[0]))
+            self.assertNotEqual(shown[4], shown[6])
+
+            # the frames are views, the next capture writes over the oldest
+            pygame.display.update()
+            self.assertEqual(frames[0].raw, shown[7])
+
+            self.assertRaises(ValueError, pygame.display.start_capture, -1)
+            self.assertRaises(ValueError, pygame.display.start_capture, 1, 0)
+            pygame.display.start_capture(0)
+            self.assertEqual(pygame.display.get_captured(), [])
+            pygame.display.start_capture(2)
+            pygame.display.flip()
+            self.assertEqual(len(pygame.display.get_captured()), 1)
+            pygame.display.set_mode((20, 10))
+            self.assertEqual(pygame.display.get_captured(), [])
+        finally:
+            pygame.quit()
+
     def todo_test_flip(self):
 
         # __doc__ (as of 2008-08-02) for pygame.display.flip:
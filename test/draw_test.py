@@ -162,7 +162,58 @@ class DrawModuleTest(unittest.TestCase):
             h = abs(p2[1] - p1[1]) + 1 + yinc * (line_width - 1)
             msg += ", %s" % (rec,)
             self.assert_(rec == (rx, ry, w, h), msg)
-        
+
+    def test_line__width_all_depths(self):
+        # A thick line is the same set of pixels as its offset one pixel
+        # lines, whether or not the line is inside the clip rect.
+        white = (255, 255, 255)
+        for depth in (8, 16, 24, 32):
+            for clip in (None, pygame.Rect(0, 0, 40, 30)):
+                for p1, p2 in [((10, 10), (60, 25)), ((60, 40), (12, 5)),
+                               ((20, 5), (30, 45)), ((15, 15), (15, 15))]:
+                    for width in (2, 3, 6):
+                        msg = "%d bit, %s, %s - %s, %d" % (
+                            depth, clip, p1, p2, width)
+                        thick = pygame.Surface((70, 50), 0, depth)
+                        thin = pygame.Surface((70, 50), 0, depth)
+                        thick.set_clip(clip)
+                        thin.set_clip(clip)
+                        draw.line(thick, white, p1, p2, width)
+                        xinc = yinc = 0
+                        if abs(p1[0] - p2[0]) > abs(p1[1] - p2[1]):
+                            yinc = 1
+                        else:
+                            xinc = 1
+                        for i in range(-((width - 1) // 2), width // 2 + 1):
+                            draw.line(thin, white,
+                                      (p1[0] + xinc * i, p1[1] + yinc * i),
+                                      (p2[0] + xinc * i, p2[1] + yinc * i))
+                        for x in range(70):
+                            for y in range(50):
+                                self.assertEqual(thick.get_at((x, y)),
+                                                 thin.get_at((x, y)), msg)
+
+    def test_rect__fill_all_depths(self):
+        white = (255, 255, 255)
+        for depth in (8, 16, 24, 32):
+            surf = pygame.Surface((30, 20), 0, depth)
+            surf.set_clip((2, 3, 20, 10))
+            mapped = surf.map_rgb(white)
+            drawn = draw.rect(surf, white, (-5, 5, 20, 30))
+            filled = [(x, y) for x in range(30) for y in range(20)
+                      if surf.get_at_mapped((x, y)) == mapped]
+            # the returned rect is exactly the filled pixels
+            self.assertEqual(len(filled), drawn.w * drawn.h)
+            for posn in filled:
+                self.assertTrue(drawn.collidepoint(posn),
+                                "%d bit at %s" % (depth, posn))
+            self.assertEqual(drawn, (2, 5, 13, 8))
+
+            # nothing inside the clip area
+            drawn = draw.rect(surf, white, (25, 1, 4, 4))
+            self.assertEqual(drawn, (25, 1, 0, 0))
+            self.assertNotEqual(surf.get_at_mapped((26, 2)), mapped)
+
     def todo_test_aaline(self):
 
         # __doc__ (as of 2008-08-02) for pygame.draw.aaline:
@@ -260,6 +311,356 @@ class DrawModuleTest(unittest.TestCase):
 
         self.fail() 
 
+    def test_polygon__fill_rules(self):
+        surf = pygame.Surface((60, 60))
+        # a pentagram, its center is covered twice
+        star = [(30, 2), (47, 55), (3, 22), (57, 22), (13, 55)]
+        for nonzero, center in ((False, (0, 0, 0, 255)),
+                                (True, (255, 255, 255, 255))):
+            surf.fill((0, 0, 0))
+            draw.polygon(surf, (255, 255, 255), star, 0, nonzero)
+            self.assertEqual(surf.get_at((30, 32)), center)
+            self.assertEqual(surf.get_at((30, 8)), (255, 255, 255, 255))
+            self.assertEqual(surf.get_at((5, 5)), (0, 0, 0, 255))
+
+    def test_polygon__matches_rect_fill(self):
+        surf = pygame.Surface((40, 40))
+        surf.fill((0, 0, 0))
+        draw.polygon(surf, (255, 0, 0), [(5, 5), (20, 5), (20, 12), (5, 12)])
+        for x in range(40):
+            for y in range(40):
+                expected = (255, 0, 0, 255) if (5 <= x <= 20 and
+                                                 5 <= y <= 12) \
+                           else (0, 0, 0, 255)
+                self.assertEqual(surf.get_at((x, y)), expected)
+
+    def test_polygon__antialias(self):
+        surf = pygame.Surface((40, 40))
+        surf.fill((0, 0, 0))
+        draw.polygon(surf, (255, 255, 255), [(4.5, 4.5), (20.5, 4.5),
+                                             (20.5, 12), (4.5, 12)],
+                     antialias=True)
+        self.assertEqual(surf.get_at((10, 8)), (255, 255, 255, 255))
+        self.assertEqual(surf.get_at((30, 30)), (0, 0, 0, 255))
+        # the bottom edge cuts the last row in half
+        edge = surf.get_at((10, 12))
+        self.assertTrue(100 < edge.r < 155, edge)
+
+    def _coverage(self, surf):
+        # drawn area in pixels, for white drawn on black
+        return sum(bytearray(pygame.image.tostring(surf, 'RGB'))[::3]) / 255.0
+
+    def test_circle__antialias(self):
+        import math
+        surf = pygame.Surface((100, 100))
+        drawn = draw.circle(surf, (255, 255, 255), (50, 50), 30,
+                            antialias=True)
+        self.assertEqual(drawn, (20, 20, 61, 61))
+        self.assertAlmostEqual(self._coverage(surf), math.pi * 30 ** 2,
+                               delta=5)
+        self.assertEqual(surf.get_at((50, 50)), (255, 255, 255, 255))
+        edge = surf.get_at((50, 80))
+        self.assertTrue(80 < edge.r < 175, edge)
+
+        surf.fill((0, 0, 0))
+        draw.circle(surf, (255, 255, 255), (50, 50), 30, 5, antialias=True)
+        self.assertAlmostEqual(self._coverage(surf),
+                               math.pi * (30 ** 2 - 25 ** 2), delta=5)
+        self.assertEqual(surf.get_at((50, 50)), (0, 0, 0, 255))
+
+    def test_circle__bad_radius(self):
+        surf = pygame.Surface((20, 20))
+        nan, inf = float('nan'), float('inf')
+        for antialias in (False, True):
+            for radius in (-1, nan, inf, 1e30):
+                self.assertRaises(ValueError, draw.circle, surf,
+                                  (255, 255, 255), (10, 10), radius,
+                                  antialias=antialias)
+            for pos in ((nan, 10), (10, -inf), (1e30, 10)):
+                self.assertRaises(ValueError, draw.circle, surf,
+                                  (255, 255, 255), pos, 5,
+                                  antialias=antialias)
+        self.assertEqual(surf.get_at((10, 10)), (0, 0, 0, 255))
+
+    def test_ellipse__antialias(self):
+        import math
+        surf = pygame.Surface((100, 100))
+        drawn = draw.ellipse(surf, (255, 255, 255), (10, 20, 80, 40),
+                             antialias=True)
+        self.assertTrue(drawn.contains((10, 20, 80, 40)), drawn)
+        self.assertAlmostEqual(self._coverage(surf), math.pi * 40 * 20,
+                               delta=5)
+
+    def test_aaline__width(self):
+        import math
+        surf = pygame.Surface((100, 100))
+        draw.aaline(surf, (255, 255, 255), (10, 10), (90, 60), 1, 6)
+        self.assertAlmostEqual(self._coverage(surf),
+                               6 * math.hypot(80, 50), delta=3)
+        self.assertEqual(surf.get_at((50, 35)), (255, 255, 255, 255))
+
+    def test_aalines__joint(self):
+        import math
+        white = (255, 255, 255)
+        surf = pygame.Surface((100, 100))
+        points = [(10, 10), (80, 10), (80, 80)]
+        # the miter fills the 5x5 outer corner, a round joint a quarter circle
+        draw.aalines(surf, white, False, points, width=10)
+        self.assertAlmostEqual(self._coverage(surf), 1400, delta=3)
+        self.assertEqual(surf.get_at((84, 6)), (255, 255, 255, 255))
+        surf.fill((0, 0, 0))
+        draw.aalines(surf, white, False, points, width=10, joint='round')
+        self.assertAlmostEqual(self._coverage(surf),
+                               1400 - 25 + math.pi * 25 / 4, delta=3)
+        self.assertEqual(surf.get_at((84, 6)), (0, 0, 0, 255))
+        self.assertRaises(ValueError, draw.aalines, surf, white, False,
+                          points, width=10, joint='bevel')
+
+        # a closed outline is one shape, the corners are not blended twice
+        surf.fill((0, 0, 0))
+        square = [(20, 20), (70, 20), (70, 70), (20, 70)]
+        draw.polygon(surf, white, square, 4, antialias=True)
+        self.assertAlmostEqual(self._coverage(surf), 54 ** 2 - 46 ** 2,
+                               delta=3)
+
+    def test_lines_batch(self):
+        from array import array
+        import ctypes
+        import sys
+        segments = [(5, 5, 60, 30), (70, 2, 10, 45), (30, 0, 30, 49),
+                    (-10, 20, 90, 20)]
+        colors = [(255, 0, 0), (0, 255, 0), (0, 0, 255), (255, 255, 0)]
+        flat = array('i', [v for s in segments for v in s])
+        for width in (1, 4):
+            for segs in (segments, flat):
+                single = pygame.Surface((80, 50))
+                batch = pygame.Surface((80, 50))
+                for s, c in zip(segments, colors):
+                    draw.line(single, c, s[:2], s[2:], width)
+                drawn = draw.lines_batch(batch, colors, segs, width)
+                self.assertEqual(pygame.image.tostring(batch, 'RGB'),
+                                 pygame.image.tostring(single, 'RGB'))
+                self.assertEqual(drawn, (0, 0, 80, 50))
+
+        surf = pygame.Surface((20, 20))
+        drawn = draw.lines_batch(surf, (255, 255, 255), [((2, 3), (10, 3))])
+        self.assertEqual(drawn, (2, 3, 9, 1))
+        self.assertEqual(surf.get_at((10, 3)), (255, 255, 255))
+        self.assertEqual(draw.lines_batch(surf, (255, 255, 255), []),
+                         (0, 0, 0, 0))
+        self.assertRaises(ValueError, draw.lines_batch, surf, (0, 0, 0),
+                          array('i', [1, 2, 3]))
+        # the item size picks the C type, whatever the format letter says
+        drawn = draw.lines_batch(surf, (255, 255, 255),
+                                 array('l', [2, 5, 10, 5]))
+        self.assertEqual(drawn, (2, 5, 9, 1))
+        swapped = (ctypes.c_int32.__ctype_be__ if sys.byteorder == 'little'
+                   else ctypes.c_int32.__ctype_le__)
+        self.assertRaises(TypeError, draw.lines_batch, surf, (0, 0, 0),
+                          (swapped * 4)(2, 5, 10, 5))
+        self.assertRaises(TypeError, draw.lines_batch, surf, (0, 0, 0),
+                          [(1, 2, 3)])
+        self.assertRaises(TypeError, draw.lines_batch, surf,
+                          [(0, 0, 0)], [(1, 2, 3, 4), (4, 3, 2, 1)])
+
+    def test_circles(self):
+        from array import array
+        centers = [(10, 10), (40, 25), (75, 45)]
+        radii = [8, 20, 12]
+        colors = [(255, 0, 0), (0, 255, 0), (0, 0, 255)]
+        for width in (0, 1, 3):
+            single = pygame.Surface((80, 50))
+            batch = pygame.Surface((80, 50))
+            for p, r, c in zip(centers, radii, colors):
+                draw.circle(single, c, p, r, width)
+            draw.circles(batch, colors,
+                         array('d', [v for p in centers for v in p]),
+                         radii, width)
+            self.assertEqual(pygame.image.tostring(batch, 'RGB'),
+                             pygame.image.tostring(single, 'RGB'))
+
+        surf = pygame.Surface((50, 50))
+        drawn = draw.circles(surf, (255, 255, 255), [(10, 10), (30, 20)], 5)
+        self.assertEqual(drawn, (5, 5, 31, 21))
+        self.assertRaises(ValueError, draw.circles, surf, (0, 0, 0),
+                          [(10, 10)], -1)
+        self.assertRaises(ValueError, draw.circles, surf, (0, 0, 0),
+                          [(10, 10)], 2, 3)
+        self.assertRaises(ValueError, draw.circles, surf, (0, 0, 0),
+                          [(10, 10)], [1, 2])
+
+    def test_rects(self):
+        from array import array
+        surf = pygame.Surface((40, 30))
+        rects = [(2, 2, 5, 4), pygame.Rect(10, 10, 3, 8), (20, 5, 0, 5)]
+        mapped = [surf.map_rgb(c) for c in ((255, 0, 0), (0, 255, 0),
+                                             (0, 0, 255))]
+        drawn = draw.rects(surf, array('I', mapped), rects)
+        self.assertEqual(drawn, (2, 2, 11, 16))
+        self.assertEqual(surf.get_at((2, 2)), (255, 0, 0))
+        self.assertEqual(surf.get_at((6, 5)), (255, 0, 0))
+        self.assertEqual(surf.get_at((7, 5)), (0, 0, 0))
+        self.assertEqual(surf.get_at((12, 17)), (0, 255, 0))
+        self.assertEqual(surf.get_at((20, 5)), (0, 0, 0))
+
+        for width in (0, 1, 3):
+            single = pygame.Surface((40, 30))
+            batch = pygame.Surface((40, 30))
+            batch.set_clip((5, 5, 20, 20))
+            single.set_clip((5, 5, 20, 20))
+            for r in rects[:2]:
+                draw.rect(single, (255, 255, 0), r, width)
+            draw.rects(batch, (255, 255, 0), rects[:2], width)
+            self.assertEqual(pygame.image.tostring(batch, 'RGB'),
+                             pygame.image.tostring(single, 'RGB'))
+
+    def test_rects__color_per_shape(self):
+        from array import array
+        rects = [(0, 0, 2, 2), (2, 0, 2, 2), (4, 0, 2, 2)]
+        surf = pygame.Surface((6, 2), 0, 8)
+        for colors in (array('B', [1, 2, 3]), [1, 2, 3]):
+            surf.fill(0)
+            draw.rects(surf, colors, rects)
+            self.assertEqual([surf.get_at_mapped((x, 1)) for x in (0, 2, 4)],
+                             [1, 2, 3])
+
+        # a tuple or a Color is one color for all of them
+        surf = pygame.Surface((6, 2))
+        for color in ((255, 0, 0), pygame.Color(255, 0, 0)):
+            surf.fill(0)
+            draw.rects(surf, color, rects)
+            for x in (0, 2, 4):
+                self.assertEqual(surf.get_at((x, 1)), (255, 0, 0))
+
+        # mapped colors use all 32 bits
+        surf = pygame.Surface((6, 2), pygame.SRCALPHA, 32)
+        white = surf.map_rgb((255, 255, 255, 255))
+        signed = white - (1 << 32) if white >= 1 << 31 else white
+        for colors in (array('I', [white] * 3), array('i', [signed] * 3)):
+            surf.fill(0)
+            draw.rects(surf, colors, rects)
+            self.assertEqual(surf.get_at((5, 1)), (255, 255, 255, 255))
+        self.assertRaises(ValueError, draw.rects, surf,
+                          array('d', [2.0 ** 40] * 3), rects)
+        self.assertRaises(ValueError, draw.rects, surf,
+                          array('B', [1, 2]), rects)
+
+    def test_textured_triangles(self):
+        from array import array
+        texture = pygame.Surface((4, 4), pygame.SRCALPHA, 32)
+        for x in range(4):
+            for y in range(4):
+                texture.set_at((x, y), (x * 60, y * 60, 100, 255))
+        quad = [(0, 0), (16, 0), (16, 16), (0, 16)]
+        uvs = [(0, 0), (1, 0), (1, 1), (0, 1)]
+        surf = pygame.Surface((20, 20), pygame.SRCALPHA, 32)
+        drawn = draw.textured_triangles(surf, texture, quad, uvs,
+                                        [0, 1, 2, 0, 2, 3], smooth=False)
+        self.assertEqual(drawn, (0, 0, 16, 16))
+        for x in range(16):
+            for y in range(16):
+                self.assertEqual(surf.get_at((x, y)),
+                                 texture.get_at((x // 4, y // 4)))
+        self.assertEqual(surf.get_at((16, 16)), (0, 0, 0, 0))
+
+        # buffers are read by their item size, whatever the letter
+        flat = pygame.Surface((20, 20), pygame.SRCALPHA, 32)
+        draw.textured_triangles(flat, texture,
+                                array('l', [v for p in quad for v in p]),
+                                array('d', [v for p in uvs for v in p]),
+                                array('h', [0, 1, 2, 0, 2, 3]), smooth=False)
+        self.assertEqual(pygame.image.tostring(flat, 'RGBA'),
+                         pygame.image.tostring(surf, 'RGBA'))
+
+        # w of 1 everywhere is the same as no perspective
+        persp = pygame.Surface((20, 20), pygame.SRCALPHA, 32)
+        draw.textured_triangles(persp, texture, [(x, y, 1) for x, y in quad],
+                                uvs, [0, 1, 2, 0, 2, 3], perspective=True,
+                                smooth=False)
+        self.assertEqual(pygame.image.tostring(persp, 'RGBA'),
+                         pygame.image.tostring(surf, 'RGBA'))
+
+        # shared edges are drawn once, so the half transparent texture
+        # blends exactly once on every pixel of the grid
+        texture.fill((255, 255, 255, 128))
+        surf = pygame.Surface((100, 100), pygame.SRCALPHA, 32)
+        verts = [(x * 11.3 + 0.4, y * 9.7 + 0.2)
+                 for y in range(9) for x in range(9)]
+        indices = []
+        for y in range(8):
+            for x in range(8):
+                i = y * 9 + x
+                indices += [i, i + 1, i + 10, i, i + 10, i + 9]
+        draw.textured_triangles(surf, texture, verts, [(0, 0)] * 81, indices)
+        alphas = set(surf.get_at((x, y))[3]
+                     for x in range(1, 90) for y in range(1, 77))
+        self.assertEqual(alphas, set([128]))
+
+    def test_textured_triangles__nonfinite_uvs(self):
+        texture = pygame.Surface((3, 5), pygame.SRCALPHA, 32)
+        for x in range(3):
+            for y in range(5):
+                texture.set_at((x, y), (x * 60, y * 50, 100, 255))
+        colors = set(tuple(texture.get_at((x, y)))
+                     for x in range(3) for y in range(5))
+        nan, inf = float('nan'), float('inf')
+        tri = [(0, 0), (12, 0), (0, 12)]
+        for uvs in [[(nan, 0), (1, nan), (0, 1)],
+                    [(inf, -inf), (1, 0), (0, inf)],
+                    [(1e300, -1e300), (1e-300, 0), (0, 1e300)]]:
+            for smooth in (False, True):
+                surf = pygame.Surface((14, 14), pygame.SRCALPHA, 32)
+                draw.textured_triangles(surf, texture, tri, uvs,
+                                        smooth=smooth)
+                for x in range(10):
+                    self.assertIn(tuple(surf.get_at((x, 0))), colors)
+
+        # a tiny w makes the perspective uvs overflow
+        surf = pygame.Surface((14, 14), pygame.SRCALPHA, 32)
+        draw.textured_triangles(surf, texture,
+                                [(0, 0, 1e-320), (12, 0, 1), (0, 12, 1)],
+                                [(0.5, 0.5)] * 3, perspective=True)
+        self.assertIn(tuple(surf.get_at((5, 5))), colors)
+
+    def test_textured_triangles__threaded(self):
+        # big enough for more than one drawing thread where there are
+        # several CPUs, and the same as drawing it in small pieces
+        texture = pygame.Surface((4, 4), pygame.SRCALPHA, 32)
+        for x in range(4):
+            for y in range(4):
+                texture.set_at((x, y), (x * 60, y * 60, 100, 255))
+        quad = [(0, 0), (256, 0), (256, 256), (0, 256)]
+        uvs = [(0, 0), (1, 0), (1, 1), (0, 1)]
+        indices = [0, 1, 2, 0, 2, 3]
+        whole = pygame.Surface((256, 256), pygame.SRCALPHA, 32)
+        draw.textured_triangles(whole, texture, quad, uvs, indices,
+                                smooth=False)
+        pieces = pygame.Surface((256, 256), pygame.SRCALPHA, 32)
+        for y in range(0, 256, 64):
+            pieces.set_clip((0, y, 256, 64))
+            draw.textured_triangles(pieces, texture, quad, uvs, indices,
+                                    smooth=False)
+        pieces.set_clip(None)
+        self.assertEqual(pygame.image.tostring(whole, 'RGBA'),
+                         pygame.image.tostring(pieces, 'RGBA'))
+        self.assertEqual(whole.get_at((100, 200)), texture.get_at((1, 3)))
+
+    def test_textured_triangles__errors(self):
+        surf = pygame.Surface((10, 10))
+        texture = pygame.Surface((2, 2))
+        tri = [(0, 0), (5, 0), (0, 5)]
+        self.assertRaises(ValueError, draw.textured_triangles,
+                          surf, texture, tri, [(0, 0)] * 2)
+        self.assertRaises(ValueError, draw.textured_triangles,
+                          surf, texture, tri, [(0, 0)] * 3, [0, 1])
+        self.assertRaises(IndexError, draw.textured_triangles,
+                          surf, texture, tri, [(0, 0)] * 3, [0, 1, 3])
+        self.assertRaises(ValueError, draw.textured_triangles,
+                          surf, texture, [(0, 0, 1), (5, 0, 0), (0, 5, 1)],
+                          [(0, 0)] * 3, perspective=True)
+        self.assertRaises(ValueError, draw.textured_triangles,
+                          surf, pygame.Surface((0, 0)), tri, [(0, 0)] * 3)
+
     def todo_test_polygon(self):
 
         # __doc__ (as of 2008-08-02) for pygame.draw.polygon:
@@ -134,6 +134,52 @@ class EventModuleTest(unittest.TestCase):
             self.assertEquals (
                 pygame.event.poll().type, i, race_condition_notification
             )
+
+    def test_post_threaded(self):
+        import threading
+
+        posted, dropped, high_water = pygame.event.get_threaded_stats()
+
+        # small enough for the SDL 1.2 queue of 128 events
+        def post(thread):
+            for i in range(25):
+                e = pygame.event.Event(pygame.USEREVENT, thread=thread, i=i)
+                self.assertTrue(pygame.event.post_threaded(e))
+
+        threads = [threading.Thread(target=post, args=(t,)) for t in range(4)]
+        for t in threads:
+            t.start()
+        for t in threads:
+            t.join()
+
+        # the events only reach the queue when it is pumped
+        events = pygame.event.get(pygame.USEREVENT)
+        self.assertEqual(len(events), 100)
+        for t in range(4):
+            self.assertEqual([e.i for e in events if e.thread == t],
+                             list(range(25)))
+        stats = pygame.event.get_threaded_stats()
+        self.assertEqual(stats[0] - posted, 100)
+        self.assertEqual(stats[1], dropped)
+        self.assertTrue(stats[2] >= 100)
+
+    def test_post_threaded__wait(self):
+        # a thread posting wakes up a wait() that is already waiting
+        import threading
+
+        pygame.event.clear()
+        e = pygame.event.Event(pygame.USEREVENT, posted=True)
+        timer = threading.Timer(0.2, pygame.event.post_threaded, (e,))
+        timer.start()
+        try:
+            event = pygame.event.wait()
+            while event.type != pygame.USEREVENT:
+                event = pygame.event.wait()
+        finally:
+            timer.join()
+        self.assertEqual(event.type, pygame.USEREVENT)
+        self.assertTrue(event.posted)
+
     def test_post_large_user_event(self):
         pygame.event.post(pygame.event.Event(pygame.USEREVENT, {'a': "a" * 1024}))
 
@@ -143,6 +189,23 @@ class EventModuleTest(unittest.TestCase):
 
 
 
+    def test_post__many_user_events(self):
+        # every posted event keeps its attributes until it is taken back
+        # off the queue, or dropped by clear()
+        import sys
+        payload = object()
+        refs = sys.getrefcount(payload)
+        for i in range(100):
+            pygame.event.post(pygame.event.Event(pygame.USEREVENT,
+                                                 seq=i, obj=payload))
+        self.assertEqual([pygame.event.poll().seq for i in range(50)],
+                         list(range(50)))
+        pygame.event.clear()
+        self.assertEqual(sys.getrefcount(payload), refs)
+        for i in range(10):
+            pygame.event.post(pygame.event.Event(pygame.USEREVENT, seq=i))
+        self.assertEqual([e.seq for e in pygame.event.get()], list(range(10)))
+
     def test_get(self):
         # __doc__ (as of 2008-06-25) for pygame.event.get:
 
@@ -157,6 +220,163 @@ class EventModuleTest(unittest.TestCase):
 
         self.assert_ ( len(pygame.event.get()) >= 10 )
 
+    def test_get_into(self):
+        from array import array
+
+        pygame.event.post(pygame.event.Event(pygame.MOUSEBUTTONDOWN,
+                                             pos=(5, 6), button=3))
+        pygame.event.post(pygame.event.Event(pygame.USEREVENT, code=7))
+        buf = bytearray(64)
+        count = pygame.event.get_into(buf, pygame.MOUSEBUTTONDOWN)
+        self.assertEqual(count, 1)
+        record = array('i', bytes(buf[:32]))
+        self.assertEqual(record[0], pygame.MOUSEBUTTONDOWN)
+        self.assertEqual(list(record[2:]), [5, 6, 3, 0, 0, 0])
+
+        # a buffer too small for a record takes nothing off the queue
+        self.assertEqual(pygame.event.get_into(bytearray(31)), 0)
+        count = pygame.event.get_into(buf, [pygame.USEREVENT])
+        self.assertEqual(count, 1)
+        record = array('i', bytes(buf[:32]))
+        self.assertEqual(record[0], pygame.USEREVENT)
+        self.assertEqual(record[2], 7)
+        self.assertRaises(BufferError, pygame.event.get_into, b'x' * 32)
+
+    def test_get__filter(self):
+        pygame.event.post(pygame.event.Event(pygame.KEYDOWN, key=pygame.K_a))
+        pygame.event.post(pygame.event.Event(pygame.KEYDOWN, key=pygame.K_b))
+        pygame.event.post(pygame.event.Event(pygame.MOUSEMOTION, pos=(1, 2)))
+        pygame.event.post(pygame.event.Event(pygame.USEREVENT, code=3))
+        table = {pygame.MOUSEMOTION: None,
+                 pygame.KEYDOWN: {'key': [pygame.K_b]}}
+        events = pygame.event.get(filter=table)
+        self.assertEqual([e.key for e in events if e.type == pygame.KEYDOWN],
+                         [pygame.K_b])
+        self.assertEqual([e.code for e in events
+                          if e.type == pygame.USEREVENT], [3])
+        self.assertFalse([e for e in events if e.type == pygame.MOUSEMOTION])
+        self.assertFalse(pygame.event.get())
+
+        self.assertRaises(ValueError, pygame.event.get,
+                          filter={pygame.MOUSEMOTION: {'pos': 1}})
+        self.assertRaises(TypeError, pygame.event.get,
+                          filter={pygame.KEYDOWN: {'key': 'a'}})
+
+    def test_set_coalesce(self):
+        pygame.event.set_coalesce(pygame.MOUSEMOTION, 'latest')
+        try:
+            for i in range(5):
+                pygame.event.post(pygame.event.Event(pygame.MOUSEMOTION,
+                                                     pos=(i, i)))
+            pygame.event.post(pygame.event.Event(pygame.USEREVENT))
+            events = pygame.event.get()
+            self.assertEqual([e.pos for e in events
+                              if e.type == pygame.MOUSEMOTION], [(4, 4)])
+
+            for i in range(5):
+                pygame.event.post(pygame.event.Event(pygame.MOUSEMOTION,
+                                                     pos=(i, i)))
+            self.assertEqual(pygame.event.poll().pos, (4, 4))
+            self.assertEqual(pygame.event.poll().type, pygame.NOEVENT)
+        finally:
+            pygame.event.set_coalesce(pygame.MOUSEMOTION, None)
+
+        for i in range(3):
+            pygame.event.post(pygame.event.Event(pygame.MOUSEMOTION))
+        self.assertEqual(len(pygame.event.get(pygame.MOUSEMOTION)), 3)
+        self.assertRaises(ValueError, pygame.event.set_coalesce,
+                          pygame.MOUSEMOTION, 'oldest')
+
+    def test_start_recording__and_replay(self):
+        import tempfile
+
+        fd, path = tempfile.mkstemp()
+        os.close(fd)
+        try:
+            pygame.event.start_recording(path)
+            # posted events are made by the program, they are not recorded
+            pygame.event.post(pygame.event.Event(pygame.KEYDOWN, key=1))
+            self.assertEqual(len(pygame.event.get()), 1)
+            pygame.event.stop_recording()
+
+            self.assertEqual(pygame.event.replay(path), 0)
+            self.assertEqual(pygame.event.get_replay_pending(), 0)
+            self.assertEqual(pygame.event.stop_replay(), 0)
+
+            with open(path, 'wb') as f:
+                f.write(b'not a log')
+            self.assertRaises(ValueError, pygame.event.replay, path)
+            self.assertRaises(ValueError, pygame.event.replay, path, -1.0)
+        finally:
+            os.remove(path)
+        self.assertRaises(IOError, pygame.event.replay, path)
+
+    def test_replay__order_and_timing(self):
+        # wait() wakes up for each event of a replay when it is due, and
+        # the events taken off the queue are recorded again
+        import struct
+        import tempfile
+        import time
+
+        paths = []
+        for i in range(2):
+            fd, path = tempfile.mkstemp()
+            os.close(fd)
+            paths.append(path)
+
+        def wait_for_buttons():
+            start = time.time()
+            found = []
+            while len(found) < 3:
+                e = pygame.event.wait()
+                if e.type == pygame.JOYBUTTONDOWN:
+                    found.append((e.button, time.time() - start))
+            return found
+
+        try:
+            pygame.event.start_recording(paths[0])
+            pygame.event.stop_recording()
+            with open(paths[0], 'rb') as f:
+                magic, record_size, reserved = struct.unpack('=8sII',
+                                                             f.read())
+
+            # the dummy video driver makes no input events, so the first
+            # log gets its raw SDL_Event records written here
+            offset = struct.calcsize('IP') - struct.calcsize('P')
+            with open(paths[0], 'ab') as f:
+                for button, ticks in ((1, 0), (2, 150), (3, 300)):
+                    # type, (timestamp,) which, button and state
+                    if pygame.get_sdl_version()[0] == 2:
+                        event = struct.pack('=IIiBB', pygame.JOYBUTTONDOWN,
+                                            0, 0, button, 1)
+                    else:
+                        event = struct.pack('=BBBB', pygame.JOYBUTTONDOWN,
+                                            0, button, 1)
+                    record = struct.pack('=I', ticks).ljust(offset, b'\0')
+                    f.write((record + event).ljust(record_size, b'\0'))
+
+            pygame.event.clear()
+            self.assertEqual(pygame.event.replay(paths[0]), 3)
+            pygame.event.start_recording(paths[1])
+            found = wait_for_buttons()
+            pygame.event.stop_recording()
+            self.assertEqual([b for b, t in found], [1, 2, 3])
+            self.assertTrue(found[1][1] >= 0.13, found)
+            self.assertTrue(found[2][1] >= 0.28, found)
+            self.assertEqual(pygame.event.get_replay_pending(), 0)
+
+            # the recorded events replay the same, twice as fast
+            self.assertTrue(pygame.event.replay(paths[1], 2.0) >= 3)
+            found = wait_for_buttons()
+            self.assertEqual([b for b, t in found], [1, 2, 3])
+            self.assertTrue(found[1][1] >= 0.06, found)
+            self.assertTrue(found[2][1] >= 0.13, found)
+        finally:
+            pygame.event.stop_replay()
+            pygame.event.stop_recording()
+            for path in paths:
+                os.remove(path)
+
     def test_clear(self):
 
         # __doc__ (as of 2008-06-25) for pygame.event.clear:
@@ -108,6 +108,15 @@ class FasteventModuleTest(unittest.TestCase):
         else:
             self.fail()
     
+    def test_get__timers(self):
+        # the timers of pygame.time run when fastevent pumps the queue
+        timer = pygame.time.add_timer(pygame.USEREVENT, 5, loops=1)
+        pygame.time.delay(20)
+        self.assertEquals(
+            [e.type for e in fastevent.get()], [pygame.USEREVENT]
+        )
+        self.assertFalse(timer.cancel())
+
     def todo_test_pump(self):
     
         # __doc__ (as of 2008-08-02) for pygame.fastevent.pump:
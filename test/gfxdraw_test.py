@@ -644,6 +644,56 @@ class GfxdrawDefaultTest( unittest.TestCase ):
             for posn in bg_test_points:
                 self.check_at(surf, posn, bg_adjusted)
 
+    def test_filled__threads(self):
+        """filled shapes drawn from several threads match serial drawing"""
+        import threading
+        color = self.foreground_color + (128,)
+        star = [(50, 2), (62, 38), (98, 38), (68, 60),
+                (80, 96), (50, 74), (20, 96), (32, 60), (2, 38), (38, 38)]
+
+        def draw(surf):
+            for i in range(20):
+                pygame.gfxdraw.filled_polygon(surf, star, color)
+                pygame.gfxdraw.filled_circle(surf, 50, 50, 30 - i, color)
+                pygame.gfxdraw.filled_trigon(surf, 5, 5, 95, 20, 30, 90,
+                                             color)
+                pygame.gfxdraw.box(surf, (10, 40, 80, 20), color)
+
+        for surf in self.surfaces:
+            expected = surf.copy()
+            draw(expected)
+            copies = [surf.copy() for i in range(4)]
+            threads = [threading.Thread(target=draw, args=(s,))
+                       for s in copies]
+            for t in threads:
+                t.start()
+            for t in threads:
+                t.join()
+            for s in copies:
+                self.assertEqual(pygame.image.tostring(s, 'RGB'),
+                                 pygame.image.tostring(expected, 'RGB'))
+
+    def test_filled__scalar_blend(self):
+        """the scalar reference blend draws the same as the span blend"""
+        color = self.foreground_color + (128,)
+
+        def draw(surf):
+            surf.fill((30, 200, 90, 200))
+            pygame.gfxdraw.box(surf, (3, 2, 90, 60), color)
+            pygame.gfxdraw.filled_circle(surf, 50, 50, 33, color)
+
+        for surf in self.surfaces:
+            expected = surf.copy()
+            draw(expected)
+            previous = pygame.gfxdraw._set_scalar_blend(True)
+            try:
+                draw(surf)
+            finally:
+                pygame.gfxdraw._set_scalar_blend(previous)
+            self.assertFalse(previous)
+            self.assertEqual(pygame.image.tostring(surf, 'RGBA'),
+                             pygame.image.tostring(expected, 'RGBA'))
+
     def test_textured_polygon(self):
         """textured_polygon(surface, points, texture, tx, ty): return None"""
         w, h = self.default_size
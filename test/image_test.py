@@ -113,6 +113,226 @@ class ImageModuleTest( unittest.TestCase ):
 
         # surf = pygame.image.load(open(os.path.join("examples", "data", "alien1.jpg"), "rb"))
 
+    def test_load_format_like(self):
+        """ see if load converts to the format of format_like.
+        """
+        name = 'alien1.png' if pygame.image.get_extended() else 'asprite.bmp'
+        path = example_path(os.path.join('data', name))
+        expected = pygame.image.load(path)
+        points = [(0, 0), (5, 5), (expected.get_width() - 1,
+                                    expected.get_height() - 1)]
+
+        for masks in [(0xff0000, 0xff00, 0xff, 0xff000000),
+                      (0xff, 0xff00, 0xff0000, 0xff000000),
+                      (0xff00, 0xff0000, 0xff000000, 0xff),
+                      (0xff0000, 0xff00, 0xff, 0)]:
+            surf = pygame.image.load(path, format_like=masks)
+            self.assertEqual(surf.get_masks(), masks)
+            self.assertEqual(surf.get_size(), expected.get_size())
+            for pos in points:
+                color = expected.get_at(pos)
+                if not masks[3]:
+                    color.a = 255
+                self.assertEqual(surf.get_at(pos), color)
+
+        # a 32 bit image going to a 32 bit layout is converted in place,
+        # 37 pixels wide so a row does not end on a group of 4
+        source = pygame.Surface((37, 5), pygame.SRCALPHA, 32)
+        for y in range(5):
+            for x in range(37):
+                source.set_at((x, y), ((x * 7) & 255, (y * 40 + x) & 255,
+                                       (x * x) & 255, (255 - x * 5) & 255))
+        fd, saved = tempfile.mkstemp(
+            '.png' if pygame.image.get_extended() else '.bmp')
+        os.close(fd)
+        try:
+            pygame.image.save(source, saved)
+            expected = pygame.image.load(saved)
+            if pygame.image.get_extended():
+                self.assertEqual(expected.get_bytesize(), 4)
+            for masks in [(0xff0000, 0xff00, 0xff, 0xff000000),
+                          (0xff, 0xff00, 0xff0000, 0xff000000),
+                          (0xff00, 0xff0000, 0xff000000, 0xff),
+                          (0xff0000, 0xff00, 0xff, 0),
+                          (0xff000000, 0xff0000, 0xff00, 0)]:
+                surf = pygame.image.load(saved, format_like=masks)
+                self.assertEqual(surf.get_masks(), masks)
+                for y in range(5):
+                    for x in range(37):
+                        color = expected.get_at((x, y))
+                        if not masks[3]:
+                            color.a = 255
+                        self.assertEqual(surf.get_at((x, y)), color,
+                                         (masks, x, y))
+        finally:
+            os.remove(saved)
+
+        like = pygame.Surface((1, 1), 0, 16)
+        surf = pygame.image.load(path, format_like=like)
+        self.assertEqual(surf.get_bitsize(), 16)
+        self.assertEqual(surf.get_masks(), like.get_masks())
+
+        self.assertRaises(TypeError, pygame.image.load, path, format_like=5)
+        self.assertRaises(ValueError, pygame.image.load, path,
+                          format_like='screen')
+        pygame.display.init()
+        try:
+            screen = pygame.display.set_mode((10, 10))
+            surf = pygame.image.load(path, format_like='display')
+            if not expected.get_masks()[3]:
+                self.assertEqual(surf.get_masks(), screen.get_masks())
+        finally:
+            pygame.display.quit()
+
+    def test_load_many(self):
+        """ see if load_many loads like load, in order, with item errors.
+        """
+        if pygame.image.get_extended():
+            names = ['alien1.png', 'alien1.jpg', 'asprite.bmp', 'brick.png']
+        else:
+            names = ['asprite.bmp', 'chimp.bmp', 'fist.bmp']
+        paths = [example_path(os.path.join('data', n)) for n in names]
+        f = open(paths[0], 'rb')
+        items = paths + [f, example_path('data/no_such_image.bmp')]
+        try:
+            surfs = pygame.image.load_many(items, threads=2)
+        finally:
+            f.close()
+
+        self.assertEqual(len(surfs), len(items))
+        for surf, path in zip(surfs, paths + paths[:1]):
+            expected = pygame.image.load(path)
+            self.assertEqual(surf.get_size(), expected.get_size())
+            self.assertEqual(surf.get_at((5, 5)), expected.get_at((5, 5)))
+        self.assertTrue(isinstance(surfs[-1], pygame.error))
+
+        target = pygame.Surface((1, 1), 0, 16)
+        surfs = pygame.image.load_many(paths, convert_to=target)
+        for surf in surfs:
+            self.assertEqual(surf.get_bitsize(), 16)
+        self.assertEqual(pygame.image.load_many([]), [])
+        self.assertRaises(TypeError, pygame.image.load_many, paths, 1)
+        self.assertRaises(ValueError, pygame.image.load_many, paths,
+                          threads=-1)
+
+    def test_load_many__display_quit(self):
+        """ see if load_many refuses to convert to a display Surface that quit.
+        """
+        paths = [example_path(os.path.join('data', 'asprite.bmp'))]
+        pygame.display.init()
+        try:
+            screen = pygame.display.set_mode((10, 10))
+        finally:
+            pygame.display.quit()
+        for load_many in (pygame.image.load_many,
+                          pygame.image.load_many_basic):
+            self.assertRaises(pygame.error, load_many, paths,
+                              convert_to=screen)
+
+    def test_load_async(self):
+        """ see if load_async loads in the background and tells when done.
+        """
+        if pygame.image.load_async is None:
+            return
+        path = example_path('data/alien1.png')
+        expected = pygame.image.load(path)
+        done = []
+
+        first = handle = pygame.image.load_async(path, callback=done.append)
+        self.assertTrue(isinstance(handle, pygame.image.AsyncLoad))
+        self.assertEqual(handle.path, path)
+        surf = handle.result()
+        self.assertTrue(handle.done())
+        self.assertFalse(handle.cancelled())
+        self.assertFalse(handle.cancel())
+        self.assertEqual(surf.get_size(), expected.get_size())
+        self.assertEqual(surf.get_at((5, 5)), expected.get_at((5, 5)))
+
+        handle = pygame.image.load_async(example_path('data/no_such.png'))
+        self.assertRaises(pygame.error, handle.result)
+
+        f = open(path, 'rb')
+        try:
+            surf = pygame.image.load_async(f).result()
+        finally:
+            f.close()
+        self.assertEqual(surf.get_size(), expected.get_size())
+
+        pygame.display.init()
+        try:
+            event_type = pygame.USEREVENT + 1
+            handle = pygame.image.load_async(path, event_type=event_type)
+            handle.result()
+            for i in range(100):
+                events = pygame.event.get(event_type)
+                if events:
+                    break
+                pygame.time.wait(10)
+            self.assertEqual(len(events), 1)
+            self.assertTrue(events[0].handle is handle)
+            self.assertEqual(events[0].surface.get_size(), surf.get_size())
+            self.assertTrue(events[0].error is None)
+        finally:
+            pygame.display.quit()
+        # one thread loads them all, the first callback ran before
+        self.assertEqual(done, [first])
+
+    def test_load_async__cancel_and_limit(self):
+        """ see if queued loads cancel, and at most 64 are loading at once.
+        """
+        if pygame.image.load_async is None:
+            return
+        import io
+        import threading
+        import time
+
+        path = example_path('data/alien1.png')
+        size = pygame.image.load(path).get_size()
+        with open(path, 'rb') as f:
+            data = f.read()
+        release = threading.Event()
+
+        class BlockingFile(io.BytesIO):
+            def read(self, *args):
+                release.wait()
+                return io.BytesIO.read(self, *args)
+
+        # the first load holds up the loading thread, the rest stay queued
+        handles = [pygame.image.load_async(BlockingFile(data))]
+        try:
+            handles += [pygame.image.load_async(path) for i in range(63)]
+            self.assertRaises(pygame.error, pygame.image.load_async, path)
+
+            queued = handles.pop()
+            self.assertTrue(queued.cancel())
+            self.assertTrue(queued.cancelled())
+            self.assertTrue(queued.cancel())
+            self.assertRaises(pygame.error, queued.result)
+            handles.append(pygame.image.load_async(path))
+
+            # every cancel wakes the waiting result(), which still gives up
+            # once its timeout has passed in all
+            cancelled = handles[32:]
+            del handles[32:]
+            def cancel_all():
+                for handle in cancelled:
+                    handle.cancel()
+                    time.sleep(0.01)
+            canceller = threading.Thread(target=cancel_all)
+            start = time.time()
+            canceller.start()
+            try:
+                self.assertRaises(pygame.error, handles[0].result, 100)
+                elapsed = time.time() - start
+            finally:
+                canceller.join()
+            self.assertTrue(elapsed < 0.25, elapsed)
+            self.assertTrue(all(h.cancelled() for h in cancelled))
+        finally:
+            release.set()
+        for handle in handles:
+            self.assertEqual(handle.result().get_size(), size)
+
     def testSaveJPG(self):
         """ JPG equivalent to issue #211 - color channel swapping
 
@@ -164,6 +384,59 @@ class ImageModuleTest( unittest.TestCase ):
             posn = rect.move((offset, offset)).topleft
             self.assertEqual(approx(jpg_surf.get_at(posn)), approx(color))
 
+    def testSaveJPGOptions(self):
+        """ see if the jpg save options keep the colors of any surface.
+        """
+        square_len = 16
+        colors = [(255, 0, 0), (0, 255, 0), (0, 0, 255), (255, 128, 64)]
+        f_path = tempfile.mktemp(suffix='.jpg')
+
+        def save(surf, **options):
+            pygame.image.save(surf, f_path, **options)
+            return os.path.getsize(f_path)
+
+        try:
+            for flags, depth in [(0, 24), (0, 32), (pygame.SRCALPHA, 32),
+                                 (0, 16), (0, 8)]:
+                surf = pygame.Surface((2 * square_len, 3 * square_len),
+                                      flags, depth)
+                for i, color in enumerate(colors):
+                    surf.fill(color, ((i % 2) * square_len,
+                                      (i // 2) * square_len,
+                                      square_len, square_len))
+                for options in [dict(),
+                                dict(quality=95, subsampling='4:4:4'),
+                                dict(subsampling='4:2:2', progressive=True),
+                                dict(subsampling='4:2:0', optimize=True)]:
+                    save(surf, **options)
+                    jpg_surf = pygame.image.load(f_path)
+                    self.assertEqual(jpg_surf.get_size(), surf.get_size())
+                    for i in range(len(colors)):
+                        posn = ((i % 2) * square_len + square_len // 2,
+                                (i // 2) * square_len + square_len // 2)
+                        expected = surf.get_at(posn)
+                        color = jpg_surf.get_at(posn)
+                        for j in range(3):
+                            self.assertAlmostEqual(color[j], expected[j],
+                                                   delta=8)
+
+            self.assertLess(save(surf, quality=10), save(surf, quality=95))
+            self.assertLessEqual(save(surf, optimize=True), save(surf))
+        finally:
+            if os.path.exists(f_path):
+                os.remove(f_path)
+
+        self.assertRaises(ValueError, pygame.image.save, surf, f_path,
+                          quality=0)
+        # the PNG options do not apply to a JPEG file
+        for options in [dict(compression=9), dict(filter='up'),
+                        dict(threads=2)]:
+            self.assertRaises(TypeError, pygame.image.save, surf, f_path,
+                              **options)
+        self.assertFalse(os.path.exists(f_path))
+        self.assertRaises(ValueError, pygame.image.save, surf, f_path,
+                          subsampling='4:1:1')
+
     def testSavePNG32(self):
         """ see if we can save a png with color values in the proper channels.
         """
@@ -226,6 +499,81 @@ class ImageModuleTest( unittest.TestCase ):
 
         os.remove(f_path)
 
+    def _png_chunk_crc_errors(self, f_path):
+        """ returns the types of the chunks with a bad CRC, up to IEND.
+        """
+        import struct
+        import zlib
+        with open(f_path, 'rb') as f:
+            data = f.read()
+        self.assertEqual(data[:8], b'\x89PNG\r\n\x1a\n')
+        errors = []
+        pos = 8
+        chunk_type = None
+        while pos < len(data) and chunk_type != b'IEND':
+            length, = struct.unpack('>I', data[pos:pos + 4])
+            chunk_type = data[pos + 4:pos + 8]
+            end = pos + 8 + length
+            crc, = struct.unpack('>I', data[end:end + 4])
+            if zlib.crc32(data[pos + 4:pos + 8 + length]) & 0xffffffff != crc:
+                errors.append(chunk_type)
+            pos += 12 + length
+        self.assertEqual(chunk_type, b'IEND')
+        self.assertEqual(pos, len(data))
+        return errors
+
+    def testSavePNGOptions(self):
+        """ see if the png save options give the same image.
+        """
+        # Tall enough for the threaded encoder to split it in blocks.
+        width, height = 200, 700
+        surf = pygame.Surface((width, height), pygame.SRCALPHA, 32)
+        for y in range(height):
+            surf.fill((y % 256, y * 7 % 256, 128, 255 - y % 100),
+                      (0, y, width, 1))
+        for x in range(0, width, 3):
+            surf.fill((x, 255 - x, x * 3 % 256, 255), (x, 0, 1, height))
+        expected = [tuple(surf.get_at((x, y)))
+                    for y in range(0, height, 7) for x in range(width)]
+
+        f_path = tempfile.mktemp(suffix='.png')
+        try:
+            for options in [dict(compression=0),
+                            dict(compression=9, filter='none'),
+                            dict(filter='sub'),
+                            dict(filter='up', threads=2),
+                            dict(filter='average', threads=4),
+                            dict(filter='paeth', threads=0),
+                            dict(filter='adaptive', compression=1,
+                                 threads=3)]:
+                pygame.image.save(surf, f_path, **options)
+                self.assertEqual(self._png_chunk_crc_errors(f_path), [],
+                                 options)
+                reader = png.Reader(filename=f_path)
+                w, h, pixels, metadata = reader.asRGBA8()
+                self.assertEqual((w, h), (width, height))
+                pixels = [tuple(row[x * 4:x * 4 + 4])
+                          for y, row in enumerate(pixels) if y % 7 == 0
+                          for x in range(width)]
+                self.assertEqual(pixels, expected, options)
+        finally:
+            os.remove(f_path)
+
+        self.assertRaises(ValueError, pygame.image.save, surf, f_path,
+                          compression=10)
+        self.assertRaises(ValueError, pygame.image.save, surf, f_path,
+                          filter='best')
+        self.assertRaises(ValueError, pygame.image.save, surf, f_path,
+                          threads=-1)
+        self.assertRaises(TypeError, pygame.image.save, surf,
+                          tempfile.mktemp(suffix='.bmp'), compression=1)
+        # the JPEG options do not apply to a PNG file
+        for options in [dict(quality=90), dict(subsampling='4:4:4'),
+                        dict(progressive=True), dict(optimize=True)]:
+            self.assertRaises(TypeError, pygame.image.save, surf, f_path,
+                              **options)
+        self.assertFalse(os.path.exists(f_path))
+
     def test_save(self):
 
         s = pygame.Surface((10,10))
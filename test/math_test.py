@@ -16,7 +16,7 @@ import unittest
 
 import math
 import pygame.math
-from pygame.math import Vector2, Vector3
+from pygame.math import Vector2, Vector3, Affine2, Matrix44, PointIndex
 from time import clock
 from random import random
 import gc
@@ -492,6 +492,21 @@ class Vector2TypeTest(unittest.TestCase):
         self.assertEqual(type(self.v1.xyxy), tuple)
         self.assertEqual(type(self.v1.xyxyx), tuple)
 
+    def test_swizzle_repeated_and_dynamic_names(self):
+        v = Vector2(1, 2)
+        for i in range(3):
+            self.assertEqual(v.yx, Vector2(2, 1))
+            self.assertEqual(v.xyyx, (1, 2, 2, 1))
+            # non-interned attribute names take the uncached path
+            self.assertEqual(getattr(v, ''.join(['y', 'x'])), Vector2(2, 1))
+        v.x = 5
+        self.assertEqual(v.yx, Vector2(2, 5))
+        self.assertRaises(AttributeError, lambda: v.xz)
+        self.assertRaises(AttributeError, lambda: v.wx)
+        self.assertRaises(AttributeError,
+                          lambda: getattr(v, ''.join(['x', 'z'])))
+        self.assertRaises(AttributeError, lambda: v.xyxyxyxyxyz)
+
     def test_elementwise(self):
         # behaviour for "elementwise op scalar"
         self.assertEqual(self.v1.elementwise() + self.s1,
@@ -1607,6 +1622,245 @@ class Vector3TypeTest(unittest.TestCase):
         self.assertEqual(pickle.loads(pickle.dumps(v3)), v3)
 
 
+class Affine2TypeTest(unittest.TestCase):
+
+    def assertSequenceAlmostEqual(self, seq1, seq2, places=7):
+        self.assertEqual(len(seq1), len(seq2))
+        for a, b in zip(seq1, seq2):
+            self.assertAlmostEqual(a, b, places)
+
+    def testConstruction(self):
+        self.assertEqual(list(Affine2()), [1., 0., 0., 1., 0., 0.])
+        self.assertEqual(list(Affine2(1, 2, 3, 4, 5, 6)), [1, 2, 3, 4, 5, 6])
+        self.assertEqual(list(Affine2((1, 2, 3, 4, 5, 6))), [1, 2, 3, 4, 5, 6])
+        a = Affine2(1, 2, 3, 4, 5, 6)
+        self.assertEqual(Affine2(a), a)
+        self.assertEqual(Affine2.identity(), Affine2())
+        self.assertRaises(ValueError, Affine2, 1, 2, 3)
+        self.assertRaises(ValueError, Affine2, (1, 2, 3, 4, 5, "6"))
+
+    def testItems(self):
+        a = Affine2()
+        self.assertEqual(len(a), 6)
+        a[4] = 3
+        self.assertEqual(a[4], 3.)
+        self.assertRaises(IndexError, lambda: a[6])
+
+    def testTransformPoint(self):
+        t = Affine2.translation((10, 20))
+        self.assertEqual(t.transform_point((1, 2)), Vector2(11, 22))
+        self.assertEqual(t.transform_vector((1, 2)), Vector2(1, 2))
+        r = Affine2.rotation(90)
+        self.assertEqual(r.transform_point(Vector2(1, 0)),
+                         Vector2(1, 0).rotate(90))
+        r = Affine2.rotation(33)
+        self.assertEqual(r.transform_point(Vector2(3, 4)),
+                         Vector2(3, 4).rotate(33))
+        s = Affine2.scaling((2, 3))
+        self.assertEqual(s.transform_point((1, 1)), Vector2(2, 3))
+        self.assertEqual(Affine2.scaling(2).transform_point((1, 1)),
+                         Vector2(2, 2))
+
+    def testComposition(self):
+        t = Affine2.translation((10, 0))
+        r = Affine2.rotation(90)
+        p = Vector2(1, 0)
+        self.assertEqual((t * r).transform_point(p),
+                         t.transform_point(r.transform_point(p)))
+        self.assertEqual((r * t).transform_point(p),
+                         r.transform_point(t.transform_point(p)))
+        m = Affine2(t)
+        m *= r
+        self.assertEqual(m, t * r)
+        self.assertRaises(TypeError, lambda: t * 2)
+
+    def testInverse(self):
+        a = Affine2(2, 1, -1, 3, 5, 7)
+        self.assertAlmostEqual(a.determinant(), 7.)
+        self.assertSequenceAlmostEqual(a * a.inverse(), Affine2())
+        self.assertRaises(ValueError, Affine2(1, 2, 2, 4, 0, 0).inverse)
+
+    def testDecompose(self):
+        a = (Affine2.translation((3, 4)) * Affine2.rotation(30) *
+             Affine2.scaling((2, 5)))
+        (tx, ty), angle, (sx, sy), shear = a.decompose()
+        self.assertSequenceAlmostEqual((tx, ty, angle, sx, sy, shear),
+                                       (3, 4, 30, 2, 5, 0))
+        (tx, ty), angle, (sx, sy), shear = Affine2.scaling((1, -1)).decompose()
+        self.assertSequenceAlmostEqual((angle, sx, sy), (0, 1, -1))
+        self.assertRaises(ValueError, Affine2(0, 0, 0, 0, 0, 0).decompose)
+
+    def testTransformPointsBuffer(self):
+        from array import array
+        a = Affine2.translation((1, 2)) * Affine2.rotation(45)
+        points = [(1., 2.), (3., 4.), (-5., 6.)]
+        flat = array('d', [c for p in points for c in p])
+        out = array('d', [0.] * len(flat))
+        self.assertIs(a.transform_points(flat, out), out)
+        expected = [a.transform_point(p) for p in points]
+        self.assertSequenceAlmostEqual(out, [c for p in expected for c in p])
+        a.transform_points(flat)
+        self.assertEqual(list(flat), list(out))
+        vecs = a.transform_vectors(points)
+        self.assertEqual(vecs, [a.transform_vector(p) for p in points])
+        self.assertEqual(a.transform_points(points), expected)
+        self.assertRaises(ValueError, a.transform_points, array('d', [1.]))
+        self.assertRaises(TypeError, a.transform_points, array('f', [1., 2.]))
+        self.assertRaises(ValueError, a.transform_points, flat,
+                          array('d', [0.] * 2))
+
+    def testPickle(self):
+        import pickle
+        a = Affine2(1, 2, 3, 4, 5, 6)
+        self.assertEqual(pickle.loads(pickle.dumps(a)), a)
+        self.assertEqual(repr(a), "<Affine2(1, 2, 3, 4, 5, 6)>")
+
+
+class Matrix44TypeTest(unittest.TestCase):
+
+    def assertSequenceAlmostEqual(self, seq1, seq2, places=7):
+        self.assertEqual(len(seq1), len(seq2))
+        for a, b in zip(seq1, seq2):
+            self.assertAlmostEqual(a, b, places)
+
+    def testConstruction(self):
+        identity = [1., 0., 0., 0., 0., 1., 0., 0.,
+                    0., 0., 1., 0., 0., 0., 0., 1.]
+        self.assertEqual(list(Matrix44()), identity)
+        self.assertEqual(list(Matrix44(*range(16))), list(range(16)))
+        self.assertEqual(Matrix44(range(16)), Matrix44(*range(16)))
+        rows = [[0, 1, 2, 3], [4, 5, 6, 7], [8, 9, 10, 11], [12, 13, 14, 15]]
+        self.assertEqual(Matrix44(rows), Matrix44(*range(16)))
+        self.assertEqual(Matrix44.identity(), Matrix44())
+        self.assertRaises(ValueError, Matrix44, 1, 2, 3)
+
+    def testTransform(self):
+        t = Matrix44.translation((1, 2, 3))
+        self.assertEqual(t.transform_point((1, 1, 1)), Vector3(2, 3, 4))
+        self.assertEqual(t.transform_vector((1, 1, 1)), Vector3(1, 1, 1))
+        r = Matrix44.rotation(33, (1, 2, 3))
+        v = Vector3(4, 5, 6)
+        self.assertEqual(r.transform_point(v), v.rotate(33, (1, 2, 3)))
+        s = Matrix44.scaling((2, 3, 4))
+        self.assertEqual(s.transform_point((1, 1, 1)), Vector3(2, 3, 4))
+        self.assertEqual((t * s).transform_point((1, 1, 1)), Vector3(3, 5, 7))
+
+    def testProjection(self):
+        p = Matrix44.perspective(90, 1, 1, 10)
+        self.assertSequenceAlmostEqual(p.transform_point((1, 1, -1)),
+                                       (1, 1, -1))
+        self.assertSequenceAlmostEqual(p.transform_point((10, 0, -10)),
+                                       (1, 0, 1))
+        o = Matrix44.orthographic(0, 10, 0, 20, -1, 1)
+        self.assertSequenceAlmostEqual(o.transform_point((10, 20, 0)),
+                                       (1, 1, 0))
+
+    def testInverse(self):
+        m = (Matrix44.translation((1, -2, 3)) *
+             Matrix44.rotation(40, (0, 1, 1)) * Matrix44.scaling((2, 3, 4)))
+        self.assertAlmostEqual(m.determinant(), 24.)
+        self.assertSequenceAlmostEqual(m * m.inverse(), Matrix44())
+        p = Matrix44.perspective(60, 1.5, 0.1, 100)
+        self.assertSequenceAlmostEqual(p.inverse() * p, Matrix44())
+        self.assertRaises(ValueError, Matrix44(*([1.] * 16)).inverse)
+        self.assertEqual(Matrix44(*range(16)).transpose(),
+                         Matrix44(0, 4, 8, 12, 1, 5, 9, 13,
+                                  2, 6, 10, 14, 3, 7, 11, 15))
+
+    def testDecompose(self):
+        r = Matrix44.rotation(40, (0, 1, 1))
+        m = (Matrix44.translation((1, -2, 3)) * r *
+             Matrix44.scaling((2, 3, 4)))
+        translation, rotation, scale = m.decompose()
+        self.assertSequenceAlmostEqual(translation, (1, -2, 3))
+        self.assertSequenceAlmostEqual(rotation, r)
+        self.assertSequenceAlmostEqual(scale, (2, 3, 4))
+
+    def testTransformPointsBuffer(self):
+        from array import array
+        m = Matrix44.perspective(60, 1.5, 0.1, 100) * \
+            Matrix44.translation((1, 2, -5))
+        points = [(1., 2., 3.), (-4., 5., -6.)]
+        flat = array('d', [c for p in points for c in p])
+        m.transform_points(flat)
+        expected = [m.transform_point(p) for p in points]
+        self.assertSequenceAlmostEqual(flat, [c for p in expected for c in p])
+        self.assertEqual(m.transform_vectors(points),
+                         [m.transform_vector(p) for p in points])
+
+    def testPickle(self):
+        import pickle
+        m = Matrix44(*range(16))
+        self.assertEqual(pickle.loads(pickle.dumps(m)), m)
+
+
+class PointIndexTypeTest(unittest.TestCase):
+
+    def setUp(self):
+        from random import Random
+        rng = Random(1234)
+        self.points = [(rng.uniform(-100, 100), rng.uniform(-100, 100))
+                       for i in range(500)]
+
+    def brute_within(self, points, p, r):
+        return [i for i, q in enumerate(points)
+                if (q[0] - p[0]) ** 2 + (q[1] - p[1]) ** 2 <= r * r]
+
+    def testConstruction(self):
+        from array import array
+        index = PointIndex(self.points)
+        self.assertEqual(len(index), 500)
+        self.assertEqual(index[3], Vector2(self.points[3]))
+        flat = array('d', [c for p in self.points for c in p])
+        self.assertEqual(len(PointIndex(flat)), 500)
+        self.assertEqual(len(PointIndex([])), 0)
+        self.assertRaises(ValueError, PointIndex, array('d', [1, 2, 3]))
+        self.assertRaises(TypeError, PointIndex, array('f', [1, 2]))
+        self.assertRaises(TypeError, PointIndex, [(1, 2), "ab"])
+        self.assertRaises(IndexError, lambda: index[500])
+
+    def testNearest(self):
+        index = PointIndex(self.points)
+        for p in [(0, 0), (99.5, -20), (-300, 40), self.points[7]]:
+            dists = sorted((Vector2(q).distance_squared_to(p), i)
+                           for i, q in enumerate(self.points))
+            self.assertEqual(index.nearest(p), [dists[0][1]])
+            self.assertEqual(index.nearest(p, k=10),
+                             [i for d, i in dists[:10]])
+        self.assertEqual(len(index.nearest((0, 0), 1000)), 500)
+        self.assertEqual(PointIndex([]).nearest((0, 0)), [])
+        self.assertRaises(ValueError, index.nearest, (0, 0), 0)
+
+    def testWithin(self):
+        index = PointIndex(self.points)
+        for p, r in [((0, 0), 10), ((50, 50), 35.5), ((0, 0), 0), ((0, 0), 500)]:
+            self.assertEqual(index.within(p, r),
+                             self.brute_within(self.points, p, r))
+        self.assertEqual(index.within(self.points[4], 0), [4])
+        self.assertRaises(ValueError, index.within, (0, 0), -1)
+
+    def testPairsWithin(self):
+        index = PointIndex(self.points)
+        pairs = [(i, j) for i in range(500)
+                 for j in self.brute_within(self.points, self.points[i], 6)
+                 if j > i]
+        self.assertEqual(index.pairs_within(6), pairs)
+        self.assertEqual(PointIndex([(1, 1), (1, 1)]).pairs_within(0),
+                         [(0, 1)])
+
+    def testMoveAndUpdate(self):
+        index = PointIndex(self.points)
+        points = list(self.points)
+        for i in range(0, 500, 7):
+            points[i] = (points[i][1] * 0.5, -points[i][0])
+            index[i] = points[i]
+        self.assertEqual(index.within((10, 10), 30),
+                         self.brute_within(points, (10, 10), 30))
+        self.assertEqual(index.nearest(points[14]), [14])
+        index.update(points[:50])
+        self.assertEqual(len(index), 50)
+        self.assertEqual(index.within((0, 0), 60),
+                         self.brute_within(points[:50], (0, 0), 60))
 
 
 if __name__ == '__main__':
@@ -23,7 +23,57 @@ class ClockTypeTest(unittest.TestCase):
     def test_construction(self):
         c = Clock()
         self.assert_(c, "Clock can be constructed")
+
+    def test_precise_tick(self):
+        pygame.init()
+        try:
+            c = Clock(precise=True)
+            c.tick(100)
+            start = pygame.time.get_ticks_ns()
+            for i in range(5):
+                c.tick(100)
+            elapsed = pygame.time.get_ticks_ns() - start
+            # five frames at 100 fps are 50 milliseconds
+            self.assertTrue(45000000 <= elapsed < 150000000, elapsed)
+            self.assertTrue(9000000 <= c.get_time_ns() < 40000000,
+                            c.get_time_ns())
+            self.assertTrue(0 <= c.get_rawtime_ns() <= c.get_time_ns())
+            self.assertEqual(c.get_time(),
+                             int(c.get_time_ns() / 1000000.0 + 0.5))
+        finally:
+            pygame.quit()
     
+    def test_get_stats(self):
+        c = Clock(precise=True)
+        stats = c.get_stats()
+        self.assertEqual(stats['frames'], 0)
+        self.assertEqual(stats['sections'], {})
+
+        c.tick()
+        for i in range(10):
+            with c.section("physics"):
+                pygame.time.delay(2)
+            if i % 2:
+                with c.section("render"):
+                    pass
+            c.tick()
+        stats = c.get_stats()
+        self.assertEqual(stats['frames'], 10)
+        self.assertTrue(0.0 < stats['p50'] <= stats['p95'] <= stats['p99']
+                        <= stats['max'])
+        self.assertTrue(stats['jitter'] >= 0.0)
+        self.assertEqual(stats['missed'], 0)
+        self.assertEqual(len(stats['histogram']), 32)
+        self.assertEqual(sum(stats['histogram']), 10)
+
+        sections = stats['sections']
+        self.assertEqual(sorted(sections.keys()), ['physics', 'render'])
+        self.assertEqual(sections['physics']['frames'], 10)
+        self.assertEqual(sections['render']['frames'], 5)
+        self.assertTrue(sections['physics']['p50'] >= 1.5)
+        self.assertTrue(c.section("physics") is c.section("physics"))
+        self.assertRaises(TypeError, c.section, 1)
+
     def todo_test_get_fps(self):
 
         # __doc__ (as of 2008-08-02) for pygame.time.Clock.get_fps:
@@ -148,6 +198,19 @@ class ClockTypeTest(unittest.TestCase):
         self.fail() 
 
 class TimeModuleTest(unittest.TestCase):
+    def test_get_ticks_ns(self):
+        pygame.init()
+        try:
+            first = pygame.time.get_ticks_ns()
+            pygame.time.delay(10)
+            second = pygame.time.get_ticks_ns()
+            self.assertTrue(second - first >= 9000000, second - first)
+            ms = pygame.time.get_ticks()
+            self.assertTrue(abs(pygame.time.get_ticks_ns() // 1000000 - ms)
+                            <= 2)
+        finally:
+            pygame.quit()
+
     def todo_test_delay(self):
 
         # __doc__ (as of 2008-08-02) for pygame.time.delay:
@@ -176,6 +239,96 @@ class TimeModuleTest(unittest.TestCase):
 
         self.fail() 
 
+    def test_add_timer(self):
+        pygame.display.init()
+        try:
+            pygame.event.clear()
+            once = pygame.time.add_timer(
+                pygame.event.Event(pygame.USEREVENT, ability="dash"), 20,
+                loops=1)
+            three = pygame.time.add_timer(pygame.USEREVENT + 1, 5, loops=3)
+            cancelled = pygame.time.add_timer(pygame.USEREVENT + 2, 5)
+            self.assertTrue(cancelled.cancel())
+            self.assertFalse(cancelled.cancel())
+
+            pygame.time.delay(60)
+            events = pygame.event.get()
+            self.assertEqual([e.ability for e in events
+                              if e.type == pygame.USEREVENT], ["dash"])
+            self.assertEqual(len([e for e in events
+                                  if e.type == pygame.USEREVENT + 1]), 3)
+            self.assertFalse([e for e in events
+                              if e.type == pygame.USEREVENT + 2])
+            self.assertFalse(once.cancel())
+            self.assertFalse(three.cancel())
+
+            self.assertRaises(ValueError, pygame.time.add_timer,
+                              pygame.USEREVENT, 0)
+            self.assertRaises(TypeError, pygame.time.add_timer, "x", 10)
+        finally:
+            pygame.display.quit()
+
+    def test_add_timer__quit(self):
+        # every pygame.quit() stops the timers, not only the first one
+        for i in range(2):
+            pygame.init()
+            timer = pygame.time.add_timer(pygame.USEREVENT, 1000)
+            pygame.quit()
+            self.assertFalse(timer.cancel())
+
+    def test_fixed_step_loop(self):
+        calls = []
+        def update(dt):
+            calls.append(dt)
+        def render(alpha):
+            self.assertTrue(0.0 <= alpha < 1.0)
+            calls.append(None)
+
+        loop = pygame.time.FixedStepLoop(update, render, 50, framerate=200)
+        loop.run(20)
+        self.assertEqual(calls.count(None), 20)
+        # 20 frames at 200 fps are 100 ms, about 5 updates at 50 hz
+        updates = [dt for dt in calls if dt is not None]
+        self.assertTrue(3 <= len(updates) <= 8, len(updates))
+        self.assertEqual(set(updates), set([1.0 / 50]))
+        stats = loop.get_stats()
+        self.assertEqual(stats['frames'], 19)
+        self.assertEqual(stats['updates'], len(updates))
+
+        def stop(dt):
+            loop.stop()
+        loop = pygame.time.FixedStepLoop(stop, lambda alpha: None, 1000)
+        loop.run()
+        self.assertEqual(loop.get_stats()['updates'], 1)
+
+        def fail(alpha):
+            raise KeyError(alpha)
+        loop = pygame.time.FixedStepLoop(update, fail, 100)
+        self.assertRaises(KeyError, loop.run)
+        for hz in (0, -60, 2e9, float('nan'), float('inf')):
+            self.assertRaises(ValueError, pygame.time.FixedStepLoop,
+                              update, render, hz)
+        self.assertRaises(ValueError, pygame.time.FixedStepLoop,
+                          update, render, 60, 0)
+        for framerate in (-1, 2e9, float('nan'), float('inf')):
+            self.assertRaises(ValueError, pygame.time.FixedStepLoop,
+                              update, render, 60, framerate=framerate)
+        # the highest rate still has a whole nanosecond for a step
+        pygame.time.FixedStepLoop(update, render, 1e9, framerate=1e9)
+
+    def test_fixed_step_loop__pumps(self):
+        # the loop runs the timers without the callbacks reading events
+        pygame.display.init()
+        try:
+            once = pygame.time.add_timer(pygame.USEREVENT, 10, loops=1)
+            loop = pygame.time.FixedStepLoop(lambda dt: None,
+                                             lambda alpha: None, 200)
+            loop.run(20)
+            self.assertFalse(once.cancel())
+            self.assertEqual(len(pygame.event.get(pygame.USEREVENT)), 1)
+        finally:
+            pygame.display.quit()
+
     def todo_test_set_timer(self):
 
         # __doc__ (as of 2008-08-02) for pygame.time.set_timer: